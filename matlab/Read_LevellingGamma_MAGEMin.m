@@ -0,0 +1,47 @@
+function [Lvl] = Read_LevellingGamma_MAGEMin(dir)
+% Reads the binary output of the batch levelling mode (Mode 4), __LEVELLING_GAMMA.bin
+%
+% Lvl.P, Lvl.T          : pressure [kbar] and temperature [C] of the points
+% Lvl.Bulk, Lvl.Gamma   : normalized bulk-rock composition and Gamma [n_points x n_ox]
+% Lvl.Phase_id          : phases of the levelled assemblage [n_points x n_ox] (index in Lvl.Phases, 0 = empty)
+% Lvl.Phase_frac        : fraction of the phases [n_points x n_ox]
+% Lvl.Phase_xeos        : x-eos of the solution phases [n_points x n_ox x n_ox]
+
+curdir = pwd;
+cd(dir)
+
+fid         = fopen('__LEVELLING_GAMMA.bin','r');
+magic       = fread(fid,16,'*char')';
+version     = fread(fid,1,'int32');
+n_ox        = fread(fid,1,'int32');
+n_pp        = fread(fid,1,'int32');
+n_ss        = fread(fid,1,'int32');
+n_points    = fread(fid,1,'int32');
+rec_len     = fread(fid,1,'int32');
+offset      = fread(fid,1,'int64');
+
+names       = fread(fid,[20 n_ox+n_pp+n_ss],'*char')';
+for i=1:size(names,1)
+    Lvl.Names{i} = deblank(strtok(names(i,:),char(0)));
+end
+Lvl.Oxides  = Lvl.Names(1:n_ox);
+Lvl.Phases  = Lvl.Names(n_ox+1:end);           % pure phases, then solution phases
+
+fseek(fid,offset,'bof');
+Data        = fread(fid,[rec_len n_points],'double')';
+fclose(fid);
+cd(curdir)
+
+Lvl.Num         = Data(:,1);                    % line of the point in the input file
+Lvl.n_phase     = Data(:,2);
+Lvl.P           = Data(:,3);
+Lvl.T           = Data(:,4);
+Lvl.Time        = Data(:,5);                    % levelling time [ms]
+Lvl.PC_reuse    = Data(:,6);
+Lvl.Bulk        = Data(:,7:6+n_ox);
+Lvl.Gamma       = Data(:,7+n_ox:6+2*n_ox);
+
+Slots           = reshape(Data(:,7+2*n_ox:end),n_points,2+n_ox,n_ox);
+Lvl.Phase_id    = squeeze(Slots(:,1,:)) + 1;
+Lvl.Phase_frac  = squeeze(Slots(:,2,:));
+Lvl.Phase_xeos  = permute(Slots(:,3:end,:),[1 3 2]);
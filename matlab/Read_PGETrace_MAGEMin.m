@@ -0,0 +1,73 @@
+function [Trc] = Read_PGETrace_MAGEMin(dir)
+% Reads the PGE convergence trace written with --PGE_trace=1, __PGE_TRACE.bin
+%
+% Trc.P, Trc.T          : pressure [kbar] and temperature [C] of the points
+% Trc.Status            : 0 success, 1-2 under-relaxed, 3 failed, 4 diverged
+% Trc.n_ite             : number of global PGE iterations
+% Trc.Time              : sum of the global iteration durations [ms]
+% Trc.ur                : under-relaxation thresholds of the run [ur_1 ur_2 ur_3 ur_f]
+% Trc.Point(k)          : history of point k
+%   .Ite                : [n_ite x 4] duration[ms], mass norm, moving average norm, Gamma norm
+%   .Events             : [n_ev x 5] iteration, type (1 act2hold, 2 hold2act, 3 hold2rmv, 4 act2rmv),
+%                         phase type (0 pure phase, 1 solution phase), phase index (1-based), cp index (1-based, 0 for pure phases)
+%   .cp_phase, .cp_n_LM, .cp_state, .cp_LM_time : considered phases, # local minimizations,
+%                         final state (1 active, 2 hold, 3 removed) and local minimization time [ms]
+%
+% Slow converging regions can be located with e.g. scatter(Trc.T,Trc.P,20,Trc.n_ite,'filled')
+
+curdir = pwd;
+cd(dir)
+
+fid         = fopen('__PGE_TRACE.bin','r');
+magic       = fread(fid,16,'*char')';
+version     = fread(fid,1,'int32');
+n_ox        = fread(fid,1,'int32');
+n_pp        = fread(fid,1,'int32');
+n_ss        = fread(fid,1,'int32');
+Trc.ur      = fread(fid,4,'int32')';
+offset      = fread(fid,1,'int64');
+
+names       = fread(fid,[20 n_ox+n_pp+n_ss],'*char')';
+for i=1:size(names,1)
+    Trc.Names{i} = deblank(strtok(names(i,:),char(0)));
+end
+Trc.Oxides  = Trc.Names(1:n_ox);
+Trc.PP      = Trc.Names(n_ox+1:n_ox+n_pp);
+Trc.SS      = Trc.Names(n_ox+n_pp+1:end);
+
+fseek(fid,offset,'bof');
+k = 0;
+while true
+    head    = fread(fid,6,'int32');
+    if numel(head) < 6
+        break
+    end
+    k       = k + 1;
+    info    = fread(fid,4,'double');
+    n_ite   = head(3);
+    n_ev    = head(4);
+    n_cp    = head(5);
+
+    Trc.Num(k,1)                = head(1);
+    Trc.Status(k,1)             = head(2);
+    Trc.n_ite(k,1)              = n_ite;
+    Trc.n_phase(k,1)            = head(6);
+    Trc.P(k,1)                  = info(1);
+    Trc.T(k,1)                  = info(2);
+    Trc.LVL_time(k,1)           = info(3);
+    Trc.BR_norm(k,1)            = info(4);
+
+    Trc.Point(k).Ite            = fread(fid,[4 n_ite],'double')';
+    Events                      = fread(fid,[5 n_ev],'int32')';
+    Events(:,4:5)               = Events(:,4:5) + 1;
+    Trc.Point(k).Events         = Events;
+    cp                          = fread(fid,[4 n_cp],'int32')';
+    Trc.Point(k).cp_phase       = Trc.SS(cp(:,1)+1);
+    Trc.Point(k).cp_n_LM        = cp(:,2);
+    Trc.Point(k).cp_state       = cp(:,3);
+    Trc.Point(k).cp_split       = cp(:,4);
+    Trc.Point(k).cp_LM_time     = fread(fid,n_cp,'double');
+    Trc.Time(k,1)               = sum(Trc.Point(k).Ite(:,1));
+end
+fclose(fid);
+cd(curdir)
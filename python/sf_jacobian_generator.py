@@ -0,0 +1,140 @@
+"""
+Sparse jacobians of the site-fraction constraints
+-------------------------------------------------
+
+Reads the <phase>_c constraint functions of src/NLopt_opt_function.c and writes src/sf_jacobian.c/.h, where the
+dense m x n gradient of each phase is split into
+
+    - the constant non-zero entries (index and value), written once in the jacobian of a minimization
+    - the x-dependent entries, written by <phase>_c_jac at each evaluation
+
+The zero entries are written by neither, see sf_jac_init and SS_sf_sparse in src/NLopt_opt_function.c.
+
+usage (from the root of the repository, after changing a <phase>_c function):
+
+    python3 python/sf_jacobian_generator.py
+"""
+
+import re
+
+src     = "src/NLopt_opt_function.c"
+out_c   = "src/sf_jacobian.c"
+out_h   = "src/sf_jacobian.h"
+
+head    = re.compile(r"^void (\w+)_c\(unsigned m, double \*result, unsigned n, const double \*x, double \*grad, void \*data\)\{")
+res     = re.compile(r"^\s*result\[(\d+)\]\s*=")
+grd     = re.compile(r"^\s*grad\[(\d+)\]\s*=\s*(.*);\s*$")
+
+
+def parse(text):
+    """ phase name -> (m, list of (index, expression)) in the order of the source file """
+    phases  = {}
+    name    = None
+    for line in text.splitlines():
+        h = head.match(line)
+        if h:
+            name            = h.group(1)
+            phases[name]    = [0, []]
+            continue
+        if name is None:
+            continue
+        r = res.match(line)
+        if r:
+            phases[name][0] = max(phases[name][0], int(r.group(1)) + 1)
+            continue
+        g = grd.match(line)
+        if g:
+            phases[name][1].append((int(g.group(1)), g.group(2).strip()))
+            continue
+        if line.startswith("}"):
+            name = None
+    return phases
+
+
+def is_zero(expr):
+    try:
+        return float(eval(expr)) == 0.0
+    except Exception:
+        return False
+
+
+def c_list(values, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("\t" + ", ".join(values[i:i + per_line]))
+    return ",\n".join(lines) if lines else "\t0"
+
+
+def generate(phases):
+    c = []
+    c.append("/**")
+    c.append("  sparse jacobians of the site-fraction constraints (<phase>_c functions of NLopt_opt_function.c)")
+    c.append("")
+    c.append("  generated by python/sf_jacobian_generator.py, do not edit: the constant non-zero entries of the m x n")
+    c.append("  gradient are listed once per phase, <phase>_c_jac only writes the entries that depend on x")
+    c.append("*/")
+    c.append("")
+    c.append("#include <stdio.h>")
+    c.append("")
+    c.append("#include \"nlopt.h\"")
+    c.append("#include \"MAGEMin.h\"")
+    c.append("#include \"NLopt_opt_function.h\"")
+    c.append("#include \"sf_jacobian.h\"")
+    c.append("")
+
+    h = []
+    h.append("#ifndef __SF_JACOBIAN_H_")
+    h.append("#define __SF_JACOBIAN_H_")
+    h.append("")
+
+    for name, (m, grad) in phases.items():
+        n       = len(grad) // m
+        if n * m != len(grad) or sorted(k for k, _ in grad) != list(range(m * n)):
+            raise SystemExit("%s_c: gradient entries do not form a %d x n array" % (name, m))
+
+        const   = [(k, e) for k, e in grad if "x[" not in e and not is_zero(e)]
+        var     = [(k, e) for k, e in grad if "x[" in e]
+
+        c.append("")
+        c.append("/**")
+        c.append("  %s: %d x %d, %d constant and %d x-dependent non-zero entries" % (name, m, n, len(const), len(var)))
+        c.append("*/")
+        c.append("static const int %s_jc_i[] = {" % name)
+        c.append(c_list([str(k) for k, _ in const], 16))
+        c.append("};")
+        c.append("static const double %s_jc_v[] = {" % name)
+        c.append(c_list([e for _, e in const], 8))
+        c.append("};")
+        c.append("static const int %s_jv_i[] = {" % name)
+        c.append(c_list([str(k) for k, _ in var], 16))
+        c.append("};")
+        c.append("")
+        c.append("void %s_c_jac(const double *x, double *grad){" % name)
+        for k, e in var:
+            c.append("    grad[%d] = %s;" % (k, e))
+        c.append("}")
+        c.append("")
+        c.append("const sf_jac_data %s_sf_jac = {" % name)
+        c.append("\t%s_c, %s_c_jac, %d, %d," % (name, name, m, n))
+        c.append("\t%d, %s_jc_i, %s_jc_v," % (len(const), name, name))
+        c.append("\t%d, %s_jv_i" % (len(var), name))
+        c.append("};")
+
+        h.append("void %s_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);" % name)
+        h.append("void %s_c_jac(const double *x, double *grad);" % name)
+        h.append("extern const sf_jac_data %s_sf_jac;" % name)
+        h.append("")
+
+    h.append("#endif")
+    return "\n".join(c) + "\n", "\n".join(h) + "\n"
+
+
+if __name__ == "__main__":
+    with open(src, newline="") as f:
+        text = f.read().replace("\r\n", "\n")
+
+    code, header = generate(parse(text))
+
+    for path, s in ((out_c, code), (out_h, header)):
+        with open(path, "w", newline="") as f:
+            f.write(s.replace("\n", "\r\n"))
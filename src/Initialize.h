@@ -145,6 +145,7 @@ global_variable global_variable_init(){
 	
 	gv.outpath 			= malloc(100 * sizeof(char));
 	gv.version 			= malloc(50  * sizeof(char));
+	gv.PC_grid 			= malloc(255 * sizeof(char));
 	gv.len_pp      		= 10;	
 	
 	/* Control center... */
@@ -162,6 +163,14 @@ global_variable global_variable_init(){
 
 	strcpy(gv.outpath,"./output/");				/** define the outpath to save logs and final results file	 						*/
 	strcpy(gv.version,"1.0.6 [18/03/2022]");					/** MAGEMin version 																*/
+	strcpy(gv.PC_grid,"default");				/** pseudocompound grid density: coarse, default, fine (or path to a grid file)	*/
+	gv.rt_PC_grid 		= malloc(255 * sizeof(char));
+	strcpy(gv.rt_PC_grid,"fine");				/** denser pseudocompound grid of the retry ladder (--PGE_retry_grid=name) 		*/
+	gv.PC_grid_dir 		= malloc(255 * sizeof(char));
+	strcpy(gv.PC_grid_dir,"");					/** directory of the pseudocompound grids, see get_PC_grid_path 				*/
+	if (getenv("MAGEMIN_PC_GRID_DIR") != NULL){
+		snprintf(gv.PC_grid_dir, 255, "%s", getenv("MAGEMIN_PC_GRID_DIR"));
+	}
 
 	
 	gv.len_ox           = 11;					/** number of components in the system 												*/
@@ -181,6 +190,12 @@ global_variable global_variable_init(){
 	
 	/* levelling parameters */
 	gv.em2ss_shift		= 1e-5;					/** small value to shift x-eos of pure endmember from bounds after levelling 		*/
+	gv.lvl_dG_tol		= 1e-6;					/** reduced cost under which a candidate enters the levelling basis 				*/
+	gv.lvl_piv_tol		= 1e-10;				/** minimum pivot value of the levelling ratio test 								*/
+	gv.lvl_refac		= 32;					/** number of basis updates after which the basis inverse is recomputed 			*/
+	gv.lvl_max_degen	= 16;					/** consecutive degenerate pivots before switching to Bland's rule 					*/
+	gv.lvl_max_pivot	= 4096;					/** maximum number of pivots per levelling stage 									*/
+	gv.lvl_stats		= 0;					/** dump levelling counters (--lvl_stats=1) 										*/
 	gv.bnd_filter_pc    = 10.0;					/** value of driving force the pseudocompound is considered 						*/
 	gv.n_pc				= 7500;
 	gv.max_G_pc         = 5.0;					/** dG under which PC is considered after their generation		 					*/
@@ -199,10 +214,50 @@ global_variable global_variable_init(){
 	/* Partitioning Gibbs Energy */
 	gv.outter_PGE_ite   = 24;					/** minimum number of outter PGE iterations, before a solution can be accepted 		*/
 	gv.inner_PGE_ite    = 8;					/** number of inner PGE iterations, this has to be made mass or dG dependent 		*/
+	gv.inner_PGE_n		= gv.inner_PGE_ite;
+	gv.adapt_PGE		= 0;					/** adaptive PGE iteration control (--PGE_adapt=1) 									*/
+	gv.inner_PGE_min	= 2;					/** minimum number of inner PGE iterations when adapt_PGE = 1						*/
+	gv.inner_PGE_max	= 16;					/** maximum number of inner PGE iterations when adapt_PGE = 1						*/
+	gv.adapt_min_stable	= 3;					/** converged global iterations (steady Gamma and phases) to accept the solution 	*/
+	gv.adapt_max_skip	= 4;					/** a phase is minimized at least every adapt_max_skip+1 global iterations 			*/
+	gv.adapt_gam_tol	= 1e-3;					/** Gamma update norm under which Gamma is steady 									*/
+	gv.adapt_xeos_tol	= 1e-6;					/** x-eos change under which the local minimization of a phase is steady 			*/
+	gv.adapt_df_tol		= 1e-4;					/** driving force change under which the local minimization of a phase is steady 	*/
+	gv.LM_schedule		= 0;					/** selective local minimization of the on-hold phases (--LM_schedule=1) 			*/
+	gv.LM_hld_refresh	= 4;					/** distant on-hold phases are minimized every LM_hld_refresh+1 global iterations 	*/
+	gv.LM_df_near		= 10.0;					/** on-hold phases closer to the G-hyperplane (df*factor) are minimized every time 	*/
+	gv.LM_n_near		= 2;					/** the closest on-hold phases are minimized every time (--LM_near=k) 				*/
+	gv.LM_early			= 0;					/** early exit of the local minimization of the on-hold phases (--LM_early=1) 		*/
+	gv.LM_ee_hi			= 10.0;					/** on-hold phases estimated above this df*factor stay on hold (LM_early) 			*/
+	gv.LM_ee_lo			= 1.0;					/** on-hold phases below -LM_ee_lo are reintroduced (LM_early) 					*/
+	gv.LM_cache			= 0;					/** memorized local minimizations per solution phase (--LM_cache=n) 				*/
+	gv.LM_cache_tol		= 1e-10;				/** relative tolerance on the memorized inputs (--LM_cache_tol=val) 				*/
+	gv.LM_threads		= 1;					/** OpenMP threads used for the local minimizations of a point (--LM_threads=n) 		*/
+	gv.LM_pool			= 1;					/** reuse the NLopt optimizer of each solution phase (--LM_pool=0 to disable) 		*/
+	gv.LM_hess			= 0;					/** analytic Hessians in the SQP local minimizer instead of BFGS (--LM_hess=1) 		*/
+	gv.ms_n				= 6;					/** local minimizations started per phase by the solvus search (--solvus_ms_n=n) 	*/
+	gv.ms_sep			= 2.0;					/** separation of the starting pseudocompounds, in pseudocompound grid steps 		*/
+	gv.ms_time			= 200.0;				/** wall time budget of the solvus search of a point [ms] (--solvus_ms_time=ms) 		*/
+	gv.PGE_trace		= 0;					/** dump the PGE iteration history of every point (--PGE_trace=1) 					*/
+	gv.GM_on			= 0;					/** joint minimization of the assemblage near convergence (--PGE_gm=1) 				*/
+	gv.GM_br			= 1e-3;					/** BR_norm under which the joint minimization is run (--PGE_gm_br=val) 			*/
+	gv.GM_maxeval		= 256;					/** maximum number of evaluations of the joint minimization 						*/
+	gv.GM_done			= 0;
+	gv.GM_db			= NULL;
+	gv.rt_max			= 0;					/** rungs of the retry ladder tried on a failed point (--PGE_retry=n, 0 to 3)		*/
+	gv.rt_time			= 5000.0;				/** wall time budget of one rung [ms] (--PGE_retry_time=ms, 0 for no limit)			*/
+	gv.rt_deadline		= 0.0;
+	gv.rt_dP			= 0.02;					/** pressure perturbation of the third rung [kbar]									*/
+	gv.rt_dT			= 0.2;					/** temperature perturbation of the third rung [K]									*/
+	gv.rt_seed			= 0;
+	gv.rt_rung			= 0;
+	gv.rt_PC_grid_map	= NULL;
+	gv.SS_th			= NULL;
 	gv.max_n_phase  	= 0.025;				/** maximum mol% phase change during one PGE iteration in wt% 						*/
 	gv.max_g_phase  	= 2.5;					/** maximum delta_G of reference change during PGE 									*/
 	gv.max_fac          = 1.0;					/** maximum update factor during PGE under-relax < 0.0, over-relax > 0.0 	 		*/
 	gv.max_br			= 0.25;
+	gv.aa_depth			= 0;					/** Anderson mixing of the last aa_depth Gamma updates (--PGE_aa=k), 0 keeps the under-relaxed update	*/
 			
 	/* set of parameters to record the evolution of the norm of the mass constraint 												*/
 	gv.br_max_rlx       = 20.0;					/** maximum relaxing factor on mass constraint when #PGE iterations is too large	*/
@@ -238,6 +293,20 @@ global_variable global_variable_init(){
 	gv.PGE_total_norm  	= malloc (gv.ur_f * sizeof (double) 	); 
 	gv.gamma_norm  		= malloc (gv.ur_f * sizeof (double) 	); 
 	gv.ite_time  		= malloc (gv.ur_f * sizeof (double) 	); 
+	gv.trc_ev  			= malloc (n_trc_ev_max * sizeof (PGE_trc_event)	); 
+	gv.n_trc_ev 		= 0;
+
+	/* last converged solution, restart point of the retry ladder */
+	gv.rt_sol.ok 		= 0;
+	gv.rt_sol.n_cp 		= 0;
+	gv.rt_sol.gam_tot 	= malloc ((gv.len_ox) 					* sizeof (double) 	);
+	gv.rt_sol.pp_act 	= malloc ((gv.len_pp) 					* sizeof (int) 		);
+	gv.rt_sol.pp_n 		= malloc ((gv.len_pp) 					* sizeof (double) 	);
+	gv.rt_sol.cp_ss 	= malloc ((gv.len_ox) 					* sizeof (int) 		);
+	gv.rt_sol.cp_n 		= malloc ((gv.len_ox) 					* sizeof (double) 	);
+	gv.rt_sol.cp_factor = malloc ((gv.len_ox) 					* sizeof (double) 	);
+	gv.rt_sol.cp_xeos 	= malloc ((gv.len_ox*gv.len_ox) 		* sizeof (double) 	);
+	gv.rt_sol.cp_p 		= malloc ((gv.len_ox*(gv.len_ox+1)) 	* sizeof (double) 	);
 	
 	for (int i = 0; i < gv.ur_f; i++){	
 		gv.PGE_mass_norm[i] 	= 0.0;
@@ -278,6 +347,8 @@ global_variable global_variable_init(){
 	gv.SS_list 			= malloc ((gv.len_ss) * sizeof (char*)	);
 	gv.n_solvi			= malloc ((gv.len_ss) * sizeof (int) 	);
     gv.id_solvi 		= malloc ((gv.len_ss) * sizeof (int*)	);
+	gv.LM_sqp 			= malloc ((gv.len_ss) * sizeof (int) 	);
+	gv.ms_ss 			= malloc ((gv.len_ss) * sizeof (int) 	);
     
 	for (int i = 0; i < (gv.len_ss); i++){	
 		gv.id_solvi[i]   	= malloc (gv.max_n_cp  * sizeof(int));
@@ -287,9 +358,17 @@ global_variable global_variable_init(){
 		gv.verifyPC[i]      = verifyPC_tmp[i]; 
 		gv.n_SS_PC[i] 		= n_SS_PC_tmp[i]; 
 		gv.SS_PC_stp[i] 	= SS_PC_stp_tmp[i]; 
+		gv.LM_sqp[i] 		= 0;						/** NLopt for all the phases, unless selected with --LM_solver=ph1,ph2 or all */
+		gv.ms_ss[i] 		= 0;						/** no solvus search, unless selected with --solvus_ms=ph1,ph2 or all (e.g. cpx,opx,pl4T,spn) */
 		gv.SS_list[i] 		= malloc(20 * sizeof(char)		);
 		strcpy(gv.SS_list[i],SS_tmp[i]);			
 	}
+
+	/* the pseudocompound grid selected by --PC_grid is mapped once the options are read (load_PC_grid) */
+	gv.PC_xeos 			= malloc ((gv.len_ss) * sizeof (PC_ref) );
+	gv.PC_grid_map 		= NULL;
+	gv.PC_grid_size 	= 0;
+	gv.PC_reuse 		= 0;
 	
 	/* size of the flag array */
     gv.n_flags     = 6;
@@ -317,11 +396,9 @@ global_variable global_variable_init(){
 	}
 
 	/**
-		PGE Matrix and RHS
+		PGE Matrix and RHS are part of the workspace, allocated once the databases are initialized (init_PGE_workspace)
 	*/
-	/* PGE method matrix and gradient arrays */
-	gv.A_PGE = malloc ((gv.len_ox*gv.len_ox*4) 	* sizeof(double));			
-	gv.b_PGE = malloc ((gv.len_ox*gv.len_ox) 	* sizeof(double));			
+	gv.ws.block = NULL;
 
 	gv.cp_id = malloc ((gv.len_ox) 				* sizeof(int));			
 	gv.pp_id = malloc ((gv.len_ox) 				* sizeof(int));			
@@ -329,6 +406,23 @@ global_variable global_variable_init(){
 	gv.dn_cp = malloc ((gv.len_ox) 				* sizeof(double));			
 	gv.dn_pp = malloc ((gv.len_ox) 				* sizeof(double));			
 
+	/* Anderson mixing history */
+	gv.aa_x  = malloc ((gv.len_ox) 				* sizeof(double));
+	gv.aa_f  = malloc ((gv.len_ox) 				* sizeof(double));
+	gv.aa_g  = malloc ((gv.len_ox) 				* sizeof(double));
+	gv.aa_dF = malloc ((n_aa_max*gv.len_ox) 	* sizeof(double));
+	gv.aa_dG = malloc ((n_aa_max*gv.len_ox) 	* sizeof(double));
+	gv.aa_ph = calloc ((gv.len_pp + gv.max_n_cp), sizeof(int));
+	gv.aa_n  = -1;
+	gv.aa_pos = 0;
+
+	/* flattened endmember compositions: pure phases, then at most len_ox+1 endmembers per considered phase */
+	gv.em_ld = gv.len_pp + gv.max_n_cp*(gv.len_ox+1);
+	gv.em_C  = malloc ((gv.em_ld*gv.len_ox) * sizeof(double));
+	gv.em_g  = malloc ((gv.em_ld) 			* sizeof(double));
+	gv.em_x  = malloc ((gv.em_ld) 			* sizeof(double));
+	gv.n_em_rows = gv.len_pp;
+
 	/* stoechiometry matrix */
 	gv.A = malloc ((gv.len_ox) * sizeof(double*));			
     for (int i = 0; i < (gv.len_ox); i++){
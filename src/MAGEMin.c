@@ -52,6 +52,7 @@ Imported libraries
 #include "objective_functions.h"
 #include "NLopt_opt_function.h"
 #include "simplex_levelling.h"
+#include "PC_grid_function.h"
 #include "Initialize.h"
 #include "ss_min_function.h"
 #include "pp_min_function.h"
@@ -60,6 +61,8 @@ Imported libraries
 #include "phase_update_function.h"
 #include "MAGEMin.h"
 #include "simplex_levelling.h"
+#include "batch_levelling_function.h"
+#include "recovery_function.h"
 
 #define n_em_db 291
 
@@ -87,14 +90,15 @@ int runMAGEMin(int argc, char **argv){
 	int rank, numprocs;
 	int EM_database;
 	double time_taken;
+	int n_recovered = 0, n_failed = 0, n_recovered_tot = 0, n_failed_tot = 0;
 
 	Databases DB;
 	
 	/* Select the endmember database */
    	EM_database = _tc_ds634_;
    	
-	clock_t t,u; 
-	t = clock();u = clock();
+	double t,u; 
+	t = batch_wtime();u = batch_wtime();
 	
 	MPI_Comm_size(MPI_COMM_WORLD, &numprocs);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -103,9 +107,6 @@ int runMAGEMin(int argc, char **argv){
 	global_variable gv;
 	gv = global_variable_init();
 
-	/* Allocate both pure and solid-solution databases */
-	DB = InitializeDatabases(gv, EM_database);
-	
 	/** Declare bulk info structure */
 	struct bulk_info z_b;
 
@@ -121,41 +122,76 @@ int runMAGEMin(int argc, char **argv){
 	/** 
 	Read command-line arguments and set default parameters
 	*/
-	gv = ReadCommandLineOptions(	 gv,
-									 argc, 
-									 argv,  
-									&Mode, 
-									&Verb, 
-									&test, 
-									&n_points, 
-									&Pres, 
-									&Temp,
-									 Bulk, 
-									 Gam, 
-									 gv.init_prop, 
-									 File, 
-									 Phase, 
-									&n_pc, 
-									&maxeval,
-									&get_version			); 
+	ReadCommandLineOptions(	&gv,
+							 argc, 
+							 argv,  
+							&Mode, 
+							&Verb, 
+							&test, 
+							&n_points, 
+							&Pres, 
+							&Temp,
+							 Bulk, 
+							 Gam, 
+							 gv.init_prop, 
+							 File, 
+							 Phase, 
+							&n_pc, 
+							&maxeval,
+							&get_version			); 
 									
 	if ( Verb == 0){
 		gv.verbose = Verb;
 	}
 	gv.Mode = Mode;
 
+	/* map the pseudocompound grid (updates n_SS_PC and SS_PC_stp with the values stored in the grid file) */
+	load_PC_grid(&gv);
+
+	/* map the denser pseudocompound grid of the retry ladder */
+	load_retry_PC_grid(&gv);
+
+	/* Allocate both pure and solid-solution databases */
+	DB = InitializeDatabases(&gv, EM_database);
+
+	/* memo tables of the local minimizations, shared by the scratch copies */
+	init_LM_cache(&gv, DB.SS_ref_db);
+
+	/* scratch copies of the solution phases for the threaded local minimizations */
+	init_LM_threads(&gv, DB.SS_ref_db);
+
+	/* scratch arrays of the PGE iterations, levelling and global minimization */
+	init_PGE_workspace(&gv, DB.SS_ref_db);
+
     if (maxeval>-1){
         gv.maxeval = maxeval;   // otherwise we use default. Note that 0=no limit
     }
 
 	/* initial dumping logs and output */
-	dump_init(gv);
+	dump_init(&gv);
 
 	if (rank==0 && gv.verbose != 2){
     	printf("Running MAGEMin %5s on %d cores {\n", gv.version, numprocs);
     	printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
 	}
 
+	/****************************************************************************************/
+	/**            BATCH LEVELLING (MODE 4), P-T-BULK POINTS ARE READ FROM FILE            **/
+	/****************************************************************************************/
+	if (Mode == 4){
+		run_batch_levelling(	EM_database,
+								File,
+								n_points,
+								&gv,
+								DB				);
+
+		if (gv.lvl_stats == 1){
+			mergeParallel_LevellingStats_Files(&gv);
+		}
+		FreeDatabases(&gv, DB);
+		return 0;
+	}
+
 	/****************************************************************************************/
 	/**              READ INPUT FILE FOR MULTIPLE P-T CONDITIONS, IF IT EXISTS             **/
 	/****************************************************************************************/
@@ -164,7 +200,7 @@ int runMAGEMin(int argc, char **argv){
 
 	/* get data from input file */
 	if (strcmp( File, "none") != 0){	
-		read_in_data(gv, input_data, File, n_points);			
+		read_in_data(&gv, input_data, File, n_points);			
 	}
 	
 	/****************************************************************************************/
@@ -198,7 +234,7 @@ int runMAGEMin(int argc, char **argv){
 	for (int sgleP = 0; sgleP < n_points; sgleP++){
         if ((Mode==0) && (sgleP % numprocs != rank)) continue;   /** this ensures that, in parallel, not every point is computed by every processor (instead only every numprocs point). Only applied to Mode==0 */
 
-		t              = clock();							/** reset loop timer 				*/
+		t              = batch_wtime();						/** reset loop timer 				*/
 		gv.BR_norm     = 1.0; 								/** reset bulk rock norm 			*/
 		gv.global_ite  = 0;              					/** reset global iteration 			*/
 		gv.numPoint    = sgleP; 								/** the number of the current point */
@@ -214,48 +250,77 @@ int runMAGEMin(int argc, char **argv){
 		}
 		
 		/* reset all flags for pure phases and solution phases */
-		gv = reset_global_variables(		gv,
-											DB.PP_ref_db,									/** pure phase database 			*/
-											DB.SS_ref_db,									/** solid solution database 		*/
-											DB.cp						);
+		reset_global_variables(		&gv,
+									DB.PP_ref_db,									/** pure phase database 			*/
+									DB.SS_ref_db,									/** solid solution database 		*/
+									DB.cp						);
 		
 		
-		gv = reset_phases(					gv,												/** reset solution phase database 	*/
-											z_b,
-											DB.PP_ref_db,
-											DB.SS_ref_db,
-											DB.cp						);	
+		reset_phases(					&gv,												/** reset solution phase database 	*/
+										z_b,
+										DB.PP_ref_db,
+										DB.SS_ref_db,
+										DB.cp						);	
 		
 		/* Perform calculation for a single point */	
-		gv = ComputeEquilibrium_Point(		EM_database, 
-											input_data[sgleP],
-											Mode,
-											z_b,											/** bulk rock informations */
-											gv,												/** global variables (e.g. Gamma) */
-											DB.PP_ref_db,									/** pure phase database */
-											DB.SS_ref_db,									/** solid solution database */
-											DB.cp							);
+		ComputeEquilibrium_Point(		EM_database, 
+										input_data[sgleP],
+										Mode,
+										z_b,											/** bulk rock informations */
+										&gv,												/** global variables (e.g. Gamma) */
+										DB.PP_ref_db,									/** pure phase database */
+										DB.SS_ref_db,									/** solid solution database */
+										DB.cp							);
+
+		/* Retry the point if it failed, and keep the solution as restart point of the next failed points */
+		if (Mode == 0 && gv.rt_max > 0){
+			run_retry_ladder(			EM_database,
+										input_data[sgleP],
+										z_b,
+										&gv,
+										DB							);
+
+			if 		(gv.rt_rung > 0){ n_recovered += 1; }
+			else if (gv.rt_rung < 0){ n_failed    += 1; }
+
+			save_retry_solution(		z_b,
+										&gv,
+										DB.cp						);
+		}
+
+		/* Dump levelling counters */
+		if (gv.lvl_stats == 1 && (Mode == 0 || Mode == 3)){
+			dump_levelling_stats(			&gv,
+											z_b,
+											DB.SS_ref_db				);
+		}
 
+		/* Dump PGE iteration history */
+		if (gv.PGE_trace == 1 && Mode == 0){
+			dump_PGE_trace(					&gv,
+											z_b,
+											DB.cp						);
+		}
 
 		/* Perform calculation for a single point */	
 		ComputePostProcessing(				EM_database,
 											z_b,											/** bulk rock informations */
-											gv,												/** global variables (e.g. Gamma) */
+											&gv,												/** global variables (e.g. Gamma) */
 											DB.PP_ref_db,									/** pure phase database */
 											DB.SS_ref_db,									/** solid solution database */
 											DB.cp						);
 					
 		/* Dump final results to files */
-		dump_results_function(				gv,												/** global variables (e.g. Gamma) */
+		dump_results_function(				&gv,												/** global variables (e.g. Gamma) */
 											z_b,											/** bulk-rock informations */
 											DB.PP_ref_db,									/** pure phase database */
 											DB.SS_ref_db,									/** solution phase database */
 											DB.cp						);
 
 		/* Print output to screen */
-		t = clock() - t; 
-		time_taken = ((double)t)/CLOCKS_PER_SEC; 				/** in seconds  */
-		PrintOutput(gv, rank, sgleP, DB, time_taken, z_b);	/** print output on screen **/
+		t = batch_wtime() - t; 
+		time_taken = t; 										/** in seconds  */
+		PrintOutput(&gv, rank, sgleP, DB, time_taken, z_b);	/** print output on screen **/
 										
 		printf("Point   \t  %i\n",sgleP);														/** repeted here to be able to track it in the GUI */
 	}
@@ -265,16 +330,29 @@ int runMAGEMin(int argc, char **argv){
 	MPI_Barrier(MPI_COMM_WORLD);		
 
 	/* now merge the parallel output files into one*/
-	mergeParallelFiles(gv);
+	mergeParallelFiles(&gv);
+	if (gv.lvl_stats == 1){
+		mergeParallel_LevellingStats_Files(&gv);
+	}
+	if (gv.PGE_trace == 1 && Mode == 0){
+		mergeParallel_PGE_trace_Files(&gv);
+	}
+	if (gv.rt_max > 0 && Mode == 0){
+		MPI_Reduce(&n_recovered, &n_recovered_tot, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+		MPI_Reduce(&n_failed,    &n_failed_tot,    1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+		if (rank == 0 && gv.verbose != 2){
+			printf("\nRetry ladder  : %i point(s) recovered, %i point(s) still failed\n", n_recovered_tot, n_failed_tot);
+		}
+	}
 
 	/* free memory allocated to solution and pure phases */
-	FreeDatabases(gv, DB);
+	FreeDatabases(&gv, DB);
 
 	/* print the time */
-	u = clock() - u; 
+	u = batch_wtime() - u; 
 	
 	if (gv.verbose != 2){
-		time_taken = ((double)u)/(CLOCKS_PER_SEC); 				/** in seconds */
+		time_taken = u; 										/** in seconds */
 		if (rank==0){
 			printf("__________________________________\n");
 			printf("MAGEMin comp time: %+3f ms }\n", time_taken*1000.);
@@ -288,7 +366,7 @@ int runMAGEMin(int argc, char **argv){
 */
 	void ComputePostProcessing(			int 				EM_database,
 										struct bulk_info 	z_b,
-										global_variable 	gv,
+										global_variable 	*gv,
 										PP_ref  			*PP_ref_db,
 										SS_ref  			*SS_ref_db,
 										csd_phase_set  		*cp					){
@@ -303,11 +381,11 @@ int runMAGEMin(int argc, char **argv){
 	double sum_volume     = 0.0;
 	double dGdTPP, dGdTMP, dG2dT2, dGdP, dG2dP2;
 
-	double density	[gv.len_ox];
+	double density	[gv->len_ox];
 
 	int ss;
 	/** calculate mass, volume and densities */
-	for (int i = 0; i < gv.len_cp; i++){
+	for (int i = 0; i < gv->len_cp; i++){
 		if (cp[i].ss_flags[1] == 1){
 
 			ss = cp[i].id;	
@@ -319,17 +397,17 @@ int runMAGEMin(int argc, char **argv){
 			/* Associate the right solid-solution data */
 			for (int FD = 0; FD < 7; FD++){
 
-				z_b.P 		= P + gv.gb_P_eps*gv.numDiff[0][FD];
-				z_b.T 		= T + gv.gb_T_eps*gv.numDiff[1][FD];
+				z_b.P 		= P + gv->gb_P_eps*gv->numDiff[0][FD];
+				z_b.T 		= T + gv->gb_T_eps*gv->numDiff[1][FD];
 						
-				SS_ref_db[ss] = raw_hyperplane(		gv, 
-													SS_ref_db[ss],
-													SS_ref_db[ss].mu_array[FD]	);
+				raw_hyperplane(		gv, 
+									&SS_ref_db[ss],
+									SS_ref_db[ss].mu_array[FD]	);
 				
-				SS_ref_db[ss] = PC_function(		gv,
-													SS_ref_db[ss], 
-													z_b,
-													gv.SS_list[ss] 				);
+				PC_function(		gv,
+									&SS_ref_db[ss], 
+									z_b,
+									gv->SS_list[ss] 				);
 													
 				for (int j = 0; j < SS_ref_db[ss].n_em; j++){ 
 					SS_ref_db[ss].mu_array[FD][j] = SS_ref_db[ss].mu[j];
@@ -338,7 +416,7 @@ int runMAGEMin(int argc, char **argv){
 													
 			/** calculate Molar Mass of solution phase */
 			cp[i].mass = 0.0;
-			for (int k = 0; k < gv.len_ox; k++){
+			for (int k = 0; k < gv->len_ox; k++){
 				cp[i].mass	+= cp[i].ss_comp[k]*z_b.masspo[k];
 			}
 
@@ -350,11 +428,11 @@ int runMAGEMin(int argc, char **argv){
 
 			for (int j = 0; j < cp[i].n_em; j++){ 
 				if (cp[i].z_em[j] == 1.0){
-					dG2dT2 					 = (SS_ref_db[ss].mu_array[0][j]-2.0*SS_ref_db[ss].mu_array[6][j]+SS_ref_db[ss].mu_array[1][j])/(gv.gb_T_eps*gv.gb_T_eps);
-					dG2dP2 					 = (SS_ref_db[ss].mu_array[4][j]-2.0*SS_ref_db[ss].mu_array[5][j]+SS_ref_db[ss].mu_array[6][j])/(gv.gb_P_eps*gv.gb_P_eps);
-					dGdTPP 					 = (SS_ref_db[ss].mu_array[2][j]-SS_ref_db[ss].mu_array[3][j])/(2.0*gv.gb_T_eps);
-					dGdTMP 					 = (SS_ref_db[ss].mu_array[0][j]-SS_ref_db[ss].mu_array[1][j])/(2.0*gv.gb_T_eps);
-					dGdP					 = (SS_ref_db[ss].mu_array[5][j]-SS_ref_db[ss].mu_array[6][j])/(gv.gb_P_eps);
+					dG2dT2 					 = (SS_ref_db[ss].mu_array[0][j]-2.0*SS_ref_db[ss].mu_array[6][j]+SS_ref_db[ss].mu_array[1][j])/(gv->gb_T_eps*gv->gb_T_eps);
+					dG2dP2 					 = (SS_ref_db[ss].mu_array[4][j]-2.0*SS_ref_db[ss].mu_array[5][j]+SS_ref_db[ss].mu_array[6][j])/(gv->gb_P_eps*gv->gb_P_eps);
+					dGdTPP 					 = (SS_ref_db[ss].mu_array[2][j]-SS_ref_db[ss].mu_array[3][j])/(2.0*gv->gb_T_eps);
+					dGdTMP 					 = (SS_ref_db[ss].mu_array[0][j]-SS_ref_db[ss].mu_array[1][j])/(2.0*gv->gb_T_eps);
+					dGdP					 = (SS_ref_db[ss].mu_array[5][j]-SS_ref_db[ss].mu_array[6][j])/(gv->gb_P_eps);
 					
 					/* heat capacity 	*/
 					cp[i].phase_cp    		+= -T*(dG2dT2)*cp[i].p_em[j];
@@ -363,10 +441,10 @@ int runMAGEMin(int argc, char **argv){
 					cp[i].volume    		+= (dGdP)*cp[i].p_em[j];
 					
 					/* expansivity 		*/
-					cp[i].phase_expansivity += (1.0/(dGdP)*((dGdTPP-dGdTMP)/(gv.gb_P_eps)))*cp[i].p_em[j];
+					cp[i].phase_expansivity += (1.0/(dGdP)*((dGdTPP-dGdTMP)/(gv->gb_P_eps)))*cp[i].p_em[j];
 					
 					/* shear modulus	*/
-					cp[i].phase_shearModulus+= -dGdP/( dG2dP2 - pow(((dGdTPP-dGdTMP)/(gv.gb_P_eps)),2.0)/dG2dT2 );
+					cp[i].phase_shearModulus+= -dGdP/( dG2dP2 - pow(((dGdTPP-dGdTMP)/(gv->gb_P_eps)),2.0)/dG2dT2 );
 				}
 			}	
 			
@@ -378,27 +456,27 @@ int runMAGEMin(int argc, char **argv){
 		}
 	}
 
-	for (int i = 0; i < gv.len_pp; i++){
+	for (int i = 0; i < gv->len_pp; i++){
 
 		/* if pure phase is active or on hold (PP cannot be removed from consideration */
-		if (gv.pp_flags[i][1] == 1){
+		if (gv->pp_flags[i][1] == 1){
 
 			/* calculate phase volume as V = dG/dP */
-			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P, z_b.T, gv.PP_list[i], "equilibrium");
+			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P, z_b.T, gv->PP_list[i], "equilibrium");
 			muC	 	 	 = PP_db.gbase;
-			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P + gv.gb_P_eps, z_b.T, gv.PP_list[i], "equilibrium");
+			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P + gv->gb_P_eps, z_b.T, gv->PP_list[i], "equilibrium");
 			muN 	 	 = PP_db.gbase;
-			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P + gv.gb_P_eps*2.0, z_b.T, gv.PP_list[i], "equilibrium");
+			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P + gv->gb_P_eps*2.0, z_b.T, gv->PP_list[i], "equilibrium");
 			muNN 	 	 = PP_db.gbase;
 		
-			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P, z_b.T + gv.gb_T_eps, gv.PP_list[i], "equilibrium");
+			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P, z_b.T + gv->gb_T_eps, gv->PP_list[i], "equilibrium");
 			muE	 		 = PP_db.gbase;
-			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P, z_b.T - gv.gb_T_eps, gv.PP_list[i], "equilibrium");			
+			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P, z_b.T - gv->gb_T_eps, gv->PP_list[i], "equilibrium");			
 			muW	 		 = PP_db.gbase;
 
-			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P + gv.gb_P_eps, z_b.T + gv.gb_T_eps, gv.PP_list[i], "equilibrium");
+			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P + gv->gb_P_eps, z_b.T + gv->gb_T_eps, gv->PP_list[i], "equilibrium");
 			muNE	 	 = PP_db.gbase;
-			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P + gv.gb_P_eps, z_b.T - gv.gb_T_eps, gv.PP_list[i], "equilibrium");			
+			PP_db    	 = G_EM_function(EM_database, z_b.bulk_rock, z_b.P + gv->gb_P_eps, z_b.T - gv->gb_T_eps, gv->PP_list[i], "equilibrium");			
 			muNW	 	 = PP_db.gbase;
 
 
@@ -409,11 +487,11 @@ int runMAGEMin(int argc, char **argv){
 				PP_ref_db[i].mass += PP_ref_db[i].Comp[j]*z_b.masspo[j];
 			}
 
-			dG2dT2 					 = (muE-2.0*muC+muW)/(gv.gb_T_eps*gv.gb_T_eps);
-			dG2dP2 					 = (muNN-2.0*muN+muC)/(gv.gb_P_eps*gv.gb_P_eps);
-			dGdTPP 					 = (muNE-muNW)/(2.0*gv.gb_T_eps);
-			dGdTMP 					 = (muE-muW)/(2.0*gv.gb_T_eps);
-			dGdP					 = (muN-muC)/(gv.gb_P_eps);
+			dG2dT2 					 = (muE-2.0*muC+muW)/(gv->gb_T_eps*gv->gb_T_eps);
+			dG2dP2 					 = (muNN-2.0*muN+muC)/(gv->gb_P_eps*gv->gb_P_eps);
+			dGdTPP 					 = (muNE-muNW)/(2.0*gv->gb_T_eps);
+			dGdTMP 					 = (muE-muW)/(2.0*gv->gb_T_eps);
+			dGdP					 = (muN-muC)/(gv->gb_P_eps);
 
 			/* Calculate volume  per pure phase */
 			PP_ref_db[i].volume  	   = dGdP; 
@@ -425,55 +503,55 @@ int runMAGEMin(int argc, char **argv){
 			PP_ref_db[i].phase_cp = -T*(dG2dT2);
 			
 			/* expansivity 		*/
-			PP_ref_db[i].phase_expansivity = 1.0/(dGdP)*((dGdTPP-dGdTMP)/(gv.gb_P_eps));
+			PP_ref_db[i].phase_expansivity = 1.0/(dGdP)*((dGdTPP-dGdTMP)/(gv->gb_P_eps));
 			
 			/* shear modulus	*/
-			PP_ref_db[i].phase_shearModulus= -dGdP/( dG2dP2 - pow(((dGdTPP-dGdTMP)/(gv.gb_P_eps)),2.0)/dG2dT2 );
+			PP_ref_db[i].phase_shearModulus= -dGdP/( dG2dP2 - pow(((dGdTPP-dGdTMP)/(gv->gb_P_eps)),2.0)/dG2dT2 );
 	
 			
 			/** get sum of volume*fraction*factor to calculate vol% from mol% */
-			sum_volume += PP_ref_db[i].volume*gv.pp_n[i]*PP_ref_db[i].factor;
+			sum_volume += PP_ref_db[i].volume*gv->pp_n[i]*PP_ref_db[i].factor;
 		}
 	}
 
 	/* calculate density of the system */
-	for (int i = 0; i < gv.len_cp; i++){
+	for (int i = 0; i < gv->len_cp; i++){
 		if (cp[i].ss_flags[1] == 1){
 			system_density += cp[i].phase_density*((cp[i].volume*cp[i].ss_n*cp[i].factor)/sum_volume);
 		}
 	}
 	
-	for (int i = 0; i < gv.len_pp; i++){
-		if (gv.pp_flags[i][1] == 1){
-			system_density += PP_ref_db[i].phase_density*((PP_ref_db[i].volume*gv.pp_n[i]*PP_ref_db[i].factor)/sum_volume);
+	for (int i = 0; i < gv->len_pp; i++){
+		if (gv->pp_flags[i][1] == 1){
+			system_density += PP_ref_db[i].phase_density*((PP_ref_db[i].volume*gv->pp_n[i]*PP_ref_db[i].factor)/sum_volume);
 		}
 	}
-	printf("\nVOL_SYS \t %+10f\nRHO_SYS  \t  %+10f\nMASS_RES \t %+10f\n",sum_volume,system_density,gv.BR_norm);	
+	printf("\nVOL_SYS \t %+10f\nRHO_SYS  \t  %+10f\nMASS_RES \t %+10f\n",sum_volume,system_density,gv->BR_norm);	
 }
 
 /** 
   Compute stable equilibrium at given P/T/C point
 */
-global_variable ComputeEquilibrium_Point( 		int 				 EM_database,
-												io_data 			 input_data,
-												int 				 Mode,
-												struct bulk_info 	 z_b,
-												global_variable 	 gv,
-												PP_ref  			*PP_ref_db,
-												SS_ref  			*SS_ref_db,
-												csd_phase_set  		*cp						){
+void ComputeEquilibrium_Point( 		int 				 EM_database,
+									io_data 			 input_data,
+									int 				 Mode,
+									struct bulk_info 	 z_b,
+									global_variable 	*gv,
+									PP_ref  			*PP_ref_db,
+									SS_ref  			*SS_ref_db,
+									csd_phase_set  		*cp						){
 
 	/* initialize endmember database for given P-T point */
-	gv = init_em_db(		EM_database,
-							z_b,										/** bulk rock informations */
-							gv,											/** global variables (e.g. Gamma) */
-							PP_ref_db				);
+	init_em_db(		EM_database,
+					z_b,										/** bulk rock informations */
+					gv,											/** global variables (e.g. Gamma) */
+					PP_ref_db				);
 
 	/* Calculate solution phase data at given P-T conditions (G0 based on G0 of endmembers) */
-	gv = init_ss_db(		EM_database,
-							z_b,
-							gv,
-							SS_ref_db						);
+	init_ss_db(		EM_database,
+					z_b,
+					gv,
+					SS_ref_db						);
 
 
 	/* if Mode is 0, perform normal minimization with PGE */
@@ -481,22 +559,31 @@ global_variable ComputeEquilibrium_Point( 		int 				 EM_database,
 		/****************************************************************************************/
 		/**                                   LEVELLING                                        **/
 		/****************************************************************************************/	
-		gv = Levelling(			z_b,									/** bulk rock informations */
-								gv,										/** global variables (e.g. Gamma) */
+		Levelling(			z_b,									/** bulk rock informations */
+							gv,										/** global variables (e.g. Gamma) */
 								
-								PP_ref_db,								/** pure phase database */
-								SS_ref_db,								/** solution phase database */
-								cp					);
+							PP_ref_db,								/** pure phase database */
+							SS_ref_db,								/** solution phase database */
+							cp					);
+
+		/* retry ladder: restart from the last converged solution instead of the levelled assemblage */
+		if (gv->rt_seed == 1){
+			seed_retry_solution(	z_b,
+									gv,
+									PP_ref_db,
+									SS_ref_db,
+									cp			);
+		}
 		
 		/****************************************************************************************/
 		/**                                   MAIN LOOP (PGE)                                  **/
 		/****************************************************************************************/
-		gv = PGE(				z_b,									/** bulk rock constraint */ 
-								gv,										/** global variables (e.g. Gamma) */
+		PGE(				z_b,									/** bulk rock constraint */ 
+							gv,										/** global variables (e.g. Gamma) */
 								
-								PP_ref_db,								/** pure phase database */
-								SS_ref_db,								/** solution phase database */
-								cp					);
+							PP_ref_db,								/** pure phase database */
+							SS_ref_db,								/** solution phase database */
+							cp					);
 
 	}
 	/* if Mode = 1, spit out Gibbs energy and reference values with given compositional variables */
@@ -513,16 +600,16 @@ global_variable ComputeEquilibrium_Point( 		int 				 EM_database,
 			for (int j = 0; j < SS_ref_db[ss].n_xeos; j++){
 				SS_ref_db[ss].iguess[j] =  input_data.phase_xeos[i][j];
 			}
-			SS_ref_db[ss] = raw_hyperplane(		gv, 
-												SS_ref_db[ss],
-												SS_ref_db[ss].gbase		);
+			raw_hyperplane(		gv, 
+								&SS_ref_db[ss],
+								SS_ref_db[ss].gbase		);
 			
-			SS_ref_db[ss] = PC_function(	gv,
-											SS_ref_db[ss], 
-											z_b,
-											gv.SS_list[ss] 				);
+			PC_function(	gv,
+							&SS_ref_db[ss], 
+							z_b,
+							gv->SS_list[ss] 				);
 											
-			strcpy(cp[id_cp].name,gv.SS_list[ss]);				/* get phase name */	
+			strcpy(cp[id_cp].name,gv->SS_list[ss]);				/* get phase name */	
 			
 			cp[id_cp].split 		= 0;							
 			cp[id_cp].id 			= ss;						/* get phase id */
@@ -557,22 +644,22 @@ global_variable ComputeEquilibrium_Point( 		int 				 EM_database,
 					cp[id_cp].dpdx[ii][jj] = SS_ref_db[ss].dp_dx[ii][jj];
 				}
 			}
-			for (int ii = 0; ii < gv.len_ox; ii++){
+			for (int ii = 0; ii < gv->len_ox; ii++){
 				cp[id_cp].ss_comp[ii]	= SS_ref_db[ss].ss_comp[ii];
 			}
 			for (int ii = 0; ii < cp[id_cp].n_sf; ii++){
 				cp[id_cp].sf[ii]		= SS_ref_db[ss].sf[ii];
 			}	
 			
-			gv.id_solvi[ss][gv.n_solvi[ss]] = id_cp;
-			gv.n_solvi[ss] 	   	   += 1;
+			gv->id_solvi[ss][gv->n_solvi[ss]] = id_cp;
+			gv->n_solvi[ss] 	   	   += 1;
 			id_cp 				   += 1;
-			gv.len_cp 			   += 1;
-			gv.n_cp_phase 		   += 1;
-			gv.n_phase             += 1;
+			gv->len_cp 			   += 1;
+			gv->n_cp_phase 		   += 1;
+			gv->n_phase             += 1;
 		
-			if (gv.verbose ==1){
-				printf("   -> reading in %4s %+10f|",gv.SS_list[ss],SS_ref_db[ss].df);
+			if (gv->verbose ==1){
+				printf("   -> reading in %4s %+10f|",gv->SS_list[ss],SS_ref_db[ss].df);
 				for (int j = 0; j < SS_ref_db[ss].n_xeos; j++){
 					printf(" %+12.5f", input_data.phase_xeos[i][j]);
 				}
@@ -588,38 +675,36 @@ global_variable ComputeEquilibrium_Point( 		int 				 EM_database,
 	/* if Mode = 3, perform first stage levelling only */
 	else if (Mode == 3){
 		/* when Mode = 3, only first stage of levelling is activated */
-		gv = Levelling(			z_b,									/** bulk rock informations */
-								gv,										/** global variables (e.g. Gamma) */
+		Levelling(			z_b,									/** bulk rock informations */
+							gv,										/** global variables (e.g. Gamma) */
 								
-								PP_ref_db,								/** pure phase database */
-								SS_ref_db,								/** solution phase database */
-								cp						);
+							PP_ref_db,								/** pure phase database */
+							SS_ref_db,								/** solution phase database */
+							cp						);
 		}
-	
-	return gv;
 }
 
 /** 
   Get command line options
 */
-global_variable ReadCommandLineOptions(	global_variable 	 gv,		
-
-									int argc, 
-									char ** argv, 	
-									int *Mode_out, 
-									int *Verb_out, 
-									int *test_out, 
-									int *n_points_out, 
-									double *P, 
-									double *T, 
-									double Bulk[11], 
-									double Gam[11], 
-									double InitEM_Prop[15],
-									char File[50], 
-									char Phase[50], 
-									int *n_pc_out, 
-									int *maxeval_out,
-									int *get_version_out			
+void ReadCommandLineOptions(	global_variable 	*gv,		
+
+							int argc, 
+							char ** argv, 	
+							int *Mode_out, 
+							int *Verb_out, 
+							int *test_out, 
+							int *n_points_out, 
+							double *P, 
+							double *T, 
+							double Bulk[11], 
+							double Gam[11], 
+							double InitEM_Prop[15],
+							char File[50], 
+							char Phase[50], 
+							int *n_pc_out, 
+							int *maxeval_out,
+							int *get_version_out			
 ){
 	int i;
 	static ko_longopt_t longopts[] = {
@@ -637,6 +722,29 @@ global_variable ReadCommandLineOptions(	global_variable 	 gv,
         { "InitEM_Prop",ko_optional_argument, 312 },
         { "maxeval",    ko_optional_argument, 313 },
         { "version",    ko_optional_argument, 314 },
+        { "PC_grid",    ko_optional_argument, 315 },
+        { "lvl_stats",  ko_optional_argument, 316 },
+        { "PGE_aa",     ko_optional_argument, 317 },
+        { "PGE_adapt",  ko_optional_argument, 318 },
+        { "LM_schedule",ko_optional_argument, 319 },
+        { "LM_threads", ko_optional_argument, 320 },
+        { "PGE_trace",  ko_optional_argument, 321 },
+        { "PGE_retry",  ko_optional_argument, 322 },
+        { "PGE_retry_time", ko_optional_argument, 323 },
+        { "PGE_retry_grid", ko_optional_argument, 324 },
+        { "LM_pool",    ko_optional_argument, 325 },
+        { "LM_solver",  ko_optional_argument, 326 },
+        { "LM_hess",    ko_optional_argument, 327 },
+        { "solvus_ms",  ko_optional_argument, 328 },
+        { "solvus_ms_n",ko_optional_argument, 329 },
+        { "solvus_ms_time", ko_optional_argument, 330 },
+        { "LM_early",   ko_optional_argument, 331 },
+        { "PGE_gm",     ko_optional_argument, 332 },
+        { "PGE_gm_br",  ko_optional_argument, 333 },
+        { "LM_cache",   ko_optional_argument, 334 },
+        { "LM_cache_tol", ko_optional_argument, 335 },
+        { "PC_grid_dir", ko_optional_argument, 336 },
+        { "LM_near",    ko_optional_argument, 337 },
     	{ NULL, 0, 0 }
 	};
 	ketopt_t opt = KETOPT_INIT;
@@ -664,7 +772,7 @@ global_variable ReadCommandLineOptions(	global_variable 	 gv,
 	strcpy(File,"none"); // Filename to be read to have multiple P-T-bulk conditions to solve
 
 	while ((c = ketopt(&opt, argc, argv, 1, "", longopts)) >= 0) {
-		if 		(c == 314){ printf("MAGEMin %20s\n",gv.version ); exit(0); }	
+		if 		(c == 314){ printf("MAGEMin %20s\n",gv->version ); exit(0); }	
         else if	(c == 301){ Verb     = atoi(opt.arg	);}
 		else if (c == 302){ Mode     = atoi(opt.arg);			if (Verb == 1){		printf("--Mode        : Mode                     = %i \n", 	 	   		Mode		);}}																		
 		else if (c == 303){ strcpy(File,opt.arg);		 		if (Verb == 1){		printf("--File        : File                     = %s \n", 	 	   		File		);}}
@@ -674,6 +782,67 @@ global_variable ReadCommandLineOptions(	global_variable 	 gv,
 		else if (c == 307){ Pres     = strtof(opt.arg,NULL); 	if (Verb == 1){		printf("--Pres        : Pressure                 = %f kbar \n", 			Pres		);}}
 		else if (c == 308){ strcpy(Phase,opt.arg);		 		if (Verb == 1){		printf("--Phase       : Phase name               = %s \n", 	   			Phase		);}}
 		else if (c == 309){ n_pc     = strtof(opt.arg,NULL); 	if (Verb == 1){		printf("--n_pc        : Number of pc             = %i  \n", 				n_pc		);}}
+		else if (c == 315){ strcpy(gv->PC_grid,opt.arg);	 		if (Verb == 1){		printf("--PC_grid     : Pseudocompound grid      = %s \n", 	   			gv->PC_grid	);}}
+		else if (c == 336){ snprintf(gv->PC_grid_dir,255,"%s",opt.arg);	if (Verb == 1){		printf("--PC_grid_dir : Pseudocompound grid dir  = %s \n", 	   			gv->PC_grid_dir);}}
+		else if (c == 316){ gv->lvl_stats = atoi(opt.arg);	 	if (Verb == 1){		printf("--lvl_stats   : Levelling counters       = %i \n", 	   			gv->lvl_stats);}}
+		else if (c == 317){ gv->aa_depth  = atoi(opt.arg);
+			if (gv->aa_depth > n_aa_max){ gv->aa_depth = n_aa_max; }
+			if (gv->aa_depth < 0)	   { gv->aa_depth = 0; 		 }
+			if (Verb == 1){		printf("--PGE_aa      : Anderson mixing depth    = %i \n", 	   			gv->aa_depth);}
+		}
+		else if (c == 318){ gv->adapt_PGE = atoi(opt.arg);	 	if (Verb == 1){		printf("--PGE_adapt   : Adaptive PGE iterations  = %i \n", 	   			gv->adapt_PGE);}}
+		else if (c == 319){ gv->LM_schedule = atoi(opt.arg);	 	if (Verb == 1){		printf("--LM_schedule : Selective local min.     = %i \n", 	   			gv->LM_schedule);}}
+		else if (c == 337){ gv->LM_n_near = atoi(opt.arg);	 	if (Verb == 1){		printf("--LM_near     : Closest on-hold LM       = %i \n", 	   			gv->LM_n_near);}}
+		else if (c == 320){ gv->LM_threads  = atoi(opt.arg);
+			if (gv->LM_threads < 1){ gv->LM_threads = 1; }
+			if (Verb == 1){		printf("--LM_threads  : Local min. threads       = %i \n", 	   			gv->LM_threads);}
+		}
+		else if (c == 321){ gv->PGE_trace = atoi(opt.arg);	 	if (Verb == 1){		printf("--PGE_trace   : PGE convergence trace    = %i \n", 	   			gv->PGE_trace);}}
+		else if (c == 322){ gv->rt_max    = atoi(opt.arg);
+			if (gv->rt_max < 0){ gv->rt_max = 0; }
+			if (gv->rt_max > 3){ gv->rt_max = 3; }
+			if (Verb == 1){		printf("--PGE_retry   : Retry ladder rungs       = %i \n", 	   			gv->rt_max);}
+		}
+		else if (c == 323){ gv->rt_time   = strtod(opt.arg,NULL);	if (Verb == 1){		printf("--PGE_retry_time : Rung time budget [ms] = %.1f \n", 	   		gv->rt_time);}}
+		else if (c == 325){ gv->LM_pool   = atoi(opt.arg);	 	if (Verb == 1){		printf("--LM_pool     : Reuse NLopt optimizers   = %i \n", 	   			gv->LM_pool);}}
+		else if (c == 326){
+			if (Verb == 1){		printf("--LM_solver   : In-house SQP phases      = %s \n", 	   			opt.arg);}
+			for (int i = 0; i < gv->len_ss; i++){
+				gv->LM_sqp[i] = (strcmp(opt.arg, "all") == 0) ? 1 : 0;
+			}
+			char *p = strtok(opt.arg,",");
+			while (p){
+				for (int i = 0; i < gv->len_ss; i++){
+					if (strcmp(gv->SS_list[i], p) == 0){ gv->LM_sqp[i] = 1; }
+				}
+				p = strtok(NULL, ",");
+			}
+		}
+		else if (c == 327){ gv->LM_hess   = atoi(opt.arg);	 	if (Verb == 1){		printf("--LM_hess     : SQP analytic Hessians    = %i \n", 	   			gv->LM_hess);}}
+		else if (c == 328){
+			if (Verb == 1){		printf("--solvus_ms   : Solvus search phases     = %s \n", 	   			opt.arg);}
+			for (int i = 0; i < gv->len_ss; i++){
+				gv->ms_ss[i] = (strcmp(opt.arg, "all") == 0) ? 1 : 0;
+			}
+			char *p = strtok(opt.arg,",");
+			while (p){
+				for (int i = 0; i < gv->len_ss; i++){
+					if (strcmp(gv->SS_list[i], p) == 0){ gv->ms_ss[i] = 1; }
+				}
+				p = strtok(NULL, ",");
+			}
+		}
+		else if (c == 329){ gv->ms_n      = atoi(opt.arg);
+			if (gv->ms_n < 1){ gv->ms_n = 1; }
+			if (Verb == 1){		printf("--solvus_ms_n : Solvus search starts     = %i \n", 	   			gv->ms_n);}
+		}
+		else if (c == 330){ gv->ms_time   = strtod(opt.arg,NULL);	if (Verb == 1){		printf("--solvus_ms_time : Solvus search budget [ms] = %.1f \n", 	gv->ms_time);}}
+		else if (c == 331){ gv->LM_early  = atoi(opt.arg);	 	if (Verb == 1){		printf("--LM_early    : Early exit of on-hold LM = %i (heuristic) \n", 	   			gv->LM_early);}}
+		else if (c == 332){ gv->GM_on     = atoi(opt.arg);	 	if (Verb == 1){		printf("--PGE_gm      : Joint minimization       = %i \n", 	   			gv->GM_on);}}
+		else if (c == 333){ gv->GM_br     = strtod(opt.arg,NULL);	if (Verb == 1){		printf("--PGE_gm_br   : Joint min. BR_norm       = %g \n", 	   			gv->GM_br);}}
+		else if (c == 334){ gv->LM_cache  = atoi(opt.arg);	 	if (Verb == 1){		printf("--LM_cache    : Memorized LM per phase   = %i \n", 	   			gv->LM_cache);}}
+		else if (c == 335){ gv->LM_cache_tol = strtod(opt.arg,NULL);	if (Verb == 1){		printf("--LM_cache_tol : Memorized LM tolerance = %g \n", 	   			gv->LM_cache_tol);}}
+		else if (c == 324){ strcpy(gv->rt_PC_grid,opt.arg);	 	if (Verb == 1){		printf("--PGE_retry_grid : Retry PC grid        = %s \n", 	   			gv->rt_PC_grid);}}
 		else if (c == 313){ maxeval  = strtof(opt.arg,NULL); 	if (Verb == 1){
             if (maxeval==0){        printf("--maxeval     : Max. # of local iter.    = infinite  \n"		); }
             else{                   printf("--maxeval     : Max. # of local iter.    = %i  \n", maxeval		);}
@@ -737,8 +906,6 @@ global_variable ReadCommandLineOptions(	global_variable 	 gv,
 	*n_points_out 	= 	n_points;
 	*n_pc_out       =   n_pc;
     *maxeval_out    =   maxeval;
-	
-	return gv;
 } 
 
 
@@ -746,30 +913,34 @@ global_variable ReadCommandLineOptions(	global_variable 	 gv,
 /** 
   Initiatizes the endmember and solid solution databases and adds them to a single struct
 **/
-Databases InitializeDatabases(global_variable gv, int EM_database){
+Databases InitializeDatabases(global_variable *gv, int EM_database){
 	
 	Databases 	DB;
 	int 		i;
 
 	/* Allocate pure-phase database (to get gbase, comp and factor) 				*/
-	DB.PP_ref_db = malloc ((gv.len_pp) 		* sizeof(PP_ref)); 
+	DB.PP_ref_db = malloc ((gv->len_pp) 		* sizeof(PP_ref)); 
 	
 	/* Allocate solid-solution reference database (to get gbase, comp and factor) 	*/
-	DB.SS_ref_db = malloc ((gv.len_ss) 		* sizeof(SS_ref)); 
+	DB.SS_ref_db = malloc ((gv->len_ss) 		* sizeof(SS_ref)); 
 	
 	/* Allocate memory of the considered set of phases 								*/
-	DB.cp 		 = malloc ((gv.max_n_cp) 	* sizeof(csd_phase_set)); 
+	DB.cp 		 = malloc ((gv->max_n_cp) 	* sizeof(csd_phase_set)); 
 
 	/* Allocate memory for each solution phase according to their specificities (n_em, sf etc) */
-	for (i = 0; i < gv.len_ss; i++){
+	for (i = 0; i < gv->len_ss; i++){
 		DB.SS_ref_db[i] = G_SS_INIT_EM_function(		DB.SS_ref_db[i], 
 														EM_database, 
-														gv.SS_list[i], 
+														gv->SS_list[i], 
 														gv							);
 	}
+
+	/* NLopt optimizers of the solution phases, reused by all their local minimizations */
+	NLopt_opt_init(		gv,
+						DB.SS_ref_db		);
 	
 	/* Allocate memory of the considered set of phases 								*/
-	for (i = 0; i < gv.max_n_cp; i++){
+	for (i = 0; i < gv->max_n_cp; i++){
 		DB.cp[i] = CP_INIT_function(		DB.cp[i], 
 											gv										);
 	}
@@ -777,25 +948,29 @@ Databases InitializeDatabases(global_variable gv, int EM_database){
 	/* Endmember names */
 	DB.EM_names  =	get_EM_DB_names(EM_database);
 
-	/* Create endmember Hashtable */
+	/* Create endmember Hashtable (shared by all databases, only created once) */
 	struct EM2id *p_s, *tmp_p;
 	struct EM_db EM_return;
-    for (int i = 0; i < n_em_db; ++i) {
-		char EM_name[20];
-        p_s = (struct EM2id *)malloc(sizeof *p_s);
-        strcpy(p_s->EM_tag, DB.EM_names[i]);
-        p_s->id = i;
-        HASH_ADD_STR( EM, EM_tag, p_s );
-    }
+	if (EM == NULL){
+	    for (int i = 0; i < n_em_db; ++i) {
+			char EM_name[20];
+	        p_s = (struct EM2id *)malloc(sizeof *p_s);
+	        strcpy(p_s->EM_tag, DB.EM_names[i]);
+	        p_s->id = i;
+	        HASH_ADD_STR( EM, EM_tag, p_s );
+	    }
+	}
 
 	/* Create pure-phase hashtable */
 	struct PP2id *pp_s, *tmp_pp;
-    for (int i = 0; i < sizeof(gv.PP_list); ++i) {
-        pp_s = (struct PP2id *)malloc(sizeof *pp_s);
-        strcpy(pp_s->PP_tag, gv.PP_list[i]);
-        pp_s->id = i;
-        HASH_ADD_STR( PP, PP_tag, pp_s );
-    }
+	if (PP == NULL){
+	    for (int i = 0; i < sizeof(gv->PP_list); ++i) {
+	        pp_s = (struct PP2id *)malloc(sizeof *pp_s);
+	        strcpy(pp_s->PP_tag, gv->PP_list[i]);
+	        pp_s->id = i;
+	        HASH_ADD_STR( PP, PP_tag, pp_s );
+	    }
+	}
 
 	return DB;
 }
@@ -803,7 +978,7 @@ Databases InitializeDatabases(global_variable gv, int EM_database){
 /** 
   Free the memory associated with the databases
 **/
-void FreeDatabases(		global_variable gv, 
+void FreeDatabases(		global_variable *gv, 
 						Databases 		DB	){
 
 	//SS_ref_destroy(	gv, 
@@ -811,6 +986,18 @@ void FreeDatabases(		global_variable gv,
 
 	CP_destroy(		gv, 
 						DB.cp				);
+
+	destroy_LM_threads(	gv 				);
+
+	destroy_LM_cache(	gv,
+						DB.SS_ref_db		);
+
+	destroy_PGE_workspace(	gv 			);
+
+	NLopt_opt_destroy(	gv,
+						DB.SS_ref_db		);
+
+	NLopt_global_opt_destroy(	gv 		);
 	
 	//free(DB.SS_ref_db);
 	
@@ -822,12 +1009,16 @@ void FreeDatabases(		global_variable gv,
 	
 	free(DB.EM_names);
 	free(DB.PP_ref_db);
+
+	/* release the pseudocompound grid */
+	unload_PC_grid(	gv 					);
+	unload_retry_PC_grid(gv 			);
 }
 
 /** 
   This prints output on screen
 **/
-void PrintOutput(	global_variable 	gv,
+void PrintOutput(	global_variable 	*gv,
 					int 				rank,
 					int 				l,
 					Databases 			DB,
@@ -835,35 +1026,59 @@ void PrintOutput(	global_variable 	gv,
 					struct bulk_info 	z_b				){
 						
 	int i;
-	if (gv.Mode==0 && gv.verbose != 2){
+	if (gv->Mode==0 && gv->verbose != 2){
 
     	printf("Rank          : %i \n",rank);
     	printf("Point         : %i \n",l);
     	printf("Temperature   : %3.4f\t [C] \n",   z_b.T - 273.15);
 		printf("Pressure      : %3.2f\t [kbar]\n", z_b.P);
+		if (gv->rt_rung != 0){
+			printf("Retry rung    : %i\n", gv->rt_rung);
+		}
        
- 		if (gv.verbose == 1){
+ 		if (gv->verbose == 1){
  			printf("\n______________________________\n");
 			printf("| Total Time: %.6f (ms) |", time_taken*1000);
             printf("\n‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
+
+			int    n_LM    = 0, n_eval = 0, n_ee = 0, n_saved = 0, n_hit = 0;
+			double LM_time = 0.0;
+			for (i = 0; i < gv->len_cp; i++){
+				n_LM    += DB.cp[i].n_LM;
+				LM_time += DB.cp[i].LM_time;
+				n_eval  += DB.cp[i].n_eval;
+				n_ee    += DB.cp[i].n_ee;
+				n_saved += DB.cp[i].n_eval_saved;
+				n_hit   += DB.cp[i].n_hit;
+			}
+			printf(" Local minimizations: %i calls in %.3f ms (%.0f calls/s)\n", n_LM, LM_time, (LM_time > 0.0) ? n_LM/LM_time*1000.0 : 0.0);
+			printf(" Objective evaluations: %i, %i early exits saving about %i evaluations\n", n_eval, n_ee, n_saved);
+			if (gv->LM_cache > 0){
+				long n_lookup_run = 0, n_hit_run = 0;
+				for (i = 0; i < gv->len_ss; i++){
+					n_lookup_run += DB.SS_ref_db[i].cache->n_lookup;
+					n_hit_run 	 += DB.SS_ref_db[i].cache->n_hit;
+				}
+				printf(" Memorized minimizations: %i of %i calls, %ld of %ld since the start of the run (%.1f%%)\n", n_hit, n_LM, n_hit_run, n_lookup_run, (n_lookup_run > 0) ? 100.0*n_hit_run/n_lookup_run : 0.0);
+			}
         }
     }
 
-	if ((gv.verbose < 1) &  (gv.Mode==0)){
-		printf("\nSOLUTION: [G = %.3f] (%i iterations, %.2f ms)\n",gv.G_system,gv.global_ite,time_taken*1000.0);
+	if ((gv->verbose < 1) &  (gv->Mode==0)){
+		printf("\nSOLUTION: [G = %.3f] (%i iterations, %.2f ms)\n",gv->G_system,gv->global_ite,time_taken*1000.0);
 		printf("[");
 		for (i = 0; i < z_b.nzEl_val; i++){
-			printf("%+8f,",gv.gam_tot[z_b.nzEl_array[i]]);
+			printf("%+8f,",gv->gam_tot[z_b.nzEl_array[i]]);
 		}
 		printf("]\n");
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if (DB.cp[i].ss_flags[1] == 1){
 				printf("%4s \t %.5f \n", DB.cp[i].name, DB.cp[i].ss_n);
 			}
 		}
-		for (int i = 0; i < gv.len_pp; i++){
-			if (gv.pp_flags[i][1] == 1){
-				printf("%4s \t %.5f \n", gv.PP_list[i], gv.pp_n[i]);
+		for (int i = 0; i < gv->len_pp; i++){
+			if (gv->pp_flags[i][1] == 1){
+				printf("%4s \t %.5f \n", gv->PP_list[i], gv->pp_n[i]);
 			}
 		}	
 	}
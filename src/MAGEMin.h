@@ -7,6 +7,7 @@
 
 #define n_em_db 291
 #define nEl 11
+#define n_aa_max 8
 
 #include "nlopt.h"
 #include "gem_function.h"
@@ -49,6 +50,21 @@ struct EM_db {
     double input_3[11];         /** third line of the thermodynamics datable 								*/
 };
 
+/* memo table of the local minimizations of a solution phase (--LM_cache=n), shared by its scratch copies */
+typedef struct LM_caches {
+	int      n;					/** number of entries 															*/
+	int      n_used;			/** number of filled entries 													*/
+	int      next;				/** entry overwritten by the next store (ring buffer) 							*/
+	int      len_key;			/** length of a key: P, T, min_mode, LM_ee, maxeval, gb_lvl, iguess, box bounds 	*/
+	double  *key;				/** keys of the entries [n x len_key] 											*/
+	double  *xeos;				/** minimized x-eos [n x n_xeos] 												*/
+	double  *df;				/** objective at the minimum [n] 												*/
+	int     *status;			/** status of the minimization [n] 												*/
+	int     *ee_exit;			/** early exit of the minimization [n] 											*/
+	long     n_lookup;			/** number of lookups since the start of the run 								*/
+	long     n_hit;				/** number of lookups that returned an entry 									*/
+} LM_cache;
+
 /* Declare structures to hold reference gbase, composition and factor for solid solutions */
 /* "bi","cpx","crd","ep","fl","g","hb","ilm","liq","mu","ol","opx","pl4T","spn" */
 typedef struct SS_refs {
@@ -80,6 +96,14 @@ typedef struct SS_refs {
 	double  *factor_pc;			/** normalization factor of each PC, mainly useful for liquid 				*/
 	double  *ub_pc;				/** upper bounds for pc 													*/
 	double  *lb_pc;				/** lower bounds for pc 													*/
+	int     *kd_idx;			/** k-d tree over xeos_pc (permutation of the pseudocompound indexes) 		*/
+	int      kd_n;				/** number of pseudocompounds stored in the k-d tree 						*/
+	int     *kd_nb;				/** scratch array receiving the result of k-d tree queries 					*/
+	double   fbc_pc;			/** fbc of the bulk rock used to generate the stored pseudocompounds 		*/
+	int      n_pc_gen;			/** levelling counter: grid pseudocompounds evaluated 						*/
+	int      n_pc_kept;			/** levelling counter: pseudocompounds stored (G < max_G_pc, or reused) 	*/
+	int      n_pc_filt;			/** levelling counter: pseudocompounds removed by filter_hld_PC 			*/
+	int      n_pc_pivot;		/** levelling counter: pseudocompounds entering the levelling basis 		*/
 	
 	/** data needed for phase change and solvus processing **/	
 	int	    *solvus_id;
@@ -127,6 +151,9 @@ typedef struct SS_refs {
 
 	/** NLopt memory allocation */
 	nlopt_opt opt;				/** send NLopt optimizer													*/
+	double  *sqp_ws;			/** workspace of the in-house local minimizer (SQP_opt_function) 			*/
+	int     *sqp_iw;			/** integer workspace of the in-house local minimizer 						*/
+	double  *hess_ws;			/** workspace of the analytic Hessian (hess_* functions, SS_hess_ws_size) 	*/
 	double   fbc;				/** saved number of atoms of the bulk rock composition 						*/
 	double   sum_apep;			/** saved number of atoms of the bulk rock composition 						*/
 	double  *p;					/** Following declarations needed for local minimizer 						*/
@@ -141,6 +168,14 @@ typedef struct SS_refs {
 	double   df;				/** save driving force: delta_G from G-hyperplane 							*/
 	double   df_raw;			/** save driving force: delta_G from G-hyperplane 							*/
 	double   LM_time;			/** local minimization time  												*/
+	double (*LM_obj)(unsigned, const double*, double*, void*);	/** objective function minimized by NLopt (NLopt_obj_wrap) 	*/
+	int      n_eval;			/** number of objective evaluations of the last local minimization 			*/
+	int      LM_ee;				/** 1 to allow the early exit of the next local minimization (on-hold phase) */
+	int      LM_ee_exit;		/** early exit of the last local minimization: 0 none, 1 above, 2 below the G-hyperplane */
+	double   LM_ee_hi;			/** first-order estimate of the minimum above which the minimization stops (heuristic) */
+	double   LM_ee_lo;			/** the minimization stops when the objective is below -LM_ee_lo 			*/
+	LM_cache *cache;			/** memo table of the local minimizations, NULL when --LM_cache=0 			*/
+	double  *LM_key;			/** key of the current local minimization [cache->len_key], own to each copy */
 
 	/* data needed for PGE iterations */
     double  *ss_comp;			/** 1d array of solid solution composition */
@@ -180,6 +215,7 @@ typedef struct OUTDATA {
 	double 	 dG_norm;			/** Bulk rock norm 										*/
 	int 	 number;			/** number of point										*/
 	int 	 status;			/** status of calculation								*/
+	int 	 retry;				/** rung of the retry ladder that converged (0 none, -1 failed)	*/
 
 	double  *Gamma;				/** Gamma of stable solution 							*/
 	
@@ -216,6 +252,16 @@ typedef struct csd_phase_sets {
 	
 	int     split;
 	int     in_iter;
+	int     min_stable;			/** number of consecutive local minimizations that left x-eos and df unchanged 	*/
+	int     min_skip;			/** number of consecutive global iterations without local minimization 			*/
+	int     n_LM;				/** number of local minimizations of the phase for the current point 			*/
+	double  LM_time;			/** total time spent in the local minimizations of the phase (ms) 				*/
+	int     n_eval;				/** number of objective evaluations of the local minimizations 					*/
+	int     n_ee;				/** number of local minimizations stopped early (--LM_early) 					*/
+	int     n_eval_ref;			/** objective evaluations of the last complete local minimization 				*/
+	int     n_eval_saved;		/** evaluations saved by the early exits, relative to n_eval_ref 				*/
+	int     n_hit;				/** number of local minimizations returned by the memo table (--LM_cache) 		*/
+	double  df_LM;				/** driving force right after the last local minimization 						*/
 	int 	id;					/** id of solution phas 								*/
 	int 	n_xeos;				/** number of compositional variables 					*/
 	int 	n_em;	
@@ -246,6 +292,8 @@ typedef struct csd_phase_sets {
 	double *delta_mu;
 	double *sf;
 	double *ss_comp;
+	double *comp_nz;			/** factor-scaled endmember compositions over the non-zero oxides [n_em x nzEl_val], cached for PGE */
+	int     em_row;				/** first row of the endmembers in gv.em_C, -1 when the phase is not packed */
 	double *gbase;				/** chemical potentials 													*/
 
 	double mass;
@@ -258,6 +306,135 @@ typedef struct csd_phase_sets {
 } csd_phase_set;
 
 
+/* structure to store the x-eos of one pseudocompound (the grids are stored in binary files, see PC_grid_function.c) */
+struct ss_pc{
+    double xeos_pc[11];
+};
+
+/* pointer to the pseudocompound grid of one solution phase */
+typedef struct PC_refs {
+	struct ss_pc *ss_pc_xeos;
+
+} PC_ref;
+
+/* levelling counters of the current point, indexes of n_price and n_pivot: pure phases, endmembers, pseudocompounds */
+typedef struct lvl_stats {
+	int 	 n_price[3];		/** number of candidates priced (swap attempts) */
+	int 	 n_pivot[3];		/** number of candidates entering the basis (accepted swaps) */
+	int 	 n_degen;			/** number of degenerate pivots */
+	int 	 n_bland;			/** number of iterations using Bland's rule */
+	int 	 n_inv;				/** number of basis inversions (LAPACKE) */
+	int 	 n_eta;				/** number of eta updates of the basis inverse */
+	double 	 obj_time;			/** time spent generating the pseudocompounds (objective functions, ms) */
+	double 	 la_time;			/** time spent in the revised simplex (linear algebra and pricing, ms) */
+} lvl_stat;
+
+/* phase-set change of the current point, recorded for the PGE convergence trace (--PGE_trace=1) */
+#define n_trc_ev_max 512
+typedef struct PGE_trc_events {
+	int 	 ite;				/** global iteration */
+	int 	 type;				/** 1 act2hold, 2 hold2act, 3 hold2rmv, 4 act2rmv (polymorph replaced) */
+	int 	 ph_type;			/** 0 pure phase, 1 solution phase */
+	int 	 ph_id;				/** index of the pure phase or of the solution phase */
+	int 	 cp_id;				/** index of the considered phase, -1 for pure phases */
+} PGE_trc_event;
+
+/* converged assemblage of a point, used to restart a failed point (retry ladder, see recovery_function.c) */
+typedef struct PGE_solutions {
+	int 	 ok;				/** 1 if a solution is stored */
+	double 	 P;					/** pressure [kbar] */
+	double 	 T;					/** temperature [K] */
+	double 	*gam_tot;			/** Gamma [len_ox] */
+	int 	*pp_act;			/** 1 for the active pure phases [len_pp] */
+	double 	*pp_n;				/** fraction of the pure phases [len_pp] */
+	int 	 n_cp;				/** number of active considered phases */
+	int 	*cp_ss;				/** solution phase of the active considered phases [len_ox] */
+	double 	*cp_n;				/** fraction of the active considered phases [len_ox] */
+	double 	*cp_factor;			/** normalization factor of the active considered phases [len_ox] */
+	double 	*cp_xeos;			/** x-eos of the active considered phases [len_ox x len_ox] */
+	double 	*cp_p;				/** endmember fractions of the active considered phases [len_ox x (len_ox+1)] */
+} PGE_solution;
+
+/**
+  structure to be passed to compare function (cmp_dbl)
+*/
+struct str
+{
+	double value;
+	int    index;
+};
+
+/**
+	Scratch arrays of the PGE iterations, of the levelling and of the global minimization. They are carved from one
+	64-byte aligned block, allocated once per context (driver or batch levelling thread) by init_PGE_workspace, such
+	that the per-iteration path does not allocate memory nor use variable length arrays.
+*/
+#define ws_align 64
+
+
+typedef struct PGE_workspaces {
+	void 	*block;				/** allocated block, the arrays below point into it */
+	size_t 	 size;				/** size of the block (bytes) */
+	int 	 nEntry_max;		/** maximum size of the PGE system, len_ox oxides and at most len_ox phases */
+	int 	 n_x_max;			/** maximum number of variables (fractions and x-eos) of the global minimization */
+	int 	 n_sf_max;			/** maximum number of site fraction constraints of the global minimization */
+	int 	 n_xeos_max;		/** maximum number of x-eos of a solution phase */
+	int 	 n_em_max;			/** maximum number of endmembers of a solution phase */
+	int 	 n_pc_max;			/** maximum number of pseudocompounds stored by a solution phase */
+
+	/* PGE system */
+	double 	*A;					/** Jacobian [nEntry_max x nEntry_max] */
+	double 	*b;					/** gradient, then solution [nEntry_max] */
+	int 	*ipiv;				/** pivot indices of the LU fallback [nEntry_max] */
+	double 	*h;					/** oxide-phase block row of the Jacobian [len_ox] */
+	double 	*K;					/** Schur complement solve, augmented oxide block [len_ox x len_ox] */
+	double 	*W;					/** Schur complement solve, K^-1 G' [nEntry_max x len_ox] */
+	double 	*S;					/** Schur complement solve, phase block [nEntry_max x nEntry_max] */
+	double 	*y;					/** Schur complement solve, oxide right-hand side [len_ox] */
+	double 	*dn;				/** Schur complement solve, phase right-hand side [nEntry_max] */
+
+	/* Anderson mixing */
+	double 	*aa_r;				/** residual of the current global iteration [len_ox] */
+	double 	*aa_y;				/** current Gamma [len_ox] */
+	double 	*aa_d;				/** correction of Gamma [len_ox] */
+	double 	*aa_M;				/** normal equations [n_aa_max x n_aa_max] */
+	double 	*aa_c;				/** mixing coefficients [n_aa_max] */
+
+	/* phase update and local minimizations */
+	double 	*w;					/** endmember weights of a considered phase [len_ox + 1] */
+	int 	*pp_act;			/** active pure phases [len_ox] */
+	int 	*cp_act;			/** active considered phases [len_ox] */
+	struct str *hld_cp_sort;	/** considered phases on hold sorted by driving force [max_n_cp] */
+	struct str *hld_pp_sort;	/** pure phases on hold sorted by driving force [len_pp] */
+	int 	*lm_id;				/** considered phases to minimize [max_n_cp] */
+	int 	*th_id;				/** thread of the local minimizations [max_n_cp] */
+	int 	*lm_rank;			/** rank of the on-hold phases by estimated distance to the G-hyperplane, -1 if not ranked [max_n_cp] */
+	int 	*done;				/** last instance written back per solution phase [len_ss] */
+	int 	*dist;				/** pseudocompounds far enough from the existing instances [n_pc_max] */
+	double 	*dp;				/** change of the endmember fractions of a phase (PGE_update_pi) [n_em_max] */
+
+	/* multi-start solvus search */
+	int 	*ms_ph;				/** solution phase of the starts [len_ss*ms_n] */
+	int 	*ms_ok;				/** 1 if the start converged with respected site fractions [len_ss*ms_n] */
+	double 	*ms_df;				/** driving force of the converged starts [len_ss*ms_n] */
+	double 	*ms_x;				/** x-eos of the starting pseudocompounds, then of the minima [len_ss*ms_n x n_xeos_max] */
+	double 	*ms_p;				/** endmember fractions of the minima [len_ss*ms_n x n_em_max] */
+
+	/* levelling */
+	int 	*phase_on;			/** solution phases of the levelled assemblage [len_ss] */
+	int 	*bas;				/** basic phases of the simplex [len_ox] */
+	double 	*gam;				/** chemical potential of the oxides [len_ox] */
+	double 	*br;				/** bulk-rock of the refactorized basis (update_basis) [len_ox] */
+	int 	*lvl_ipiv;			/** pivot indices of the basis inversion (inverseMatrix) [len_ox] */
+
+	/* global minimization */
+	double 	*x;					/** fractions and x-eos of the active phases [n_x_max] */
+	double 	*lb;				/** lower bounds [n_x_max] */
+	double 	*ub;				/** upper bounds [n_x_max] */
+	double 	*tol_sf;			/** site fraction constraint tolerances [n_sf_max] */
+	double 	*tol_eq;			/** mass constraint tolerances [len_ox] */
+} PGE_workspace;
+
 /* structure to store global variables */
 typedef struct global_variables {
 	
@@ -265,7 +442,7 @@ typedef struct global_variables {
 	char    *version;			/** MAGEMin version */
 	int      verbose;			/** verbose variable: 0, none; 1, all */
 	char    *outpath;			/** output path */
-	int      Mode;				/** calcultion mode, 0 = full minimization, 1 = extract solution phases informations, 2 = local minimization */
+	int      Mode;				/** calcultion mode, 0 = full minimization, 1 = extract solution phases informations, 2 = local minimization, 3 = levelling only, 4 = batch levelling */
 	double **numDiff;
 	int      n_Diff;
 	
@@ -304,6 +481,13 @@ typedef struct global_variables {
 	/* LEVELLING */
 	double   LVL_time;			/** time taken for levelling (ms) */
 	double   em2ss_shift;		/** small value to retrieve x-eos from pure endmember after levelling */
+	double   lvl_dG_tol;		/** reduced cost under which a candidate enters the levelling basis */
+	double   lvl_piv_tol;		/** minimum pivot value of the ratio test */
+	int      lvl_refac;			/** number of basis updates after which the basis inverse is recomputed */
+	int      lvl_max_degen;		/** number of consecutive degenerate pivots before switching to Bland's rule */
+	int      lvl_max_pivot;		/** maximum number of pivots per levelling stage */
+	int      lvl_stats;			/** 1 to dump the levelling counters of every point in __LEVELLING_STATS.txt */
+	lvl_stat lvl;				/** levelling counters of the current point */
 	
 	/* PSEUDOCOMPOUNDS */
 	double   bnd_filter_pc;     /** value of driving force the pseudocompound is considered to reduce the compositional space */
@@ -312,6 +496,12 @@ typedef struct global_variables {
 	int     *n_SS_PC;
 	double  *SS_PC_stp;
 	double   eps_sf_pc;	
+	char    *PC_grid;			/** pseudocompound grid density (coarse, default, fine) or path to a grid file */
+	char    *PC_grid_dir;		/** directory of the grid files (--PC_grid_dir=path or MAGEMIN_PC_GRID_DIR), empty to search next to the executable */
+	void    *PC_grid_map;		/** memory mapped pseudocompound grid file */
+	size_t   PC_grid_size;		/** size of the mapped grid file in bytes */
+	PC_ref  *PC_xeos;			/** per solution phase pointer to the pseudocompound grid (inside the mapping) */
+	int      PC_reuse;			/** 1 if the pseudocompounds of the previous point are kept (same P, T and zero oxides) */
 	
 	/* SOLVI */
 	int     *verifyPC;		/** allow to check for solvi */
@@ -330,8 +520,7 @@ typedef struct global_variables {
 	double 	*init_prop;			/** holds the initial proportions of the EM's, in case we do Mode=2 with only a single point */
 
 	/* PARTITIONING GIBBS ENERGY */ 
-	double 	*A_PGE;				/** RHS */
-	double  *b_PGE;				/** LHS */
+	PGE_workspace ws;			/** scratch arrays, including the PGE matrix (ws.A) and RHS (ws.b) */
 	double 	*dn_cp;
 	double 	*dn_pp;
 	int 	*cp_id;
@@ -340,6 +529,81 @@ typedef struct global_variables {
 	int      outter_PGE_ite;    /** number of PGE outter iterations */
 	int      inner_PGE_ite;     /** number of PGE outter iterations */
 	double   inner_PGE_ite_time;
+	int      inner_PGE_n;		/** current number of inner PGE iterations (adapted when adapt_PGE = 1) */
+	int      ph_change_PGE;		/** number of phase changes during the last PGE inner loop */
+
+	/* ADAPTIVE PGE ITERATION CONTROL */
+	int      adapt_PGE;			/** 1 to adapt the PGE iterations to the residual history (--PGE_adapt=1) */
+	int      inner_PGE_min;		/** minimum number of inner PGE iterations */
+	int      inner_PGE_max;		/** maximum number of inner PGE iterations */
+	int      adapt_min_stable;	/** number of converged global iterations after which the solution is accepted */
+	int      adapt_n_stable;	/** current number of consecutive converged global iterations */
+	int      adapt_max_skip;	/** maximum number of consecutive global iterations a phase is not minimized */
+	double   adapt_gam_tol;		/** Gamma update norm under which Gamma is considered steady */
+	double   adapt_xeos_tol;	/** x-eos change under which the local minimization of a phase is considered steady */
+	double   adapt_df_tol;		/** driving force change under which the local minimization of a phase is considered steady */
+
+	/* LOCAL MINIMIZATION SCHEDULING */
+	int      LM_schedule;		/** 1 to minimize the on-hold phases far from the G-hyperplane only every LM_hld_refresh iterations (--LM_schedule=1) */
+	int      LM_hld_refresh;	/** number of global iterations after which a distant on-hold phase is minimized again */
+	double   LM_df_near;		/** estimated distance to the G-hyperplane (df*factor) under which an on-hold phase is minimized every iteration */
+	int      LM_n_near;			/** number of closest on-hold phases minimized every iteration (--LM_near=k) */
+	int      LM_early;			/** 1 to stop the local minimization of the on-hold phases once the sign of their driving force is decided, heuristic (--LM_early=1) */
+	double   LM_ee_hi;			/** estimated minimum of df*factor above which an on-hold phase stays on hold (heuristic, not for --solvus_ms phases) */
+	double   LM_ee_lo;			/** df*factor below -LM_ee_lo an on-hold phase is reintroduced */
+	int      LM_cache;			/** number of memorized local minimizations per solution phase, 0 to disable (--LM_cache=n) */
+	double   LM_cache_tol;		/** relative tolerance under which the inputs of two local minimizations are the same */
+
+	/* FLATTENED ENDMEMBER COMPOSITIONS (PGE inner iterations) */
+	double  *em_C;				/** compositions of the pure phases, then of the endmembers of the considered phases [n_em_rows x len_ox], column-major */
+	double  *em_g;				/** rotated reference G of the rows of em_C (work array) */
+	double  *em_x;				/** Boltzmann factors of the rows of em_C (work array) */
+	int      n_em_rows;			/** number of rows of em_C currently packed */
+	int      em_ld;				/** leading dimension of em_C (allocated number of rows) */
+
+	/* PGE CONVERGENCE TRACE */
+	int      PGE_trace;			/** 1 to dump the iteration history of every point in __PGE_TRACE.bin (--PGE_trace=1) */
+	int      n_trc_ev;			/** number of phase-set changes recorded for the current point */
+	PGE_trc_event *trc_ev;		/** phase-set changes of the current point [n_trc_ev_max] */
+
+	/* JOINT MINIMIZATION OF THE ASSEMBLAGE (NLopt_global_opt_function) */
+	int      GM_on;				/** 1 to polish the assemblage near convergence by a joint minimization (--PGE_gm=1) */
+	double   GM_br;				/** BR_norm under which the joint minimization is run, once per point (--PGE_gm_br=val) */
+	int      GM_maxeval;		/** maximum number of evaluations of the joint minimization */
+	int      GM_done;			/** 1 once the joint minimization has been run for the current point */
+	int      GM_n_eval;			/** number of evaluations of the last joint minimization */
+	int      GM_status;			/** NLopt status of the last joint minimization, negative if its result was rejected */
+	double   GM_time;			/** time of the last joint minimization [ms] */
+	void    *GM_db;				/** data and buffers of the joint minimization (NLopt_global_opt_init), NULL before the first call */
+
+	/* RETRY LADDER OF THE FAILED POINTS */
+	int      rt_max;			/** number of rungs tried on a failed point, 0 to 3 (--PGE_retry=n) */
+	double   rt_time;			/** wall time budget of one rung [ms], 0 for no limit (--PGE_retry_time=ms) */
+	double   rt_deadline;		/** wall time at which the current rung is stopped [ms], 0 outside of the ladder */
+	double   rt_dP;				/** pressure perturbation of the third rung [kbar] */
+	double   rt_dT;				/** temperature perturbation of the third rung [K] */
+	int      rt_seed;			/** 1 to replace the levelled assemblage by rt_sol before PGE */
+	int      rt_rung;			/** rung that converged: 0 first attempt, 1 neighbour, 2 denser grid, 3 perturbed P/T, -1 failed */
+	PGE_solution rt_sol;		/** last converged solution of the rank */
+	char    *rt_PC_grid;		/** denser pseudocompound grid of the second rung (--PGE_retry_grid=name) */
+	void    *rt_PC_grid_map;	/** memory mapped denser grid, NULL if it is not used */
+	size_t   rt_PC_grid_size;	/** size of the mapped denser grid in bytes */
+	int     *rt_n_SS_PC;		/** n_SS_PC of the denser grid (exchanged with the grid in use by swap_PC_grid) */
+	double  *rt_SS_PC_stp;		/** SS_PC_stp of the denser grid */
+	PC_ref  *rt_PC_xeos;		/** PC_xeos of the denser grid */
+
+	/* THREADED LOCAL MINIMIZATION */
+	int      LM_threads;		/** number of OpenMP threads sharing the local minimizations of a point (--LM_threads=n) */
+	SS_ref 	**SS_th;			/** per-thread scratch copies of the solution phases [LM_threads][len_ss] */
+	int     *LM_sqp;			/** 1 if the phase is minimized by the in-house SQP solver, NLopt being the fallback [len_ss] (--LM_solver) */
+	int      LM_pool;			/** 1 to reuse the NLopt optimizer of each solution phase, 0 to create it at every call (--LM_pool) */
+	int      LM_hess;			/** 1 to use the analytic Hessians (hess_*) in the SQP local minimizer, 0 for BFGS (--LM_hess) */
+
+	/* MULTI-START SOLVUS SEARCH */
+	int     *ms_ss;				/** 1 if the multi-start solvus search is run for the phase [len_ss] (--solvus_ms=ph1,ph2 or all) */
+	int      ms_n;				/** maximum number of local minimizations started per selected phase (--solvus_ms_n=n) */
+	double   ms_sep;			/** minimum distance between two starting pseudocompounds, in pseudocompound grid steps */
+	double   ms_time;			/** wall time budget of the solvus search of a point [ms] (--solvus_ms_time=ms, 0 for no limit) */
 	
 	int      n_phase;			/** number of estimated stable phases */	
 	int 	 n_pp_phase;		/** number of active pure phases */
@@ -357,6 +621,18 @@ typedef struct global_variables {
 	int      ur_f;				/** send a failed message when the number of iteration is greater than this value */
 	int 	 div;				/** send status of divergence */
 
+	/* ANDERSON MIXING OF GAMMA */
+	int      aa_depth;			/** number of previous global iterations mixed in the Gamma update (0 disables the mixing, max n_aa_max) */
+	int      aa_n;				/** number of stored differences, -1 when the history is empty */
+	int      aa_pos;			/** position of the next stored difference (circular buffer) */
+	double   aa_br;				/** mass constraint norm of the previous global iteration */
+	double  *aa_x;				/** Gamma at the start of the global iteration (non-zero oxides) */
+	double  *aa_f;				/** Gamma update of the previous global iteration */
+	double  *aa_g;				/** Gamma at the end of the previous global iteration, before mixing */
+	double  *aa_dF;				/** differences of the Gamma updates [n_aa_max x len_ox] */
+	double  *aa_dG;				/** differences of the Gamma iterates [n_aa_max x len_ox] */
+	int     *aa_ph;				/** active flags of the pure and solution phases at the previous global iteration */
+
 	/* DECLARE ARRAY FOR PGE CALCULATION */	
 	double	*dGamma;			/** array to store gamma change */
 	
@@ -399,48 +675,48 @@ typedef struct Database {	PP_ref     		*PP_ref_db;			/** Pure phases 								*/
 							char 	  		**EM_names;			/** Names of endmembers 						*/
 } Databases;
 
-Databases InitializeDatabases(	global_variable gv, 
+Databases InitializeDatabases(	global_variable *gv, 
 								int 			EM_database		);
 
-void FreeDatabases(	global_variable gv, 
+void FreeDatabases(	global_variable *gv, 
 					Databases		DB							);
 
-global_variable ComputeEquilibrium_Point(	int 				 EM_database,
-											io_data 			 input_data,
-											int 				 Mode,
-											struct bulk_info 	 z_b,
-											global_variable 	 gv,
-											PP_ref  			*PP_ref_db,
-											SS_ref  			*SS_ref_db,
-											csd_phase_set  		*cp					);
+void ComputeEquilibrium_Point(	int 				 EM_database,
+								io_data 			 input_data,
+								int 				 Mode,
+								struct bulk_info 	 z_b,
+								global_variable 	*gv,
+								PP_ref  			*PP_ref_db,
+								SS_ref  			*SS_ref_db,
+								csd_phase_set  		*cp					);
 											
 void ComputePostProcessing(					int 				 EM_database,
 											struct bulk_info 	 z_b,
-											global_variable 	 gv,
+											global_variable 	*gv,
 											PP_ref  			*PP_ref_db,
 											SS_ref  			*SS_ref_db,
 											csd_phase_set  		*cp					);											
 
-global_variable ReadCommandLineOptions(	global_variable 	 gv,
-										int 	  argc, 
-										char 	**argv, 
-										int 	 *Mode_out, 
-										int 	 *Verb_out, 
-										int 	 *test_out, 
-										int 	 *n_points_out, 
-										double 	 *P, 
-										double 	 *T, 
-										double 	  Bulk[11], 
-										double 	  Gam[11], 
-										double 	  InitEM_Prop[15], 
-										char 	  File[50], 
-										char 	  Phase[50], 
-										int 	 *n_pc_out, 
-										int 	 *maxeval_out, 
-										int      *get_version_out	);
+void ReadCommandLineOptions(	global_variable 	*gv,
+								int 	  argc, 
+								char 	**argv, 
+								int 	 *Mode_out, 
+								int 	 *Verb_out, 
+								int 	 *test_out, 
+								int 	 *n_points_out, 
+								double 	 *P, 
+								double 	 *T, 
+								double 	  Bulk[11], 
+								double 	  Gam[11], 
+								double 	  InitEM_Prop[15], 
+								char 	  File[50], 
+								char 	  Phase[50], 
+								int 	 *n_pc_out, 
+								int 	 *maxeval_out, 
+								int      *get_version_out	);
 
 /* function that prints output */
-void PrintOutput(	global_variable 	gv, 
+void PrintOutput(	global_variable 	*gv, 
 					int 				rank, 
 					int 				l, 
 					Databases 			DB, 
@@ -16,7 +16,11 @@
 #include "gss_function.h"			// order of header file declaration is important
 #include "objective_functions.h"
 #include "NLopt_opt_function.h"
+#include "SQP_opt_function.h"
+#include "sf_jacobian.h"
+#include "ss_min_function.h"
 #include "toolkit.h"
+#include "batch_levelling_function.h"
 
 #define nEl 11						// max number of non-zeros compoenents
 #define eps_sf -1e-10				// eps to shift site fraction from zero
@@ -1280,174 +1284,306 @@ void cd_c(unsigned m, double *result, unsigned n, const double *x, double *grad,
 };
 
 typedef struct global_min_datas {
-	global_variable 	 gv; 
+	global_variable 	*gv; 
 	struct bulk_info 	 z_b;
-	obj_type 			*SS_objective;
-	sf_type 			*SS_sf;
+	obj_type 			*SS_objective;		/** objective functions of the solution phases [len_ss] */
+	const sf_jac_data 	**SS_sf;			/** site-fraction constraints of the solution phases [len_ss] */
 	PP_ref 				*PP_ref_db;
 	SS_ref 				*SS_ref_db;
 	csd_phase_set  		*cp;
-	
+
+	nlopt_opt 			 opt;				/** SLSQP optimizer, kept while n, m and l do not change */
+	unsigned 			 n, m, l;			/** number of variables, inequality and equality constraints */
+	int 				 valid;				/** 1 if the buffers hold the evaluation at x_eval */
+	int 				 n_eval;			/** number of evaluations of the current minimization */
+	double 				 f;					/** objective at x_eval */
+	double 				*x_eval;			/** point of the last evaluation [n_x_max] */
+	double 				*grad;				/** gradient of the objective at x_eval [n_x_max] */
+	double 				*dfac;				/** derivative of the normalization factor of a phase [n_x_max] */
+	double 				*eq;				/** mass-balance residual at x_eval [len_ox] */
+	double 				*J_eq;				/** Jacobian of the mass balance at x_eval [len_ox x n_x_max] */
 } global_min_data;
 
 
+/**
+	site-fraction inequality constraints of a solution phase, NULL if the phase is not in the database
+*/
+sf_type SS_sf_function(		char 				*name 			){
+
+	if      (strcmp( name, "bi")  == 0 ){
+		return bi_c; 		}
+	else if (strcmp( name, "cd")  == 0){
+		return cd_c; 		}
+	else if (strcmp( name, "cpx") == 0){
+		return cpx_c; 		}
+	else if (strcmp( name, "ep")  == 0){
+		return ep_c; 		}
+	else if (strcmp( name, "fl")  == 0){
+		return fl_c; 		}
+	else if (strcmp( name, "g")   == 0){
+		return g_c; 		}
+	else if (strcmp( name, "hb")  == 0){
+		return hb_c; 		}
+	else if (strcmp( name, "ilm") == 0){
+		return ilm_c; 		}
+	else if (strcmp( name, "liq") == 0){
+		return liq_c; 		}
+	else if (strcmp( name, "mu")  == 0){
+		return mu_c; 		}
+	else if (strcmp( name, "ol")  == 0){
+		return ol_c; 		}
+	else if (strcmp( name, "opx") == 0){
+		return opx_c; 		}
+	else if (strcmp( name, "pl4T") == 0){
+		return pl4T_c; 		}
+	else if (strcmp( name, "spn") == 0){
+		return spn_c; 		}
+
+	return NULL;
+}
+
 /**
 	associate the array of pointer with the right solution phase
 */
-void SS_sf_init_function(	sf_type 			*SS_sf,
-							global_variable 	 gv				){	
-
-	for (int iss = 0; iss < gv.len_ss; iss++){
-
-		if      (strcmp( gv.SS_list[iss], "bi")  == 0 ){
-			SS_sf[iss]  = bi_c; 		}
-		else if (strcmp( gv.SS_list[iss], "cd")  == 0){
-			SS_sf[iss]  = cd_c; 		}
-		else if (strcmp( gv.SS_list[iss], "cpx") == 0){
-			SS_sf[iss]  = cpx_c; 		}
-		else if (strcmp( gv.SS_list[iss], "ep")  == 0){
-			SS_sf[iss]  = ep_c; 		}
-		else if (strcmp( gv.SS_list[iss], "fl")  == 0){
-			SS_sf[iss]  = fl_c; 		}
-		else if (strcmp( gv.SS_list[iss], "g")   == 0){
-			SS_sf[iss]  = g_c; 			}
-		else if (strcmp( gv.SS_list[iss], "hb")  == 0){
-			SS_sf[iss]  = hb_c; 		}
-		else if (strcmp( gv.SS_list[iss], "ilm") == 0){
-			SS_sf[iss]  = ilm_c; 		}
-		else if (strcmp( gv.SS_list[iss], "liq") == 0){
-			SS_sf[iss]  = liq_c; 		}
-		else if (strcmp( gv.SS_list[iss], "mu")  == 0){
-			SS_sf[iss]  = mu_c; 		}
-		else if (strcmp( gv.SS_list[iss], "ol")  == 0){
-			SS_sf[iss]  = ol_c; 		}
-		else if (strcmp( gv.SS_list[iss], "opx") == 0){
-			SS_sf[iss]  = opx_c; 		}
-		else if (strcmp( gv.SS_list[iss], "pl4T") == 0){
-			SS_sf[iss]  = pl4T_c; 		}
-		else if (strcmp( gv.SS_list[iss], "spn") == 0){
-			SS_sf[iss]  = spn_c; 		}
-		else{
-			printf("\nsolid solution '%s' is not in the database, cannot be initiated\n", gv.SS_list[iss]);	
+void SS_sf_init_function(	const sf_jac_data 	**SS_sf,
+							global_variable 	*gv				){	
+
+	for (int iss = 0; iss < gv->len_ss; iss++){
+		SS_sf[iss] = SS_sf_jac_function(gv->SS_list[iss]);
+
+		if (SS_sf[iss] == NULL){
+			printf("\nsolid solution '%s' is not in the database, cannot be initiated\n", gv->SS_list[iss]);	
 		}	
 	};			
 }
 
 /**
-  Equality constraint for AUGLAG global minimization approach
+	sparse jacobian of the site-fraction constraints of a solution phase (sf_jacobian.c), NULL if the phase is not in the database
 */
-void GM_eq(unsigned l, double *result, unsigned n, const double *x, double *grad, void *GM_db){
-	global_min_data *d  = (global_min_data *)GM_db;
-	int ph, ss, sf, h, i, j, k, ix, iy, iz, sf_ok;
-		
-	double Gph, alpha;
-	
-	iy = 0;
-	/** loop through every non-zero components of the bulk-rock composition */
-	for (k = 0; k < d->z_b.nzEl_val; k++){
-		ix = 0;		
+const sf_jac_data *SS_sf_jac_function(	char 		*name 			){
+
+	if      (strcmp( name, "bi")  == 0 ){
+		return &bi_sf_jac; 		}
+	else if (strcmp( name, "cd")  == 0){
+		return &cd_sf_jac; 		}
+	else if (strcmp( name, "cpx") == 0){
+		return &cpx_sf_jac; 	}
+	else if (strcmp( name, "ep")  == 0){
+		return &ep_sf_jac; 		}
+	else if (strcmp( name, "fl")  == 0){
+		return &fl_sf_jac; 		}
+	else if (strcmp( name, "g")   == 0){
+		return &g_sf_jac; 		}
+	else if (strcmp( name, "hb")  == 0){
+		return &hb_sf_jac; 		}
+	else if (strcmp( name, "ilm") == 0){
+		return &ilm_sf_jac; 	}
+	else if (strcmp( name, "liq") == 0){
+		return &liq_sf_jac; 	}
+	else if (strcmp( name, "mu")  == 0){
+		return &mu_sf_jac; 		}
+	else if (strcmp( name, "ol")  == 0){
+		return &ol_sf_jac; 		}
+	else if (strcmp( name, "opx") == 0){
+		return &opx_sf_jac; 	}
+	else if (strcmp( name, "pl4T") == 0){
+		return &pl4T_sf_jac; 	}
+	else if (strcmp( name, "spn") == 0){
+		return &spn_sf_jac; 	}
+
+	return NULL;
+}
 
-		result[iy] = d->z_b.bulk_rock[d->z_b.nzEl_array[k]];
-		
-		/** loop through all the solution models considered in the assemblage */
-		for (i = 0; i < d->gv.n_cp_phase; i++){
-			ph 	  = d->gv.cp_id[i];
-			ss    = d->cp[ph].id;
-			
-			alpha = x[ix];
-			
-			/* get initial guess */
-			for (j = 0; j < d->cp[ph].n_xeos; j++){
-				d->SS_ref_db[ss].iguess[j] = x[ix+1+j];
-			}	
-			
-			/* retrieve phase data at given set of compositional variables */
-			Gph   = (*d->SS_objective[ss])(		 		 d->cp[ph].n_xeos,
-														 d->SS_ref_db[ss].iguess, 
-														 d->SS_ref_db[ss].dfx, 
-														&d->SS_ref_db[ss]				);
-			
-			for (j = 0; j < d->SS_ref_db[ss].n_em; j++){
-				result[iy] -= alpha*d->SS_ref_db[ss].p[j]*d->SS_ref_db[ss].Comp[j][d->z_b.nzEl_array[k]]*d->SS_ref_db[ss].factor*d->SS_ref_db[ss].z_em[j];
+/**
+	constant part of the jacobian: zeros and constant entries, the x-dependent entries are then written by s->jac
+*/
+void sf_jac_init(				const sf_jac_data 	*s,
+								double 				*grad 				){
+
+	memset(grad, 0, s->m*s->n*sizeof(double));
+	for (int k = 0; k < s->n_c; k++){
+		grad[s->c_i[k]] = s->c_v[k];
+	}
+}
+
+/**
+	site-fraction constraints with the sparse jacobian, data is the sf_jac_data of the phase. The gradient buffer of
+	NLopt is not kept between calls, so the constant part is written again, without the m x n explicit entries
+*/
+void SS_sf_sparse(				unsigned 			 m,
+								double 				*result,
+								unsigned 			 n,
+								const double 		*x,
+								double 				*grad,
+								void 				*data 				){
+	const sf_jac_data *s = (const sf_jac_data *) data;
+
+	s->sf(m, result, n, x, NULL, NULL);
+	if (grad){
+		sf_jac_init(s, grad);
+		s->jac(x, grad);
+	}
+}
+
+/**
+  evaluate the objective, the mass-balance residual and their analytic derivatives of the joint minimization at x,
+  stored in the buffers of GM_db such that the objective and the equality constraints share the evaluation. The
+  variables are, for each active solution phase, its fraction followed by its x-eos, then the fractions of the active
+  pure phases
+*/
+void GM_eval(		global_min_data 	*d,
+					const double 		*x		){
+	global_variable *gv = d->gv;
+	SS_ref 	*SS;
+	int 	 ph, ss, ox, nx, ix = 0;
+	unsigned n = d->n, l = d->l;
+	double 	 alpha, G, s, ds;
+
+	d->f = 0.0;
+	for (unsigned j = 0; j < n; j++){
+		d->grad[j] = 0.0;
+	}
+	for (unsigned k = 0; k < l; k++){
+		d->eq[k] = -d->z_b.bulk_rock[d->z_b.nzEl_array[k]];
+		for (unsigned j = 0; j < n; j++){
+			d->J_eq[k*n + j] = 0.0;
+		}
+	}
+
+	for (int i = 0; i < gv->n_cp_phase; i++){
+		ph 	  = gv->cp_id[i];
+		ss    = d->cp[ph].id;
+		SS 	  = &d->SS_ref_db[ss];
+		nx 	  = SS->n_xeos;
+		alpha = x[ix];
+
+		G 	  = (*d->SS_objective[ss])(nx, x + ix + 1, SS->dfx, SS);
+
+		d->f 		+= alpha*G;
+		d->grad[ix]  = G;
+		for (int j = 0; j < nx; j++){
+			d->grad[ix + 1 + j] = alpha*SS->dfx[j];
+		}
+
+		/* derivative of the normalization factor = fbc/sum_apep */
+		for (int j = 0; j < nx; j++){
+			d->dfac[j] = 0.0;
+			for (int m = 0; m < SS->n_em; m++){
+				d->dfac[j] += SS->ape[m]*SS->dp_dx[m][j];
 			}
-			
-			ix += d->SS_ref_db[ss].n_em;
-		}	
-		/** loop though pure phase */
-		for (i = 0; i < d->gv.n_pp_phase; i++){
-			ph 	  = d->gv.pp_id[i];
-			
-			alpha = x[ix];
-			
-			result[iy] -= alpha*d->PP_ref_db[ph].Comp[d->z_b.nzEl_array[k]]*d->PP_ref_db[ph].factor;
-			
-			ix += 1;
-			//Gph   = d->PP_ref_db[ph].gb_lvl;
+			d->dfac[j] *= -SS->factor/SS->sum_apep;
 		}
-		iy += 1;
+
+		/* composition of one unit of phase: factor*sum_m p_m Comp_m */
+		for (unsigned k = 0; k < l; k++){
+			ox = d->z_b.nzEl_array[k];
+			s  = 0.0;
+			for (int m = 0; m < SS->n_em; m++){
+				s += SS->Comp[m][ox]*SS->z_em[m]*SS->p[m];
+			}
+			d->eq[k] 			+= alpha*SS->factor*s;
+			d->J_eq[k*n + ix] 	 = SS->factor*s;
+			for (int j = 0; j < nx; j++){
+				ds = 0.0;
+				for (int m = 0; m < SS->n_em; m++){
+					ds += SS->Comp[m][ox]*SS->z_em[m]*SS->dp_dx[m][j];
+				}
+				d->J_eq[k*n + ix + 1 + j] = alpha*(SS->factor*ds + d->dfac[j]*s);
+			}
+		}
+		ix += nx + 1;
 	}
- 
-	
-	for (k = 0; k < d->z_b.nzEl_val; k++){
-		printf(" %+10f",result[k]);
+
+	for (int i = 0; i < gv->n_pp_phase; i++){
+		ph 	  = gv->pp_id[i];
+		alpha = x[ix];
+		G 	  = d->PP_ref_db[ph].gb_lvl*d->PP_ref_db[ph].factor;
+
+		d->f 		+= alpha*G;
+		d->grad[ix]  = G;
+		for (unsigned k = 0; k < l; k++){
+			ox = d->z_b.nzEl_array[k];
+			d->eq[k] 			+= alpha*d->PP_ref_db[ph].Comp[ox]*d->PP_ref_db[ph].factor;
+			d->J_eq[k*n + ix] 	 = d->PP_ref_db[ph].Comp[ox]*d->PP_ref_db[ph].factor;
+		}
+		ix += 1;
 	}
-	printf("\n");
-    return;
+
+	for (unsigned j = 0; j < n; j++){
+		d->x_eval[j] = x[j];
+	}
+	d->valid 	= 1;
+	d->n_eval  += 1;
 };
 
 /**
-  Sets inequality constraints for the global minimization approach
+  evaluate the joint minimization at x, unless x is the point of the last evaluation
+*/
+void GM_update(		global_min_data 	*d,
+					const double 		*x		){
+	if (d->valid == 0 || memcmp(x, d->x_eval, d->n*sizeof(double)) != 0){
+		GM_eval(d, x);
+	}
+};
+
+/**
+  mass-balance equality constraints of the joint minimization, with their analytic Jacobian (l x n)
+*/
+void GM_eq(unsigned l, double *result, unsigned n, const double *x, double *grad, void *GM_db){
+	global_min_data *d  = (global_min_data *)GM_db;
+
+	GM_update(d, x);
+	for (unsigned k = 0; k < l; k++){
+		result[k] = d->eq[k];
+	}
+	if (grad){
+		for (unsigned k = 0; k < l*n; k++){
+			grad[k] = d->J_eq[k];
+		}
+	}
+};
+
+/**
+  site-fraction inequality constraints of the joint minimization, the Jacobian of every phase is scattered in its
+  x-eos columns (m x n)
 */
 void GM_ineq(unsigned m, double *result, unsigned n, const double *x, double *grad, void *GM_db){
 	global_min_data *d  = (global_min_data *)GM_db;
-	int ph, ss, sf, i, j, k, ix, iy, iz, sf_ok;
-		
-	ix 		  = 0;
-	iy		  = 0;
-	iz		  = 0;
-	for (i = 0; i < d->gv.n_cp_phase; i++){
-		ph 	  = d->gv.cp_id[i];
-		ss    = d->cp[ph].id;
-		
-		for (j = 0; j < d->SS_ref_db[ss].n_xeos; j++){
-			//d->SS_ref_db[ss].iguess[j] = x[ix+1+j];
-			d->SS_ref_db[ss].iguess[j] = x[ix+j];
-		}	
+	SS_ref 	*SS;
+	int 	 ph, ss, nx, ix = 0, iy = 0;
 
-		(*d->SS_sf[ss])(		d->SS_ref_db[ss].n_sf, 
-								d->SS_ref_db[ss].sf, 
-								d->SS_ref_db[ss].n_xeos, 
-								d->SS_ref_db[ss].iguess, 
-								d->SS_ref_db[ss].dsf, 
-								NULL							);
-								
-		for (j = 0; j < d->SS_ref_db[ss].n_sf; j++){
-			result[iy] = d->SS_ref_db[ss].sf[j];
-			iy        += 1;
+	if (grad){
+		for (unsigned k = 0; k < m*n; k++){
+			grad[k] = 0.0;
 		}
-		
+	}
+	for (int i = 0; i < d->gv->n_cp_phase; i++){
+		ph 	= d->gv->cp_id[i];
+		ss  = d->cp[ph].id;
+		SS 	= &d->SS_ref_db[ss];
+		nx 	= SS->n_xeos;
+
+		d->SS_sf[ss]->sf(SS->n_sf, result + iy, nx, x + ix + 1, NULL, NULL);
+
+		/* only the non-zero entries are scattered, the x-dependent ones through dsf */
 		if (grad){
-			sf    = 0;													//increment for site fraction index
-			//iz 	 += 1;		
-			for (j = 0; j < d->SS_ref_db[ss].n_sf; j++){
-				for (k = 0; k < d->SS_ref_db[ss].n_xeos; k++){	
-					grad[iz+k] = d->SS_ref_db[ss].dsf[sf];
-					sf   += 1;
-				}
-				iz		 += n;
+			const sf_jac_data *s = d->SS_sf[ss];
+			for (int k = 0; k < s->n_c; k++){
+				grad[(iy + s->c_i[k]/nx)*n + ix + 1 + s->c_i[k]%nx] = s->c_v[k];
+			}
+			s->jac(x + ix + 1, SS->dsf);
+			for (int k = 0; k < s->n_v; k++){
+				grad[(iy + s->v_i[k]/nx)*n + ix + 1 + s->v_i[k]%nx] = SS->dsf[s->v_i[k]];
 			}
-			iz		 += d->SS_ref_db[ss].n_xeos;
 		}
-		
-		//ix += d->SS_ref_db[ss].n_em;
-		ix += d->SS_ref_db[ss].n_xeos;
+		iy += SS->n_sf;
+		ix += nx + 1;
 	}
-
-    return;
 };
 
 /** 
-  objective function constructor for generalized iminization with Augmented Lagrangian approach
+  objective function of the joint minimization: G of the assemblage with the solution phases rotated on the current
+  G-hyperplane, which differs from G by a constant when the mass balance holds
 */
 double GM_obj(		unsigned  		 n, 
 					const double 	*x, 
@@ -1455,871 +1591,901 @@ double GM_obj(		unsigned  		 n,
 					void 			*GM_db		)
 {			
 	global_min_data *d  = (global_min_data *)GM_db;
-	int ph, ss, i, j, ix, sf_ok;
-	
-	double Gsys = 0.0;
-	double Gph, alpha;
-	ix 		  = 0;
-	for (i = 0; i < d->gv.n_cp_phase; i++){
-		ph 	  = d->gv.cp_id[i];
-		ss    = d->cp[ph].id;
 
-		//alpha = x[ix];
-		alpha = d->cp[ph].ss_n;
-		
-		for (j = 0; j < d->cp[ph].n_xeos; j++){
-			//d->SS_ref_db[ss].iguess[j] = x[ix+1+j];
-			d->SS_ref_db[ss].iguess[j] = x[ix+j];
-		}	
-		
-		Gph   = (*d->SS_objective[ss])(		 		 d->cp[ph].n_xeos,
-													 d->SS_ref_db[ss].iguess, 
-													 d->SS_ref_db[ss].dfx, 
-													&d->SS_ref_db[ss]				);
-		Gsys += alpha*Gph;
-		
-		printf(" [%4s %+12.5f %+12.5f]",d->gv.SS_list[ss],Gph,alpha);
-		
-		sf_ok = 1;
-		for (j = 0; j < d->cp[ph].n_sf; j++){
-			if (d->SS_ref_db[ss].sf[j] < 0.0){ sf_ok = 0;};
-		}
-		printf("SFOK? %d |",sf_ok);
-		for (j = 0; j < d->cp[ph].n_xeos; j++){
-			printf(" %+12.5f",d->SS_ref_db[ss].iguess[j]);
-		}
-		printf("\n");
-		
-		if (grad){
-			//grad[ix] = Gph;
-			//ix 		+= 1;
-			for (j = 0; j < d->cp[ph].n_xeos; j++){
-				grad[ix] = alpha*d->SS_ref_db[ss].dfx[j];
-				ix      += 1;
-			}
+	GM_update(d, x);
+	if (grad){
+		for (unsigned j = 0; j < n; j++){
+			grad[j] = d->grad[j];
 		}
 	}
+	return d->f;
+};
 
-	//for (i = 0; i < d->gv.n_pp_phase; i++){
-		//ph 	  = d->gv.pp_id[i];
-		
-		//alpha = x[ix];
-		
-		//Gph   = d->PP_ref_db[ph].gb_lvl;
-		//Gsys += Gph*alpha;
-		//printf(" [%4s %+12.5f %+12.5f]\n",d->gv.PP_list[ph],Gph,x[ix]);
-		//if (grad){
-			//grad[ix] = Gph;
-			//ix 		+= 1;
-		//}
-	//}
-	
-	//for (i = 0; i < n; i++){
-		//printf(" %+10f",grad[i]);
-	//}
-	printf(" Gsys: %+12.5f\n",Gsys);
+/**
+  allocate the data and buffers of the joint minimization, sized from the largest assemblage (len_ox phases)
+*/
+void NLopt_global_opt_init(		global_variable 	*gv 				){
+	global_min_data *d = malloc (sizeof(global_min_data));
+	int 	n_max 	   = gv->ws.n_x_max;
+
+	d->gv 			= gv;
+	d->SS_objective = malloc (gv->len_ss 			* sizeof(obj_type));
+	d->SS_sf 		= malloc (gv->len_ss 			* sizeof(sf_jac_data *));
+	d->x_eval 		= malloc (n_max 				* sizeof(double));
+	d->grad 		= malloc (n_max 				* sizeof(double));
+	d->dfac 		= malloc (n_max 				* sizeof(double));
+	d->eq 			= malloc (gv->len_ox 			* sizeof(double));
+	d->J_eq 		= malloc (gv->len_ox*n_max 		* sizeof(double));
+	d->opt 			= NULL;
+	d->n 			= 0;
+	d->m 			= 0;
+	d->l 			= 0;
+
+	SS_objective_init_function(			d->SS_objective,
+										gv				);
 
-	return Gsys;
+	SS_sf_init_function(				d->SS_sf,
+										gv				);
+	gv->GM_db 		= d;
 };
 
+/**
+  release the data and the optimizer of the joint minimization
+*/
+void NLopt_global_opt_destroy(	global_variable 	*gv 				){
+	global_min_data *d = (global_min_data *)gv->GM_db;
+
+	if (d == NULL){
+		return;
+	}
+	if (d->opt != NULL){
+		nlopt_destroy(d->opt);
+	}
+	free(d->SS_objective);
+	free(d->SS_sf);
+	free(d->x_eval);
+	free(d->grad);
+	free(d->dfac);
+	free(d->eq);
+	free(d->J_eq);
+	free(d);
+	gv->GM_db = NULL;
+};
 
 /** 
-	global minimization given fixed phase assemblage
+	joint minimization of the x-eos and fractions of the active phases (given assemblage), with the mass balance as
+	equality constraints (SLSQP), used to polish the assemblage near convergence (--PGE_gm=1)
 	n: number of variables in the objective function (phase fractions + compositional variables)
 	m: number of inequality constraints (site-fractions)
 	l: number of equality constraints (active number of components)
+
+	The optimizer is kept as long as n, m and l do not change. The result is accepted when the site fractions are
+	respected and the mass-balance residual is lower than BR_norm, the fractions and x-eos of the active phases are
+	then updated
 */
-global_variable NLopt_global_opt_function(	struct bulk_info 	z_b,
-											global_variable 	 gv, 
-											PP_ref 				*PP_ref_db,
-											SS_ref 				*SS_ref_db,
-	 										csd_phase_set  		*cp
+void NLopt_global_opt_function(	struct bulk_info 	z_b,
+								global_variable 	*gv, 
+								PP_ref 				*PP_ref_db,
+								SS_ref 				*SS_ref_db,
+								csd_phase_set  		*cp
 ){
-	int ph, ss, i, j; 
+	int 	 ph, ss, i, j, ok, status; 
     unsigned int n, m, l, ix;
-    
-	/**
-	   create objective function array to be send to NLopt
-	*/
-	obj_type 		SS_objective[gv.len_ss];
-	sf_type 		SS_sf[gv.len_ss];
-	
-	SS_objective_init_function(			SS_objective,
-										gv				);
+	double 	 minf, res;
+	double 	 t = batch_wtime();
 
-	SS_sf_init_function(				SS_sf,
-										gv				);
+	if (gv->GM_db == NULL){
+		NLopt_global_opt_init(gv);
+	}
+	global_min_data *d = (global_min_data *)gv->GM_db;
+
+	d->z_b 			= z_b;
+	d->PP_ref_db 	= PP_ref_db;
+	d->SS_ref_db 	= SS_ref_db;
+	d->cp 			= cp;
+	d->valid 		= 0;
+	d->n_eval 		= 0;
 
-	/** create and fill data structure to be send to the objective function */								
-	global_min_data GM_db;
-	
-	GM_db.gv 			= gv;
-	GM_db.z_b			= z_b;
-	GM_db.SS_objective 	= SS_objective;
-	GM_db.SS_sf  	 	= SS_sf;
-	GM_db.PP_ref_db 	= PP_ref_db;
-	GM_db.SS_ref_db 	= SS_ref_db;
-	GM_db.cp 			= cp;
-	
 	/** get id of active phases */
-	//gv = get_pp_id(			gv					);
-	
-	gv = get_ss_id(			gv,
-							cp					);
-	
-	//n  = gv.n_pp_phase;
-	n = 0;	
-	for (i = 0; i < gv.n_cp_phase; i++){
-		ph  = gv.cp_id[i]; 
-		//n  += cp[ph].n_em;
-		n  += cp[ph].n_xeos;
+	get_pp_id(			gv					);
+	get_ss_id(			gv,
+						cp					);
+
+	n = gv->n_pp_phase;
+	m = 0;
+	for (i = 0; i < gv->n_cp_phase; i++){
+		ph  = gv->cp_id[i]; 
+		n  += cp[ph].n_xeos + 1;
+		m  += cp[ph].n_sf;
 	}
 
 	/** get the number of equality constraints */
 	l = z_b.nzEl_val;
 	
-	/** declare solution array 2BM */    
-	double x[n]; 
-	double lb[n]; 
-	double ub[n]; 
+	/** solution array and bounds (workspace) */    
+	double *x  		= gv->ws.x; 
+	double *lb 		= gv->ws.lb; 
+	double *ub 		= gv->ws.ub; 
+	double *tol_sf 	= gv->ws.tol_sf;
+	double *tol_eq 	= gv->ws.tol_eq;
 
 	/**	initialize x array */
 	ix = 0;
-	m  = 0;
-	for (i = 0; i < gv.n_cp_phase; i++){
-		ph     = gv.cp_id[i]; 
+	for (i = 0; i < gv->n_cp_phase; i++){
+		ph     = gv->cp_id[i]; 
 		ss	   = cp[ph].id;
-		m 	  += cp[ph].n_sf;
-
-		SS_ref_db[ss] = rotate_hyperplane(	gv, 
-											SS_ref_db[ss]	);
-											
-		//x[ix]  = cp[ph].ss_n;
-		//lb[ix] = 0.0;
-		//ub[ix] = 1.0;
-		
-		//ix    += 1;
+
+		rotate_hyperplane(	gv, 
+							&SS_ref_db[ss]	);
+
+		x[ix]  = cp[ph].ss_n;
+		lb[ix] = 0.0;
+		ub[ix] = 1.0;
+		ix    += 1;
 		for (j = 0; j < SS_ref_db[ss].n_xeos; j++){
-			x[ix]  = cp[ph].xeos[j];
-			
 			lb[ix] = SS_ref_db[ss].box_bounds_default[j][0];
 			ub[ix] = SS_ref_db[ss].box_bounds_default[j][1];
+			x[ix]  = fmin(fmax(cp[ph].xeos[j], lb[ix]), ub[ix]);
 			ix    += 1;
 		}
 	}
-	//for (i = 0; i < gv.n_pp_phase; i++){
-		//ph     = gv.pp_id[i];
-		//x[ix]  = gv.pp_n[ph];
-		//lb[ix] = 0.0;
-		//ub[ix] = 1.0;
-		//ix    += 1;
-	//}
-
-	double tol_sf[m];
-	for (i = 0; i < m; i++){
-		tol_sf[i] = 0.0;
+	for (i = 0; i < gv->n_pp_phase; i++){
+		ph     = gv->pp_id[i];
+		x[ix]  = gv->pp_n[ph];
+		lb[ix] = 0.0;
+		ub[ix] = 1.0;
+		ix    += 1;
 	}
 
-	double tol_eq[l];
-	for (i = 0; i < l; i++){
-		tol_eq[i] = 1e-8;
+	/** optimizer of the current problem size, the constraints read the assemblage from GM_db */
+	if (d->opt == NULL || d->n != n || d->m != m || d->l != l){
+		if (d->opt != NULL){
+			nlopt_destroy(d->opt);
+		}
+		for (i = 0; i < m; i++){
+			tol_sf[i] = gv->ineq_res;
+		}
+		for (i = 0; i < l; i++){
+			tol_eq[i] = 0.1*gv->br_max_tol;
+		}
+		d->opt 	= nlopt_create(NLOPT_LD_SLSQP, n);
+		d->n 	= n;
+		d->m 	= m;
+		d->l 	= l;
+		nlopt_set_min_objective(d->opt, GM_obj, d);
+		nlopt_add_equality_mconstraint(d->opt, l, GM_eq, d, tol_eq);
+		nlopt_add_inequality_mconstraint(d->opt, m, GM_ineq, d, tol_sf);
+		nlopt_set_ftol_rel(d->opt, gv->obj_tol);
+	}
+	nlopt_set_lower_bounds(d->opt, lb);
+	nlopt_set_upper_bounds(d->opt, ub);
+	nlopt_set_maxeval(d->opt, gv->GM_maxeval);
+
+	status = nlopt_optimize(d->opt, x, &minf);
+
+	/** accept the solution if the site fractions hold and the mass balance improved */
+	ok = 0;
+	if (status > 0){
+		GM_update(d, x);
+		res = norm_vector(d->eq, l);
+
+		/* tol_sf was copied by NLopt, it receives the site-fraction constraints */
+		GM_ineq(m, tol_sf, n, x, NULL, d);
+		ok 	= (res < gv->BR_norm) ? 1 : 0;
+		for (i = 0; i < m; i++){
+			if (tol_sf[i] > 0.0 || isnan(tol_sf[i])){ ok = 0; }
+		}
 	}
-   
-   
-	//double minf;
-
-	//nlopt_opt opt_auglag = nlopt_create(NLOPT_AUGLAG, n);
-	//nlopt_set_lower_bounds(opt_auglag, lb);
-	//nlopt_set_upper_bounds(opt_auglag, ub);
-	//nlopt_set_min_objective(opt_auglag, GM_obj, &GM_db);
-	//nlopt_add_equality_mconstraint(opt_auglag, l, GM_eq, &GM_db, tol_eq);
-	//nlopt_add_inequality_mconstraint(opt_auglag, m, GM_ineq, &GM_db, tol_sf);
-	//nlopt_set_ftol_rel(opt_auglag, gv.obj_tol);
-	//nlopt_set_maxeval(opt_auglag, 0);
-
-	//nlopt_opt opt = nlopt_create(NLOPT_LD_CCSAQ, n);
-	//nlopt_set_lower_bounds(opt, lb);
-	//nlopt_set_upper_bounds(opt, ub);
-	//nlopt_set_min_objective(opt, GM_obj, &GM_db);
-
-	//nlopt_set_ftol_rel(opt, gv.obj_tol);
-	//nlopt_set_maxeval(opt, 0);
-
-	//nlopt_set_local_optimizer(opt_auglag, opt);
-	
-	//int status = nlopt_optimize(opt_auglag, x, &minf);
-	//printf("Solution of global minimization: %+10f, status %d\n",minf,status);
-	//for (i = 0; i < n; i++){
-		//printf(" %+10f",x[i]);
-	//}
-	//printf("\n");
-
-	//nlopt_destroy(opt_auglag);
-	//nlopt_destroy(opt);
-	
-	
-	
 
-	nlopt_opt opt = nlopt_create(NLOPT_LD_CCSAQ, n);
-	nlopt_set_lower_bounds(opt, lb);
-	nlopt_set_upper_bounds(opt, ub);
-	nlopt_set_min_objective(opt, GM_obj, &GM_db);
-	nlopt_add_inequality_mconstraint(opt, m, GM_ineq, &GM_db, tol_sf);
-	//nlopt_add_equality_mconstraint(opt, l, GM_eq,   &GM_db, tol_eq);
-	nlopt_set_ftol_rel(opt, gv.obj_tol);
-	nlopt_set_maxeval(opt, 0);
+	/** the phases are evaluated at their new x-eos, and minimized again at the next local minimization */
+	if (ok == 1){
+		ix = 0;
+		for (i = 0; i < gv->n_cp_phase; i++){
+			ph     			= gv->cp_id[i]; 
+			ss 				= cp[ph].id;
+			cp[ph].ss_n 	= x[ix];
+			ix 			   += 1;
+			for (j = 0; j < cp[ph].n_xeos; j++){
+				SS_ref_db[ss].iguess[j] = x[ix];
+				ix 			  		   += 1;
+			}
 
-	//nlopt_set_maxeval(opt, gv.maxeval);
+			PC_function(			gv,
+									&SS_ref_db[ss], 
+									z_b,
+									gv->SS_list[ss] 			);
 
-	double minf;
-	int status = nlopt_optimize(opt, x, &minf);
-	
-	printf("Solution of global minimization: %+10f, status %d\n",minf,status);
-	for (i = 0; i < n; i++){
-		printf(" %+10f",x[i]);
+			SS_UPDATE_function(		gv, 
+									&SS_ref_db[ss], 
+									z_b, 
+									gv->SS_list[ss]				);
+
+			SS_to_cp(				gv,
+									&SS_ref_db[ss],
+									&cp[ph] 					);
+			cp[ph].min_stable 	= 0;
+		}
+		for (i = 0; i < gv->n_pp_phase; i++){
+			gv->pp_n[gv->pp_id[i]] = x[ix];
+			ix 			  += 1;
+		}
 	}
-	printf("\n");
 
-	nlopt_destroy(opt);
+	gv->GM_n_eval 	= d->n_eval;
+	gv->GM_status 	= (ok == 1) ? status : -status;
+	gv->GM_time 	= (batch_wtime() - t)*1000.0;
 
+	if (gv->verbose == 1){
+		printf("\n Joint minimization of the assemblage: %s (status %d, %d evaluations, %.3f ms)\n", (ok == 1) ? "accepted" : "rejected", status, d->n_eval, gv->GM_time);
+		printf(" G-hyperplane distance %+10f, mass-balance residual %+10e (BR_norm %+10e)\n\n", minf, (status > 0) ? res : 0.0, gv->BR_norm);
+	}
+};
 
-	return gv;
-}
+/**
+  early exit test of an on-hold phase at an evaluated x-eos (objective f, gradient g, site fractions of the evaluation),
+  only feasible x-eos are considered: 2 when the objective is below -LM_ee_lo (the phase will be reintroduced), 1 when
+  the first-order estimate of the minimum of the objective over the box is above LM_ee_hi, 0 otherwise.
+  The second exit is a heuristic: the estimate is a lower bound only where G is convex over the box, which does not hold
+  for the solution models with positive Margules terms (solvus), so it is disabled for the phases of --solvus_ms
+  (LM_ee_hi = INFINITY, see NLopt_opt_function)
+*/
+int LM_early_exit(				SS_ref 				*SS_ref_db,
+								unsigned 			 n,
+								const double 		*x,
+								const double 		*g,
+								double 				 f 					){
+	double f_lb = f;
+
+	for (int j = 0; j < SS_ref_db->n_sf; j++){
+		if (!(SS_ref_db->sf[j] >= 0.0)){
+			return 0;
+		}
+	}
+	if (f < -SS_ref_db->LM_ee_lo){
+		SS_ref_db->LM_ee_exit = 2;
+		return 2;
+	}
+	if (g != NULL){
+		for (unsigned j = 0; j < n; j++){
+			f_lb += fmin(g[j]*(SS_ref_db->lb[j] - x[j]), g[j]*(SS_ref_db->ub[j] - x[j]));
+		}
+		if (f_lb > SS_ref_db->LM_ee_hi){
+			SS_ref_db->LM_ee_exit = 1;
+			return 1;
+		}
+	}
+	return 0;
+};
 
-SS_ref NLopt_opt_bi_function(global_variable gv, SS_ref SS_ref_db){
+/**
+  objective function given to NLopt: counts the evaluations and stops the optimizer on an early exit
+*/
+double NLopt_obj_wrap(			unsigned 			 n,
+								const double 		*x,
+								double 				*grad,
+								void 				*SS_ref_db 			){
+	SS_ref *d = (SS_ref *) SS_ref_db;
+	double 	f = d->LM_obj(n, x, grad, SS_ref_db);
+
+	d->n_eval += 1;
+	if (d->LM_ee == 1 && LM_early_exit(d, n, x, grad, f) != 0){
+		nlopt_force_stop(d->opt);
+	}
+	return f;
+};
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+/**
+  set the objective function of solution phase SS_ref_db, through NLopt_obj_wrap
+*/
+void NLopt_set_objective(		SS_ref 				*SS_ref_db,
+								obj_type 			 obj 				){
+	SS_ref_db->LM_obj = obj;
+	nlopt_set_min_objective(SS_ref_db->opt, NLopt_obj_wrap, SS_ref_db);
+};
+
+/**
+  create the CCSAQ optimizer of solution phase index, with its site-fraction inequality constraints and tolerance
+*/
+nlopt_opt NLopt_opt_create(		global_variable 	*gv,
+								SS_ref 				*SS_ref_db,
+								int 				index				){
+
+	nlopt_opt opt = nlopt_create(NLOPT_LD_CCSAQ, (SS_ref_db->n_xeos));
+	nlopt_add_inequality_mconstraint(opt, SS_ref_db->n_sf, SS_sf_sparse, (void *) SS_sf_jac_function(gv->SS_list[index]), SS_ref_db->tol_sf);
+	nlopt_set_ftol_rel(opt, gv->obj_tol);
+
+	return opt;
+};
+
+/**
+  pool of optimizers, one per solution phase and per context (SS_ref_db.opt). The constraints and tolerance are set once,
+  each local minimization only updates the bounds, maxeval and the objective data pointer (the SS_ref_db entry of the phase)
+*/
+void NLopt_opt_init(			global_variable 	*gv,
+								SS_ref 			   *SS_ref_db			){
+
+	for (int i = 0; i < gv->len_ss; i++){
+		SS_ref_db[i].opt = NLopt_opt_create(	gv,
+												&SS_ref_db[i],
+												i					);
+	}
+};
+
+/**
+  release the optimizers of the solution phases
+*/
+void NLopt_opt_destroy(			global_variable 	*gv,
+								SS_ref 			   *SS_ref_db			){
+
+	for (int i = 0; i < gv->len_ss; i++){
+		nlopt_destroy(SS_ref_db[i].opt);
+		SS_ref_db[i].opt = NULL;
+	}
+};
+
+void NLopt_opt_bi_function(global_variable *gv, SS_ref *SS_ref_db){
+
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
     
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n));
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_bi, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, bi_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_bi);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_bi(n, x, NULL, &SS_ref_db); 
+     minf = obj_bi(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
   
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_cd_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_cd_function(global_variable *gv, SS_ref *SS_ref_db){
 
-	int    n_em     = SS_ref_db.n_em;
- 	unsigned int n  = SS_ref_db.n_xeos;	
- 	unsigned int m  = SS_ref_db.n_sf;	
+	int    n_em     = SS_ref_db->n_em;
+ 	unsigned int n  = SS_ref_db->n_xeos;	
    
-	double *x  = SS_ref_db.iguess;   
+	double *x  = SS_ref_db->iguess;   
 
-	for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-		SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-		SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];		
+	for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+		SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+		SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];		
 	}
 	
-    SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-	nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-	nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-	nlopt_set_min_objective(SS_ref_db.opt, obj_cd, &SS_ref_db);
-    nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, cd_c, NULL, SS_ref_db.tol_sf);
-	nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-    nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+	nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+	nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+	NLopt_set_objective(SS_ref_db, obj_cd);
+    nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
 	double minf;
-	if (gv.maxeval==1){  
+	if (gv->maxeval==1){  
           // we are only interested in evaluating the objective function  
-          minf = obj_cd(n, x, NULL, &SS_ref_db); 
+          minf = obj_cd(n, x, NULL, SS_ref_db); 
      }
      else{
           // do optimization
-          SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+          SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
      }
 
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_cpx_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_cpx_function(global_variable *gv, SS_ref *SS_ref_db){
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
    
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
    
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_cpx, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, cpx_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_cpx);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_cpx(n, x, NULL, &SS_ref_db); 
+     minf = obj_cpx(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_ep_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_ep_function(global_variable *gv, SS_ref *SS_ref_db){
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_ep, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, ep_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_ep);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_ep(n, x, NULL, &SS_ref_db); 
+     minf = obj_ep(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_fl_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_fl_function(global_variable *gv, SS_ref *SS_ref_db){
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_fl, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, fl_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_fl);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_fl(n, x, NULL, &SS_ref_db); 
+     minf = obj_fl(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_g_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_g_function(global_variable *gv, SS_ref *SS_ref_db){
     
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_g, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, g_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_g);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_g(n, x, NULL, &SS_ref_db); 
+     minf = obj_g(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-	
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_hb_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_hb_function(global_variable *gv, SS_ref *SS_ref_db){
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_hb, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, hb_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_hb);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_hb(n, x, NULL, &SS_ref_db); 
+     minf = obj_hb(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
   
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_ilm_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_ilm_function(global_variable *gv, SS_ref *SS_ref_db){
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_ilm, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, ilm_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_ilm);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_ilm(n, x, NULL, &SS_ref_db); 
+     minf = obj_ilm(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_liq_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_liq_function(global_variable *gv, SS_ref *SS_ref_db){
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
    
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
    
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
 
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_liq, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, liq_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_liq);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_liq(n, x, NULL, &SS_ref_db); 
+     minf = obj_liq(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_mu_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_mu_function(global_variable *gv, SS_ref *SS_ref_db){
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_mu, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, mu_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_mu);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_mu(n, x, NULL, &SS_ref_db); 
+     minf = obj_mu(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_ol_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_ol_function(global_variable *gv, SS_ref *SS_ref_db){
    
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_ol, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, ol_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_ol);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_ol(n, x, NULL, &SS_ref_db); 
+     minf = obj_ol(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
 
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-  
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_opx_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_opx_function(global_variable *gv, SS_ref *SS_ref_db){
     
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_opx, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, opx_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_opx);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_opx(n, x, NULL, &SS_ref_db); 
+     minf = obj_opx(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
 
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-  
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_pl4T_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_pl4T_function(global_variable *gv, SS_ref *SS_ref_db){
    
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n)); 
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_pl4T, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, pl4T_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_pl4T);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_pl4T(n, x, NULL, &SS_ref_db); 
+     minf = obj_pl4T(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i] = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i] = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-  
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 
-SS_ref NLopt_opt_spn_function(global_variable gv, SS_ref SS_ref_db){
+void NLopt_opt_spn_function(global_variable *gv, SS_ref *SS_ref_db){
 
-   int    n_em     = SS_ref_db.n_em;
-   unsigned int n  = SS_ref_db.n_xeos;
-   unsigned int m  = SS_ref_db.n_sf;
+   int    n_em     = SS_ref_db->n_em;
+   unsigned int n  = SS_ref_db->n_xeos;
 
-   double *x  = SS_ref_db.iguess; 
+   double *x  = SS_ref_db->iguess; 
 
-   for (int i = 0; i < (SS_ref_db.n_xeos); i++){
-      SS_ref_db.lb[i] = SS_ref_db.box_bounds[i][0];
-      SS_ref_db.ub[i] = SS_ref_db.box_bounds[i][1];
+   for (int i = 0; i < (SS_ref_db->n_xeos); i++){
+      SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+      SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
    }
    
-   SS_ref_db.opt = nlopt_create(NLOPT_LD_CCSAQ, (n));
-   nlopt_set_lower_bounds(SS_ref_db.opt, SS_ref_db.lb);
-   nlopt_set_upper_bounds(SS_ref_db.opt, SS_ref_db.ub);
-   nlopt_set_min_objective(SS_ref_db.opt, obj_spn, &SS_ref_db);
-   nlopt_add_inequality_mconstraint(SS_ref_db.opt, m, spn_c, NULL, SS_ref_db.tol_sf);
-   nlopt_set_ftol_rel(SS_ref_db.opt, gv.obj_tol);
-   nlopt_set_maxeval(SS_ref_db.opt, gv.maxeval);
+   nlopt_set_lower_bounds(SS_ref_db->opt, SS_ref_db->lb);
+   nlopt_set_upper_bounds(SS_ref_db->opt, SS_ref_db->ub);
+   NLopt_set_objective(SS_ref_db, obj_spn);
+   nlopt_set_maxeval(SS_ref_db->opt, gv->maxeval);
    
    double minf;
 
-   if (gv.maxeval==1){  
+   if (gv->maxeval==1){  
      // we are only interested in evaluating the objective function  
-     minf = obj_spn(n, x, NULL, &SS_ref_db); 
+     minf = obj_spn(n, x, NULL, SS_ref_db); 
    }
    else{
      // do optimization
-     SS_ref_db.status = nlopt_optimize(SS_ref_db.opt, x, &minf);
+     SS_ref_db->status = nlopt_optimize(SS_ref_db->opt, x, &minf);
    }
    
    /* Send back needed local solution parameters */
-   for (int i = 0; i < SS_ref_db.n_xeos; i++){
-      SS_ref_db.xeos[i]   = x[i];
+   for (int i = 0; i < SS_ref_db->n_xeos; i++){
+      SS_ref_db->xeos[i]   = x[i];
    }
  
-   SS_ref_db.df   = minf;
-   nlopt_destroy(SS_ref_db.opt);
-  	
-   return SS_ref_db;
+   SS_ref_db->df   = minf;
 };
 /** 
   attributes the right solution phase to the solution phase array and calculates xi
 */
-SS_ref NLopt_opt_function(		global_variable gv,
-								SS_ref 			SS_ref_db, 
+void NLopt_opt_function(		global_variable *gv,
+								SS_ref 			*SS_ref_db, 
 								int     		index			){
 								
-	clock_t t; 
-	t = clock();
-
-	/* Associate the right solid-solution data */
-	if 		(strcmp( gv.SS_list[index], "bi") == 0 ){
-		SS_ref_db  = NLopt_opt_bi_function( gv, SS_ref_db);	}
-	else if (strcmp( gv.SS_list[index], "cd")  == 0){
-		SS_ref_db  = NLopt_opt_cd_function( gv, SS_ref_db);	}
-	else if (strcmp( gv.SS_list[index], "cpx") == 0){
-		SS_ref_db  = NLopt_opt_cpx_function( gv, SS_ref_db);}	
-	else if (strcmp( gv.SS_list[index], "ep")  == 0){
-		SS_ref_db  = NLopt_opt_ep_function( gv, SS_ref_db);	}
-	else if (strcmp( gv.SS_list[index], "fl")  == 0){
-		SS_ref_db  = NLopt_opt_fl_function( gv, SS_ref_db);	}		
-	else if (strcmp( gv.SS_list[index], "g")   == 0){
-		SS_ref_db  = NLopt_opt_g_function(  gv, SS_ref_db);	}
-	else if (strcmp( gv.SS_list[index], "hb")  == 0){
-		SS_ref_db  = NLopt_opt_hb_function( gv, SS_ref_db);	}	
-	else if (strcmp( gv.SS_list[index], "ilm") == 0){
-		SS_ref_db  = NLopt_opt_ilm_function( gv, SS_ref_db);}
-	else if (strcmp( gv.SS_list[index], "liq") == 0){
-		SS_ref_db  = NLopt_opt_liq_function( gv, SS_ref_db);}
-	else if (strcmp( gv.SS_list[index], "mu")  == 0){
-		SS_ref_db  = NLopt_opt_mu_function( gv, SS_ref_db);	}	
-	else if (strcmp( gv.SS_list[index], "ol")  == 0){
-		SS_ref_db  = NLopt_opt_ol_function( gv, SS_ref_db);	}
-	else if (strcmp( gv.SS_list[index], "opx") == 0){
-		SS_ref_db  = NLopt_opt_opx_function( gv, SS_ref_db);}	
-	else if (strcmp( gv.SS_list[index], "pl4T")  == 0){
-		SS_ref_db  = NLopt_opt_pl4T_function( gv, SS_ref_db);	}	
-	else if (strcmp( gv.SS_list[index], "spn") == 0){
-		SS_ref_db  = NLopt_opt_spn_function( gv, SS_ref_db);	
-		}
-	else{
-		printf("\nsolid solution '%s index %d' is not in the database\n",gv.SS_list[index], index);	}	
+	double t = batch_wtime();
+
+	SS_ref_db->n_eval 		= 0;
+	SS_ref_db->LM_ee_exit 	= 0;
+	SS_ref_db->LM_ee_hi 	= (gv->ms_ss[index] == 1) ? INFINITY : gv->LM_ee_hi;
+	SS_ref_db->LM_ee_lo 	= gv->LM_ee_lo;
+
+	/* --LM_pool=0: optimizer created for this call only (as done before the pool, for benchmarking) */
+	nlopt_opt opt_pool = SS_ref_db->opt;
+	if (gv->LM_pool == 0){
+		SS_ref_db->opt = NLopt_opt_create(gv, SS_ref_db, index);
+	}
+
+	/* in-house SQP solver of the selected phases, NLopt is used when it fails (negative status) */
+	SS_ref_db->status = NLOPT_FAILURE;
+	if (gv->LM_sqp[index] == 1 && gv->maxeval != 1){
+		SQP_opt_function(	gv,
+							SS_ref_db,
+							SS_objective_function(gv->SS_list[index]),
+							(gv->LM_hess == 1) ? SS_hessian_function(gv->SS_list[index]) : NULL,
+							SS_sf_jac_function(gv->SS_list[index])		);
+	}
+
+	if (SS_ref_db->status < 0){
+		/* Associate the right solid-solution data */
+		if 		(strcmp( gv->SS_list[index], "bi") == 0 ){
+			NLopt_opt_bi_function( gv, SS_ref_db);	}
+		else if (strcmp( gv->SS_list[index], "cd")  == 0){
+			NLopt_opt_cd_function( gv, SS_ref_db);	}
+		else if (strcmp( gv->SS_list[index], "cpx") == 0){
+			NLopt_opt_cpx_function( gv, SS_ref_db);}	
+		else if (strcmp( gv->SS_list[index], "ep")  == 0){
+			NLopt_opt_ep_function( gv, SS_ref_db);	}
+		else if (strcmp( gv->SS_list[index], "fl")  == 0){
+			NLopt_opt_fl_function( gv, SS_ref_db);	}		
+		else if (strcmp( gv->SS_list[index], "g")   == 0){
+			NLopt_opt_g_function(  gv, SS_ref_db);	}
+		else if (strcmp( gv->SS_list[index], "hb")  == 0){
+			NLopt_opt_hb_function( gv, SS_ref_db);	}	
+		else if (strcmp( gv->SS_list[index], "ilm") == 0){
+			NLopt_opt_ilm_function( gv, SS_ref_db);}
+		else if (strcmp( gv->SS_list[index], "liq") == 0){
+			NLopt_opt_liq_function( gv, SS_ref_db);}
+		else if (strcmp( gv->SS_list[index], "mu")  == 0){
+			NLopt_opt_mu_function( gv, SS_ref_db);	}	
+		else if (strcmp( gv->SS_list[index], "ol")  == 0){
+			NLopt_opt_ol_function( gv, SS_ref_db);	}
+		else if (strcmp( gv->SS_list[index], "opx") == 0){
+			NLopt_opt_opx_function( gv, SS_ref_db);}	
+		else if (strcmp( gv->SS_list[index], "pl4T")  == 0){
+			NLopt_opt_pl4T_function( gv, SS_ref_db);	}	
+		else if (strcmp( gv->SS_list[index], "spn") == 0){
+			NLopt_opt_spn_function( gv, SS_ref_db);	
+			}
+		else{
+			printf("\nsolid solution '%s index %d' is not in the database\n",gv->SS_list[index], index);	}	
+	}
+
+	if (gv->LM_pool == 0){
+		nlopt_destroy(SS_ref_db->opt);
+		SS_ref_db->opt = opt_pool;
+	}
+
+	/* the early exit is allowed for one call only */
+	SS_ref_db->LM_ee = 0;
 		
-   t = clock() - t; 
-   SS_ref_db.LM_time = ((double)t)/CLOCKS_PER_SEC*1000; // in seconds 
-   
-	return SS_ref_db;
+   SS_ref_db->LM_time = (batch_wtime() - t)*1000.0; // in milliseconds, wall time of the call 
 };
 
 
@@ -10,16 +10,75 @@ typedef void (*sf_type) (		unsigned  		 m,
 								double 			*grad,
 								void 			*data		);
 
+typedef void (*sf_jac_type) (	const double 	*x,
+								double 			*grad 		);
+
+/**
+  sparse structure of the m x n gradient of the site-fraction constraints of a phase (generated in sf_jacobian.c)
+*/
+typedef struct sf_jac_datas {
+	sf_type 		 sf;			/** constraint function <phase>_c 									*/
+	sf_jac_type 	 jac;			/** writes the x-dependent entries of the gradient 					*/
+	int 			 m, n;			/** number of site fractions and of x-eos 							*/
+	int 			 n_c;			/** number of constant non-zero entries 								*/
+	const int 		*c_i;			/** their index in the row-major gradient 								*/
+	const double 	*c_v;			/** their value 														*/
+	int 			 n_v;			/** number of x-dependent entries 										*/
+	const int 		*v_i;			/** their index in the row-major gradient 								*/
+} sf_jac_data;
+
 	
-global_variable NLopt_global_opt_function(	struct bulk_info 	z_b,
-											global_variable 	 gv, 
-											PP_ref 				*PP_ref_db,
-											SS_ref 				*SS_ref_db,
-	 										csd_phase_set  		*cp
+void NLopt_global_opt_function(	struct bulk_info 	z_b,
+								global_variable 	*gv, 
+								PP_ref 				*PP_ref_db,
+								SS_ref 				*SS_ref_db,
+								csd_phase_set  		*cp
 );
 
-SS_ref NLopt_opt_function(		global_variable 	gv, 
-								SS_ref 				SS_ref_db,  
+void NLopt_global_opt_init(		global_variable 	*gv 				);
+
+void NLopt_global_opt_destroy(	global_variable 	*gv 				);
+
+sf_type SS_sf_function(		char 				*name 			);
+
+const sf_jac_data *SS_sf_jac_function(	char 		*name 			);
+
+void sf_jac_init(				const sf_jac_data 	*s,
+								double 				*grad 				);
+
+void SS_sf_sparse(				unsigned 			 m,
+								double 				*result,
+								unsigned 			 n,
+								const double 		*x,
+								double 				*grad,
+								void 				*data 				);
+
+int LM_early_exit(				SS_ref 				*SS_ref_db,
+								unsigned 			 n,
+								const double 		*x,
+								const double 		*g,
+								double 				 f 					);
+
+double NLopt_obj_wrap(			unsigned 			 n,
+								const double 		*x,
+								double 				*grad,
+								void 				*SS_ref_db 			);
+
+void NLopt_set_objective(		SS_ref 				*SS_ref_db,
+								obj_type 			 obj 				);
+
+nlopt_opt NLopt_opt_create(		global_variable 	*gv,
+								SS_ref 			   *SS_ref_db,
+								int 				index				);
+
+void NLopt_opt_init(			global_variable 	*gv,
+								SS_ref 			   *SS_ref_db			);
+
+void NLopt_opt_destroy(			global_variable 	*gv,
+								SS_ref 			   *SS_ref_db			);
+
+void NLopt_opt_function(		global_variable 	*gv, 
+								SS_ref 			   *SS_ref_db,  
 								int     			index				);
 
 #endif
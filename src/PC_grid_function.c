@@ -0,0 +1,313 @@
+/**
+Pseudocompound grids are stored in binary files (PC_grid_<density>.bin)
+that are memory-mapped read-only when MAGEMin starts. The mapping is shared through the
+page cache, so MPI ranks running on the same node all use the same physical copy of the grid.
+
+Available densities:
+
+- coarse : half of the points of the default grid (checkerboard pattern)
+- default: grid used to generate the pseudocompounds during levelling
+- fine   : default grid refined along the lattice axes (half the step), or with grids of python/XEOS_SIMPLEX_SS_GENERATOR.ipynb
+
+The grid files are generated by PC_grid_generator (make pc_grid) in ref_database/ and installed
+next to the executable (make install), any other grid file can be provided using --PC_grid=path/to/file.bin.
+The directory of the grids is, in order:
+
+- the directory given by --PC_grid_dir=path, or by the MAGEMIN_PC_GRID_DIR environment variable
+- ref_database/ or ../share/MAGEMin/ next to the executable or library holding MAGEMin (make install)
+- ref_database/ in the working directory
+*/
+
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MAGEMin.h"
+#include "PC_grid_function.h"
+
+/**
+  map a pseudocompound grid file in memory (read-only), returns NULL if the file cannot be read or is not a grid file
+*/
+PC_grid_header *map_PC_grid(	char 		*path,
+								size_t 		*size		){
+	struct stat  	 st;
+	void 			*map;
+	PC_grid_header 	*grid;
+	int 			 fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1){ return NULL; }
+
+	if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(PC_grid_header)){
+		close(fd);
+		return NULL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED){ return NULL; }
+
+	grid = (PC_grid_header*) map;
+	if (strcmp(grid->magic, PC_grid_magic) != 0 || grid->version != PC_grid_version){
+		munmap(map, st.st_size);
+		return NULL;
+	}
+
+	*size = st.st_size;
+	return grid;
+};
+
+/**
+  get the grid of a given solution phase, returns NULL if the phase is not in the file
+*/
+PC_grid_entry *get_PC_grid_entry(	PC_grid_header 	*grid,
+									char 			*name		){
+
+	PC_grid_entry *entry = (PC_grid_entry*) (grid + 1);
+
+	for (int i = 0; i < grid->n_ss; i++){
+		if (strcmp(entry[i].name, name) == 0){
+			return &entry[i];
+		}
+	}
+	return NULL;
+};
+
+/**
+  directory (with a trailing '/') of the executable or library holding MAGEMin, returns 0 if it cannot be found
+*/
+int get_module_dir(					char 				*dir		){
+	Dl_info  info;
+	char 	 module[PATH_MAX];
+	char 	*slash;
+
+	module[0] = '\0';
+	if (dladdr((void*) get_module_dir, &info) != 0 && info.dli_fname != NULL && strchr(info.dli_fname, '/') != NULL){
+		if (realpath(info.dli_fname, module) == NULL){ module[0] = '\0'; }
+	}
+#ifdef __linux__
+	/* the main executable is reported by its argv[0], which has no '/' when found in the PATH */
+	if (module[0] == '\0'){
+		ssize_t len = readlink("/proc/self/exe", module, PATH_MAX - 1);
+		module[(len > 0) ? len : 0] = '\0';
+	}
+#endif
+
+	slash = strrchr(module, '/');
+	if (slash == NULL){ return 0; }
+
+	slash[1] = '\0';
+	strcpy(dir, module);
+	return 1;
+};
+
+/**
+  path of a pseudocompound grid given by its density (coarse, default, fine) or by a path. A density is looked up in
+  gv.PC_grid_dir if it is set, else next to the executable (make install) and then in the working directory; the first
+  candidate is returned when the grid is found nowhere, such that the error message names it
+*/
+void get_PC_grid_path(				global_variable 	*gv,
+									char 				*name,
+									char 				*path		){
+	char 	dir[PATH_MAX];
+	char 	candidate[3][PATH_MAX + 64];
+	int 	n_candidate = 0;
+
+	if (	strcmp(name, "coarse")  != 0
+		&& 	strcmp(name, "default") != 0
+		&& 	strcmp(name, "fine")    != 0	){
+		strcpy(path, name);
+		return;
+	}
+
+	if (strlen(gv->PC_grid_dir) > 0){
+		sprintf(path, "%s/PC_grid_%s.bin", gv->PC_grid_dir, name);
+		return;
+	}
+
+	if (get_module_dir(dir) == 1){
+		sprintf(candidate[n_candidate++], "%s%sPC_grid_%s.bin", dir, PC_grid_db_dir, name);
+		sprintf(candidate[n_candidate++], "%s../share/MAGEMin/PC_grid_%s.bin", dir, name);
+	}
+	sprintf(candidate[n_candidate++], "%sPC_grid_%s.bin", PC_grid_db_dir, name);
+
+	strcpy(path, candidate[0]);
+	for (int i = 0; i < n_candidate; i++){
+		if (access(candidate[i], R_OK) == 0){
+			strcpy(path, candidate[i]);
+			return;
+		}
+	}
+};
+
+/**
+  associate the grid of each solution phase, returns the largest number of pseudocompounds of a phase, or -(i+1) if
+  solution phase i is missing in the grid. The pseudocompound storage of each phase is sized from its own grid, see
+  G_SS_INIT_EM_function
+*/
+int attach_PC_grid(					global_variable 	*gv,
+									PC_grid_header 		*grid,
+									size_t 				 size,
+									int 				*n_SS_PC,
+									double 				*SS_PC_stp,
+									PC_ref 				*PC_xeos 	){
+	PC_grid_entry 	*entry;
+	int 			 max_n_pc = 0;
+
+	for (int i = 0; i < gv->len_ss; i++){
+		entry = get_PC_grid_entry(grid, gv->SS_list[i]);
+
+		if (entry == NULL || entry->offset + entry->n_pc*sizeof(struct ss_pc) > size){
+			return -(i+1);
+		}
+
+		n_SS_PC[i] 				= entry->n_pc;
+		SS_PC_stp[i] 			= entry->stp;
+		PC_xeos[i].ss_pc_xeos 	= (struct ss_pc*) ((char*)grid + entry->offset);
+
+		if (entry->n_pc > max_n_pc){ max_n_pc = entry->n_pc; }
+	}
+
+	return max_n_pc;
+};
+
+/**
+  load the pseudocompound grid selected by gv.PC_grid and associate the grid of each solution phase
+*/
+void load_PC_grid(		global_variable 	*gv			){
+
+	PC_grid_header 	*grid;
+	char 			 path[PATH_MAX + 64];
+	size_t 			 size;
+	int 			 max_n_pc;
+
+	get_PC_grid_path(gv, gv->PC_grid, path);
+
+	grid = map_PC_grid(path, &size);
+	if (grid == NULL){
+		printf("\n pseudocompound grid '%s' cannot be read, run 'make pc_grid' to generate the grid files", path);
+		printf(" or give their directory with --PC_grid_dir=path (or MAGEMIN_PC_GRID_DIR)\n");
+		exit(EXIT_FAILURE);
+	}
+
+	max_n_pc = attach_PC_grid(gv, grid, size, gv->n_SS_PC, gv->SS_PC_stp, gv->PC_xeos);
+	if (max_n_pc < 0){
+		printf("\n solution phase '%s' is missing in pseudocompound grid '%s'\n", gv->SS_list[-max_n_pc-1], path);
+		exit(EXIT_FAILURE);
+	}
+
+	gv->PC_grid_map  = grid;
+	gv->PC_grid_size = size;
+};
+
+/**
+  release the pseudocompound grid mapping
+*/
+void unload_PC_grid(				global_variable 	*gv			){
+	if (gv->PC_grid_map != NULL){
+		munmap(gv->PC_grid_map, gv->PC_grid_size);
+	}
+};
+
+/**
+  1 if the grid of the retry ladder has the same number of pseudocompounds and step as the grid in use for every phase
+*/
+int same_PC_grid(		global_variable 	*gv			){
+
+	for (int i = 0; i < gv->len_ss; i++){
+		if (gv->rt_n_SS_PC[i] != gv->n_SS_PC[i] || gv->rt_SS_PC_stp[i] != gv->SS_PC_stp[i]){
+			return 0;
+		}
+	}
+	return 1;
+};
+
+/**
+  load the denser grid used by the retry ladder (gv.rt_PC_grid), after the grid in use and before the databases are
+  allocated such that the pseudocompound storage can hold it. The rung is skipped (gv.rt_PC_grid_map = NULL) if the grid
+  cannot be used or holds the same pseudocompounds (n_pc and stp of every phase) as the grid in use.
+*/
+void load_retry_PC_grid(	global_variable 	*gv			){
+
+	PC_grid_header 	*grid;
+	char 			 path[PATH_MAX + 64];
+	size_t 			 size;
+	int 			 max_n_pc;
+
+	gv->rt_PC_grid_map = NULL;
+	if (gv->rt_max < 2 || strcmp(gv->rt_PC_grid, gv->PC_grid) == 0){
+		return;
+	}
+
+	get_PC_grid_path(gv, gv->rt_PC_grid, path);
+
+	grid = map_PC_grid(path, &size);
+	if (grid == NULL){
+		if (gv->verbose != 2){
+			printf(" pseudocompound grid '%s' cannot be read, the denser grid retry is skipped\n", path);
+		}
+		return;
+	}
+
+	gv->rt_n_SS_PC 	= malloc ((gv->len_ss) * sizeof (int) 	);
+	gv->rt_SS_PC_stp = malloc ((gv->len_ss) * sizeof (double) );
+	gv->rt_PC_xeos 	= malloc ((gv->len_ss) * sizeof (PC_ref) );
+
+	max_n_pc = attach_PC_grid(gv, grid, size, gv->rt_n_SS_PC, gv->rt_SS_PC_stp, gv->rt_PC_xeos);
+	if (max_n_pc < 0 || same_PC_grid(gv) == 1){
+		if (gv->verbose != 2){
+			if (max_n_pc < 0){
+				printf(" solution phase '%s' is missing in pseudocompound grid '%s', the denser grid retry is skipped\n", gv->SS_list[-max_n_pc-1], path);
+			}
+			else{
+				printf(" pseudocompound grid '%s' is the grid in use, the denser grid retry is skipped\n", path);
+			}
+		}
+		munmap(grid, size);
+		free(gv->rt_n_SS_PC);
+		free(gv->rt_SS_PC_stp);
+		free(gv->rt_PC_xeos);
+		return;
+	}
+
+	gv->rt_PC_grid_map  = grid;
+	gv->rt_PC_grid_size = size;
+};
+
+/**
+  swap the grid in use with the denser grid of the retry ladder (called twice to restore it)
+*/
+void swap_PC_grid(		global_variable 	*gv			){
+	int 	*n_SS_PC 	= gv->n_SS_PC;
+	double 	*SS_PC_stp 	= gv->SS_PC_stp;
+	PC_ref 	*PC_xeos 	= gv->PC_xeos;
+
+	gv->n_SS_PC 			= gv->rt_n_SS_PC;
+	gv->SS_PC_stp 		= gv->rt_SS_PC_stp;
+	gv->PC_xeos 			= gv->rt_PC_xeos;
+
+	gv->rt_n_SS_PC 		= n_SS_PC;
+	gv->rt_SS_PC_stp 	= SS_PC_stp;
+	gv->rt_PC_xeos 		= PC_xeos;
+};
+
+/**
+  release the denser grid of the retry ladder
+*/
+void unload_retry_PC_grid(			global_variable 	*gv			){
+	if (gv->rt_PC_grid_map != NULL){
+		munmap(gv->rt_PC_grid_map, gv->rt_PC_grid_size);
+		free(gv->rt_n_SS_PC);
+		free(gv->rt_SS_PC_stp);
+		free(gv->rt_PC_xeos);
+	}
+};
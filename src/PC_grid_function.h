@@ -0,0 +1,60 @@
+#ifndef __PC_GRID_FUNCTION_H_
+#define __PC_GRID_FUNCTION_H_
+
+#define PC_grid_magic 	"MAGEMin_PC_grid"
+#define PC_grid_version 1
+#define PC_grid_db_dir 	"ref_database/"	/** where make pc_grid writes the grids, relative to the executable or the working directory */
+
+/**
+	Layout of a pseudocompound grid file:
+
+	PC_grid_header
+	PC_grid_entry  x n_ss
+	struct ss_pc   x n_pc, for every entry (at entry.offset bytes from the start of the file)
+*/
+typedef struct PC_grid_headers {
+	char 	magic[16];			/** PC_grid_magic 														*/
+	int 	version;			/** PC_grid_version 													*/
+	int 	n_ss;				/** number of solution phase grids stored in the file 					*/
+} PC_grid_header;
+
+typedef struct PC_grid_entries {
+	char 	name[16];			/** solution phase name 												*/
+	int 	n_pc;				/** number of pseudocompounds 											*/
+	int 	n_xeos;				/** number of compositional variables 									*/
+	double 	stp;				/** step of the grid 													*/
+	long 	offset;				/** position of the x-eos table in the file (bytes) 					*/
+} PC_grid_entry;
+
+PC_grid_header *map_PC_grid(	char 				*path,
+								size_t 				*size 		);
+
+PC_grid_entry  *get_PC_grid_entry(	PC_grid_header 	*grid,
+									char 			*name 		);
+
+int get_module_dir(				char 				*dir 		);
+
+void get_PC_grid_path(			global_variable 	*gv,
+								char 				*name,
+								char 				*path 		);
+
+int attach_PC_grid(				global_variable 	*gv,
+								PC_grid_header 		*grid,
+								size_t 				 size,
+								int 				*n_SS_PC,
+								double 				*SS_PC_stp,
+								PC_ref 				*PC_xeos 	);
+
+void load_PC_grid(	global_variable 	*gv 		);
+
+int same_PC_grid(				global_variable 	*gv 		);
+
+void unload_PC_grid(			global_variable 	*gv 		);
+
+void load_retry_PC_grid(	global_variable *gv 		);
+
+void swap_PC_grid(	global_variable 	*gv 		);
+
+void unload_retry_PC_grid(		global_variable 	*gv 		);
+
+#endif
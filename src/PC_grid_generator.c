@@ -0,0 +1,203 @@
+/**
+Writes the binary pseudocompound grid files mapped by MAGEMin at startup (see PC_grid_function.c).
+
+usage: ./PC_grid_generator [coarse|default|fine] [phase_grid.bin ...]
+
+- default: grids of SS_xeos_PC.h
+- coarse : half of the points of the default grids (checkerboard pattern, the spacing increases by sqrt(2))
+- fine   : default grids refined along the lattice axes (midpoints between neighbouring points, the spacing is halved),
+           the phases given as additional arguments (refined grids written by python/XEOS_SIMPLEX_SS_GENERATOR.ipynb)
+           then replace the computed ones
+
+The additional grid files can be given for any density, the file is written to ref_database/PC_grid_<density>.bin
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MAGEMin.h"
+#include "PC_grid_function.h"
+#include "SS_xeos_PC.h"
+
+#define n_ss_grid 14
+
+/**
+  keep the points of the grid for which the sum of the lattice indexes is even (checkerboard)
+*/
+int coarsen_PC_grid(	struct ss_pc 	*xeos,
+						int 			 n_pc,
+						int 			 n_xeos,
+						double 			 stp		){
+
+	double 	min_x[11];
+	long 	sum_id;
+	int 	n = 0;
+
+	for (int j = 0; j < n_xeos; j++){
+		min_x[j] = xeos[0].xeos_pc[j];
+		for (int i = 1; i < n_pc; i++){
+			if (xeos[i].xeos_pc[j] < min_x[j]){ min_x[j] = xeos[i].xeos_pc[j]; }
+		}
+	}
+
+	for (int i = 0; i < n_pc; i++){
+		sum_id = 0;
+		for (int j = 0; j < n_xeos; j++){
+			sum_id += lround((xeos[i].xeos_pc[j] - min_x[j])/stp);
+		}
+		if (sum_id % 2 == 0){
+			xeos[n] = xeos[i];
+			n 	   += 1;
+		}
+	}
+
+	return n;
+};
+
+/**
+  add the midpoint of every pair of points that are neighbours along one axis of the lattice (the spacing along the axes
+  of the refined grid is stp/2), returns the new number of points. fine holds n_pc*(n_xeos+1) points. Midpoints that do
+  not respect the site fractions give a non-finite G and are discarded when the pseudocompounds are generated
+*/
+int refine_PC_grid(		struct ss_pc 	*xeos,
+						struct ss_pc 	*fine,
+						int 			 n_pc,
+						int 			 n_xeos,
+						double 			 stp		){
+
+	double 	tol = 0.05*stp, dx;
+	int 	n 	= n_pc, ok;
+
+	memcpy(fine, xeos, n_pc * sizeof(struct ss_pc));
+
+	for (int i = 0; i < n_pc; i++){
+		for (int k = 0; k < n_pc; k++){
+			for (int a = 0; a < n_xeos; a++){
+				dx = xeos[k].xeos_pc[a] - xeos[i].xeos_pc[a];
+				if (fabs(dx - stp) > tol){ continue; }
+
+				ok = 1;
+				for (int j = 0; j < n_xeos && ok == 1; j++){
+					if (j != a && fabs(xeos[k].xeos_pc[j] - xeos[i].xeos_pc[j]) > tol){ ok = 0; }
+				}
+				if (ok == 1){
+					fine[n] = xeos[i];
+					for (int j = 0; j < n_xeos; j++){
+						fine[n].xeos_pc[j] = 0.5*(xeos[i].xeos_pc[j] + xeos[k].xeos_pc[j]);
+					}
+					n += 1;
+				}
+			}
+		}
+	}
+
+	return n;
+};
+
+int main(int argc, char **argv){
+
+	char    		*density = "default";
+	char 			 path[255];
+	PC_grid_header 	 header;
+	PC_grid_entry 	 entry[n_ss_grid];
+	struct ss_pc 	*xeos[n_ss_grid];
+
+	/* default grids: name, table, number of pseudocompounds, number of compositional variables and step */
+	char   			*name[n_ss_grid] 	= {"spn"		,"bi"		,"cd"		,"cpx"		,"ep"		,"g"		,"hb"		,"ilm"		,"liq"		,"mu"		,"ol"		,"opx"		,"pl4T"			,"fl"		};
+	struct ss_pc 	*table[n_ss_grid] 	= {spn_pc_xeos	,bi_pc_xeos	,cd_pc_xeos	,cpx_pc_xeos,ep_pc_xeos	,g_pc_xeos	,hb_pc_xeos	,ilm_pc_xeos,liq_pc_xeos,mu_pc_xeos	,ol_pc_xeos	,opx_pc_xeos,pl4T_pc_xeos	,fl_pc_xeos	};
+	int 			 n_pc[n_ss_grid] 	= {4996			,2587		,121		,4529		,110		,972		,6801		,420		,3099		,2376		,222		,1735		,231			,1			};
+	int 			 n_xeos[n_ss_grid] 	= {7			,5			,2			,9			,2			,5			,10			,2			,11			,5			,3			,8			,2				,10			};
+	double 			 stp[n_ss_grid] 	= {0.199		,0.124		,0.098		,0.249		,0.049		,0.198		,0.329		,0.0499		,0.198		,0.198		,0.098		,0.249		,0.049			,1.0		};
+
+	if (argc > 1){ density = argv[1]; }
+	if (	strcmp(density, "coarse")  != 0
+		&& 	strcmp(density, "default") != 0
+		&& 	strcmp(density, "fine")    != 0	){
+		printf("unknown grid density '%s', use coarse, default or fine\n", density);
+		exit(EXIT_FAILURE);
+	}
+
+	memset(entry, 0, sizeof(entry));
+	for (int i = 0; i < n_ss_grid; i++){
+		strcpy(entry[i].name, name[i]);
+		entry[i].n_pc 	= n_pc[i];
+		entry[i].n_xeos = n_xeos[i];
+		entry[i].stp 	= stp[i];
+		xeos[i] 		= malloc (n_pc[i] * sizeof(struct ss_pc));
+		memcpy(xeos[i], table[i], n_pc[i] * sizeof(struct ss_pc));
+
+		if (strcmp(density, "coarse") == 0 && n_pc[i] > 1){
+			entry[i].n_pc = coarsen_PC_grid(xeos[i], n_pc[i], n_xeos[i], stp[i]);
+			entry[i].stp  = sqrt(2.0)*stp[i];
+		}
+		if (strcmp(density, "fine") == 0 && n_pc[i] > 1){
+			struct ss_pc *fine = malloc (n_pc[i]*(n_xeos[i] + 1) * sizeof(struct ss_pc));
+			entry[i].n_pc = refine_PC_grid(xeos[i], fine, n_pc[i], n_xeos[i], stp[i]);
+			if (entry[i].n_pc > n_pc[i]){
+				entry[i].stp = 0.5*stp[i];
+			}
+			free(xeos[i]);
+			xeos[i] = fine;
+		}
+	}
+
+	/* replace the grid of the phases given as additional arguments */
+	for (int k = 2; k < argc; k++){
+		PC_grid_header 	*grid;
+		PC_grid_entry 	*ph_entry;
+		size_t 			 size;
+
+		grid = map_PC_grid(argv[k], &size);
+		if (grid == NULL){
+			printf("cannot read grid file '%s'\n", argv[k]);
+			exit(EXIT_FAILURE);
+		}
+		for (int i = 0; i < n_ss_grid; i++){
+			ph_entry = get_PC_grid_entry(grid, name[i]);
+			if (ph_entry != NULL){
+				free(xeos[i]);
+				entry[i].n_pc 	= ph_entry->n_pc;
+				entry[i].n_xeos = ph_entry->n_xeos;
+				entry[i].stp 	= ph_entry->stp;
+				xeos[i] 		= malloc (ph_entry->n_pc * sizeof(struct ss_pc));
+				memcpy(xeos[i], (char*)grid + ph_entry->offset, ph_entry->n_pc * sizeof(struct ss_pc));
+				printf(" %4s grid replaced by %s (%d PCs)\n", name[i], argv[k], ph_entry->n_pc);
+			}
+		}
+	}
+
+	/* write header, entries and x-eos tables */
+	memset(&header, 0, sizeof(header));
+	strcpy(header.magic, PC_grid_magic);
+	header.version 	= PC_grid_version;
+	header.n_ss 	= n_ss_grid;
+
+	long offset = sizeof(PC_grid_header) + n_ss_grid*sizeof(PC_grid_entry);
+	for (int i = 0; i < n_ss_grid; i++){
+		entry[i].offset = offset;
+		offset 		   += entry[i].n_pc*sizeof(struct ss_pc);
+	}
+
+	sprintf(path, "%sPC_grid_%s.bin", PC_grid_db_dir, density);
+	FILE *grid_file = fopen(path, "wb");
+	if (grid_file == NULL){
+		printf("cannot write grid file '%s'\n", path);
+		exit(EXIT_FAILURE);
+	}
+	fwrite(&header, sizeof(PC_grid_header), 1, grid_file);
+	fwrite(entry, sizeof(PC_grid_entry), n_ss_grid, grid_file);
+	for (int i = 0; i < n_ss_grid; i++){
+		fwrite(xeos[i], sizeof(struct ss_pc), entry[i].n_pc, grid_file);
+		free(xeos[i]);
+	}
+	fclose(grid_file);
+
+	printf("%s written (%ld bytes)\n", path, offset);
+	for (int i = 0; i < n_ss_grid; i++){
+		printf(" %4s %6d PCs, step %.4f\n", entry[i].name, entry[i].n_pc, entry[i].stp);
+	}
+
+	return 0;
+}
@@ -26,23 +26,30 @@ The routine is the core of MAGEMin algorithm and is constructed around the Gibbs
 #include "pp_min_function.h"
 #include "objective_functions.h"
 #include "NLopt_opt_function.h"
+#include "em_comp_function.h"
+#include "solvus_function.h"
+#include "batch_levelling_function.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 /** 
   Partitioning Gibbs Energy function 
 */
 void PGE_print(					struct bulk_info 		z_b,
-								global_variable  		gv,
+								global_variable  		*gv,
 
 								PP_ref 					*PP_ref_db,
 								SS_ref 					*SS_ref_db,
 								csd_phase_set  			*cp
 ){
-	printf("\n\nUnder-relaxing factor: %g\n",gv.alpha);
+	printf("\n\nUnder-relaxing factor: %g\n",gv->alpha);
 
 	printf(" [          GAMMA       ]\n");
 	for (int i = 0; i < z_b.nzEl_val; i++){		
-		printf(" [ %6s\t%.4f \t]\n",gv.ox[z_b.nzEl_array[i]],gv.gam_tot[z_b.nzEl_array[i]]);
+		printf(" [ %6s\t%.4f \t]\n",gv->ox[z_b.nzEl_array[i]],gv->gam_tot[z_b.nzEl_array[i]]);
 	}
 	printf("\n");
 	printf("\n ___________________________________\n");
@@ -51,7 +58,7 @@ void PGE_print(					struct bulk_info 		z_b,
 	printf("ON | phase |  Fraction |  delta_G   |  factor   |   sum_xi   |    Pi - Xi...\n");
 	printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
 
-	for (int i = 0; i < gv.len_cp; i++){
+	for (int i = 0; i < gv->len_cp; i++){
 		if (cp[i].ss_flags[0] == 1 && cp[i].ss_flags[1] == 1 ){
 
 			printf(" %d | %4s | %+10f | %+10f | %+10f | %+10f | ",cp[i].ss_flags[1],cp[i].name,cp[i].ss_n,cp[i].df,cp[i].factor,cp[i].sum_xi);
@@ -81,13 +88,13 @@ void PGE_print(					struct bulk_info 		z_b,
 		}
 	}
 	
-	if (gv.n_pp_phase > 0){
+	if (gv->n_pp_phase > 0){
 		printf("\n");
 		printf("ON | P. phase |  Fraction  |  delta_G   |  factor   | \n");
 		printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
-		for (int i = 0; i < gv.len_pp; i++){ 
-			if (gv.pp_flags[i][1] == 1){
-				printf(" %d | %4s     | %+10f | %+10f | %+10f | \n",1,gv.PP_list[i],gv.pp_n[i],PP_ref_db[i].gb_lvl*PP_ref_db[i].factor,PP_ref_db[i].factor);
+		for (int i = 0; i < gv->len_pp; i++){ 
+			if (gv->pp_flags[i][1] == 1){
+				printf(" %d | %4s     | %+10f | %+10f | %+10f | \n",1,gv->PP_list[i],gv->pp_n[i],PP_ref_db[i].gb_lvl*PP_ref_db[i].factor,PP_ref_db[i].factor);
 			}
 		}	
 	}
@@ -95,7 +102,7 @@ void PGE_print(					struct bulk_info 		z_b,
 	printf("\n");
 	printf("OFF| phase |  Fraction |  delta_G   |  factor   |   sum_xi   |    Pi - Xi...\n");
 	printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
-	for (int i = 0; i < gv.len_cp; i++){
+	for (int i = 0; i < gv->len_cp; i++){
 		if (cp[i].ss_flags[0] == 1 && cp[i].ss_flags[2] == 1){
 
 			printf(" %d | %4s | %+10f | %+10f | %+10f | %+10f | ",cp[i].ss_flags[1],cp[i].name,cp[i].ss_n,cp[i].df,cp[i].factor,cp[i].sum_xi);
@@ -133,121 +140,126 @@ void PGE_print(					struct bulk_info 		z_b,
 	printf("\n");
 	printf("OFF| P. phase |  Fraction  |  delta_G  (< 5.0) | \n");
 	printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
-	for (int i = 0; i < gv.len_pp; i++){ 
-		if (gv.pp_flags[i][2] == 1 && PP_ref_db[i].gb_lvl*PP_ref_db[i].factor < 50.0){
-			printf(" %d | %4s     | %+10f | %+10f | \n",0,gv.PP_list[i],gv.pp_n[i],PP_ref_db[i].gb_lvl*PP_ref_db[i].factor);
+	for (int i = 0; i < gv->len_pp; i++){ 
+		if (gv->pp_flags[i][2] == 1 && PP_ref_db[i].gb_lvl*PP_ref_db[i].factor < 50.0){
+			printf(" %d | %4s     | %+10f | %+10f | \n",0,gv->PP_list[i],gv->pp_n[i],PP_ref_db[i].gb_lvl*PP_ref_db[i].factor);
 		}
 	}
 	printf("\n\n\n");
-	printf(" [GIBBS SYSTEM (Gibbs-Duhem) %.8f (with mu %.8f)]\n",gv.G_system,gv.G_system_mu);
-	printf(" [MASS RESIDUAL NORM  = %+.8f ]\n",gv.BR_norm);
+	printf(" [GIBBS SYSTEM (Gibbs-Duhem) %.8f (with mu %.8f)]\n",gv->G_system,gv->G_system_mu);
+	printf(" [MASS RESIDUAL NORM  = %+.8f ]\n",gv->BR_norm);
 };
 
 
 /** 
   Partitioning Gibbs Energy function 
 */
-global_variable PGE_residual_update_function(	struct bulk_info 		z_b,
-											global_variable  		gv,
+void PGE_residual_update_function(	struct bulk_info 		z_b,
+								global_variable  		*gv,
 
-											PP_ref 					*PP_ref_db,
-											SS_ref 					*SS_ref_db,
-											csd_phase_set  			*cp
+								PP_ref 					*PP_ref_db,
+								SS_ref 					*SS_ref_db,
+								csd_phase_set  			*cp
 ){
 
 	/* update mass-constraint residual here */
-	for (int j = 0; j < gv.len_ox; j++){
-	   gv.mass_residual[j] = -z_b.bulk_rock[j];
-		for (int i = 0; i < gv.len_pp; i++){
-			if (gv.pp_flags[i][1] == 1){ // && gv.pp_n[i] > 0.0
-				gv.mass_residual[j] += PP_ref_db[i].Comp[j]*PP_ref_db[i].factor*gv.pp_n[i];
+	for (int j = 0; j < gv->len_ox; j++){
+	   gv->mass_residual[j] = -z_b.bulk_rock[j];
+		for (int i = 0; i < gv->len_pp; i++){
+			if (gv->pp_flags[i][1] == 1){ // && gv->pp_n[i] > 0.0
+				gv->mass_residual[j] += PP_ref_db[i].Comp[j]*PP_ref_db[i].factor*gv->pp_n[i];
 			}
 		}	
 
 		/** calculate residual as function xi fraction and not endmember fractions from x-eos */
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[1] == 1 ){ // && cp[i].ss_n > 0.0
 				for (int k = 0; k < cp[i].n_em; k++){
-					gv.mass_residual[j] += SS_ref_db[cp[i].id].Comp[k][j]*cp[i].factor*cp[i].p_em[k]*cp[i].xi_em[k]*cp[i].z_em[k]*cp[i].ss_n;
+					gv->mass_residual[j] += SS_ref_db[cp[i].id].Comp[k][j]*cp[i].factor*cp[i].p_em[k]*cp[i].xi_em[k]*cp[i].z_em[k]*cp[i].ss_n;
 				}
 			}
 		}
 	}
 
-	gv.BR_norm    = norm_vector(	gv.mass_residual,
+	gv->BR_norm    = norm_vector(	gv->mass_residual,
 									z_b.nzEl_val				);
 
 	/* Calculate G-system */
-	gv.G_system = 0.0;
-	for (int j = 0; j < gv.len_ox; j++){ gv.G_system += z_b.bulk_rock[j]*gv.gam_tot[j]; }
+	gv->G_system = 0.0;
+	for (int j = 0; j < gv->len_ox; j++){ gv->G_system += z_b.bulk_rock[j]*gv->gam_tot[j]; }
 	
-	gv.G_system_mu = gv.G_system;
-	for (int i = 0; i < gv.len_cp; i++){
+	gv->G_system_mu = gv->G_system;
+	for (int i = 0; i < gv->len_cp; i++){
 		if (cp[i].ss_flags[1] == 1){
 			for (int j = 0; j < cp[i].n_em; j++){
-				gv.G_system_mu +=  cp[i].ss_n*cp[i].p_em[j]*cp[i].mu[j]*cp[i].factor;
+				gv->G_system_mu +=  cp[i].ss_n*cp[i].p_em[j]*cp[i].mu[j]*cp[i].factor;
 			}
 		}
 	}
-	for (int i = 0; i < gv.len_pp; i++){
-		if (gv.pp_flags[i][1] == 1){
-			gv.G_system_mu +=  gv.pp_n[i]*PP_ref_db[i].gb_lvl*PP_ref_db[i].factor;
+	for (int i = 0; i < gv->len_pp; i++){
+		if (gv->pp_flags[i][1] == 1){
+			gv->G_system_mu +=  gv->pp_n[i]*PP_ref_db[i].gb_lvl*PP_ref_db[i].factor;
 		}
 	}
-
-   return gv;
 };
 
 
 /** 
-  Function to update chemical potential of endmembers (mui)
+  Function to update chemical potential of endmembers (mui), the change of base is computed for all the endmembers
+  packed in gv.em_C by PGE_cache_composition at once
 */
-global_variable PGE_update_mu(		struct bulk_info 	z_b,
-									global_variable  	gv,
+void PGE_update_mu(		struct bulk_info 	z_b,
+						global_variable  	*gv,
 
-									PP_ref 				*PP_ref_db,
-									SS_ref 				*SS_ref_db,
-									csd_phase_set  		*cp
+						PP_ref 				*PP_ref_db,
+						SS_ref 				*SS_ref_db,
+						csd_phase_set  		*cp
 ){
-	int 	ss;
-	double  cv;
-	for (int i = 0; i < gv.len_cp; i++){
-		if (cp[i].ss_flags[0] == 1 && (cp[i].ss_flags[1] == 1 || cp[i].ss_flags[2] == 1)){
-			ss  = cp[i].id;
+	int 	 r;
+	int 	 n_rows = gv->n_em_rows - gv->len_pp;
+	double 	*dmu 	= gv->em_g + gv->len_pp;
 
-			/** rotate gbase with respect to the G-hyperplane (change of base) */
+	/** rotate gbase with respect to the G-hyperplane (change of base) */
+	for (r = 0; r < n_rows; r++){
+		dmu[r] = 0.0;
+	}
+	em_project(						dmu,
+									gv->em_C + gv->len_pp,
+									gv->em_ld,
+									gv->delta_gam_tot,
+									n_rows,
+									gv->len_ox				);
+
+	for (int i = 0; i < gv->len_cp; i++){
+		if (cp[i].em_row >= 0 && cp[i].ss_flags[0] == 1 && (cp[i].ss_flags[1] == 1 || cp[i].ss_flags[2] == 1)){
+			r = cp[i].em_row - gv->len_pp;
 			for (int k = 0; k < cp[i].n_em; k++) {
-				cp[i].delta_mu[k] = 0.0;
-				for (int j = 0; j < gv.len_ox; j++) {
-					cp[i].delta_mu[k] 	-= SS_ref_db[ss].Comp[k][j]*gv.delta_gam_tot[j];
-				}
+				cp[i].delta_mu[k] = dmu[r + k];
 				cp[i].mu[k] += cp[i].delta_mu[k];
 				cp[i].df 	+= cp[i].delta_mu[k]*cp[i].p_em[k];
 			}
 		}
 	}
-
-   return gv;
 };
 
 /** 
   Partitioning Gibbs Energy function 
 */
-global_variable PGE_update_pi(		struct bulk_info 	z_b,
-									global_variable  	gv,
+void PGE_update_pi(		struct bulk_info 	z_b,
+						global_variable  	*gv,
 
-									PP_ref 				*PP_ref_db,
-									SS_ref 				*SS_ref_db,
-									csd_phase_set  		*cp
+						PP_ref 				*PP_ref_db,
+						SS_ref 				*SS_ref_db,
+						csd_phase_set  		*cp
 ){
 	int ss,ph,i,j,k,x,v;	
 	
-	for (ph = 0; ph < gv.len_cp; ph++){
-		//if (cp[ph].ss_flags[1] == 1 && strcmp(gv.SS_list[cp[ph].id], "liq") == 0){
+	for (ph = 0; ph < gv->len_cp; ph++){
+		//if (cp[ph].ss_flags[1] == 1 && strcmp(gv->SS_list[cp[ph].id], "liq") == 0){
 		if (cp[ph].ss_flags[1] == 1 && SS_ref_db[cp[ph].id].CstFactor == 0){
 			ss = cp[ph].id;
 
-			double dp[cp[ph].n_em];
+			double *dp = gv->ws.dp;
 			for (k = 0; k < cp[ph].n_em; k++){
 				dp[k] = (cp[ph].p_em[k]-cp[ph].xi_em[k]*cp[ph].p_em[k])*cp[ph].z_em[k];
 			}
@@ -260,13 +272,13 @@ global_variable PGE_update_pi(		struct bulk_info 	z_b,
 				SS_ref_db[ss] = P2X(			gv,
 												SS_ref_db[ss],
 												z_b,
-												gv.SS_list[ss]				);
+												gv->SS_list[ss]				);
 											
 											
-				SS_ref_db[ss] = PC_function(	gv,
-												SS_ref_db[ss], 
-												z_b,
-												gv.SS_list[ss] 				);
+				PC_function(	gv,
+								&SS_ref_db[ss], 
+								z_b,
+								gv->SS_list[ss] 				);
 														
 				if (SS_ref_db[ss].sf_ok == 1){	
 					double x   = 0.75;						
@@ -279,34 +291,69 @@ global_variable PGE_update_pi(		struct bulk_info 	z_b,
 			
 		}
 	}
-
-   return gv;
 };
 
 /** 
-  Partitioning Gibbs Energy function 
+  Update xi, sum_xi and the composition of the considered phases (same as CP_UPDATE_function), the Boltzmann factors
+  of all the endmembers packed in gv.em_C are evaluated in one pass over a contiguous vector
 */
-global_variable PGE_update_xi(		struct bulk_info 	z_b,
-									global_variable  	gv,
+void PGE_update_xi(		struct bulk_info 	z_b,
+						global_variable  	*gv,
 
-									PP_ref 				*PP_ref_db,
-									SS_ref 				*SS_ref_db,
-									csd_phase_set  		*cp
+						PP_ref 				*PP_ref_db,
+						SS_ref 				*SS_ref_db,
+						csd_phase_set  		*cp
 ){
-	int ss;
+	int 	 r, n_em;
+	int 	 n_rows = gv->n_em_rows - gv->len_pp;
+	double 	*mu 	= gv->em_g + gv->len_pp;
+	double 	*xi 	= gv->em_x + gv->len_pp;
+	double 	*w 		= gv->ws.w;
+
+	for (int i = 0; i < gv->len_cp; i++){
+		if (cp[i].em_row >= 0){
+			r = cp[i].em_row - gv->len_pp;
+			for (int k = 0; k < cp[i].n_em; k++){
+				mu[r + k] = cp[i].mu[k];
+			}
+		}
+	}
+	em_exp(							xi,
+									mu,
+									z_b.R*z_b.T,
+									n_rows					);
+
+	for (int i = 0; i < gv->len_cp; i++){
+		if (cp[i].em_row >= 0 && cp[i].ss_flags[0] == 1 && (cp[i].ss_flags[1] == 1 || cp[i].ss_flags[2] == 1)){
+			r 	 = cp[i].em_row - gv->len_pp;
+			n_em = cp[i].n_em;
+
+			/* sf_ok?*/
+			cp[i].sf_ok = 1;
+			for (int k = 0; k < cp[i].n_sf; k++){
+				if (cp[i].sf[k] <= 0.0 || isnan(cp[i].sf[k]) == 1|| isinf(cp[i].sf[k]) == 1){
+					cp[i].sf_ok = 0;	
+					break;
+				}
+			}
 
-	for (int i = 0; i < gv.len_cp; i++){
-		if (cp[i].ss_flags[0] == 1 && (cp[i].ss_flags[1] == 1 || cp[i].ss_flags[2] == 1)){
-			ss = cp[i].id;
+			/* xi calculation (phase fraction expression for PGE) */
+			cp[i].sum_xi = 0.0;
+			for (int k = 0; k < n_em; k++){
+				cp[i].xi_em[k] = xi[r + k];
+				cp[i].sum_xi  += cp[i].xi_em[k]*cp[i].p_em[k]*cp[i].z_em[k];
+				w[k] 		   = cp[i].p_em[k]*cp[i].z_em[k];
+			}
 
-			cp[i] = CP_UPDATE_function(			gv, 
-												SS_ref_db[ss], 
-												cp[i],
-												z_b							);							
+			/* get composition of solution phase */
+			em_mix(					cp[i].ss_comp,
+									gv->em_C + cp[i].em_row,
+									gv->em_ld,
+									w,
+									n_em,
+									gv->len_ox				);
 		}	
 	}
-
-   return gv;
 };
 
 
@@ -314,15 +361,15 @@ global_variable PGE_update_xi(		struct bulk_info 	z_b,
 /**
 	check PC driving force and add phase if below hyperplane
 */
-global_variable check_EM(					struct bulk_info 	 z_b,
-											global_variable  	 gv,
+void check_EM(					struct bulk_info 	 z_b,
+								global_variable  	*gv,
 
-											PP_ref 				*PP_ref_db,
-											SS_ref 				*SS_ref_db,
-											csd_phase_set  		*cp				
+								PP_ref 				*PP_ref_db,
+								SS_ref 				*SS_ref_db,
+								csd_phase_set  		*cp				
 ){
 	double df, factor;
-	for (int i = 0; i < gv.len_ss; i++){												/**loop to pass informations from active endmembers */
+	for (int i = 0; i < gv->len_ss; i++){												/**loop to pass informations from active endmembers */
 		if (SS_ref_db[i].ss_flags[0] == 1){														/** if SS is not filtered out then continue */
 
 			for (int l = 0; l < SS_ref_db[i].n_em; l++){	
@@ -333,62 +380,75 @@ global_variable check_EM(					struct bulk_info 	 z_b,
 					factor 	= z_b.fbc/SS_ref_db[i].ape[l];	
 
 					df = SS_ref_db[i].gbase[l];
-					for (int j = 0; j < gv.len_ox; j++) {
-						df -= SS_ref_db[i].Comp[l][j]*gv.gam_tot[j];
+					for (int j = 0; j < gv->len_ox; j++) {
+						df -= SS_ref_db[i].Comp[l][j]*gv->gam_tot[j];
 					}
 					
 					if (df*factor < 0.0){
-						printf("WARN: %4s %d %+10f\n",gv.SS_list[i],l,df*factor);
+						printf("WARN: %4s %d %+10f\n",gv->SS_list[i],l,df*factor);
 					}
 				}
 			}
 		}
 	}
-	
-	return gv;
 }
 
 /**
 	check PC driving force and add phase if below hyperplane
 */
-global_variable check_PC(					struct bulk_info 	 z_b,
-											global_variable  	 gv,
+void check_PC(					struct bulk_info 	 z_b,
+								global_variable  	*gv,
 
-											PP_ref 				*PP_ref_db,
-											SS_ref 				*SS_ref_db,
-											csd_phase_set  		*cp				
+								PP_ref 				*PP_ref_db,
+								SS_ref 				*SS_ref_db,
+								csd_phase_set  		*cp				
 ){
-	double 	min_df, xeos_dist, norm;
-	int 	max_n_pc, phase_add, id_cp, min_df_id, dist, ph;
-	int 	i,j,k,l;
+	double 	min_df, r2;
+	int 	max_n_pc, phase_add, id_cp, min_df_id, ph, n_nb;
+	int 	i,j,k,l,m;
 	
-	for (i = 0; i < gv.len_ss; i++){
+	for (i = 0; i < gv->len_ss; i++){
 		min_df_id = -1;						// unreallistic index to start with
 		min_df    =  1e6;					// high starting value as it is expected to go down
 		phase_add =  0;
 		
-		if (SS_ref_db[i].ss_flags[0] == 1  && gv.verifyPC[i] == 1){
+		if (SS_ref_db[i].ss_flags[0] == 1  && gv->verifyPC[i] == 1){
 			
 			max_n_pc  = ((SS_ref_db[i].tot_pc >= SS_ref_db[i].n_pc) ? (SS_ref_db[i].n_pc) : (SS_ref_db[i].tot_pc));
 			
-			for (l = 0; l < max_n_pc; l++){
-
-				dist =  1;
-				if (gv.n_solvi[i] > 0){
-
-					for (k = 0; k < gv.n_solvi[i]; k++){  /* go through the upper triangle of the matrix (avoiding diagonal)*/
-						ph = SS_ref_db[i].solvus_id[k];
+			if (SS_ref_db[i].kd_n != max_n_pc){
+				kdtree_build(			SS_ref_db[i].kd_idx,
+										SS_ref_db[i].xeos_pc,
+										max_n_pc,
+										SS_ref_db[i].n_xeos		);
+				SS_ref_db[i].kd_n = max_n_pc;
+			}
 
-						xeos_dist = euclidean_distance(cp[ph].xeos, SS_ref_db[i].xeos_pc[l], SS_ref_db[i].n_xeos);
-						if (xeos_dist < gv.PC_min_dist*gv.SS_PC_stp[i]*sqrt((double)SS_ref_db[i].n_xeos) ){
-							 dist = 0;
-						} 
-					}	
+			/* flag the PCs lying too close to an existing instance of the solution phase */
+			int *dist = gv->ws.dist;
+			for (l = 0; l < max_n_pc; l++){
+				dist[l] = 1;
+			}
+			r2 = pow(gv->PC_min_dist*gv->SS_PC_stp[i],2.0)*(double)SS_ref_db[i].n_xeos;
+			for (k = 0; k < gv->n_solvi[i]; k++){
+				ph   = SS_ref_db[i].solvus_id[k];
+				n_nb = kdtree_radius_search(	SS_ref_db[i].kd_idx,
+												SS_ref_db[i].xeos_pc,
+												max_n_pc,
+												SS_ref_db[i].n_xeos,
+												cp[ph].xeos,
+												r2,
+												SS_ref_db[i].kd_nb		);
+				for (m = 0; m < n_nb; m++){
+					dist[SS_ref_db[i].kd_nb[m]] = 0;
 				}
-				if (dist == 1){
+			}
+			
+			for (l = 0; l < max_n_pc; l++){
+				if (dist[l] == 1){
 					SS_ref_db[i].DF_pc[l] = SS_ref_db[i].G_pc[l];
-					for (j = 0; j < gv.len_ox; j++) {
-						SS_ref_db[i].DF_pc[l] -= SS_ref_db[i].comp_pc[l][j]*gv.gam_tot[j];
+					for (j = 0; j < gv->len_ox; j++) {
+						SS_ref_db[i].DF_pc[l] -= SS_ref_db[i].comp_pc[l][j]*gv->gam_tot[j];
 					}
 
 					if (SS_ref_db[i].DF_pc[l] < min_df){	
@@ -399,9 +459,9 @@ global_variable check_PC(					struct bulk_info 	 z_b,
 			}
 			
 			/* if there is a possible solvus */
-			if (min_df < gv.PC_df_add && min_df_id != -1 && phase_add == 0){
-				if (gv.verbose == 1){
-					printf(" %4s %d has been added\n",gv.SS_list[i],min_df_id);
+			if (min_df < gv->PC_df_add && min_df_id != -1 && phase_add == 0){
+				if (gv->verbose == 1){
+					printf(" %4s %d has been added\n",gv->SS_list[i],min_df_id);
 					
 					for (int k = 0; k < SS_ref_db[i].n_xeos; k++) {
 						SS_ref_db[i].iguess[k] = SS_ref_db[i].xeos_pc[min_df_id][k];
@@ -415,10 +475,10 @@ global_variable check_PC(					struct bulk_info 	 z_b,
 				/**
 					copy the minimized phase informations to cp structure
 				*/
-				gv.len_cp				   += 1;
-				id_cp 		 				= gv.len_cp-1;
-				strcpy(cp[id_cp].name,gv.SS_list[i]);				/* get phase name */				
-				cp[id_cp].in_iter			= gv.global_ite;
+				gv->len_cp				   += 1;
+				id_cp 		 				= gv->len_cp-1;
+				strcpy(cp[id_cp].name,gv->SS_list[i]);				/* get phase name */				
+				cp[id_cp].in_iter			= gv->global_ite;
 				cp[id_cp].ss_flags[0] 		= 1;						/* set flags */
 				cp[id_cp].ss_flags[1] 		= 0;
 				cp[id_cp].ss_flags[2] 		= 1;
@@ -437,15 +497,13 @@ global_variable check_PC(					struct bulk_info 	 z_b,
 					cp[id_cp].mu[k]    =  0.0;
 				}
 
-				gv.n_solvi[i] 	       	   += 1;
-				gv.id_solvi[i][gv.n_solvi[i]] = id_cp;
+				gv->n_solvi[i] 	       	   += 1;
+				gv->id_solvi[i][gv->n_solvi[i]] = id_cp;
 				phase_add				    = 1;
 			}
 			
 		}
 	}
-
-	return gv;
 };
 
 
@@ -453,17 +511,17 @@ global_variable check_PC(					struct bulk_info 	 z_b,
 /**
 	checks if the pseudocompounds generated during the levelling stage yield a negative driving force
 */
-global_variable check_PC_driving_force(		struct bulk_info 	 z_b,
-											global_variable  	 gv,
+void check_PC_driving_force(		struct bulk_info 	 z_b,
+									global_variable  	*gv,
 
-											PP_ref 				*PP_ref_db,
-											SS_ref 				*SS_ref_db,
-											csd_phase_set  		*cp				
+									PP_ref 				*PP_ref_db,
+									SS_ref 				*SS_ref_db,
+									csd_phase_set  		*cp				
 ){
 
 	int max_n_pc, n_em;
 	printf("\n");
-	for (int i = 0; i < gv.len_ss; i++){
+	for (int i = 0; i < gv->len_ss; i++){
 		if (SS_ref_db[i].ss_flags[0] == 1){
 				
 			n_em 	 = SS_ref_db[i].n_em;
@@ -471,12 +529,12 @@ global_variable check_PC_driving_force(		struct bulk_info 	 z_b,
 			
 			for (int l = 0; l < max_n_pc; l++){
 				SS_ref_db[i].DF_pc[l] = SS_ref_db[i].G_pc[l];
-				for (int j = 0; j < gv.len_ox; j++) {
-					SS_ref_db[i].DF_pc[l] -= SS_ref_db[i].comp_pc[l][j]*gv.gam_tot[j];
+				for (int j = 0; j < gv->len_ox; j++) {
+					SS_ref_db[i].DF_pc[l] -= SS_ref_db[i].comp_pc[l][j]*gv->gam_tot[j];
 				}
 				
 				if (SS_ref_db[i].DF_pc[l] < -1e-10){
-					printf("%4s #%4d | %+10f | ",gv.SS_list[i],l,SS_ref_db[i].DF_pc[l]);
+					printf("%4s #%4d | %+10f | ",gv->SS_list[i],l,SS_ref_db[i].DF_pc[l]);
 					for (int k = 0; k < SS_ref_db[i].n_xeos; k++) {
 						printf(" %+10f",SS_ref_db[i].xeos_pc[l][k]);
 					}
@@ -489,87 +547,115 @@ global_variable check_PC_driving_force(		struct bulk_info 	 z_b,
 			}	
 		}
 	}
+};
+
+/**
+	cache the factor-scaled composition of the endmembers of the considered phases, compacted to the non-zero oxides,
+	and pack their raw composition after the pure phases in the flattened endmember matrix gv.em_C.
+	Compositions and normalization factors do not change during the PGE inner iterations, only the xi, p and ss_n weights do.
+*/
+void PGE_cache_composition(	struct bulk_info 	 z_b,
+							global_variable  	*gv,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set  		*cp
+){
+	int 	ss;
+	double *C;
+
+	gv->n_em_rows = gv->len_pp;
+	for (int i = 0; i < gv->len_cp; i++){
+		cp[i].em_row = -1;
+		if (cp[i].ss_flags[0] == 1){
+			ss = cp[i].id;
+			C  = cp[i].comp_nz;
+			for (int x = 0; x < cp[i].n_em; x++){
+				for (int j = 0; j < z_b.nzEl_val; j++){
+					C[x*z_b.nzEl_val + j] = SS_ref_db[ss].Comp[x][z_b.nzEl_array[j]]*cp[i].factor;
+				}
+			}
 
-	return gv;
+			C  = gv->em_C + gv->n_em_rows;
+			for (int x = 0; x < cp[i].n_em; x++){
+				for (int j = 0; j < gv->len_ox; j++){
+					C[j*gv->em_ld + x] = SS_ref_db[ss].Comp[x][j];
+				}
+			}
+			cp[i].em_row  	= gv->n_em_rows;
+			gv->n_em_rows   += cp[i].n_em;
+		}
+	}
 };
 
 /** 
-	function to fill LHS (J)
+	function to fill LHS (J), uses the compositions cached by PGE_cache_composition
 */
 void PGE_get_Jacobian( 		double 			    *A,
 							struct bulk_info 	 z_b,
-							global_variable  	 gv,
+							global_variable  	*gv,
 							PP_ref 				*PP_ref_db,
 							SS_ref 				*SS_ref_db,
 							csd_phase_set  		*cp,
 							int 				 nEntry
 ){
-	int i,j,k,l,v,x,ph,ss,ix,ix0;
-	
-	/* 1) fill the Top Left corner of the matrix with: fv = sum(nl*sum(a_ij*a_iv*xi_l)) [nzEl_val * nzEl_val entries] */
-	for (v = 0; v < z_b.nzEl_val; v++){
-		/* CONSTRUCT LHS */
-		for (j = 0; j < z_b.nzEl_val; j++){
-			ix = v*nEntry + j;
-			A[ix] = 0.;
-
-			for (i = 0; i < gv.n_cp_phase; i++){
-				ph = gv.cp_id[i];
-				ss = cp[ph].id;
-				for (x = 0; x < cp[ph].n_em; x++){
-					/* CONSTRUCT TL CORNER */
-					A[ix] 					+= 	SS_ref_db[ss].Comp[x][z_b.nzEl_array[j]] * cp[ph].factor * 
-												SS_ref_db[ss].Comp[x][z_b.nzEl_array[v]] * cp[ph].factor * 
-												cp[ph].xi_em[x]*cp[ph].p_em[x] * cp[ph].ss_n * cp[ph].z_em[x];
+	int 	i,j,k,v,x,ph,ix,ix0;
+	int 	m = z_b.nzEl_val;
+	double 	w, wn, *C;
+	double 	*h = gv->ws.h;
+
+	for (v = 0; v < m; v++){
+		for (j = 0; j < m; j++){
+			A[v*nEntry + j] = 0.0;
+		}
+	}
+
+	for (i = 0; i < gv->n_cp_phase; i++){
+		ph = gv->cp_id[i];
+		C  = cp[ph].comp_nz;
+
+		for (j = 0; j < m; j++){ h[j] = 0.0; }
+
+		for (x = 0; x < cp[ph].n_em; x++){
+			w  = cp[ph].xi_em[x]*cp[ph].p_em[x]*cp[ph].z_em[x];
+			if (w == 0.0){ continue; }
+			wn = w*cp[ph].ss_n;
+
+			for (v = 0; v < m; v++){
+				/* 1) Top Left corner (upper triangle): fv = sum(nl*sum(a_ij*a_iv*xi_l)) */
+				for (j = v; j < m; j++){
+					A[v*nEntry + j] += C[x*m + v]*C[x*m + j]*wn;
 				}
+				/* hl = sum(a_ij*xi_l) */
+				h[v] += C[x*m + v]*w;
 			}
 		}
+
+		/* 2) Middle Left row and 4) Top Middle column of the phase */
+		for (j = 0; j < m; j++){
+			A[(i+m)*nEntry + j] = h[j];
+			A[j*nEntry + i + m] = h[j];
+		}
 	}
 
-	/* 2) fill the Middle Left part of the matrix with: hl = sum(a_ij*xi_l)) [n_ss_phase * nzEl_val entries] */
-	for (l = 0; l < gv.n_cp_phase; l++){
-		ph      = gv.cp_id[l];
-		ss 		= cp[ph].id;
-		
-		/* CONSTRUCT LHS */
-		for (j = 0; j < z_b.nzEl_val; j++){								/** shifts by +z_b.nzEl_val */
-			ix = (l+z_b.nzEl_val)*nEntry + j;
-			A[ix] =  0.0;
-			for (i = 0; i < cp[ph].n_em; i++){
-				A[ix] +=  SS_ref_db[ss].Comp[i][z_b.nzEl_array[j]] * cp[ph].factor * (cp[ph].p_em[i]*cp[ph].xi_em[i])  * cp[ph].z_em[i];		
-			}
+	/* lower triangle of the Top Left corner by symmetry */
+	for (v = 1; v < m; v++){
+		for (j = 0; j < v; j++){
+			A[v*nEntry + j] = A[j*nEntry + v];
 		}
 	}
 
 	/* 3) fill the Bottom Left part of the matrix with: qk = a_ik [n_pp_phase * nzEl_val entries] */
-	/* IS THERE A z_b.nzEl_array[v] */
-	for (k = 0; k < gv.n_pp_phase; k++){
-		ph    = gv.pp_id[k];
+	for (k = 0; k < gv->n_pp_phase; k++){
+		ph    = gv->pp_id[k];
 
-		for (v = 0; v < z_b.nzEl_val; v++){ 
-			ix = (k+z_b.nzEl_val+gv.n_cp_phase)*nEntry + v;
+		for (v = 0; v < m; v++){ 
+			ix = (k+m+gv->n_cp_phase)*nEntry + v;
 			A[ix] = PP_ref_db[ph].Comp[z_b.nzEl_array[v]] * PP_ref_db[ph].factor;
 		}
 	}
 
-	/* 4) fill the TM */
-	for (l = 0; l < gv.n_cp_phase; l++){
-		ph      = gv.cp_id[l];
-		ss 		= cp[ph].id;
-		
-		/* CONSTRUCT LHS */
-		for (j = 0; j < z_b.nzEl_val; j++){
-			ix0    = j*nEntry + l + z_b.nzEl_val;
-			A[ix0] =  0.0;
-			for (i = 0; i < cp[ph].n_em; i++){
-				A[ix0] +=  SS_ref_db[ss].Comp[i][z_b.nzEl_array[j]] * cp[ph].factor * (cp[ph].p_em[i]*cp[ph].xi_em[i])  * cp[ph].z_em[i];		
-			}
-		}
-	}
-
 	/* 5) fill the TR corner by symmetry */
-	for (i = z_b.nzEl_val+gv.n_cp_phase; i < nEntry; i++){
-		for (j = 0; j < z_b.nzEl_val; j++){
+	for (i = m+gv->n_cp_phase; i < nEntry; i++){
+		for (j = 0; j < m; j++){
 			ix  = i*nEntry + j;
 			ix0 = j*nEntry + i;
 			
@@ -590,70 +676,78 @@ void PGE_get_Jacobian( 		double 			    *A,
 }
 
 /** 
-	function to fill RHS gradient
+	function to fill RHS gradient, uses the compositions cached by PGE_cache_composition
 */
 void PGE_get_gradient( 		double				*b,
 							struct bulk_info 	 z_b,
-							global_variable  	 gv,
+							global_variable  	*gv,
 							PP_ref 				*PP_ref_db,
 							SS_ref 				*SS_ref_db,
 							csd_phase_set  		*cp,
 							int 				 nEntry
 ){
-	int i,j,k,l,v,x,ph,ss;
+	int 	i,k,l,v,x,ph;
+	int 	m = z_b.nzEl_val;
+	double 	wn, *C;
 
-	/* 1) fill the Top Left corner of the matrix with: fv = sum(nl*sum(a_ij*a_iv*xi_l)) [nzEl_val * nzEl_val entries] */
-	for (v = 0; v < z_b.nzEl_val; v++){
-		/* CONSTRUCT RHS */
-		b[v]   = - z_b.bulk_rock[z_b.nzEl_array[v]];
-		
-		for (i = 0; i < gv.n_cp_phase; i++){
-			ph = gv.cp_id[i];
-			ss = cp[ph].id;
-			for (x = 0; x < cp[ph].n_em; x++){
-				b[v] 	+= SS_ref_db[ss].Comp[x][z_b.nzEl_array[v]] * cp[ph].factor * (cp[ph].p_em[x]*cp[ph].xi_em[x]) * cp[ph].ss_n * cp[ph].z_em[x];
+	/* 1) mass constraint: bulk - sum(nl*sum(a_ij*xi_l)) - sum(nk*a_ik) [nzEl_val entries] */
+	for (v = 0; v < m; v++){
+		b[v] = - z_b.bulk_rock[z_b.nzEl_array[v]];
+	}
+
+	for (i = 0; i < gv->n_cp_phase; i++){
+		ph = gv->cp_id[i];
+		C  = cp[ph].comp_nz;
+		for (x = 0; x < cp[ph].n_em; x++){
+			wn = cp[ph].p_em[x]*cp[ph].xi_em[x]*cp[ph].ss_n*cp[ph].z_em[x];
+			if (wn == 0.0){ continue; }
+			for (v = 0; v < m; v++){
+				b[v] += C[x*m + v]*wn;
 			}
 		}
-		
-		for (k = 0; k < gv.n_pp_phase; k++){
-			ph = gv.pp_id[k];
-			b[v] 	    += PP_ref_db[ph].Comp[z_b.nzEl_array[v]] * PP_ref_db[ph].factor * gv.pp_n[ph] ;
+	}
+
+	for (k = 0; k < gv->n_pp_phase; k++){
+		ph = gv->pp_id[k];
+		for (v = 0; v < m; v++){
+			b[v] += PP_ref_db[ph].Comp[z_b.nzEl_array[v]] * PP_ref_db[ph].factor * gv->pp_n[ph];
 		}
+	}
+
+	for (v = 0; v < m; v++){
 		b[v] *= -1.0;
 	}
 
 	/* 2) fill the Middle Left part of the matrix with: hl = sum(a_ij*xi_l)) [n_ss_phase * nzEl_val entries] */
-	for (l = 0; l < gv.n_cp_phase; l++){
-		ph      = gv.cp_id[l];
-		ss 		= cp[ph].id;
+	for (l = 0; l < gv->n_cp_phase; l++){
+		ph      = gv->cp_id[l];
 		
 		/* CONSTRUCT RHS */
-		b[l+z_b.nzEl_val]    = -1.0;
+		b[l+m]    = -1.0;
 		for (i = 0; i < cp[ph].n_em; i++){
-			b[l+z_b.nzEl_val]    +=  (cp[ph].p_em[i]*cp[ph].xi_em[i])* cp[ph].z_em[i];
+			b[l+m]    +=  (cp[ph].p_em[i]*cp[ph].xi_em[i])* cp[ph].z_em[i];
 		}
-		b[l+z_b.nzEl_val] *= -1.0;
+		b[l+m] *= -1.0;
 	}
 
 	/* 3) fill the Bottom Left part of the matrix with: qk = a_ik [n_pp_phase * nzEl_val entries] */
-	/* IS THERE A z_b.nzEl_array[v] */
-	for (k = 0; k < gv.n_pp_phase; k++){
-		ph    = gv.pp_id[k];
+	for (k = 0; k < gv->n_pp_phase; k++){
+		ph    = gv->pp_id[k];
 
-		b[k+z_b.nzEl_val+gv.n_cp_phase]        = -PP_ref_db[ph].gbase;	
-		for (v = 0; v < z_b.nzEl_val; v++){ 
-			b[k+z_b.nzEl_val+gv.n_cp_phase]   += PP_ref_db[ph].Comp[z_b.nzEl_array[v]] * gv.gam_tot[z_b.nzEl_array[v]];
+		b[k+m+gv->n_cp_phase]        = -PP_ref_db[ph].gbase;	
+		for (v = 0; v < m; v++){ 
+			b[k+m+gv->n_cp_phase]   += PP_ref_db[ph].Comp[z_b.nzEl_array[v]] * gv->gam_tot[z_b.nzEl_array[v]];
 		}
-		b[k+z_b.nzEl_val+gv.n_cp_phase]  *= -1.0;
+		b[k+m+gv->n_cp_phase]  *= -1.0;
 	}
 }
 
 /** 
   Partitioning Gibbs Energy function 
 */
-global_variable PGE_update_solution(	global_variable  	 gv,
-										struct bulk_info 	 z_b,
-										csd_phase_set  		*cp	){
+void PGE_update_solution(	global_variable  	*gv,
+							struct bulk_info 	 z_b,
+							csd_phase_set  		*cp	){
 	int 	i, j, k, ph;										
 	double 	n_fac, 
 			g_fac, 
@@ -668,97 +762,184 @@ global_variable PGE_update_solution(	global_variable  	 gv,
 		calculate under relaxing factor
 	*/
 	for (i = 0; i < z_b.nzEl_val; i++){
-		gv.dGamma[i] = gv.b_PGE[i];
+		gv->dGamma[i] = gv->ws.b[i];
 	}
-	for (i = 0; i < gv.n_cp_phase; i++){
-		gv.dn_cp[i] = gv.b_PGE[i+z_b.nzEl_val];
+	for (i = 0; i < gv->n_cp_phase; i++){
+		gv->dn_cp[i] = gv->ws.b[i+z_b.nzEl_val];
 	}
-	for (i = 0; i < gv.n_pp_phase; i++){
-		gv.dn_pp[i] = gv.b_PGE[i+z_b.nzEl_val + gv.n_cp_phase];
+	for (i = 0; i < gv->n_pp_phase; i++){
+		gv->dn_pp[i] = gv->ws.b[i+z_b.nzEl_val + gv->n_cp_phase];
 	}
 	
-	max_dG 		= norm_vector(gv.dGamma,z_b.nzEl_val);
-	max_dnss 	= norm_vector(gv.dn_cp,gv.n_cp_phase);
-	max_dnpp 	= norm_vector(gv.dn_pp,gv.n_pp_phase);
+	max_dG 		= norm_vector(gv->dGamma,z_b.nzEl_val);
+	max_dnss 	= norm_vector(gv->dn_cp,gv->n_cp_phase);
+	max_dnpp 	= norm_vector(gv->dn_pp,gv->n_pp_phase);
 	max_dn 		= ((max_dnss < max_dnpp) ? (max_dnpp) : (max_dnss) );
-	max_dG_ss   = gv.relax_PGE_val*exp(-8.0*pow(gv.BR_norm,0.28))+1.0;
+	max_dG_ss   = gv->relax_PGE_val*exp(-8.0*pow(gv->BR_norm,0.28))+1.0;
 	
-	g_fac       = (gv.max_g_phase/max_dG_ss)/max_dG;
-	n_fac   	= (gv.max_n_phase/max_dG_ss)/max_dn;
+	g_fac       = (gv->max_g_phase/max_dG_ss)/max_dG;
+	n_fac   	= (gv->max_n_phase/max_dG_ss)/max_dn;
 	alpha 		= ((n_fac < g_fac) 	 	? 	(n_fac) 		: (g_fac)	);
-	alpha 		= ((alpha > gv.max_fac) ? 	(gv.max_fac) 	: (alpha)	);
-	gv.alpha	= alpha; 		
+	alpha 		= ((alpha > gv->max_fac) ? 	(gv->max_fac) 	: (alpha)	);
+	gv->alpha	= alpha; 		
 	
 	/* Update Gamma */
 	for (i = 0; i < z_b.nzEl_val; i++){
-		gv.delta_gam_tot[z_b.nzEl_array[i]]  = gv.dGamma[i]*alpha;	
-		gv.gam_tot[z_b.nzEl_array[i]] 		+= gv.dGamma[i]*alpha;		
+		gv->delta_gam_tot[z_b.nzEl_array[i]]  = gv->dGamma[i]*alpha;	
+		gv->gam_tot[z_b.nzEl_array[i]] 		+= gv->dGamma[i]*alpha;		
 	}
 	
-	gv.gamma_norm[gv.global_ite] = norm_vector(gv.dGamma, z_b.nzEl_val);
+	gv->gamma_norm[gv->global_ite] = norm_vector(gv->dGamma, z_b.nzEl_val);
 
 	/* Update solusion phase (SS) fractions */
-	for (i = 0; i < gv.n_cp_phase; i++){
-		 cp[gv.cp_id[i]].delta_ss_n  = gv.dn_cp[i]*alpha;
-		 cp[gv.cp_id[i]].ss_n 		+= gv.dn_cp[i]*alpha;
+	for (i = 0; i < gv->n_cp_phase; i++){
+		 cp[gv->cp_id[i]].delta_ss_n  = gv->dn_cp[i]*alpha;
+		 cp[gv->cp_id[i]].ss_n 		+= gv->dn_cp[i]*alpha;
 	}
 	
 	/* Update pure phase (PP) fractions */
-	if (gv.n_pp_phase > 0){
-		for (i = 0; i < gv.n_pp_phase; i++){
-			 gv.pp_n[gv.pp_id[i]] 		+= gv.dn_pp[i]*alpha;
-			 gv.delta_pp_n[gv.pp_id[i]]  = gv.dn_pp[i]*alpha;
+	if (gv->n_pp_phase > 0){
+		for (i = 0; i < gv->n_pp_phase; i++){
+			 gv->pp_n[gv->pp_id[i]] 		+= gv->dn_pp[i]*alpha;
+			 gv->delta_pp_n[gv->pp_id[i]]  = gv->dn_pp[i]*alpha;
 		}
 	}
-	
-	return gv;
+};
+
+/** 
+	Solve the PGE system using its block structure:
+
+	| F  G'| |dGamma|   |b1|		F : oxide-oxide block (symmetric positive semi-definite, m = nzEl_val)
+	| G  0 | |dn    | = |b2|		G : phase rows (solution phases then pure phases), the phase-phase block is empty
+
+	F is augmented with g*G'G (using the second block row G*dGamma = b2), K = F + g*G'G is then positive definite
+	whenever the system is not singular. The phase fractions are obtained from the Schur complement S = G*inv(K)*G'
+	and Gamma from K, both using Cholesky factorizations. Returns 1 if a factorization fails (A and b are unchanged).
+*/
+int PGE_solve_schur(		double 				*A,
+							double 				*b,
+							int 				 m,
+							int 				 nEntry,
+							PGE_workspace 		 ws
+){
+	int 	np = nEntry - m;
+	double 	*K = ws.K, *W = ws.W, *S = ws.S, *y = ws.y, *dn = ws.dn;
+	double 	g, tr_F = 0.0, tr_G = 0.0;
+
+	/* scaling of the augmentation term */
+	for (int i = 0; i < m; i++){
+		tr_F += A[i*nEntry + i];
+		for (int k = 0; k < np; k++){
+			tr_G += A[(m+k)*nEntry + i]*A[(m+k)*nEntry + i];
+		}
+	}
+	g = (tr_F > 0.0 && tr_G > 0.0) ? (tr_F/tr_G) : (1.0);
+
+	/* K = F + g*G'G and y = b1 + g*G'b2 */
+	for (int i = 0; i < m; i++){
+		y[i] = b[i];
+		for (int k = 0; k < np; k++){
+			y[i] += g*A[(m+k)*nEntry + i]*b[m+k];
+		}
+		for (int j = 0; j <= i; j++){
+			K[i*m + j] = A[i*nEntry + j];
+			for (int k = 0; k < np; k++){
+				K[i*m + j] += g*A[(m+k)*nEntry + i]*A[(m+k)*nEntry + j];
+			}
+			K[j*m + i] = K[i*m + j];
+		}
+	}
+	if (cholesky_factor(K, m) != 0){ return 1; }
+	cholesky_solve(K, y, m);
+
+	if (np > 0){
+		/* W = inv(K)*G' (column k stored in W[k*m]) */
+		for (int k = 0; k < np; k++){
+			for (int i = 0; i < m; i++){
+				W[k*m + i] = A[(m+k)*nEntry + i];
+			}
+			cholesky_solve(K, W + k*m, m);
+		}
+
+		/* S = G*W and rhs = G*y - b2 */
+		for (int k = 0; k < np; k++){
+			dn[k] = -b[m+k];
+			for (int i = 0; i < m; i++){
+				dn[k] += A[(m+k)*nEntry + i]*y[i];
+			}
+			for (int l = 0; l <= k; l++){
+				S[k*np + l] = 0.0;
+				for (int i = 0; i < m; i++){
+					S[k*np + l] += A[(m+k)*nEntry + i]*W[l*m + i];
+				}
+				S[l*np + k] = S[k*np + l];
+			}
+		}
+		if (cholesky_factor(S, np) != 0){ return 1; }
+		cholesky_solve(S, dn, np);
+
+		/* dGamma = y - W*dn */
+		for (int k = 0; k < np; k++){
+			for (int i = 0; i < m; i++){
+				y[i] -= W[k*m + i]*dn[k];
+			}
+		}
+	}
+
+	for (int i = 0; i < m; i++){
+		b[i] = y[i];
+	}
+	for (int k = 0; k < np; k++){
+		b[m+k] = dn[k];
+	}
+
+	return 0;
 };
 
 /** 
   Partitioning Gibbs Energy function 
 */
-global_variable PGE_function(	int 				PGEi,
-								struct bulk_info 	z_b,
-								global_variable  	gv,
+void PGE_function(	int 				PGEi,
+					struct bulk_info 	z_b,
+					global_variable  	*gv,
 
-								PP_ref 				*PP_ref_db,
-								SS_ref 				*SS_ref_db,
-								csd_phase_set  		*cp
+					PP_ref 				*PP_ref_db,
+					SS_ref 				*SS_ref_db,
+					csd_phase_set  		*cp
 ){
 	/* allocate */
 	int 	i,j,k,l,v,x,ph,ss;
 
 	/* extract the number of entries in the matrix */
-	int 	nEntry = z_b.nzEl_val + gv.n_phase;
+	int 	nEntry = z_b.nzEl_val + gv->n_phase;
 	
-	/* LAPACKE memory allocation */
+	/* LAPACKE memory allocation (LU fallback) */
 	int 	nrhs   = 1;													/** number of rhs columns, 1 is vector*/
 	int 	lda    = nEntry;											/** leading dimesion of A*/
 	int 	ldb    = 1;													/** leading dimension of b*/
-	int 	ipiv[nEntry];												/** pivot indices*/
 	int 	info;														/** get info from lapacke function*/
 
-	for (i = 0; i < z_b.nzEl_val;  i++){ gv.dGamma[i] 	= 0.0;	}		/** initialize dGamma to 0.0 */
-	for (i = 0; i < gv.n_cp_phase; i++){ gv.dn_cp[i]  	= 0.0;	}		/** initialize dGamma to 0.0 */
-	for (i = 0; i < gv.n_pp_phase; i++){ gv.dn_pp[i]  	= 0.0;	}		/** initialize dGamma to 0.0 */
-    for (i = 0; i < nEntry*nEntry; i++){ gv.A_PGE[i]  	= 0.0;	}
-	for (i = 0; i < nEntry; i++){ 		 gv.b_PGE[i]  	= 0.0;	}
+	for (i = 0; i < z_b.nzEl_val;  i++){ gv->dGamma[i] 	= 0.0;	}		/** initialize dGamma to 0.0 */
+	for (i = 0; i < gv->n_cp_phase; i++){ gv->dn_cp[i]  	= 0.0;	}		/** initialize dGamma to 0.0 */
+	for (i = 0; i < gv->n_pp_phase; i++){ gv->dn_pp[i]  	= 0.0;	}		/** initialize dGamma to 0.0 */
+    for (i = 0; i < nEntry*nEntry; i++){ gv->ws.A[i]  	= 0.0;	}
+	for (i = 0; i < nEntry; i++){ 		 gv->ws.b[i]  	= 0.0;	}
 
 	/**
 		get id of active pure phases
 	*/
-	gv = get_pp_id(			gv					);
+	get_pp_id(			gv					);
 	
 	/**
 		get id of active solution phases
 	*/
-	gv = get_ss_id(			gv,
-							cp					);
+	get_ss_id(			gv,
+						cp					);
 	
 	/** 
 		function to fill Jacobian
 	*/
-	PGE_get_Jacobian( 		gv.A_PGE,
+	PGE_get_Jacobian( 		gv->ws.A,
 							z_b,
 							gv,
 
@@ -770,7 +951,7 @@ global_variable PGE_function(	int 				PGEi,
 	/** 
 		function to fill gradient
 	*/
-	PGE_get_gradient( 		gv.b_PGE,
+	PGE_get_gradient( 		gv->ws.b,
 							z_b,
 							gv,
 
@@ -782,61 +963,76 @@ global_variable PGE_function(	int 				PGEi,
 	/**
 		save RHS vector 
 	*/
-	gv.fc_norm_t1 = norm_vector(	gv.b_PGE,
+	gv->fc_norm_t1 = norm_vector(	gv->ws.b,
 									nEntry		);
 										
 	/**
-		call lapacke to solve system of linear equation using LU 
+		solve the system using its block structure, LU decomposition (lapacke) is used when the Cholesky factorizations fail
 	*/
-	info = LAPACKE_dgesv(	LAPACK_ROW_MAJOR, 
-							nEntry, 
-							nrhs, 
-							gv.A_PGE, 
-							lda, 
-							ipiv, 
-							gv.b_PGE, 
-							ldb					);
+	info = PGE_solve_schur(	gv->ws.A,
+							gv->ws.b,
+							z_b.nzEl_val,
+							nEntry,
+							gv->ws				);
+
+	if (info != 0){
+		info = LAPACKE_dgesv(	LAPACK_ROW_MAJOR, 
+								nEntry, 
+								nrhs, 
+								gv->ws.A, 
+								lda, 
+								gv->ws.ipiv, 
+								gv->ws.b, 
+								ldb					);
+	}
 
 	/**
 		get solution and max values for the set of variables
 	*/
-	gv = PGE_update_solution(	gv,
-								z_b,
-								cp				);
-
-	return gv;
+	PGE_update_solution(	gv,
+							z_b,
+							cp				);
 };
 
 /** 
   Partitioning Gibbs Energy function 
 */
-global_variable PGE_inner_loop(		struct bulk_info 	z_b,
-									global_variable  	gv,
+void PGE_inner_loop(		struct bulk_info 	z_b,
+							global_variable  	*gv,
 
-									PP_ref 				*PP_ref_db,
-									SS_ref 				*SS_ref_db,
-									csd_phase_set  		*cp
+							PP_ref 				*PP_ref_db,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set  		*cp
 ){
 	clock_t u; 
 	int 	PGEi   			= 0;
+	int 	n_ph_change 	= 0;
 	double 	fc_norm_t0 		= 0.0;
 	double 	delta_fc_norm 	= 1.0;
 
+	/**
+		compositions of the phases are fixed during the inner iterations
+	*/
+	PGE_cache_composition(		z_b,
+								gv,
+								SS_ref_db,
+								cp						);
+
 	/* transform to while if delta_phase fraction < val */
-	while (PGEi < gv.inner_PGE_ite && delta_fc_norm > 1e-10){
+	while (PGEi < gv->inner_PGE_n && delta_fc_norm > 1e-10){
 		u = clock();
 
-		gv =	PGE_function(			PGEi,
-										z_b,								/** bulk rock constraint 				*/ 
-										gv,									/** global variables (e.g. Gamma) 		*/
+		PGE_function(			PGEi,
+								z_b,								/** bulk rock constraint 				*/ 
+								gv,									/** global variables (e.g. Gamma) 		*/
 
-										PP_ref_db,							/** pure phase database 				*/ 
-										SS_ref_db,							/** solution phase database 			*/
-										cp						); 
+								PP_ref_db,							/** pure phase database 				*/ 
+								SS_ref_db,							/** solution phase database 			*/
+								cp						); 
 				
 								
-		delta_fc_norm 	= fabs(gv.fc_norm_t1 - fc_norm_t0);
-		fc_norm_t0 		= gv.fc_norm_t1;
+		delta_fc_norm 	= fabs(gv->fc_norm_t1 - fc_norm_t0);
+		fc_norm_t0 		= gv->fc_norm_t1;
 		
 							
 		/**
@@ -849,101 +1045,395 @@ global_variable PGE_inner_loop(		struct bulk_info 	z_b,
 										
 							
 		/* Update mu of solution phase  */
-		gv =	PGE_update_mu(			z_b,								/** bulk rock constraint 				*/ 
-										gv,									/** global variables (e.g. Gamma) 		*/
+		PGE_update_mu(			z_b,								/** bulk rock constraint 				*/ 
+								gv,									/** global variables (e.g. Gamma) 		*/
 
-										PP_ref_db,							/** pure phase database 				*/ 
-										SS_ref_db,							/** solution phase database 			*/
-										cp						); 
+								PP_ref_db,							/** pure phase database 				*/ 
+								SS_ref_db,							/** solution phase database 			*/
+								cp						); 
 
 		/* Update mu and xi of solution phase  */
-		if (gv.BR_norm < gv.act_varFac_stab){
-			gv =	PGE_update_pi(			z_b,								/** bulk rock constraint 				*/ 
-											gv,									/** global variables (e.g. Gamma) 		*/
+		if (gv->BR_norm < gv->act_varFac_stab){
+			PGE_update_pi(			z_b,								/** bulk rock constraint 				*/ 
+									gv,									/** global variables (e.g. Gamma) 		*/
 
-											PP_ref_db,							/** pure phase database 				*/ 
-											SS_ref_db,							/** solution phase database 			*/
-											cp					);  
+									PP_ref_db,							/** pure phase database 				*/ 
+									SS_ref_db,							/** solution phase database 			*/
+									cp					);  
 		}	
 		else{
-			gv =	PGE_update_xi(			z_b,								/** bulk rock constraint 				*/ 
-											gv,									/** global variables (e.g. Gamma) 		*/
+			PGE_update_xi(			z_b,								/** bulk rock constraint 				*/ 
+									gv,									/** global variables (e.g. Gamma) 		*/
 
-											PP_ref_db,							/** pure phase database 				*/ 
-											SS_ref_db,							/** solution phase database 			*/
-											cp					);  
+									PP_ref_db,							/** pure phase database 				*/ 
+									SS_ref_db,							/** solution phase database 			*/
+									cp					);  
 											
 		}
 
-		gv = 	phase_update_function(	z_b,								/** bulk rock constraint 				*/
-										gv,									/** global variables (e.g. Gamma) 		*/
+		phase_update_function(	z_b,								/** bulk rock constraint 				*/
+								gv,									/** global variables (e.g. Gamma) 		*/
+
+								PP_ref_db,							/** pure phase database 				*/
+								SS_ref_db,							/** solution phase database 			*/ 
+								cp						); 
+		n_ph_change += gv->ph_change;
 
-										PP_ref_db,							/** pure phase database 				*/
-										SS_ref_db,							/** solution phase database 			*/ 
-										cp						); 
 		/** 
 			Update mass constraint residual
 		*/
-		gv = PGE_residual_update_function(	z_b,							/** bulk rock constraint 				*/ 
-											gv,								/** global variables (e.g. Gamma) 		*/
+		PGE_residual_update_function(	z_b,							/** bulk rock constraint 				*/ 
+										gv,								/** global variables (e.g. Gamma) 		*/
 
-											PP_ref_db,						/** pure phase database 				*/ 
-											SS_ref_db,						/** solution phase database 			*/
-											cp					);  
+										PP_ref_db,						/** pure phase database 				*/ 
+										SS_ref_db,						/** solution phase database 			*/
+										cp					);  
 		
 		u = clock() - u; 
-		gv.inner_PGE_ite_time =(((double)u)/CLOCKS_PER_SEC*1000);
+		gv->inner_PGE_ite_time =(((double)u)/CLOCKS_PER_SEC*1000);
 		PGEi += 1;
 	} 
-		
-   return gv;
+	gv->ph_change_PGE = n_ph_change;
 };
 
 
 
+/**
+	Anderson mixing of Gamma over the last gv.aa_depth global iterations.
+
+	A global iteration is seen as a fixed-point map x -> g(x) of Gamma with residual f = g(x) - x. The mixed iterate is
+	g - dG*c, where c minimizes |f - dF*c| over the stored differences of the residuals (dF) and of the iterates (dG).
+	The history is cleared, and the under-relaxed PGE update is kept as is, when the mass constraint residual grows,
+	when the set of active phases changes or when the least-square problem is ill-conditioned. Corrections larger
+	than gv.max_g_phase are rejected.
+*/
+void PGE_anderson_mixing(	struct bulk_info 	z_b,
+							global_variable  	*gv,
+
+							PP_ref 				*PP_ref_db,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set  		*cp
+){
+	int 	m 		= z_b.nzEl_val;
+	int 	reset 	= 0;
+	int 	i, j, k, n;
+	double 	*f = gv->ws.aa_r, *g = gv->ws.aa_y, *d = gv->ws.aa_d, *M = gv->ws.aa_M, *c = gv->ws.aa_c;
+	double 	tr, norm_d;
+
+	for (i = 0; i < m; i++){
+		g[i] = gv->gam_tot[z_b.nzEl_array[i]];
+		f[i] = g[i] - gv->aa_x[i];
+	}
+
+	/* restart when the residual grows or when the phase assemblage changed */
+	if (gv->aa_n < 0 || gv->BR_norm > gv->aa_br){ reset = 1; }
+
+	for (i = 0; i < gv->len_pp; i++){
+		if (gv->aa_ph[i] != gv->pp_flags[i][1]){ reset = 1; }
+		gv->aa_ph[i] = gv->pp_flags[i][1];
+	}
+	for (i = 0; i < gv->len_cp; i++){
+		if (gv->aa_ph[gv->len_pp + i] != cp[i].ss_flags[1]){ reset = 1; }
+		gv->aa_ph[gv->len_pp + i] = cp[i].ss_flags[1];
+	}
+
+	if (reset == 0){
+		/* store the new differences */
+		k = gv->aa_pos;
+		for (i = 0; i < m; i++){
+			gv->aa_dF[k*gv->len_ox + i] = f[i] - gv->aa_f[i];
+			gv->aa_dG[k*gv->len_ox + i] = g[i] - gv->aa_g[i];
+		}
+		gv->aa_pos = (gv->aa_pos + 1) % gv->aa_depth;
+		if (gv->aa_n < gv->aa_depth){ gv->aa_n += 1; }
+		n = gv->aa_n;
+
+		/* normal equations of the least-square problem (slightly regularized) */
+		tr = 0.0;
+		for (j = 0; j < n; j++){
+			c[j] = 0.0;
+			for (i = 0; i < m; i++){
+				c[j] += gv->aa_dF[j*gv->len_ox + i]*f[i];
+			}
+			for (k = 0; k <= j; k++){
+				M[j*n + k] = 0.0;
+				for (i = 0; i < m; i++){
+					M[j*n + k] += gv->aa_dF[j*gv->len_ox + i]*gv->aa_dF[k*gv->len_ox + i];
+				}
+				M[k*n + j] = M[j*n + k];
+			}
+			tr += M[j*n + j];
+		}
+		for (j = 0; j < n; j++){
+			M[j*n + j] += 1e-10*tr;
+		}
+
+		if (tr == 0.0 || cholesky_factor(M, n) != 0){
+			reset = 1;
+		}
+		else{
+			cholesky_solve(M, c, n);
+
+			for (i = 0; i < m; i++){
+				d[i] = 0.0;
+				for (j = 0; j < n; j++){
+					d[i] -= gv->aa_dG[j*gv->len_ox + i]*c[j];
+				}
+			}
+			norm_d = norm_vector(d, m);
+
+			if (norm_d < gv->max_g_phase){
+				for (i = 0; i < gv->len_ox; i++){
+					gv->delta_gam_tot[i] = 0.0;
+				}
+				for (i = 0; i < m; i++){
+					gv->gam_tot[z_b.nzEl_array[i]] 		+= d[i];
+					gv->delta_gam_tot[z_b.nzEl_array[i]]  = d[i];
+				}
+
+				/* rotate the chemical potential of the endmembers with respect to the mixed Gamma */
+				PGE_update_mu(		z_b,
+									gv,
+									PP_ref_db,
+									SS_ref_db,
+									cp				);
+
+				if (gv->verbose == 1){
+					printf(" Anderson mixing of Gamma, %d previous iterations, |correction| = %+10e\n", n, norm_d);
+				}
+			}
+		}
+	}
+
+	if (reset == 1){
+		gv->aa_n 	= 0;
+		gv->aa_pos 	= 0;
+	}
+
+	for (i = 0; i < m; i++){
+		gv->aa_f[i] = f[i];
+		gv->aa_g[i] = g[i];
+		gv->aa_x[i] = gv->gam_tot[z_b.nzEl_array[i]];
+	}
+	gv->aa_br = gv->BR_norm;
+};
+
+/**
+	Adaptive control of the PGE iterations (adapt_PGE = 1), called at the end of every global iteration:
+
+	- the number of inner iterations is decreased when the mass constraint residual drops quickly (less than half of
+	  the previous one) and increased when it stalls (more than 90% of the previous one)
+	- the converged global iterations (mass constraint satisfied, steady Gamma and phase assemblage, pseudocompounds
+	  checked) are counted, the solution is accepted after adapt_min_stable of them even if outter_PGE_ite is not reached
+*/
+void PGE_adapt_iterations(	struct bulk_info 	z_b,
+							global_variable  	*gv
+){
+	int 	ite = gv->global_ite;
+	double 	ratio;
+
+	if (ite > 1 && gv->PGE_mass_norm[ite-1] > 0.0){
+		ratio = gv->PGE_mass_norm[ite]/gv->PGE_mass_norm[ite-1];
+
+		if 		(ratio < 0.5 && gv->inner_PGE_n > gv->inner_PGE_min){ gv->inner_PGE_n -= 1; }
+		else if (ratio > 0.9 && gv->inner_PGE_n < gv->inner_PGE_max){ gv->inner_PGE_n += 1; }
+	}
+
+	if (		gv->BR_norm 				< gv->br_max_tol
+			&& 	gv->gamma_norm[ite-1] 	< gv->adapt_gam_tol
+			&& 	gv->ph_change_PGE 		== 0
+			&& 	gv->check_PC 			== 1
+			&& 	ite 					> gv->check_PC_ite + 1 	){
+		gv->adapt_n_stable += 1;
+	}
+	else{
+		gv->adapt_n_stable  = 0;
+	}
+
+	if (gv->verbose == 1){
+		printf(" Adaptive PGE: %d inner iterations, %d converged global iteration(s)\n", gv->inner_PGE_n, gv->adapt_n_stable);
+	}
+};
+
+/**
+	Estimated distance of considered phase i to the G-hyperplane: the driving force minus its change since the last
+	minimization (a phase moving quickly may have come closer), times the normalization factor
+*/
+double PGE_LM_dist(		int 				 i,
+						csd_phase_set  		*cp
+){
+	return (cp[i].df - fabs(cp[i].df - cp[i].df_LM))*cp[i].factor;
+};
+
+/**
+	Rank the minimized on-hold phases by their estimated distance to the G-hyperplane, closest first (LM_schedule = 1).
+	The rank of the other considered phases is -1
+*/
+void PGE_LM_rank(		global_variable  	*gv,
+						csd_phase_set  		*cp
+){
+	struct str *hld_cp_sort = gv->ws.hld_cp_sort;
+	int 	   *lm_rank 	= gv->ws.lm_rank;
+	int 		n_hld 		= 0;
+
+	for (int i = 0; i < gv->max_n_cp; i++){
+		lm_rank[i] = -1;
+	}
+	if (gv->LM_schedule != 1){
+		return;
+	}
+
+	for (int i = 0; i < gv->len_cp; i++){
+		if (cp[i].ss_flags[0] == 1 && cp[i].ss_flags[1] == 0 && cp[i].n_LM > 0){
+			hld_cp_sort[n_hld].value = PGE_LM_dist(i, cp);
+			hld_cp_sort[n_hld].index = i;
+			n_hld += 1;
+		}
+	}
+	qsort(hld_cp_sort, n_hld, sizeof(hld_cp_sort[0]), cmp_dbl);
+
+	for (int k = 0; k < n_hld; k++){
+		lm_rank[hld_cp_sort[k].index] = k;
+	}
+};
+
+/**
+	Decide if considered phase i has to be locally minimized during the current global iteration:
+
+	- a phase that has not been minimized yet for this point is always minimized
+	- adapt_PGE = 1: a phase whose last minimizations left x-eos and df unchanged is skipped while Gamma is steady
+	- LM_schedule = 1: the on-hold phases are ranked by their estimated distance to the G-hyperplane (PGE_LM_rank).
+	  The LM_n_near closest phases and the phases closer than LM_df_near are minimized every iteration, the others
+	  only every LM_hld_refresh+1 iterations. Active phases are always minimized.
+
+	The chemical potential and driving force of skipped phases are still rotated with Gamma during the PGE stage.
+*/
+int PGE_LM_needed(		int 				 i,
+						global_variable  	*gv,
+						csd_phase_set  		*cp
+){
+	if (cp[i].n_LM == 0 || gv->global_ite == 0){
+		return 1;
+	}
+
+	if (		gv->adapt_PGE 				== 1
+			&& 	cp[i].min_stable 			>= 2
+			&& 	cp[i].min_skip 				<  gv->adapt_max_skip
+			&& 	gv->gamma_norm[gv->global_ite-1] < gv->adapt_gam_tol	){
+		return 0;
+	}
+
+	if (gv->LM_schedule == 1 && cp[i].ss_flags[1] == 0 && gv->ws.lm_rank[i] >= gv->LM_n_near){
+		if (PGE_LM_dist(i, cp) > gv->LM_df_near && cp[i].min_skip < gv->LM_hld_refresh){
+			return 0;
+		}
+	}
+
+	return 1;
+};
+
+/**
+	Local minimization of the n_lm considered phases listed in lm_id, shared between gv.LM_threads OpenMP threads.
+
+	Each thread minimizes in its own scratch copy of the solution phases (gv.SS_th), so the instances of a solvus
+	do not overwrite each other's working arrays. cp[i] is only written by the thread minimizing i, and SS_ref_db
+	receives the scratch state of the last minimized instance of each phase, such that the result does not depend
+	on the thread scheduling.
+*/
+void PGE_LM_threads(	int 				 mode,
+						int 				*lm_id,
+						int 				 n_lm,
+						global_variable  	*gv,
+						struct bulk_info 	 z_b,
+						SS_ref 				*SS_ref_db,
+						csd_phase_set  		*cp
+){
+	int *th_id 	= gv->ws.th_id;
+	int *done 	= gv->ws.done;
+
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(gv->LM_threads)
+	for (int k = 0; k < n_lm; k++){
+		int i 		= lm_id[k];
+		int ph_id 	= cp[i].id;
+		int thread 	= 0;
+#ifdef _OPENMP
+		thread 		= omp_get_thread_num();
+#endif
+		gv->SS_th[thread][ph_id] = SS_scratch_swap(	SS_ref_db[ph_id],
+													gv->SS_th[thread][ph_id]	);
+		ss_min_PGE(			mode, i,
+							gv,
+							z_b,
+							gv->SS_th[thread],
+							cp 					);
+		th_id[k] 	= thread;
+	}
+
+	/* write back the state of the last minimized instance of each phase */
+	for (int i = 0; i < gv->len_ss; i++){
+		done[i] = 0;
+	}
+	for (int k = n_lm - 1; k >= 0; k--){
+		int ph_id = cp[lm_id[k]].id;
+		if (done[ph_id] == 0){
+			SS_ref_db[ph_id] = SS_scratch_copy(	gv,
+												SS_ref_db[ph_id],
+												gv->SS_th[th_id[k]][ph_id]	);
+			done[ph_id] 	 = 1;
+		}
+	}
+};
+
 /** 
   Main PGE routine
 */ 
-global_variable PGE(	struct bulk_info 	z_b,
-						global_variable 	gv,
+void PGE(	struct bulk_info 	z_b,
+			global_variable 	*gv,
 
-						PP_ref 				*PP_ref_db,
-						SS_ref 				*SS_ref_db,
-						csd_phase_set  		*cp					){
+			PP_ref 				*PP_ref_db,
+			SS_ref 				*SS_ref_db,
+			csd_phase_set  		*cp					){
 		
-	clock_t t; 	
+	double  t; 	
 	int mode = 1;
+	int *lm_id 	= gv->ws.lm_id;
+	int n_lm;
+
+	/* threads share the local minimizations, verbose mode keeps the sequential loop to preserve the output order */
+	int threaded = (gv->LM_threads > 1 && gv->SS_th != NULL && gv->verbose != 1) ? 1 : 0;
+
 	/**
 		First merge instances of the same solution phase that are compositionnally close 
 	*/
-	gv = 	phase_merge_function(	z_b,								/** bulk rock constraint 				*/
-									gv,									/** global variables (e.g. Gamma) 		*/
+	phase_merge_function(	z_b,								/** bulk rock constraint 				*/
+							gv,									/** global variables (e.g. Gamma) 		*/
 
-									PP_ref_db,							/** pure phase database 				*/
-									SS_ref_db,							/** solution phase database 			*/ 
-									cp
+							PP_ref_db,							/** pure phase database 				*/
+							SS_ref_db,							/** solution phase database 			*/ 
+							cp
 	); 			
 				
-	//for (int gi = 0; gi < 1; gi++){
-	while (gv.BR_norm > gv.br_max_tol || gv.global_ite < gv.outter_PGE_ite){
-		
-		//gv = NLopt_global_opt_function(		z_b,								/** bulk rock constraint 				*/
-											//gv,									/** global variables (e.g. Gamma) 		*/
+	/* Gamma from levelling is the starting point of the Anderson mixing */
+	if (gv->aa_depth > 0){
+		for (int i = 0; i < z_b.nzEl_val; i++){
+			gv->aa_x[i] = gv->gam_tot[z_b.nzEl_array[i]];
+		}
+		gv->aa_n = -1;
+	}
 
-											//PP_ref_db,							/** pure phase database 				*/
-											//SS_ref_db,							/** solution phase database 			*/ 
-											//cp						);
+	//for (int gi = 0; gi < 1; gi++){
+	while (gv->BR_norm > gv->br_max_tol || (gv->global_ite < gv->outter_PGE_ite && gv->adapt_n_stable < gv->adapt_min_stable)){
 		
 
-		t = clock();
-		if (gv.verbose == 1){
-			printf("\n__________________________________________ ‿︵MAGEMin‿︵ "); printf("_ %5s _",gv.version);
-			printf("\n                     GLOBAL ITERATION %i\n",gv.global_ite);
+		t = batch_wtime();
+		if (gv->verbose == 1){
+			printf("\n__________________________________________ ‿︵MAGEMin‿︵ "); printf("_ %5s _",gv->version);
+			printf("\n                     GLOBAL ITERATION %i\n",gv->global_ite);
 			printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
 		}
 		
 		/* calculate delta_G of solution phases (including local minimization) */
-		if (gv.verbose == 1){
+		if (gv->verbose == 1){
 			printf("Minimize solution phases\n");
 			printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
 			printf(" phase |  delta_G   | SF |   sum_xi   | time(ms)   |   x-eos ...\n");
@@ -961,21 +1451,43 @@ global_variable PGE(	struct bulk_info 	z_b,
 		/**
 			check driving force of PC when getting close to convergence
 		*/
-		if (gv.BR_norm < gv.PC_check_val && gv.check_PC == 0){
-			if (gv.verbose == 1){
+		if (gv->BR_norm < gv->PC_check_val && gv->check_PC == 0){
+			if (gv->verbose == 1){
 				printf(" Checking PC driving force\n");	
 				printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");	
 					
 			}
-			gv = check_PC( 					z_b,									/** bulk rock constraint 				*/ 
-											gv,										/** global variables (e.g. Gamma) 		*/
+			check_PC( 					z_b,									/** bulk rock constraint 				*/ 
+										gv,										/** global variables (e.g. Gamma) 		*/
+
+										PP_ref_db,								/** pure phase database 				*/ 
+										SS_ref_db,
+										cp				); 					
+
+			/**
+				multi-start search of the solvi of the selected phases (--solvus_ms)
+			*/
+			solvus_search( 				z_b,									/** bulk rock constraint 				*/ 
+										gv,										/** global variables (e.g. Gamma) 		*/
 
-											PP_ref_db,								/** pure phase database 				*/ 
-											SS_ref_db,
-											cp				); 					
+										SS_ref_db,								/** solution phase database 			*/
+										cp				);
 			
-			gv.check_PC 		= 1;
-			gv.check_PC_ite 	= gv.global_ite;					
+			gv->check_PC 		= 1;
+			gv->check_PC_ite 	= gv->global_ite;					
+		}
+
+		/**
+			joint minimization of the x-eos and fractions of the assemblage, once per point near convergence (--PGE_gm=1)
+		*/
+		if (gv->GM_on == 1 && gv->GM_done == 0 && gv->global_ite > 0 && gv->BR_norm < gv->GM_br){
+			NLopt_global_opt_function(	z_b,									/** bulk rock constraint 				*/
+										gv,										/** global variables (e.g. Gamma) 		*/
+
+										PP_ref_db,								/** pure phase database 				*/
+										SS_ref_db,								/** solution phase database 			*/ 
+										cp				);
+			gv->GM_done 		= 1;
 		}
 
 		//gv = check_EM( 					z_b,									/** bulk rock constraint 				*/ 
@@ -987,19 +1499,39 @@ global_variable PGE(	struct bulk_info 	z_b,
 		/** 
 			update delta_G of solution phases as function of updated Gamma
 		*/
-		for (int iss = 0; iss < gv.len_cp; iss++){ 
+		PGE_LM_rank(			gv,
+								cp 					);
+
+		n_lm = 0;
+		for (int iss = 0; iss < gv->len_cp; iss++){ 
 			if (cp[iss].ss_flags[0] == 1){
 
 				/**
 					Split phase if the current xeos is far away from the initial one 
 				*/
-				gv = split_cp(		iss,
-									gv, 								/** global variables (e.g. Gamma) */
-									SS_ref_db,							/** solution phase database */	
-									cp 					);		
+				split_cp(		iss,
+								gv, 								/** global variables (e.g. Gamma) */
+								SS_ref_db,							/** solution phase database */	
+								cp 					);		
+				/**
+					Skip the local minimization of the phases that do not need it (steady or far from the G-hyperplane)
+				*/
+				if (PGE_LM_needed(iss, gv, cp) == 0){
+					cp[iss].min_skip += 1;
+					if (gv->verbose == 1){
+						printf(" %4s  | %+10f | cp#%d local minimization skipped (%d)\n", cp[iss].name, cp[iss].df, iss, cp[iss].min_skip);
+					}
+					continue;
+				}
+
 				/**
-					Local minimization of the solution phases
+					Local minimization of the solution phases, deferred to the threads when gv->LM_threads > 1
 				*/
+				if (threaded == 1){
+					lm_id[n_lm] = iss;
+					n_lm 	   += 1;
+					continue;
+				}
 				ss_min_PGE(			mode, iss,
 									gv, 								/** global variables (e.g. Gamma) */
 									z_b,								/** bulk-rock, pressure and temperature conditions */
@@ -1007,30 +1539,49 @@ global_variable PGE(	struct bulk_info 	z_b,
 									cp 					);	
 			}
 		}
+		if (n_lm > 0){
+			PGE_LM_threads(			mode, lm_id, n_lm,
+									gv,
+									z_b,
+									SS_ref_db,
+									cp 					);
+		}
 		
 		/**
 			Merge instances of the same solution phase that are compositionnally close 
 		*/
-		gv = 	phase_merge_function(	z_b,								/** bulk rock constraint 				*/
-										gv,									/** global variables (e.g. Gamma) 		*/
+		phase_merge_function(	z_b,								/** bulk rock constraint 				*/
+								gv,									/** global variables (e.g. Gamma) 		*/
 
-										PP_ref_db,							/** pure phase database 				*/
-										SS_ref_db,							/** solution phase database 			*/ 
-										cp
-		); 
+								PP_ref_db,							/** pure phase database 				*/
+								SS_ref_db,							/** solution phase database 			*/ 
+								cp
+	); 
 	
 		/**
 			Actual Partitioning Gibbs Energy stage 
 		/*/
-		gv =	PGE_inner_loop(			z_b,							/** bulk rock constraint 				*/ 
-										gv,								/** global variables (e.g. Gamma) 		*/
+		PGE_inner_loop(			z_b,							/** bulk rock constraint 				*/ 
+								gv,								/** global variables (e.g. Gamma) 		*/
 
-										PP_ref_db,						/** pure phase database 				*/ 
-										SS_ref_db,						/** solution phase database 			*/
-										cp					); 
+								PP_ref_db,						/** pure phase database 				*/ 
+								SS_ref_db,						/** solution phase database 			*/
+								cp					); 
+
+		/**
+			Anderson mixing of the Gamma updates, falls back to the under-relaxed update when the residual grows
+		*/
+		if (gv->aa_depth > 0){
+			PGE_anderson_mixing(	z_b,
+									gv,
+
+									PP_ref_db,
+									SS_ref_db,
+									cp					);
+		}
 										
 		/* dump & print */
-		if (gv.verbose == 1){
+		if (gv->verbose == 1){
 		
 			/* Partitioning Gibbs Energy */
 			PGE_print(					z_b,								/** bulk rock constraint 				*/ 
@@ -1043,54 +1594,190 @@ global_variable PGE(	struct bulk_info 	z_b,
 		}
 
 		/* Increment global iteration value */
-		gv.global_ite += 1;
+		gv->global_ite += 1;
 
-		if (gv.global_ite > gv.ur_1 && gv.BR_norm < gv.br_max_tol*(gv.br_max_rlx/5.0)){		if (gv.verbose != 2){printf(" >200 iterations, under-relax mass constraint norm (*2.0)\n\n");}		break;	}
-		if (gv.global_ite > gv.ur_2 && gv.BR_norm < gv.br_max_tol*(gv.br_max_rlx/2.0)){		if (gv.verbose != 2){printf(" >300 iterations, under-relax mass constraint norm (*5.0)\n\n");}		break;	}
-		if (gv.global_ite > gv.ur_3 && gv.BR_norm < gv.br_max_tol*gv.br_max_rlx){			if (gv.verbose != 2){printf(" >400 iterations, under-relax mass constraint norm (*10.0)\n\n");}		break;	}
-		if (gv.global_ite > gv.ur_f){														if (gv.verbose != 2){printf(" >500 iterations, did not converge  !!!\n\n");}						break;	}
+		if (gv->global_ite > gv->ur_1 && gv->BR_norm < gv->br_max_tol*(gv->br_max_rlx/5.0)){		if (gv->verbose != 2){printf(" >200 iterations, under-relax mass constraint norm (*2.0)\n\n");}		break;	}
+		if (gv->global_ite > gv->ur_2 && gv->BR_norm < gv->br_max_tol*(gv->br_max_rlx/2.0)){		if (gv->verbose != 2){printf(" >300 iterations, under-relax mass constraint norm (*5.0)\n\n");}		break;	}
+		if (gv->global_ite > gv->ur_3 && gv->BR_norm < gv->br_max_tol*gv->br_max_rlx){			if (gv->verbose != 2){printf(" >400 iterations, under-relax mass constraint norm (*10.0)\n\n");}		break;	}
+		if (gv->global_ite > gv->ur_f){														if (gv->verbose != 2){printf(" >500 iterations, did not converge  !!!\n\n");}						break;	}
 
 		/* check evolution of mass constraint residual */
-		gv.PGE_mass_norm[gv.global_ite]  = gv.BR_norm;	/** sav norm for the current global iteration */
-		gv.PGE_total_norm[gv.global_ite] = gv.fc_norm_t1;
+		gv->PGE_mass_norm[gv->global_ite]  = gv->BR_norm;	/** sav norm for the current global iteration */
+		gv->PGE_total_norm[gv->global_ite] = gv->fc_norm_t1;
+
+		/* adapt the inner iterations and check for early convergence */
+		if (gv->adapt_PGE == 1){
+			PGE_adapt_iterations(	z_b,
+									gv					);
+		}
 
 		/* capture points that fail to converge */
-		if ((gv.global_ite > 256 && gv.BR_norm > 0.01) || gv.BR_norm > 10.0){	
-			gv.div = 1;	
+		if ((gv->global_ite > 256 && gv->BR_norm > 0.01) || gv->BR_norm > 10.0){	
+			gv->div = 1;	
 		}
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[0] == 1){
 				if (isnan(cp[i].df) == 1 || isinf(cp[i].df) == 1){
-					gv.div = 1;	
+					gv->div = 1;	
 				}
 			}
 		}
-		if (gv.div == 1){ break; }
+		if (gv->div == 1){ break; }
+
+		/* stop the current rung of the retry ladder when its time budget is exceeded */
+		if (gv->rt_deadline != 0.0 && batch_wtime()*1000.0 > gv->rt_deadline){
+			if (gv->verbose != 2){
+				printf(" retry ladder: time budget of %.1f ms exceeded\n", gv->rt_time);
+			}
+			gv->div = 1;
+			break;
+		}
 		
 
-		t = clock() - t; 
-		if (gv.verbose == 1){
-			printf("\n __ iteration duration: %+4f ms __\n\n\n",((double)t)/CLOCKS_PER_SEC*1000);
+		t = batch_wtime() - t; 
+		if (gv->verbose == 1){
+			printf("\n __ iteration duration: %+4f ms __\n\n\n",t*1000);
 		}
-		gv.ite_time[gv.global_ite] = ((double)t)/CLOCKS_PER_SEC*1000;
+		gv->ite_time[gv->global_ite] = t*1000;
 	}
 	
-	if (gv.verbose == 1){
-		gv = check_PC_driving_force( 	z_b,									/** bulk rock constraint 				*/ 
-										gv,										/** global variables (e.g. Gamma) 		*/
+	if (gv->verbose == 1){
+		check_PC_driving_force( 	z_b,									/** bulk rock constraint 				*/ 
+									gv,										/** global variables (e.g. Gamma) 		*/
 
-										PP_ref_db,								/** pure phase database 				*/ 
-										SS_ref_db,
-										cp				); 		
+									PP_ref_db,								/** pure phase database 				*/ 
+									SS_ref_db,
+									cp				); 		
 		
 		printf("\n\n\n\n ite  | duration   |  Mass norm |  move ave  | Gamma norm\n");
 		printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
 
-		for (int i = 0; i < gv.global_ite; i++){	
-			printf(" %4d | %+10f | %+10f | %+10f | %+10f\n",i,gv.ite_time[i],gv.PGE_mass_norm[i],gv.PGE_total_norm[i],gv.gamma_norm[i]);
+		for (int i = 0; i < gv->global_ite; i++){	
+			printf(" %4d | %+10f | %+10f | %+10f | %+10f\n",i,gv->ite_time[i],gv->PGE_mass_norm[i],gv->PGE_total_norm[i],gv->gamma_norm[i]);
+		}
+		printf("\n");
+
+		printf("\n cp#  | phase | ON |  # LM | LM time (ms) | # eval | # exit | saved | # hit\n");
+		printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
+		for (int i = 0; i < gv->len_cp; i++){
+			if (cp[i].n_LM > 0){
+				printf(" %4d | %5s | %2d | %5d | %+12f | %6d | %6d | %5d | %5d\n",i,cp[i].name,cp[i].ss_flags[1],cp[i].n_LM,cp[i].LM_time,cp[i].n_eval,cp[i].n_ee,cp[i].n_eval_saved,cp[i].n_hit);
+			}
 		}
 		printf("\n");
 	}
-	
-	return gv;
 };		
+
+/**
+	Reserve n bytes in the workspace block at the offset off, aligned on ws_align bytes (base = NULL only computes
+	the size of the block)
+*/
+void *PGE_ws_take(					char 				*base,
+									size_t 				*off,
+									size_t 				 n 					){
+	void *ptr = (base == NULL) ? NULL : (void*)(base + *off);
+	*off 	 += (n + ws_align - 1)/ws_align*ws_align;
+	return ptr;
+};
+
+/**
+	Lay the workspace arrays out in the block starting at base
+*/
+PGE_workspace PGE_ws_layout(		global_variable 	*gv,
+									PGE_workspace 		 ws,
+									char 				*base 				){
+	size_t 	off = 0;
+	int 	nE 	= ws.nEntry_max;
+	int 	nO 	= gv->len_ox;
+	int 	n_ms = gv->len_ss*gv->ms_n;
+
+	ws.A 		= PGE_ws_take(base, &off, nE*nE 			* sizeof(double));
+	ws.b 		= PGE_ws_take(base, &off, nE 				* sizeof(double));
+	ws.ipiv 	= PGE_ws_take(base, &off, nE 				* sizeof(int));
+	ws.h 		= PGE_ws_take(base, &off, nO 				* sizeof(double));
+	ws.K 		= PGE_ws_take(base, &off, nO*nO 			* sizeof(double));
+	ws.W 		= PGE_ws_take(base, &off, nE*nO 			* sizeof(double));
+	ws.S 		= PGE_ws_take(base, &off, nE*nE 			* sizeof(double));
+	ws.y 		= PGE_ws_take(base, &off, nO 				* sizeof(double));
+	ws.dn 		= PGE_ws_take(base, &off, nE 				* sizeof(double));
+
+	ws.aa_r 	= PGE_ws_take(base, &off, nO 				* sizeof(double));
+	ws.aa_y 	= PGE_ws_take(base, &off, nO 				* sizeof(double));
+	ws.aa_d 	= PGE_ws_take(base, &off, nO 				* sizeof(double));
+	ws.aa_M 	= PGE_ws_take(base, &off, n_aa_max*n_aa_max * sizeof(double));
+	ws.aa_c 	= PGE_ws_take(base, &off, n_aa_max 			* sizeof(double));
+
+	ws.w 		= PGE_ws_take(base, &off, (nO + 1) 			* sizeof(double));
+	ws.pp_act 	= PGE_ws_take(base, &off, nO 				* sizeof(int));
+	ws.cp_act 	= PGE_ws_take(base, &off, nO 				* sizeof(int));
+	ws.hld_cp_sort = PGE_ws_take(base, &off, gv->max_n_cp 	* sizeof(struct str));
+	ws.hld_pp_sort = PGE_ws_take(base, &off, gv->len_pp 		* sizeof(struct str));
+	ws.lm_id 	= PGE_ws_take(base, &off, gv->max_n_cp 		* sizeof(int));
+	ws.th_id 	= PGE_ws_take(base, &off, gv->max_n_cp 		* sizeof(int));
+	ws.lm_rank 	= PGE_ws_take(base, &off, gv->max_n_cp 		* sizeof(int));
+	ws.done 	= PGE_ws_take(base, &off, gv->len_ss 		* sizeof(int));
+	ws.dist 	= PGE_ws_take(base, &off, ws.n_pc_max 		* sizeof(int));
+	ws.dp 		= PGE_ws_take(base, &off, ws.n_em_max 		* sizeof(double));
+
+	ws.ms_ph 	= PGE_ws_take(base, &off, n_ms 				* sizeof(int));
+	ws.ms_ok 	= PGE_ws_take(base, &off, n_ms 				* sizeof(int));
+	ws.ms_df 	= PGE_ws_take(base, &off, n_ms 				* sizeof(double));
+	ws.ms_x 	= PGE_ws_take(base, &off, n_ms*ws.n_xeos_max * sizeof(double));
+	ws.ms_p 	= PGE_ws_take(base, &off, n_ms*ws.n_em_max 	* sizeof(double));
+
+	ws.phase_on = PGE_ws_take(base, &off, gv->len_ss 		* sizeof(int));
+	ws.bas 		= PGE_ws_take(base, &off, nO 				* sizeof(int));
+	ws.gam 		= PGE_ws_take(base, &off, nO 				* sizeof(double));
+	ws.br 		= PGE_ws_take(base, &off, nO 				* sizeof(double));
+	ws.lvl_ipiv = PGE_ws_take(base, &off, nO 				* sizeof(int));
+
+	ws.x 		= PGE_ws_take(base, &off, ws.n_x_max 		* sizeof(double));
+	ws.lb 		= PGE_ws_take(base, &off, ws.n_x_max 		* sizeof(double));
+	ws.ub 		= PGE_ws_take(base, &off, ws.n_x_max 		* sizeof(double));
+	ws.tol_sf 	= PGE_ws_take(base, &off, ws.n_sf_max 		* sizeof(double));
+	ws.tol_eq 	= PGE_ws_take(base, &off, nO 				* sizeof(double));
+
+	ws.size 	= off;
+
+	return ws;
+};
+
+/**
+	Allocate the workspace of a context (main driver or batch levelling thread), sized from the largest PGE system
+	(len_ox oxides and at most len_ox phases), the number of considered phases and the solution phase models
+*/
+void init_PGE_workspace(	global_variable 	*gv,
+							SS_ref 				*SS_ref_db 			){
+	PGE_workspace 	ws;
+	char 		   *base;
+	int 			max_x = 0, max_sf = 0, max_em = 0, max_pc = 0;
+
+	for (int i = 0; i < gv->len_ss; i++){
+		max_x 	= (SS_ref_db[i].n_xeos > max_x ) ? SS_ref_db[i].n_xeos : max_x;
+		max_sf 	= (SS_ref_db[i].n_sf   > max_sf) ? SS_ref_db[i].n_sf   : max_sf;
+		max_em 	= (SS_ref_db[i].n_em   > max_em) ? SS_ref_db[i].n_em   : max_em;
+		max_pc 	= (SS_ref_db[i].n_pc   > max_pc) ? SS_ref_db[i].n_pc   : max_pc;
+	}
+	ws.nEntry_max 	= 2*gv->len_ox;
+	ws.n_x_max 		= gv->len_ox*(max_x + 1);
+	ws.n_sf_max 	= gv->len_ox*max_sf;
+	ws.n_xeos_max 	= max_x;
+	ws.n_em_max 	= max_em;
+	ws.n_pc_max 	= max_pc;
+
+	ws 				= PGE_ws_layout(gv, ws, NULL);
+	ws.block 		= calloc (ws.size + ws_align, 1);
+	if (ws.block == NULL){
+		printf(" Could not allocate the PGE workspace (%zu bytes)\n", ws.size);
+		exit(EXIT_FAILURE);
+	}
+	base 			= (char*)ws.block + (ws_align - (size_t)ws.block % ws_align) % ws_align;
+	gv->ws 			= PGE_ws_layout(gv, ws, base);
+};
+
+/**
+	Free the workspace of a context
+*/
+void destroy_PGE_workspace(			global_variable 	*gv 				){
+	free(gv->ws.block);
+};
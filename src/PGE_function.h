@@ -1,13 +1,18 @@
 #ifndef __PGE_FUNCTION_H_
 #define __PGE_FUNCTION_H_
 
-global_variable PGE(			struct bulk_info 	z_b,
-								global_variable 	gv,
+void PGE(			struct bulk_info 	z_b,
+					global_variable 	*gv,
 								
-								PP_ref 				*PP_ref_db,
-								SS_ref 				*SS_ref_db,
-								csd_phase_set  		*cp	);
+					PP_ref 				*PP_ref_db,
+					SS_ref 				*SS_ref_db,
+					csd_phase_set  		*cp	);
 
 double norm_vector(double *array ,int n);
 
+void init_PGE_workspace(	global_variable 	*gv,
+							SS_ref 				*SS_ref_db 			);
+
+void destroy_PGE_workspace(			global_variable 	*gv 				);
+
 #endif
@@ -0,0 +1,439 @@
+/**
+In-house local minimizer of the solution phases (--LM_solver)
+---------------------------------------------------------------
+
+Sequential quadratic programming for the small x-eos problems of the solution phases:
+
+	min G(x)  subject to  sf(x) >= -eps_sf  and  lb <= x <= ub
+
+- the gradient is the analytic one of the objective functions (obj_*), the Hessian is a damped BFGS approximation, or
+  the analytic Hessian of the phase (hess_*, --LM_hess=1) shifted until it is positive definite
+- the QP subproblem, on the constraints linearized with the sparse jacobian of the phase (sf_jacobian.c), is solved with a
+  primal active-set method starting from the feasible step d = 0
+- the steps are backtracked until the site fractions are respected and the Armijo condition holds, such that the
+  objective (log of the site fractions) is only evaluated at feasible x-eos
+- the minimization starts from SS_ref_db->iguess, i.e. the x-eos of the last minimization of the phase (cp[i].xeos)
+
+It stops when the relative change of G is below obj_tol (as NLopt ftol_rel), when the step vanishes or after maxeval
+objective evaluations, on-hold phases also stop once LM_early_exit decides the sign of their driving force (--LM_early, heuristic). The status uses the NLopt result codes, a negative status means the caller has to fall back on
+NLopt.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lapacke.h>
+
+#include "nlopt.h"
+#include "MAGEMin.h"
+#include "objective_functions.h"
+#include "NLopt_opt_function.h"
+#include "SQP_opt_function.h"
+
+#define SQP_max_eval 	1024			/** objective evaluations when maxeval is 0 (no limit for NLopt) 	*/
+#define SQP_max_ls 		30				/** backtracking steps of the line search 							*/
+#define SQP_armijo 		1e-4			/** sufficient decrease of the line search 							*/
+#define SQP_xtol 		1e-12			/** step under which the minimization is converged 					*/
+#define SQP_frac 		0.99				/** fraction of the distance to the site-fraction bounds allowed to a step 	*/
+#define SQP_min_shift 	1e-8			/** first diagonal shift of the analytic Hessian, relative to its largest diagonal entry */
+#define SQP_max_shift 	24				/** max number of diagonal shifts (x10) of the analytic Hessian 				*/
+
+/**
+  size of the workspace of a solution phase with n x-eos and m site fractions (double and int arrays)
+*/
+int SQP_ws_size(		int 	n,
+						int 	m 			){
+	int nc = m + 2*n;
+	return n*n + 11*n + 2*m + m*n + nc*n + nc + 4*n*n;
+};
+
+int SQP_iws_size(		int 	n,
+						int 	m 			){
+	int nc = m + 2*n;
+	return nc + 3*n;
+};
+
+/**
+  symmetric part of the analytic Hessian B, shifted by tau*I until its Cholesky factorization (computed in L) exists
+*/
+void SQP_pd_shift(		int 	 n,
+						double 	*B,
+						double 	*L 			){
+
+	double 	tau = 0.0, b_max = 1.0, s;
+	int 	ok 	= 0;
+
+	for (int i = 0; i < n; i++){
+		for (int j = 0; j < i; j++){
+			s 			= 0.5*(B[i*n + j] + B[j*n + i]);
+			B[i*n + j] 	= s;
+			B[j*n + i] 	= s;
+		}
+		b_max = fmax(b_max, fabs(B[i*n + i]));
+	}
+
+	for (int ite = 0; ite < SQP_max_shift && ok == 0; ite++){
+		ok = 1;
+		for (int j = 0; j < n && ok == 1; j++){
+			s = B[j*n + j] + tau;
+			for (int k = 0; k < j; k++){
+				s -= L[j*n + k]*L[j*n + k];
+			}
+			if (s <= 0.0){
+				ok 	= 0;
+				tau = (tau == 0.0) ? SQP_min_shift*b_max : 10.0*tau;
+				break;
+			}
+			L[j*n + j] = sqrt(s);
+			for (int i = j+1; i < n; i++){
+				s = B[i*n + j];
+				for (int k = 0; k < j; k++){
+					s -= L[i*n + k]*L[j*n + k];
+				}
+				L[i*n + j] = s/L[j*n + j];
+			}
+		}
+	}
+
+	for (int i = 0; i < n; i++){
+		B[i*n + i] += tau;
+	}
+};
+
+/**
+  primal active-set method for the QP subproblem
+
+	min 1/2 d'Bd + g'd  subject to  A d <= b  (b >= 0, d = 0 is feasible)
+
+  the equality-constrained step of the working set W is given by the KKT system [B A_W'; A_W 0][p; lam] = [-(Bd+g); 0],
+  which is symmetric, so that it is passed as is to LAPACK. Returns 0, or -1 if a KKT system is singular.
+*/
+int SQP_qp(				int 	 n,
+						int 	 nc,
+						double 	*B,
+						double 	*g,
+						double 	*A,
+						double 	*b,
+						double 	*d,
+						double 	*p,
+						double 	*K,
+						double 	*r,
+						int 	*W,
+						int 	*wl,
+						int 	*ipiv 		){
+
+	int 	nw = 0, k, blk, min_j, info;
+	double 	alpha, ap, ad, t, min_lam, p_norm;
+
+	for (int i = 0; i < nc; i++){ W[i] = 0; }
+	for (int j = 0; j < n;  j++){ d[j] = 0.0; }
+
+	for (int ite = 0; ite < 4*(nc+n); ite++){
+
+		/* KKT system of the working set */
+		k = n + nw;
+		for (int i = 0; i < k*k; i++){ K[i] = 0.0; }
+		for (int i = 0; i < n; i++){
+			for (int j = 0; j < n; j++){
+				K[i*k + j] = B[i*n + j];
+			}
+			r[i] = -g[i];
+			for (int j = 0; j < n; j++){
+				r[i] -= B[i*n + j]*d[j];
+			}
+		}
+		for (int l = 0; l < nw; l++){
+			for (int j = 0; j < n; j++){
+				K[(n+l)*k + j] = A[wl[l]*n + j];
+				K[j*k + (n+l)] = A[wl[l]*n + j];
+			}
+			r[n+l] = 0.0;
+		}
+
+		info = LAPACKE_dgesv(	LAPACK_COL_MAJOR,
+								k,
+								1,
+								K,
+								k,
+								ipiv,
+								r,
+								k 			);
+		if (info != 0){ return -1; }
+
+		p_norm = 0.0;
+		for (int j = 0; j < n; j++){
+			p[j]   = r[j];
+			p_norm = fmax(p_norm, fabs(p[j]));
+		}
+
+		if (p_norm < SQP_xtol){
+			/* stationary on the working set: drop the constraint with the most negative multiplier, if any */
+			min_lam = 0.0;
+			min_j 	= -1;
+			for (int l = 0; l < nw; l++){
+				if (r[n+l] < min_lam){
+					min_lam = r[n+l];
+					min_j 	= l;
+				}
+			}
+			if (min_j == -1){ return 0; }
+
+			W[wl[min_j]] = 0;
+			wl[min_j] 	 = wl[nw-1];
+			nw 			-= 1;
+		}
+		else{
+			/* longest step along p keeping the constraints out of the working set */
+			alpha = 1.0;
+			blk   = -1;
+			for (int i = 0; i < nc; i++){
+				if (W[i] == 1){ continue; }
+				ap = 0.0;
+				ad = 0.0;
+				for (int j = 0; j < n; j++){
+					ap += A[i*n + j]*p[j];
+					ad += A[i*n + j]*d[j];
+				}
+				if (ap > 1e-14){
+					t = (b[i] - ad)/ap;
+					if (t < alpha){
+						alpha = fmax(t, 0.0);
+						blk   = i;
+					}
+				}
+			}
+			for (int j = 0; j < n; j++){
+				d[j] += alpha*p[j];
+			}
+			if (blk != -1){
+				if (nw == n){ return 0; }
+				W[blk] 	= 1;
+				wl[nw] 	= blk;
+				nw 	   += 1;
+			}
+		}
+	}
+
+	return 0;
+};
+
+/**
+  local minimization of a solution phase. On return xeos, df and status are set as by the NLopt functions; a negative
+  status leaves iguess unchanged for the NLopt fallback.
+*/
+void SQP_opt_function(		global_variable 	*gv,
+							SS_ref 			   *SS_ref_db,
+							obj_type 			obj,
+							hess_type 			hess,
+							const sf_jac_data  *sf 				){
+
+	int 	 n  	= SS_ref_db->n_xeos;
+	int 	 m  	= SS_ref_db->n_sf;
+	int 	 nc 	= m + 2*n;
+	double 	*x  	= SS_ref_db->iguess;
+
+	/* workspace layout */
+	double 	*B 		= SS_ref_db->sqp_ws;
+	double 	*g 		= B 	+ n*n;
+	double 	*g_new 	= g 	+ n;
+	double 	*x_new 	= g_new + n;
+	double 	*x0 	= x_new + n;
+	double 	*d 		= x0 	+ n;
+	double 	*p 		= d 	+ n;
+	double 	*s 		= p 	+ n;
+	double 	*y 		= s 	+ n;
+	double 	*Bs 	= y 	+ n;
+	double 	*r 		= Bs 	+ n;
+	double 	*c 		= r 	+ 2*n;
+	double 	*c_new 	= c 	+ m;
+	double 	*J 		= c_new + m;
+	double 	*A 		= J 	+ m*n;
+	double 	*b 		= A 	+ nc*n;
+	double 	*K 		= b 	+ nc;
+	int 	*W 		= SS_ref_db->sqp_iw;
+	int 	*wl 	= W 	+ nc;
+	int 	*ipiv 	= wl 	+ n;
+
+	int 	 max_eval 	= (gv->maxeval > 0) ? gv->maxeval : SQP_max_eval;
+	int 	 n_eval, ok, at_x;
+	double 	 f, f_new, gd, alpha, sBs, sy, theta, d_norm;
+
+	for (int i = 0; i < n; i++){
+		SS_ref_db->lb[i] = SS_ref_db->box_bounds[i][0];
+		SS_ref_db->ub[i] = SS_ref_db->box_bounds[i][1];
+		x0[i] 			= x[i];
+		x[i] 			= fmin(fmax(x[i], SS_ref_db->lb[i]), SS_ref_db->ub[i]);
+	}
+
+	f 		= obj(n, x, g, SS_ref_db);
+	n_eval 	= 1;
+	at_x 	= 1;
+	/* the constant entries of the jacobian are written once, the evaluations only update the x-dependent ones */
+	sf_jac_init(sf, J);
+	sf->sf(m, c, n, x, NULL, NULL);
+	sf->jac(x, J);
+
+	/* the status stays NLOPT_MAXEVAL_REACHED until the minimization stops */
+	SS_ref_db->status = NLOPT_MAXEVAL_REACHED;
+	if (isfinite(f) == 0){
+		SS_ref_db->status = NLOPT_FAILURE;
+	}
+
+	for (int i = 0; i < n*n; i++){ B[i] = 0.0; }
+	for (int i = 0; i < n; i++){ B[i*n + i] = 1.0; }
+
+	for (int ite = 0; SS_ref_db->status == NLOPT_MAXEVAL_REACHED && n_eval < max_eval; ite++){
+
+		/* the phase data are the ones of the gradient at x */
+		if (hess != NULL){
+			hess(n, x, B, SS_ref_db);
+			SQP_pd_shift(n, B, K);
+		}
+
+		/* constraints linearized at x: c + J d <= 0 (a violated site fraction may not get worse) and the box */
+		for (int i = 0; i < m; i++){
+			for (int j = 0; j < n; j++){
+				A[i*n + j] = J[i*n + j];
+			}
+			b[i] = SQP_frac*fmax(-c[i], 0.0);
+		}
+		for (int i = 0; i < n; i++){
+			for (int j = 0; j < n; j++){
+				A[(m+i)*n + j] 	 = (i == j) ?  1.0 : 0.0;
+				A[(m+n+i)*n + j] = (i == j) ? -1.0 : 0.0;
+			}
+			b[m+i] 	 = SS_ref_db->ub[i] - x[i];
+			b[m+n+i] = x[i] - SS_ref_db->lb[i];
+		}
+
+		if (SQP_qp(n, nc, B, g, A, b, d, p, K, r, W, wl, ipiv) != 0){
+			SS_ref_db->status = (ite == 0) ? NLOPT_FAILURE : NLOPT_SUCCESS;
+			break;
+		}
+
+		gd 		= 0.0;
+		d_norm 	= 0.0;
+		for (int j = 0; j < n; j++){
+			gd 	   += g[j]*d[j];
+			d_norm 	= fmax(d_norm, fabs(d[j]));
+		}
+		if (d_norm < SQP_xtol){
+			SS_ref_db->status = NLOPT_XTOL_REACHED;
+			break;
+		}
+		if (gd >= 0.0){
+			SS_ref_db->status = (ite == 0) ? NLOPT_FAILURE : NLOPT_SUCCESS;
+			break;
+		}
+
+		/* backtracking on the site fractions, then on the Armijo condition */
+		alpha 	= 1.0;
+		ok 		= 0;
+		for (int ls = 0; ls < SQP_max_ls && n_eval < max_eval; ls++){
+			for (int j = 0; j < n; j++){
+				x_new[j] = x[j] + alpha*d[j];
+			}
+			sf->sf(m, c_new, n, x_new, NULL, NULL);
+
+			ok = 1;
+			for (int i = 0; i < m; i++){
+				if (c_new[i] > fmax(c[i], 0.0)){ ok = 0; break; }
+			}
+			if (ok == 1){
+				f_new 	= obj(n, x_new, g_new, SS_ref_db);
+				n_eval += 1;
+				at_x 	= 0;
+				if (isfinite(f_new) == 0 || f_new > f + SQP_armijo*alpha*gd){
+					ok = 0;
+				}
+			}
+			if (ok == 1){ break; }
+			alpha *= 0.5;
+		}
+		if (ok == 0){
+			SS_ref_db->status = (ite == 0) ? NLOPT_FAILURE : NLOPT_SUCCESS;
+			break;
+		}
+
+		/* damped BFGS update (Powell), the initial matrix is scaled after the first step */
+		if (hess == NULL){
+			sy 	= 0.0;
+			for (int j = 0; j < n; j++){
+				s[j] = x_new[j] - x[j];
+				y[j] = g_new[j] - g[j];
+				sy  += s[j]*y[j];
+			}
+			if (ite == 0 && sy > 0.0){
+				double yy = 0.0;
+				for (int j = 0; j < n; j++){ yy += y[j]*y[j]; }
+				for (int j = 0; j < n; j++){ B[j*n + j] = yy/sy; }
+			}
+			sBs = 0.0;
+			for (int i = 0; i < n; i++){
+				Bs[i] = 0.0;
+				for (int j = 0; j < n; j++){
+					Bs[i] += B[i*n + j]*s[j];
+				}
+				sBs += s[i]*Bs[i];
+			}
+			if (sBs > 0.0){
+				theta = (sy >= 0.2*sBs) ? 1.0 : 0.8*sBs/(sBs - sy);
+				sy 	  = 0.0;
+				for (int j = 0; j < n; j++){
+					y[j] = theta*y[j] + (1.0 - theta)*Bs[j];
+					sy 	+= s[j]*y[j];
+				}
+				if (sy > 0.0){
+					for (int i = 0; i < n; i++){
+						for (int j = 0; j < n; j++){
+							B[i*n + j] += y[i]*y[j]/sy - Bs[i]*Bs[j]/sBs;
+						}
+					}
+				}
+			}
+		}
+
+		/* accept the step */
+		for (int j = 0; j < n; j++){
+			x[j] = x_new[j];
+			g[j] = g_new[j];
+		}
+		sf->sf(m, c, n, x, NULL, NULL);
+		sf->jac(x, J);
+		at_x = 1;
+
+		/* on-hold phase whose driving force sign is decided (--LM_early) */
+		if (SS_ref_db->LM_ee == 1 && LM_early_exit(SS_ref_db, n, x, g, f_new) != 0){
+			f 				 = f_new;
+			SS_ref_db->status = NLOPT_STOPVAL_REACHED;
+			break;
+		}
+
+		if (fabs(f - f_new) <= gv->obj_tol*fabs(f_new)){
+			f 				 = f_new;
+			SS_ref_db->status = NLOPT_FTOL_REACHED;
+			break;
+		}
+		f = f_new;
+	}
+
+	SS_ref_db->n_eval += n_eval;
+	if (SS_ref_db->status < 0){
+		for (int i = 0; i < n; i++){
+			x[i] = x0[i];
+		}
+		return;
+	}
+
+	/* the phase data (p, mu, sf, df...) are the ones of the last evaluation */
+	if (at_x == 0){
+		f = obj(n, x, NULL, SS_ref_db);
+		SS_ref_db->n_eval += 1;
+	}
+
+	for (int i = 0; i < n; i++){
+		SS_ref_db->xeos[i] = x[i];
+	}
+	SS_ref_db->df = f;
+};
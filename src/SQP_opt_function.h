@@ -0,0 +1,16 @@
+#ifndef __SQP_OPT_FUNCTION_H_
+#define __SQP_OPT_FUNCTION_H_
+
+int SQP_ws_size(		int 	n,
+						int 	m 			);
+
+int SQP_iws_size(		int 	n,
+						int 	m 			);
+
+void SQP_opt_function(		global_variable 	*gv,
+							SS_ref 			   *SS_ref_db,
+							obj_type 			obj,
+							hess_type 			hess,
+							const sf_jac_data  *sf 				);
+
+#endif
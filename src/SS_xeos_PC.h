@@ -1,9 +1,10 @@
 #ifndef __PC_XEOS_H_
 #define __PC_XEOS_H_
 
-struct ss_pc{
-    double xeos_pc[11];
-};
+/**
+	Default pseudocompound grids (generated with python/XEOS_SIMPLEX_SS_GENERATOR.ipynb)
+	This header is only compiled into PC_grid_generator, which writes the binary grid files mapped by MAGEMin
+*/
 
 struct ss_pc pl4T_pc_xeos[231] = {
 {{0.0001,0.0001}},
@@ -28232,47 +28233,5 @@ struct ss_pc spn_pc_xeos[4996] = {
 {{0.7970,0.7970,0.7970,0.0010,-0.0040,0.7920,-0.0040}},
 {{0.7970,0.7970,0.7970,0.0010,0.1950,0.3940,0.1950}},
 {{0.7970,0.7970,0.7970,0.0010,0.1950,0.5930,-0.0040}}};
-typedef struct PC_refs {
-	struct ss_pc *ss_pc_xeos;
 
-} PC_ref;
-
-
-void SS_PC_init_function(	PC_ref 	*SS_PC_xeos,
-							int 	 iss,
-							char 	*name				){	
-						 
-	if      (strcmp( name, "bi")  == 0 ){
-		SS_PC_xeos[iss].ss_pc_xeos  = bi_pc_xeos; 		}
-	else if (strcmp( name, "cd")  == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = cd_pc_xeos; 		}
-	else if (strcmp( name, "cpx") == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = cpx_pc_xeos; 		}
-	else if (strcmp( name, "ep")  == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = ep_pc_xeos; 		}
-	else if (strcmp( name, "fl")  == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = fl_pc_xeos; 		}
-	else if (strcmp( name, "g")   == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = g_pc_xeos; 		}
-	else if (strcmp( name, "hb")  == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = hb_pc_xeos; 		}
-	else if (strcmp( name, "ilm") == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = ilm_pc_xeos; 		}
-	else if (strcmp( name, "liq") == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = liq_pc_xeos; 		}
-	else if (strcmp( name, "mu")  == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = mu_pc_xeos; 		}
-	else if (strcmp( name, "ol")  == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = ol_pc_xeos; 		}
-	else if (strcmp( name, "opx") == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = opx_pc_xeos; 		}
-	else if (strcmp( name, "pl4T") == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = pl4T_pc_xeos; 	}
-	else if (strcmp( name, "spn") == 0){
-		SS_PC_xeos[iss].ss_pc_xeos  = spn_pc_xeos; 		}
-	else{
-		printf("\nsolid solution '%s' is not in the database, cannot be initiated\n", name);	
-	}	
-}
-	
 #endif
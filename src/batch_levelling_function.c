@@ -0,0 +1,460 @@
+/**
+Batch levelling mode (Mode 4): computes Gamma and the levelled assemblage of a large number of
+P-T-bulk points, e.g., to produce the training data of the Gamma estimators (matlab/Gamma_estimation_NN1.m).
+
+- input  (--File)	: one point per line, P[kbar] T[C] bulk[len_ox] (same units as --Bulk), --n_points lines at most
+- output 			: __LEVELLING_GAMMA.bin (layout in batch_levelling_function.h), read by matlab/Read_LevellingGamma_MAGEMin.m
+
+The points are split in contiguous blocks between the MPI ranks and the block of a rank is shared between
+its OpenMP threads. The points of a block are sorted by P, T and zero oxides: when these do not change
+from one point to the next, the pseudocompounds generated by the thread for the previous point are
+rescaled to the new bulk-rock instead of being generated again.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "mpi.h"
+#include "MAGEMin.h"
+#include "simplex_levelling.h"
+#include "ss_min_function.h"
+#include "pp_min_function.h"
+#include "dump_function.h"
+#include "PGE_function.h"
+#include "NLopt_opt_function.h"
+#include "batch_levelling_function.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+  wall clock time in seconds (the per-point time is measured inside the threads)
+*/
+double batch_wtime(){
+#ifdef _OPENMP
+	return omp_get_wtime();
+#else
+	return MPI_Wtime();
+#endif
+};
+
+/**
+  read the P-T-bulk points of the batch input file, returns the number of points read
+*/
+int read_batch_data(			global_variable 	*gv,
+								batch_point 		*points,
+								char 				*file_name,
+								int 				 n_points 		){
+	char 	line[1000];
+	double 	P, T;
+	double *bulk;
+	int 	k = 0, n_line = 0;
+
+	FILE* input_file = fopen(file_name,"rt");
+	if (input_file == NULL){
+		printf("\n batch levelling input file '%s' cannot be read\n", file_name);
+		exit(EXIT_FAILURE);
+	}
+
+	while (fgets(line, sizeof(line), input_file) != NULL && k < n_points){
+		n_line += 1;
+		bulk = points[k].bulk;
+		for (int i = 0; i < nEl; i++){
+			bulk[i] = 0.0;
+		}
+		/* lines that do not hold a complete point (comments, empty lines) are skipped */
+		if (sscanf(line, "%lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
+				&P,
+				&T,
+				&bulk[0],
+				&bulk[1],
+				&bulk[2],
+				&bulk[3],
+				&bulk[4],
+				&bulk[5],
+				&bulk[6],
+				&bulk[7],
+				&bulk[8],
+				&bulk[9],
+				&bulk[10] 	) != 2 + gv->len_ox){
+			continue;
+		}
+
+		norm_array(		bulk,
+						gv->len_ox	);
+
+		points[k].id 	= k;
+		points[k].line 	= n_line;
+		points[k].P 	= P;
+		points[k].T 	= T;
+		points[k].zeros = 0;
+		for (int i = 0; i < gv->len_ox; i++){
+			if (bulk[i] == 0.0){ points[k].zeros |= (1 << i); }
+		}
+		k += 1;
+	}
+	fclose(input_file);
+
+	return k;
+};
+
+/**
+  order of the points: P, T, zero oxides, then position in the input file
+*/
+int compare_batch_points(const void *a, const void *b){
+	const batch_point *pa = (const batch_point*) a;
+	const batch_point *pb = (const batch_point*) b;
+
+	if (pa->P 	  != pb->P	  ){ return (pa->P 	   < pb->P	  ) ? -1 : 1; }
+	if (pa->T 	  != pb->T	  ){ return (pa->T 	   < pb->T	  ) ? -1 : 1; }
+	if (pa->zeros != pb->zeros){ return (pa->zeros < pb->zeros) ? -1 : 1; }
+	return pa->id - pb->id;
+};
+
+/**
+  copy of the global variables for a thread: the arrays modified during levelling are duplicated,
+  the other ones (names, pseudocompound grid, ...) are shared with the main driver
+*/
+global_variable thread_global_variable(		global_variable 	*gv 		){
+	global_variable gv_th = *gv;
+
+	gv_th.gam_tot  		= malloc (gv->len_ox * sizeof(double)	);
+	gv_th.del_gam_tot  	= malloc (gv->len_ox * sizeof(double)	);
+	gv_th.delta_gam_tot = malloc (gv->len_ox * sizeof(double)	);
+	gv_th.mass_residual = malloc (gv->len_ox * sizeof(double)	);
+	gv_th.PGE_mass_norm = malloc (gv->ur_f   * sizeof(double)	);
+	gv_th.em_ld 		= gv->len_pp;
+	gv_th.em_C 			= malloc (gv->len_pp*gv->len_ox * sizeof(double)	);
+	gv_th.em_g 			= malloc (gv->len_pp * sizeof(double)	);
+	gv_th.em_x 			= malloc (gv->len_pp * sizeof(double)	);
+
+	gv_th.pp_n    		= malloc (gv->len_pp * sizeof(double)	);
+	gv_th.pp_xi    		= malloc (gv->len_pp * sizeof(double)	);
+	gv_th.delta_pp_n 	= malloc (gv->len_pp * sizeof(double)	);
+	gv_th.delta_pp_xi 	= malloc (gv->len_pp * sizeof(double)	);
+	gv_th.pp_flags 		= malloc (gv->len_pp * sizeof(int*)		);
+	for (int i = 0; i < gv->len_pp; i++){
+		gv_th.pp_flags[i] 	= malloc (gv->n_flags * sizeof(int));
+	}
+
+	gv_th.verifyPC  	= malloc (gv->len_ss * sizeof(int) 		);
+	gv_th.n_solvi		= malloc (gv->len_ss * sizeof(int) 		);
+	gv_th.id_solvi 		= malloc (gv->len_ss * sizeof(int*)		);
+	for (int i = 0; i < gv->len_ss; i++){
+		gv_th.verifyPC[i] 	= gv->verifyPC[i];
+		gv_th.id_solvi[i] 	= malloc (gv->max_n_cp * sizeof(int));
+	}
+
+	return gv_th;
+};
+
+/**
+  free the arrays allocated by thread_global_variable
+*/
+void free_thread_global_variable(			global_variable 	*gv 		){
+
+	free(gv->gam_tot);
+	free(gv->del_gam_tot);
+	free(gv->delta_gam_tot);
+	free(gv->mass_residual);
+	free(gv->PGE_mass_norm);
+	free(gv->em_C);
+	free(gv->em_g);
+	free(gv->em_x);
+
+	free(gv->pp_n);
+	free(gv->pp_xi);
+	free(gv->delta_pp_n);
+	free(gv->delta_pp_xi);
+	for (int i = 0; i < gv->len_pp; i++){
+		free(gv->pp_flags[i]);
+	}
+	free(gv->pp_flags);
+
+	for (int i = 0; i < gv->len_ss; i++){
+		free(gv->id_solvi[i]);
+	}
+	free(gv->id_solvi);
+	free(gv->n_solvi);
+	free(gv->verifyPC);
+};
+
+/**
+  free the arrays allocated by zeros_in_bulk
+*/
+void free_bulk_info(						struct bulk_info 	z_b 	){
+
+	free(z_b.apo);
+	free(z_b.masspo);
+	free(z_b.bulk_rock);
+	free(z_b.nzEl_array);
+	if (z_b.zEl_val > 0){
+		free(z_b.zEl_array);
+	}
+};
+
+/**
+  create the output file and write the header and the oxide/phase names
+*/
+void write_LVL_bin_header(		global_variable 	*gv,
+								LVL_bin_header 		 header,
+								char 				*path 			){
+	char name[LVL_bin_name];
+
+	FILE *out = fopen(path, "wb");
+	if (out == NULL){
+		printf("\n batch levelling output file '%s' cannot be written\n", path);
+		exit(EXIT_FAILURE);
+	}
+	fwrite(&header, sizeof(LVL_bin_header), 1, out);
+
+	for (int i = 0; i < gv->len_ox + gv->len_pp + gv->len_ss; i++){
+		memset(name, 0, LVL_bin_name);
+		if 		(i < gv->len_ox)				{ strncpy(name, gv->ox[i], 						LVL_bin_name - 1); }
+		else if (i < gv->len_ox + gv->len_pp)	{ strncpy(name, gv->PP_list[i - gv->len_ox], 		LVL_bin_name - 1); }
+		else 								{ strncpy(name, gv->SS_list[i - gv->len_ox - gv->len_pp], LVL_bin_name - 1); }
+		fwrite(name, 1, LVL_bin_name, out);
+	}
+	fclose(out);
+};
+
+/**
+  fill the record of a point with Gamma and the levelled assemblage
+*/
+void fill_LVL_bin_record(		double 				*rec,
+								global_variable 	*gv,
+								struct bulk_info 	 z_b,
+								batch_point 		 point,
+								Databases 			 DB,
+								double 				 time_taken 	){
+	int 	 n_ph 	= 0;
+	double 	*slot 	= rec + 6 + 2*gv->len_ox;
+
+	rec[0] = point.line;
+	rec[2] = point.P;
+	rec[3] = point.T;
+	rec[4] = time_taken;
+	rec[5] = gv->PC_reuse;
+	for (int i = 0; i < gv->len_ox; i++){
+		rec[6 + i] 			   = z_b.bulk_rock[i];
+		rec[6 + gv->len_ox + i] = gv->gam_tot[i];
+	}
+
+	for (int i = 0; i < gv->len_ox*(2 + gv->len_ox); i++){
+		slot[i] = 0.0;
+	}
+	for (int i = 0; i < gv->len_ox; i++){
+		slot[i*(2 + gv->len_ox)] = -1.0;
+	}
+
+	for (int i = 0; i < gv->len_pp && n_ph < gv->len_ox; i++){
+		if (gv->pp_flags[i][1] == 1){
+			slot[n_ph*(2 + gv->len_ox)    ] = i;
+			slot[n_ph*(2 + gv->len_ox) + 1] = gv->pp_n[i];
+			n_ph += 1;
+		}
+	}
+	for (int i = 0; i < gv->len_cp && n_ph < gv->len_ox; i++){
+		if (DB.cp[i].ss_flags[1] == 1){
+			slot[n_ph*(2 + gv->len_ox)    ] = gv->len_pp + DB.cp[i].id;
+			slot[n_ph*(2 + gv->len_ox) + 1] = DB.cp[i].ss_n;
+			for (int j = 0; j < DB.cp[i].n_xeos; j++){
+				slot[n_ph*(2 + gv->len_ox) + 2 + j] = DB.cp[i].xeos[j];
+			}
+			n_ph += 1;
+		}
+	}
+	rec[1] = n_ph;
+};
+
+/**
+  batch levelling driver (Mode 4)
+*/
+void run_batch_levelling(		int 				 EM_database,
+								char 				*file_name,
+								int 				 n_points,
+								global_variable 	*gv,
+								Databases 			 DB 			){
+
+	LVL_bin_header 	 header;
+	batch_point 	*points;
+	char 			 out_lm[255];
+	int 			 rank, numprocs, n_read, n_start, n_end, fd;
+	int 			 n_reuse = 0, n_reuse_tot = 0;
+	double 			 t0 = batch_wtime();
+
+	MPI_Comm_size(MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+	if (strcmp(file_name, "none") == 0){
+		printf("\n batch levelling (Mode 4) requires an input file (--File)\n");
+		exit(EXIT_FAILURE);
+	}
+
+	points = malloc (n_points * sizeof(batch_point));
+	n_read = read_batch_data(	gv,
+								points,
+								file_name,
+								n_points		);
+
+	/* header of the output file, the records are written at fixed positions by every rank and thread */
+	memset(&header, 0, sizeof(LVL_bin_header));
+	strcpy(header.magic, LVL_bin_magic);
+	header.version 	= LVL_bin_version;
+	header.len_ox 	= gv->len_ox;
+	header.len_pp 	= gv->len_pp;
+	header.len_ss 	= gv->len_ss;
+	header.n_points = n_read;
+	header.rec_len 	= 6 + 2*gv->len_ox + gv->len_ox*(2 + gv->len_ox);
+	header.offset 	= sizeof(LVL_bin_header) + (gv->len_ox + gv->len_pp + gv->len_ss)*LVL_bin_name;
+
+	sprintf(out_lm,	"%s__LEVELLING_GAMMA.bin", gv->outpath);
+	if (rank == 0){
+		write_LVL_bin_header(	gv,
+								header,
+								out_lm			);
+	}
+	MPI_Barrier(MPI_COMM_WORLD);
+
+	fd = open(out_lm, O_WRONLY);
+	if (fd == -1){
+		printf("\n batch levelling output file '%s' cannot be opened\n", out_lm);
+		exit(EXIT_FAILURE);
+	}
+
+	/* contiguous block of points of the rank, sorted such that the pseudocompounds can be reused */
+	n_start = (int) (((long) n_read *  rank     )/numprocs);
+	n_end   = (int) (((long) n_read * (rank + 1))/numprocs);
+	qsort(points + n_start, n_end - n_start, sizeof(batch_point), compare_batch_points);
+
+	#pragma omp parallel reduction(+:n_reuse)
+	{
+		global_variable 	gv_th;
+		Databases 			DB_th;
+		struct bulk_info 	z_b;
+		double 				rec[header.rec_len];
+		double 				t;
+		int 				thread = 0;
+		int 				prev   = -1;
+
+#ifdef _OPENMP
+		thread = omp_get_thread_num();
+#endif
+		/* the first thread uses the databases of the main driver, the others get their own copy */
+		if (thread == 0){
+			gv_th = *gv;
+			DB_th = DB;
+		}
+		else{
+			#pragma omp critical
+			{
+				gv_th = thread_global_variable(	gv 				);
+				DB_th = InitializeDatabases(	gv,
+												EM_database 	);
+				init_PGE_workspace(		&gv_th,
+										DB_th.SS_ref_db );
+			}
+		}
+		gv_th.verbose = 2;											/** results are only sent to the output file */
+
+		#pragma omp for schedule(dynamic, LVL_chunk)
+		for (int k = n_start; k < n_end; k++){
+			t 	= batch_wtime();
+			z_b = zeros_in_bulk(	points[k].bulk,
+									points[k].P,
+									points[k].T + 273.15	);
+
+			/* keep the pseudocompounds of the previous point of the thread if P, T and the zero oxides are the same */
+			gv_th.PC_reuse 	= (		prev != -1
+								&& 	points[prev].P 	   == points[k].P
+								&& 	points[prev].T 	   == points[k].T
+								&& 	points[prev].zeros == points[k].zeros	) ? 1 : 0;
+			n_reuse 	   += gv_th.PC_reuse;
+			prev 			= k;
+
+			gv_th.BR_norm     = 1.0;
+			gv_th.global_ite  = 0;
+			gv_th.numPoint    = points[k].id;
+
+			reset_global_variables(	&gv_th,
+									DB_th.PP_ref_db,
+									DB_th.SS_ref_db,
+									DB_th.cp				);
+
+			reset_phases(			&gv_th,
+									z_b,
+									DB_th.PP_ref_db,
+									DB_th.SS_ref_db,
+									DB_th.cp				);
+
+			init_em_db(				EM_database,
+									z_b,
+									&gv_th,
+									DB_th.PP_ref_db			);
+
+			init_ss_db(				EM_database,
+									z_b,
+									&gv_th,
+									DB_th.SS_ref_db			);
+
+			Levelling(				z_b,
+									&gv_th,
+									DB_th.PP_ref_db,
+									DB_th.SS_ref_db,
+									DB_th.cp				);
+
+			if (gv_th.lvl_stats == 1){
+				#pragma omp critical
+				dump_levelling_stats(		&gv_th,
+											z_b,
+											DB_th.SS_ref_db			);
+			}
+
+			fill_LVL_bin_record(			rec,
+											&gv_th,
+											z_b,
+											points[k],
+											DB_th,
+											(batch_wtime() - t)*1000.0	);
+
+			if (pwrite(fd, rec, header.rec_len*sizeof(double), header.offset + (long) points[k].id*header.rec_len*sizeof(double)) == -1){
+				printf("\n batch levelling: point %d cannot be written\n", points[k].id);
+			}
+
+			free_bulk_info(					z_b 					);
+		}
+
+		if (thread != 0){
+			CP_destroy(						&gv_th,
+											DB_th.cp 				);
+			free(DB_th.cp);
+			free(DB_th.PP_ref_db);
+			destroy_PGE_workspace(			&gv_th 					);
+			NLopt_opt_destroy(				&gv_th,
+											DB_th.SS_ref_db 		);
+			SS_ref_destroy(					&gv_th,
+											DB_th.SS_ref_db 		);
+			free(DB_th.SS_ref_db);
+			for (int i = 0; i < n_em_db; i++){
+				free(DB_th.EM_names[i]);
+			}
+			free(DB_th.EM_names);
+			free_thread_global_variable(	&gv_th 					);
+		}
+	}
+	close(fd);
+	free(points);
+
+	MPI_Reduce(&n_reuse, &n_reuse_tot, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+	MPI_Barrier(MPI_COMM_WORLD);
+
+	if (rank == 0){
+		printf("Batch levelling: %d points, pseudocompounds reused for %d points\n", n_read, n_reuse_tot);
+		printf("Results written to %s (%.3f s)\n", out_lm, batch_wtime() - t0);
+	}
+};
@@ -0,0 +1,54 @@
+#ifndef __BATCH_LEVELLING_FUNCTION_H_
+#define __BATCH_LEVELLING_FUNCTION_H_
+
+#define LVL_bin_magic 	"MAGEMin_LVL_bin"
+#define LVL_bin_version 2
+#define LVL_bin_name 	20
+#define LVL_chunk 		32
+
+/**
+	Layout of the batch levelling output file (__LEVELLING_GAMMA.bin):
+
+	LVL_bin_header
+	char[LVL_bin_name] x (len_ox + len_pp + len_ss)		oxide, pure phase and solution phase names
+	double[rec_len]    x n_points						one record per point (at offset + point*rec_len*sizeof(double))
+
+	record: line of the point in the input file, n_phase, P[kbar], T[C], levelling time[ms], PC reused[0,1], bulk[len_ox], Gamma[len_ox],
+	        then len_ox phase slots {id, fraction, x-eos[len_ox]}, id < len_pp for pure phases, len_pp + ss
+	        for solution phases and -1 for empty slots
+*/
+typedef struct LVL_bin_headers {
+	char 	magic[16];			/** LVL_bin_magic 														*/
+	int 	version;			/** LVL_bin_version 													*/
+	int 	len_ox;				/** number of oxides 													*/
+	int 	len_pp;				/** number of pure phases 												*/
+	int 	len_ss;				/** number of solution phases 											*/
+	int 	n_points;			/** number of records 													*/
+	int 	rec_len;			/** number of doubles per record 										*/
+	long 	offset;				/** position of the first record in the file (bytes) 					*/
+} LVL_bin_header;
+
+/** point of the batch input file */
+typedef struct batch_points {
+	int 	id;					/** index of the point among the valid lines of the input file (record of the output file) */
+	int 	line;				/** line number of the point in the input file (from 1) 					*/
+	int 	zeros;				/** bit mask of the zero oxides of the bulk 							*/
+	double 	P;					/** pressure [kbar] 													*/
+	double 	T;					/** temperature [C] 													*/
+	double 	bulk[11];			/** normalized bulk-rock composition 									*/
+} batch_point;
+
+double batch_wtime(void);
+
+int read_batch_data(				global_variable 	*gv,
+									batch_point 		*points,
+									char 				*file_name,
+									int 				 n_points 		);
+
+void run_batch_levelling(			int 				 EM_database,
+									char 				*file_name,
+									int 				 n_points,
+									global_variable 	*gv,
+									Databases 			 DB 			);
+
+#endif
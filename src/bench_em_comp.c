@@ -0,0 +1,183 @@
+/**
+Microbenchmark of the phase update kernels run at every PGE inner iteration (make bench_em).
+
+One inner iteration levels the pure phases (pp_min_function), rotates the chemical potential of the endmembers of the
+considered phases (PGE_update_mu) and updates their Boltzmann factors and composition (PGE_update_xi). The per-phase
+loops over double pointers are compared with the kernels of em_comp_function.c working on the flattened (column-major)
+endmember composition matrix, on a synthetic set of phases sized as a typical metapelite/igneous assemblage.
+
+usage: ./bench_em_comp [n_iterations] [n_considered_phases] [n_endmembers]
+
+The sizes are runtime values, as len_ox, n_pp and n_em are in MAGEMin.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "em_comp_function.h"
+
+#define n_cp_max 	16					/** max number of considered solution phases 			*/
+#define n_em_max 	16					/** max number of endmembers per considered phase 		*/
+
+double wtime(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+};
+
+int main(int argc, char **argv){
+
+	int 	 n_ite 	= (argc > 1) ? atoi(argv[1]) : 200000;
+	int 	 n_cp 	= (argc > 2) ? atoi(argv[2]) : 12;
+	int 	 n_em 	= (argc > 3) ? atoi(argv[3]) : 8;
+	int 	 n_ox 	= 11;
+	int 	 n_pp 	= 10;
+	double 	 RT 	= 0.0083144*1273.15;
+	double 	 t0, t_ref, t_flat, diff = 0.0;
+
+	/* per-phase storage, as in PP_ref_db, SS_ref_db and cp */
+	n_cp 	= (n_cp > n_cp_max) ? n_cp_max : n_cp;
+	n_em 	= (n_em > n_em_max) ? n_em_max : n_em;
+
+	double 	**pp_comp 	= malloc (n_pp * sizeof(double*));
+	double 	 pp_gbase[n_pp], pp_gb[n_pp], pp_xi[n_pp];
+	double 	**ss_comp[n_cp_max];
+	double 	 mu[n_cp_max][n_em_max], p[n_cp_max][n_em_max], z[n_cp_max][n_em_max], xi[n_cp_max][n_em_max];
+	double 	 comp[n_cp_max][11], sum_xi[n_cp_max];
+	double 	 gam[11], dgam[11];
+
+	/* flattened storage */
+	int 	 n_rows = n_pp + n_cp*n_em;
+	double 	*C 		= malloc (n_rows*n_ox * sizeof(double));
+	double 	*g 		= malloc (n_rows 	  * sizeof(double));
+	double 	*x 		= malloc (n_rows 	  * sizeof(double));
+	double 	 mu_f[n_cp_max][n_em_max], comp_f[n_cp_max][11], w[n_em_max];
+
+	srand(1);
+	for (int j = 0; j < n_ox; j++){
+		gam[j]  = -900.0 + 100.0*rand()/RAND_MAX;
+		dgam[j] = 1e-3*(rand()/(double)RAND_MAX - 0.5);
+	}
+	for (int i = 0; i < n_pp; i++){
+		pp_gbase[i] = -2000.0*rand()/RAND_MAX;
+		pp_comp[i] 	= malloc (n_ox * sizeof(double));
+		for (int j = 0; j < n_ox; j++){
+			pp_comp[i][j] 		= (rand() % 3)*0.5;
+			C[j*n_rows + i] 	= pp_comp[i][j];
+		}
+	}
+	for (int i = 0; i < n_cp; i++){
+		ss_comp[i] = malloc (n_em * sizeof(double*));
+		for (int k = 0; k < n_em; k++){
+			ss_comp[i][k] = malloc (n_ox * sizeof(double));
+			for (int j = 0; j < n_ox; j++){
+				ss_comp[i][k][j] 	= (rand() % 4)*0.5;
+				C[j*n_rows + n_pp + i*n_em + k] = ss_comp[i][k][j];
+			}
+			mu[i][k] 	= mu_f[i][k] = 10.0*rand()/RAND_MAX;
+			p[i][k] 	= 1.0/n_em;
+			z[i][k] 	= (k == n_em - 1) ? 0.0 : 1.0;
+		}
+	}
+
+	/* per-phase loops */
+	t0 = wtime();
+	for (int it = 0; it < n_ite; it++){
+		for (int i = 0; i < n_pp; i++){
+			pp_gb[i] = pp_gbase[i];
+			for (int j = 0; j < n_ox; j++){
+				pp_gb[i] -= pp_comp[i][j]*gam[j];
+			}
+			pp_xi[i] = exp(-pp_gb[i]/RT);
+		}
+		for (int i = 0; i < n_cp; i++){
+			for (int k = 0; k < n_em; k++){
+				double dmu = 0.0;
+				for (int j = 0; j < n_ox; j++){
+					dmu -= ss_comp[i][k][j]*dgam[j];
+				}
+				mu[i][k] += dmu;
+			}
+			sum_xi[i] = 0.0;
+			for (int k = 0; k < n_em; k++){
+				xi[i][k]   = exp(-mu[i][k]/RT);
+				sum_xi[i] += xi[i][k]*p[i][k]*z[i][k];
+			}
+			for (int j = 0; j < n_ox; j++){
+				comp[i][j] = 0.0;
+				for (int k = 0; k < n_em; k++){
+					comp[i][j] += ss_comp[i][k][j]*p[i][k]*z[i][k];
+				}
+			}
+		}
+	}
+	t_ref = wtime() - t0;
+
+	/* flattened endmember matrix */
+	t0 = wtime();
+	for (int it = 0; it < n_ite; it++){
+		for (int i = 0; i < n_pp; i++){
+			g[i] = pp_gbase[i];
+		}
+		em_project(g, C, n_rows, gam, n_pp, n_ox);
+		em_exp(x, g, RT, n_pp);
+
+		for (int r = n_pp; r < n_rows; r++){
+			g[r] = 0.0;
+		}
+		em_project(g + n_pp, C + n_pp, n_rows, dgam, n_rows - n_pp, n_ox);
+		for (int i = 0; i < n_cp; i++){
+			for (int k = 0; k < n_em; k++){
+				mu_f[i][k]  		 += g[n_pp + i*n_em + k];
+				g[n_pp + i*n_em + k]  = mu_f[i][k];
+			}
+		}
+		em_exp(x + n_pp, g + n_pp, RT, n_rows - n_pp);
+		for (int i = 0; i < n_cp; i++){
+			sum_xi[i] = 0.0;
+			for (int k = 0; k < n_em; k++){
+				sum_xi[i] += x[n_pp + i*n_em + k]*p[i][k]*z[i][k];
+				w[k] 	   = p[i][k]*z[i][k];
+			}
+			em_mix(comp_f[i], C + n_pp + i*n_em, n_rows, w, n_em, n_ox);
+		}
+	}
+	t_flat = wtime() - t0;
+
+	for (int i = 0; i < n_pp; i++){
+		diff = fmax(diff, fabs(g[i] - pp_gb[i]));
+		diff = fmax(diff, fabs(x[i] - pp_xi[i]));
+	}
+	for (int i = 0; i < n_cp; i++){
+		for (int k = 0; k < n_em; k++){
+			diff = fmax(diff, fabs(mu_f[i][k] - mu[i][k]));
+			diff = fmax(diff, fabs(x[n_pp + i*n_em + k] - xi[i][k]));
+		}
+		for (int j = 0; j < n_ox; j++){
+			diff = fmax(diff, fabs(comp_f[i][j] - comp[i][j]));
+		}
+	}
+
+	printf(" %d pure phases, %d considered phases x %d endmembers, %d oxides, %d inner iterations\n", n_pp, n_cp, n_em, n_ox, n_ite);
+	printf(" per-phase loops     : %8.1f ns/iteration\n", 1e9*t_ref /n_ite);
+	printf(" flattened matrix    : %8.1f ns/iteration (x%.2f)\n", 1e9*t_flat/n_ite, t_ref/t_flat);
+	printf(" max difference      : %g\n", diff);
+
+	for (int i = 0; i < n_pp; i++){
+		free(pp_comp[i]);
+	}
+	free(pp_comp);
+	for (int i = 0; i < n_cp; i++){
+		for (int k = 0; k < n_em; k++){
+			free(ss_comp[i][k]);
+		}
+		free(ss_comp[i]);
+	}
+	free(C);
+	free(g);
+	free(x);
+
+	return 0;
+};
@@ -0,0 +1,196 @@
+/**
+Microbenchmark of the SS_ref passing of the local minimization path (make bench_ss_ref).
+
+Every local minimization (ss_min_PGE) goes through rotate_hyperplane, restrict_SS_HyperVolume, NLopt_opt_function,
+NLopt_opt_<phase>_function, PC_function and SS_UPDATE_function. These used to take and return SS_ref by value, i.e. two
+copies of the structure per call, they now update the SS_ref_db entry of the phase through a pointer. Both versions of
+the chain are reproduced here on a synthetic garnet (obj_g, one objective evaluation standing for the minimizer and one
+for PC_function), such that only the passing of the structure differs.
+
+usage: ./bench_ss_ref [n_iterations]
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MAGEMin.h"
+#include "objective_functions.h"
+
+#define n_chain_calls 	6				/** rotate, restrict, NLopt_opt, NLopt_opt_<phase> (or SQP_opt), PC, SS_UPDATE */
+#define noinline 		__attribute__((noinline))
+
+double wtime(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9*ts.tv_nsec;
+};
+
+/**
+  synthetic garnet, allocated as in gss_init_function.c
+*/
+SS_ref bench_init(){
+
+	SS_ref 	d;
+	int 	n_em 	= 6;
+	int 	n_xeos 	= 5;
+	int 	n_sf 	= 7;
+	int 	n_W 	= n_em*(n_em-1)/2;
+
+	memset(&d, 0, sizeof(SS_ref));
+	d.n_em 		= n_em;
+	d.n_xeos 	= n_xeos;
+	d.n_sf 		= n_sf;
+	d.P 		= 10.0;
+	d.T 		= 1073.15;
+	d.R 		= 0.0083144;
+	d.fbc 		= 5.0;
+
+	d.W 		= malloc (n_W 					* sizeof (double) );
+	d.v 		= malloc (n_em 					* sizeof (double) );
+	d.gbase 	= malloc (n_em 					* sizeof (double) );
+	d.gb_lvl 	= malloc (n_em 					* sizeof (double) );
+	d.ape 		= malloc (n_em 					* sizeof (double) );
+	d.p 		= malloc (n_em 					* sizeof (double) );
+	d.mat_phi 	= malloc (n_em 					* sizeof (double) );
+	d.mu_Gex 	= malloc (n_em 					* sizeof (double) );
+	d.mu 		= malloc (n_em 					* sizeof (double) );
+	d.sf 		= malloc (n_sf 					* sizeof (double) );
+	d.dsf 		= malloc ((n_sf*n_xeos) 		* sizeof (double) );
+	d.dfx 		= malloc (n_xeos 				* sizeof (double) );
+	d.iguess 	= malloc (n_xeos 				* sizeof (double) );
+	d.eye 		= malloc (n_em 					* sizeof (double*));
+	d.dp_dx 	= malloc (n_em 					* sizeof (double*));
+	d.box_bounds 		  = malloc (n_xeos 		* sizeof (double*));
+	d.box_bounds_default  = malloc (n_xeos 		* sizeof (double*));
+	for (int i = 0; i < n_em; i++){
+		d.eye[i] 	= malloc (n_em 				* sizeof (double) );
+		d.dp_dx[i] 	= malloc (n_xeos 			* sizeof (double) );
+		for (int j = 0; j < n_em; j++){
+			d.eye[i][j] = (i == j) ? 1.0 : 0.0;
+		}
+		d.v[i] 		= 1.0 + 0.5*sin(1.0 + i);
+		d.gbase[i] 	= -10.0*cos(2.0 + i);
+		d.ape[i] 	= 3.0 + (i % 4);
+	}
+	for (int i = 0; i < n_W; i++){
+		d.W[i] 		= 20.0*sin(3.0 + 0.7*i);
+	}
+	for (int j = 0; j < n_xeos; j++){
+		d.box_bounds[j] 		= malloc (2 	* sizeof (double) );
+		d.box_bounds_default[j] = malloc (2 	* sizeof (double) );
+		d.box_bounds_default[j][0] = 0.0;
+		d.box_bounds_default[j][1] = 1.0;
+	}
+	d.iguess[0] = 0.2; d.iguess[1] = 0.1; d.iguess[2] = 0.1; d.iguess[3] = 0.05; d.iguess[4] = 0.05;
+
+	return d;
+};
+
+/** by-value chain, as before */
+noinline SS_ref val_rotate(double *gam, SS_ref d){
+	for (int k = 0; k < d.n_em; k++){
+		d.gb_lvl[k] = d.gbase[k] - gam[k];
+	}
+	return d;
+};
+noinline SS_ref val_restrict(SS_ref d, double box_size){
+	for (int j = 0; j < d.n_xeos; j++){
+		d.box_bounds[j][0] = fmax(d.iguess[j] - box_size, d.box_bounds_default[j][0]);
+		d.box_bounds[j][1] = fmin(d.iguess[j] + box_size, d.box_bounds_default[j][1]);
+	}
+	return d;
+};
+noinline SS_ref val_opt_g(SS_ref d){
+	d.df 		= obj_g(d.n_xeos, d.iguess, d.dfx, &d);
+	d.status 	= 0;
+	return d;
+};
+noinline SS_ref val_opt(SS_ref d){
+	d = val_opt_g(d);
+	return d;
+};
+noinline SS_ref val_PC(SS_ref d){
+	d.df_raw 	= obj_g(d.n_xeos, d.iguess, d.dfx, &d);
+	return d;
+};
+noinline SS_ref val_update(SS_ref d){
+	d.sf_ok 	= 1;
+	for (int i = 0; i < d.n_sf; i++){
+		if (d.sf[i] < 0.0){ d.sf_ok = 0; }
+	}
+	return d;
+};
+
+/** pointer chain, as now */
+noinline void ptr_rotate(double *gam, SS_ref *d){
+	for (int k = 0; k < d->n_em; k++){
+		d->gb_lvl[k] = d->gbase[k] - gam[k];
+	}
+};
+noinline void ptr_restrict(SS_ref *d, double box_size){
+	for (int j = 0; j < d->n_xeos; j++){
+		d->box_bounds[j][0] = fmax(d->iguess[j] - box_size, d->box_bounds_default[j][0]);
+		d->box_bounds[j][1] = fmin(d->iguess[j] + box_size, d->box_bounds_default[j][1]);
+	}
+};
+noinline void ptr_opt_g(SS_ref *d){
+	d->df 		= obj_g(d->n_xeos, d->iguess, d->dfx, d);
+	d->status 	= 0;
+};
+noinline void ptr_opt(SS_ref *d){
+	ptr_opt_g(d);
+};
+noinline void ptr_PC(SS_ref *d){
+	d->df_raw 	= obj_g(d->n_xeos, d->iguess, d->dfx, d);
+};
+noinline void ptr_update(SS_ref *d){
+	d->sf_ok 	= 1;
+	for (int i = 0; i < d->n_sf; i++){
+		if (d->sf[i] < 0.0){ d->sf_ok = 0; }
+	}
+};
+
+int main(int argc, char **argv){
+
+	int 	 n_ite 	= (argc > 1) ? atoi(argv[1]) : 2000000;
+	double 	 gam[6] = {0.1, -0.2, 0.3, -0.1, 0.2, 0.05};
+	double 	 t0, t_val, t_ptr, s_val = 0.0, s_ptr = 0.0;
+
+	SS_ref 	 d 		= bench_init();
+
+	t0 = wtime();
+	for (int it = 0; it < n_ite; it++){
+		d.iguess[0] = 0.2 + 1e-9*(it % 7);
+		d = val_rotate(gam, d);
+		d = val_restrict(d, 0.1);
+		d = val_opt(d);
+		d = val_PC(d);
+		d = val_update(d);
+		s_val += d.df + d.df_raw;
+	}
+	t_val = wtime() - t0;
+
+	t0 = wtime();
+	for (int it = 0; it < n_ite; it++){
+		d.iguess[0] = 0.2 + 1e-9*(it % 7);
+		ptr_rotate(gam, &d);
+		ptr_restrict(&d, 0.1);
+		ptr_opt(&d);
+		ptr_PC(&d);
+		ptr_update(&d);
+		s_ptr += d.df + d.df_raw;
+	}
+	t_ptr = wtime() - t0;
+
+	printf(" sizeof(SS_ref)                 : %zu bytes\n", sizeof(SS_ref));
+	printf(" calls per local minimization   : %d\n", n_chain_calls);
+	printf(" copies per local minimization  : %d by value, 0 by pointer\n", 2*n_chain_calls);
+	printf(" bytes copied per minimization  : %zu by value, 0 by pointer\n", 2*n_chain_calls*sizeof(SS_ref));
+	printf(" time per chain                 : %.1f ns by value, %.1f ns by pointer (%.2fx, %d iterations)\n", 1e9*t_val/n_ite, 1e9*t_ptr/n_ite, t_val/t_ptr, n_ite);
+	printf(" checksum                       : %.12e %.12e\n", s_val, s_ptr);
+
+	return 0;
+};
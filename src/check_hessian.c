@@ -0,0 +1,190 @@
+/**
+Finite-difference check of the analytic Hessians of the solution phases (make check_hess).
+
+For every point of the pseudocompound grids of SS_xeos_PC.h, the Hessian given by hess_<phase> is compared with the
+central differences of the analytic gradient of obj_<phase>. The Margules parameters, volumes, reference Gibbs energies and
+atoms per endmember are synthetic (the derivatives do not depend on their values), such that no thermodynamic data are needed.
+The finite-difference step is scaled by the smallest site fraction of the point, the points outside of the site-fraction
+bounds (sf <= 0) are skipped.
+
+usage: ./check_hessian [step] [tolerance]
+
+The relative error of a point is max|H - H_fd| / max(1, max|H|), the exit code is 1 if it exceeds the tolerance.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MAGEMin.h"
+#include "objective_functions.h"
+#include "SS_xeos_PC.h"
+
+#define n_ss_check 	14
+
+typedef struct check_phases {
+	char 			*name;
+	obj_type 		 obj;
+	hess_type 		 hess;
+	struct ss_pc 	*pc;
+	int 			 n_pc;
+	int 			 n_em;
+	int 			 n_xeos;
+	int 			 n_sf;
+} check_phase;
+
+/**
+  solution phase with synthetic parameters, allocated as in gss_init_function.c
+*/
+SS_ref check_init(		check_phase 	ph 		){
+
+	SS_ref 	d;
+	int 	n_em 	= ph.n_em;
+	int 	n_xeos 	= ph.n_xeos;
+	int 	n_sf 	= ph.n_sf;
+	int 	n_W 	= n_em*(n_em-1)/2;
+
+	memset(&d, 0, sizeof(SS_ref));
+	d.n_em 		= n_em;
+	d.n_xeos 	= n_xeos;
+	d.n_sf 		= n_sf;
+	d.P 		= 10.0;
+	d.T 		= 1073.15;
+	d.R 		= 0.0083144;
+	d.fbc 		= 5.0;
+
+	d.W 		= malloc (n_W 					* sizeof (double) );
+	d.v 		= malloc (n_em 					* sizeof (double) );
+	d.gb_lvl 	= malloc (n_em 					* sizeof (double) );
+	d.ape 		= malloc (n_em 					* sizeof (double) );
+	d.p 		= malloc (n_em 					* sizeof (double) );
+	d.mat_phi 	= malloc (n_em 					* sizeof (double) );
+	d.mu_Gex 	= malloc (n_em 					* sizeof (double) );
+	d.mu 		= malloc (n_em 					* sizeof (double) );
+	d.sf 		= malloc ((n_sf+1) 				* sizeof (double) );	/* obj_bi also sets sf[n_sf] */
+	d.dsf 		= malloc ((n_sf*n_xeos) 		* sizeof (double) );
+	d.dfx 		= malloc (n_xeos 				* sizeof (double) );
+	d.hess_ws 	= malloc (SS_hess_ws_size(n_em, n_xeos) * sizeof (double) );
+	d.eye 		= malloc (n_em 					* sizeof (double*));
+	d.dp_dx 	= malloc (n_em 					* sizeof (double*));
+	for (int i = 0; i < n_em; i++){
+		d.eye[i] 	= malloc (n_em 				* sizeof (double) );
+		d.dp_dx[i] 	= malloc (n_xeos 			* sizeof (double) );
+		for (int j = 0; j < n_em; j++){
+			d.eye[i][j] = (i == j) ? 1.0 : 0.0;
+		}
+		d.v[i] 		= 1.0 + 0.5*sin(1.0 + i);
+		d.gb_lvl[i] = -10.0*cos(2.0 + i);
+		d.ape[i] 	= 3.0 + (i % 4);
+	}
+	for (int i = 0; i < n_W; i++){
+		d.W[i] 		= 20.0*sin(3.0 + 0.7*i);
+	}
+
+	return d;
+};
+
+void check_free(		SS_ref 			d 		){
+
+	for (int i = 0; i < d.n_em; i++){
+		free(d.eye[i]);
+		free(d.dp_dx[i]);
+	}
+	free(d.eye);
+	free(d.dp_dx);
+	free(d.W);
+	free(d.v);
+	free(d.gb_lvl);
+	free(d.ape);
+	free(d.p);
+	free(d.mat_phi);
+	free(d.mu_Gex);
+	free(d.mu);
+	free(d.sf);
+	free(d.dsf);
+	free(d.dfx);
+	free(d.hess_ws);
+};
+
+int main(int argc, char **argv){
+
+	double 	h 		= (argc > 1) ? atof(argv[1]) : 1e-4;
+	double 	tol 	= (argc > 2) ? atof(argv[2]) : 1e-5;
+	int 	fail 	= 0;
+
+	check_phase ph[n_ss_check] = {
+		{"bi",   obj_bi,   hess_bi,   bi_pc_xeos,   sizeof(bi_pc_xeos)  /sizeof(struct ss_pc),  6, 5, 10},
+		{"cd",   obj_cd,   hess_cd,   cd_pc_xeos,   sizeof(cd_pc_xeos)  /sizeof(struct ss_pc),  3, 2,  4},
+		{"cpx",  obj_cpx,  hess_cpx,  cpx_pc_xeos,  sizeof(cpx_pc_xeos) /sizeof(struct ss_pc), 10, 9, 13},
+		{"ep",   obj_ep,   hess_ep,   ep_pc_xeos,   sizeof(ep_pc_xeos)  /sizeof(struct ss_pc),  3, 2,  4},
+		{"fl",   obj_fl,   hess_fl,   fl_pc_xeos,   sizeof(fl_pc_xeos)  /sizeof(struct ss_pc), 11,10, 12},
+		{"g",    obj_g,    hess_g,    g_pc_xeos,    sizeof(g_pc_xeos)   /sizeof(struct ss_pc),  6, 5,  7},
+		{"hb",   obj_hb,   hess_hb,   hb_pc_xeos,   sizeof(hb_pc_xeos)  /sizeof(struct ss_pc), 11,10, 17},
+		{"ilm",  obj_ilm,  hess_ilm,  ilm_pc_xeos,  sizeof(ilm_pc_xeos) /sizeof(struct ss_pc),  3, 2,  6},
+		{"liq",  obj_liq,  hess_liq,  liq_pc_xeos,  sizeof(liq_pc_xeos) /sizeof(struct ss_pc), 12,11, 18},
+		{"mu",   obj_mu,   hess_mu,   mu_pc_xeos,   sizeof(mu_pc_xeos)  /sizeof(struct ss_pc),  6, 5, 10},
+		{"ol",   obj_ol,   hess_ol,   ol_pc_xeos,   sizeof(ol_pc_xeos)  /sizeof(struct ss_pc),  4, 3,  5},
+		{"opx",  obj_opx,  hess_opx,  opx_pc_xeos,  sizeof(opx_pc_xeos) /sizeof(struct ss_pc),  9, 8, 12},
+		{"pl4T", obj_pl4T, hess_pl4T, pl4T_pc_xeos, sizeof(pl4T_pc_xeos)/sizeof(struct ss_pc),  3, 2,  5},
+		{"spn",  obj_spn,  hess_spn,  spn_pc_xeos,  sizeof(spn_pc_xeos) /sizeof(struct ss_pc),  8, 7, 10},
+	};
+
+	printf(" phase |  points  skipped |  max rel. error  (point)\n");
+
+	for (int iss = 0; iss < n_ss_check; iss++){
+
+		SS_ref 	d 		= check_init(ph[iss]);
+		int 	n 		= d.n_xeos;
+		int 	n_skip 	= 0;
+		int 	max_pc 	= -1;
+		double 	max_err = 0.0;
+		double 	x[11], xh[11], gp[11], gm[11], H[121];
+
+		for (int ipc = 0; ipc < ph[iss].n_pc; ipc++){
+			for (int k = 0; k < n; k++){
+				x[k] = ph[iss].pc[ipc].xeos_pc[k];
+			}
+
+			/* the step is scaled by the smallest site fraction, points outside of the site-fraction bounds are skipped */
+			ph[iss].obj(n, x, gp, &d);
+			double sf_min = 1.0;
+			for (int s = 0; s < d.n_sf; s++){
+				sf_min = fmin(sf_min, d.sf[s]);
+			}
+			if (sf_min <= 0.0){
+				n_skip += 1;
+				continue;
+			}
+			double hs = h*sf_min;
+
+			ph[iss].hess(n, x, H, &d);
+
+			double err = 0.0, h_max = 1.0;
+			for (int l = 0; l < n; l++){
+				for (int k = 0; k < n; k++){
+					xh[k] = x[k] + ((k == l) ? hs : 0.0);
+				}
+				ph[iss].obj(n, xh, gp, &d);
+				xh[l] = x[l] - hs;
+				ph[iss].obj(n, xh, gm, &d);
+
+				for (int k = 0; k < n; k++){
+					err 	= fmax(err, fabs(H[k*n + l] - (gp[k] - gm[k])/(2.0*hs)));
+					h_max 	= fmax(h_max, fabs(H[k*n + l]));
+				}
+			}
+			if (err/h_max > max_err){
+				max_err = err/h_max;
+				max_pc 	= ipc;
+			}
+		}
+
+		printf(" %5s | %7d  %7d |  %14.3e  (%d)%s\n", ph[iss].name, ph[iss].n_pc - n_skip, n_skip, max_err, max_pc, (max_err > tol) ? "  FAILED" : "");
+		if (max_err > tol){ fail = 1; }
+
+		check_free(d);
+	}
+
+	return fail;
+};
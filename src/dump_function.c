@@ -24,11 +24,12 @@
 #include "gem_function.h"
 #include "gss_function.h"
 #include "toolkit.h"
+#include "dump_function.h"
 
 /**
   Initialize dumping function by creating needed files
 */
-void dump_init(global_variable gv){
+void dump_init(global_variable *gv){
 	FILE *loc_min;
 	char 	out_lm[255];
 	struct 	stat st = {0};
@@ -37,31 +38,32 @@ void dump_init(global_variable gv){
 	MPI_Comm_size(MPI_COMM_WORLD, &numprocs);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-	if (stat(gv.outpath, &st) == -1) {
-    	mkdir(gv.outpath, 0700);
+	if (stat(gv->outpath, &st) == -1) {
+    	mkdir(gv->outpath, 0700);
 	}
 
 	/** ----------------------------------------------------------------------------------------------- **/
 	/** THERMOCALC LIKE FINAL OUTPUT **/
-	if (gv.verbose == 1){
-		sprintf(out_lm,	"%s_thermocalc_style_output.txt"		,gv.outpath); 
+	if (gv->verbose == 1){
+		sprintf(out_lm,	"%s_thermocalc_style_output.txt"		,gv->outpath); 
 		loc_min 	= fopen(out_lm, 	"w"); 
 		fprintf(loc_min, "\n");
 		fclose(loc_min);	
 	}
 	/** ----------------------------------------------------------------------------------------------- **/
-	if (gv.verbose != 2){
+	/** batch levelling (Mode 4) only writes the binary file __LEVELLING_GAMMA.bin **/
+	if (gv->verbose != 2 && gv->Mode != 4){
 		/** MATLAB GRID OUTPUT **/
-		if (numprocs==1){	sprintf(out_lm,	"%s_pseudosection_output.txt"		,gv.outpath); 		}
-		else 			{	sprintf(out_lm,	"%s_pseudosection_output.%i.txt"	,gv.outpath, rank); }
+		if (numprocs==1){	sprintf(out_lm,	"%s_pseudosection_output.txt"		,gv->outpath); 		}
+		else 			{	sprintf(out_lm,	"%s_pseudosection_output.%i.txt"	,gv->outpath, rank); }
 		loc_min 	= fopen(out_lm, 	"w"); 
 		fprintf(loc_min, "// NUMBER\t	STATUS[S,R1,R2,F]\tP[kbar]\tT[C]\tG_sys[G]\tbr_norm[wt]\tGAMMA[G]; PHASE[name]\tMODE[wt]\tRHO[kg.m-3]\tX-EOS\n");
 		fclose(loc_min);	
 			
 		/** MODE 2 - LOCAL MINIMA **/
-		if (gv.Mode == 2){
-			if (numprocs==1){	 sprintf(out_lm,	"%s__LOCAL_MINIMA.txt"		,gv.outpath); 	   }
-			else 			{	 sprintf(out_lm,	"%s__LOCAL_MINIMA.%i.txt"	,gv.outpath, rank);}
+		if (gv->Mode == 2){
+			if (numprocs==1){	 sprintf(out_lm,	"%s__LOCAL_MINIMA.txt"		,gv->outpath); 	   }
+			else 			{	 sprintf(out_lm,	"%s__LOCAL_MINIMA.%i.txt"	,gv->outpath, rank);}
 			loc_min 	= fopen(out_lm, 	"w"); 
 			fprintf(loc_min, "// PHASE_NAME[char]\tN_x-eos[n]\tN_POINTS\tGAMMA[G]\n");
 			fprintf(loc_min, "// NUMBER\t INITIAL ENDMEMBER PROPORTIONS[n+1]\tINITIAL_GUESS_x_eos[n]\tFINAL_x-eos[n]\tFINAL ENDMEMBER PROPORTIONS[n+1]\tDRIVING_FORCE[dG]\n");
@@ -69,21 +71,161 @@ void dump_init(global_variable gv){
 			fclose(loc_min);	
 		}
 		/** MODE 2 - LEVELLING_GAMMA **/
-		if (gv.Mode == 3){
-			if (numprocs==1){	 sprintf(out_lm,	"%s__LEVELLING_GAMMA.txt"		,gv.outpath); 	   }
-			else 			{	 sprintf(out_lm,	"%s__LEVELLING_GAMMA.%i.txt"	,gv.outpath, rank);}
+		if (gv->Mode == 3){
+			if (numprocs==1){	 sprintf(out_lm,	"%s__LEVELLING_GAMMA.txt"		,gv->outpath); 	   }
+			else 			{	 sprintf(out_lm,	"%s__LEVELLING_GAMMA.%i.txt"	,gv->outpath, rank);}
 			loc_min 	= fopen(out_lm, 	"w"); 
 			fprintf(loc_min, "// BULK-ROCK[len_ox]\tP[kbar]\tT[°C]\tGAMMA[G]\n");
 
 			fclose(loc_min);	
 		}
 	}
+
+	/** LEVELLING COUNTERS **/
+	if (gv->lvl_stats == 1){
+		if (numprocs==1){	 sprintf(out_lm,	"%s__LEVELLING_STATS.txt"		,gv->outpath); 	   }
+		else 			{	 sprintf(out_lm,	"%s__LEVELLING_STATS.%i.txt"	,gv->outpath, rank);}
+		loc_min 	= fopen(out_lm, 	"w"); 
+		fprintf(loc_min, "// NUMBER\tP[kbar]\tT[C]\tLVL_time[ms]\tOBJ_time[ms]\tLA_time[ms]\tN_INV\tN_ETA\tN_DEGEN\tN_BLAND\tPRICED[pp,em,pc]\tPIVOTS[pp,em,pc]; PHASE[name]\tPC_GEN\tPC_KEPT\tPC_FILT\tPC_PIVOTS\n");
+		fclose(loc_min);	
+	}
+
+	/** PGE CONVERGENCE TRACE (header and names, the records are appended by dump_PGE_trace) **/
+	if (gv->PGE_trace == 1 && gv->Mode == 0){
+		PGE_trc_header 	header;
+		char 			name[PGE_trc_name];
+
+		if (numprocs==1){	 sprintf(out_lm,	"%s__PGE_TRACE.bin"			,gv->outpath); 	   }
+		else 			{	 sprintf(out_lm,	"%s__PGE_TRACE.%i.bin"		,gv->outpath, rank);}
+		loc_min 	= fopen(out_lm, 	"wb"); 
+		if (loc_min == NULL){
+			printf("\n PGE trace file '%s' cannot be written\n", out_lm);
+			exit(EXIT_FAILURE);
+		}
+
+		memset(&header, 0, sizeof(PGE_trc_header));
+		strcpy(header.magic, PGE_trc_magic);
+		header.version 	= PGE_trc_version;
+		header.len_ox 	= gv->len_ox;
+		header.len_pp 	= gv->len_pp;
+		header.len_ss 	= gv->len_ss;
+		header.ur_1 	= gv->ur_1;
+		header.ur_2 	= gv->ur_2;
+		header.ur_3 	= gv->ur_3;
+		header.ur_f 	= gv->ur_f;
+		header.offset 	= sizeof(PGE_trc_header) + (gv->len_ox + gv->len_pp + gv->len_ss)*PGE_trc_name;
+		fwrite(&header, sizeof(PGE_trc_header), 1, loc_min);
+
+		for (int i = 0; i < gv->len_ox + gv->len_pp + gv->len_ss; i++){
+			memset(name, 0, PGE_trc_name);
+			if 		(i < gv->len_ox)				{ strncpy(name, gv->ox[i], 								PGE_trc_name - 1); }
+			else if (i < gv->len_ox + gv->len_pp)	{ strncpy(name, gv->PP_list[i - gv->len_ox], 				PGE_trc_name - 1); }
+			else 								{ strncpy(name, gv->SS_list[i - gv->len_ox - gv->len_pp], 	PGE_trc_name - 1); }
+			fwrite(name, 1, PGE_trc_name, loc_min);
+		}
+		fclose(loc_min);	
+	}
 }
 
+/**
+  status of the current point: 0 success, 1 under-relaxed, 2 more under-relaxed, 3 failed, 4 diverged
+*/
+int get_point_status(			global_variable 	*gv 				){
+	int result = 0;
+
+	if (gv->global_ite > gv->ur_1){ result = 1;	}
+	if (gv->global_ite > gv->ur_2){ result = 2;	}
+	if (gv->global_ite > gv->ur_3){ result = 2;	}
+	if (gv->global_ite > gv->ur_f){ result = 3;	}
+	if (gv->div == 1){ 			  result = 4;	}
+
+	return result;
+};
+
+/**
+  Append the PGE iteration history of the current point to the convergence trace (layout in dump_function.h)
+*/
+void dump_PGE_trace(			global_variable 	*gv,
+								struct bulk_info 	z_b,
+								csd_phase_set  		*cp
+){
+	FILE *loc_min;
+	char out_lm[255];
+	int rank, numprocs;
+	int n_ite = (gv->global_ite < gv->ur_f) ? gv->global_ite : gv->ur_f;
+	
+	MPI_Comm_size(MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+	if (numprocs==1){	sprintf(out_lm,	"%s__PGE_TRACE.bin"			,gv->outpath); 	}
+	else 			{	sprintf(out_lm,	"%s__PGE_TRACE.%i.bin"		,gv->outpath, rank); 	}
+
+	int 	head[6] = { gv->numPoint+1, get_point_status(gv), n_ite, gv->n_trc_ev, gv->len_cp, gv->n_phase };
+	double 	info[4] = { z_b.P, z_b.T-273.15, gv->LVL_time, gv->BR_norm };
+	double 	ite[n_ite*4 + 1];
+	int 	cp_info[gv->len_cp*4 + 1];
+	double 	cp_time[gv->len_cp + 1];
+
+	for (int i = 0; i < n_ite; i++){
+		ite[i*4 + 0] = gv->ite_time[i];
+		ite[i*4 + 1] = gv->PGE_mass_norm[i];
+		ite[i*4 + 2] = gv->PGE_total_norm[i];
+		ite[i*4 + 3] = gv->gamma_norm[i];
+	}
+	for (int i = 0; i < gv->len_cp; i++){
+		cp_info[i*4 + 0] = cp[i].id;
+		cp_info[i*4 + 1] = cp[i].n_LM;
+		cp_info[i*4 + 2] = (cp[i].ss_flags[1] == 1) ? 1 : ((cp[i].ss_flags[2] == 1) ? 2 : 3);
+		cp_info[i*4 + 3] = cp[i].split;
+		cp_time[i] 		 = cp[i].LM_time;
+	}
+
+	loc_min 	= fopen(out_lm, 	"ab"); 
+	fwrite(head, 	sizeof(int), 	6, 				loc_min);
+	fwrite(info, 	sizeof(double), 4, 				loc_min);
+	fwrite(ite, 	sizeof(double), n_ite*4, 		loc_min);
+	fwrite(gv->trc_ev, sizeof(PGE_trc_event), gv->n_trc_ev, loc_min);
+	fwrite(cp_info, sizeof(int), 	gv->len_cp*4, 	loc_min);
+	fwrite(cp_time, sizeof(double), gv->len_cp, 		loc_min);
+	fclose(loc_min);
+};
+
+/**
+  Save levelling counters of the current point (one line per point)
+*/
+void dump_levelling_stats(		global_variable 	*gv,
+								struct bulk_info 	z_b,
+								SS_ref 				*SS_ref_db
+){
+	FILE *loc_min;
+	char out_lm[255];
+	int rank, numprocs;
+	
+	MPI_Comm_size(MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+	if (numprocs==1){	sprintf(out_lm,	"%s__LEVELLING_STATS.txt"		,gv->outpath); 	}
+	else 			{	sprintf(out_lm,	"%s__LEVELLING_STATS.%i.txt"	,gv->outpath, rank); 	}
+
+	loc_min 	= fopen(out_lm, 	"a"); 
+	fprintf(loc_min, "%i %.10f %.10f %.6f %.6f %.6f %i %i %i %i",gv->numPoint+1, z_b.P, z_b.T-273.15, gv->LVL_time, gv->lvl.obj_time, gv->lvl.la_time, gv->lvl.n_inv, gv->lvl.n_eta, gv->lvl.n_degen, gv->lvl.n_bland);
+	for (int i = 0; i < 3; i++){
+		fprintf(loc_min, " %i", gv->lvl.n_price[i]);
+	}
+	for (int i = 0; i < 3; i++){
+		fprintf(loc_min, " %i", gv->lvl.n_pivot[i]);
+	}
+	for (int i = 0; i < gv->len_ss; i++){
+		fprintf(loc_min, " %s %i %i %i %i", gv->SS_list[i], SS_ref_db[i].n_pc_gen, SS_ref_db[i].n_pc_kept, SS_ref_db[i].n_pc_filt, SS_ref_db[i].n_pc_pivot);
+	}
+	fprintf(loc_min, "\n");
+	fclose(loc_min);
+};
+
 /**
   Save final result of minimization
 */
-void dump_results_function(		global_variable 	gv,
+void dump_results_function(		global_variable 	*gv,
 								struct bulk_info 	z_b,
 
 								PP_ref 				*PP_ref_db,
@@ -101,35 +243,35 @@ void dump_results_function(		global_variable 	gv,
 
 	/** ----------------------------------------------------------------------------------------------- **/
 	/** THERMOCALC LIKE FINAL OUTPUT **/
-	if (gv.verbose == 1){
+	if (gv->verbose == 1){
 		/* output active phase fraction*/
-		if (numprocs==1){	sprintf(out_lm,	"%s_thermocalc_style_output.txt"		,gv.outpath); 	}
-		else 			{	sprintf(out_lm,	"%s_thermocalc_style_output.%i.txt"		,gv.outpath, rank); 	}
+		if (numprocs==1){	sprintf(out_lm,	"%s_thermocalc_style_output.txt"		,gv->outpath); 	}
+		else 			{	sprintf(out_lm,	"%s_thermocalc_style_output.%i.txt"		,gv->outpath, rank); 	}
 
 		loc_min 	= fopen(out_lm, 	"a"); 
 		fprintf(loc_min, "============================================================\n");
 		
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if ( cp[i].ss_flags[1] == 1){
 				fprintf(loc_min, 	"%4s ", cp[i].name);
 
 			}
 		}
-		for (int i = 0; i < gv.len_pp; i++){
-			if (gv.pp_flags[i][1] == 1){
-				fprintf(loc_min, 	"%4s ", gv.PP_list[i]);
+		for (int i = 0; i < gv->len_pp; i++){
+			if (gv->pp_flags[i][1] == 1){
+				fprintf(loc_min, 	"%4s ", gv->PP_list[i]);
 			}
 		}	
 		fprintf(loc_min, " {%10.5f, %10.5f} kbar/°C\n\n",z_b.P,z_b.T-273.15);
 		
 		fprintf(loc_min, "Compositional variables (solution phase):\n");		
-		for (i = 0; i < gv.len_cp; i++){
+		for (i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[1] == 1){
 				fprintf(loc_min, 	" %5s", cp[i].name);
 				for (j = 0; j < cp[i].n_xeos; j++){
 					fprintf(loc_min, 	"%10.5f ", cp[i].xeos[j]);
 				}
-				for (int k = j; k < gv.len_ox; k++){
+				for (int k = j; k < gv->len_ox; k++){
 					fprintf(loc_min, 	"%10s ", "-");
 				}		
 				fprintf(loc_min, "\n");	
@@ -137,14 +279,14 @@ void dump_results_function(		global_variable 	gv,
 		}
 		
 		fprintf(loc_min, "\nEnd-members fraction (solution phase):\n");		
-		for (i = 0; i < gv.len_cp; i++){
+		for (i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[1] == 1){
 				
 				fprintf(loc_min, 	" %5s", "");
 				for (j = 0; j < cp[i].n_em; j++){
 					fprintf(loc_min, 	"%10s ", SS_ref_db[cp[i].id].EM_list[j]);
 				}
-				for (int k = j; k < gv.len_ox; k++){
+				for (int k = j; k < gv->len_ox; k++){
 					fprintf(loc_min, 	"%10s ", "-");
 				}		
 				fprintf(loc_min, "\n");	
@@ -153,22 +295,22 @@ void dump_results_function(		global_variable 	gv,
 				for (j = 0; j < cp[i].n_em; j++){
 					fprintf(loc_min, 	"%10.5f ", cp[i].p_em[j]);
 				}
-				for (int k = j; k < gv.len_ox; k++){
+				for (int k = j; k < gv->len_ox; k++){
 					fprintf(loc_min, 	"%10s ", "-");
 				}		
 				fprintf(loc_min, "\n");	
 			}
 		}
 		
-		if (gv.Mode == 1){
+		if (gv->Mode == 1){
 			fprintf(loc_min, "\nGibbs energy of reference G0 (solution phase):\n");		
-			for (i = 0; i < gv.len_cp; i++){
+			for (i = 0; i < gv->len_cp; i++){
 				if (cp[i].ss_flags[1] == 1){
 					fprintf(loc_min, 	" %5s", cp[i].name);
 					for (j = 0; j < cp[i].n_em; j++){
 						fprintf(loc_min, 	"%14.6f ", cp[i].gbase[j]);
 					}
-					for (int k = j; k < gv.len_ox; k++){
+					for (int k = j; k < gv->len_ox; k++){
 						fprintf(loc_min, 	"%14s ", "-");
 					}		
 					fprintf(loc_min, "\n");	
@@ -176,13 +318,13 @@ void dump_results_function(		global_variable 	gv,
 			}
 					
 			fprintf(loc_min, "\nChemical potentials [J] (solution phase):\n");		
-			for (i = 0; i < gv.len_cp; i++){
+			for (i = 0; i < gv->len_cp; i++){
 				if (cp[i].ss_flags[1] == 1){
 					fprintf(loc_min, 	" %5s", cp[i].name);
 					for (j = 0; j < cp[i].n_em; j++){
 						fprintf(loc_min, 	"%14.6f ", cp[i].mu[j]);
 					}
-					for (int k = j; k < gv.len_ox; k++){
+					for (int k = j; k < gv->len_ox; k++){
 						fprintf(loc_min, 	"%14s ", "-");
 					}		
 					fprintf(loc_min, "\n");	
@@ -191,13 +333,13 @@ void dump_results_function(		global_variable 	gv,
 		}
 
 		fprintf(loc_min, "\nSite fractions:\n");		
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[1] == 1){
 				fprintf(loc_min, 	" %5s", cp[i].name);
 				for (j = 0; j < (cp[i].n_sf); j++){
 					fprintf(loc_min, 	"%10.5f ", cp[i].sf[j]); // *-1.0 because inequality are given as -x <= 0 in NLopt
 				}
-				for (int k = j; k < gv.len_ox; k++){
+				for (int k = j; k < gv->len_ox; k++){
 					fprintf(loc_min, 	"%10s ", "-");
 				}		
 				fprintf(loc_min, "\n");	
@@ -206,18 +348,18 @@ void dump_results_function(		global_variable 	gv,
 		
 		fprintf(loc_min, "\nOxide compositions [mol%%] (normalized):\n");	
 		fprintf(loc_min, "%5s"," ");
-		for (i = 0; i < gv.len_ox; i++){
-			fprintf(loc_min, " %10s", gv.ox[i]);
+		for (i = 0; i < gv->len_ox; i++){
+			fprintf(loc_min, " %10s", gv->ox[i]);
 		}
 		fprintf(loc_min, "\n %5s","SYS");	
-		for (int i = 0; i < gv.len_ox; i++){
+		for (int i = 0; i < gv->len_ox; i++){
 			fprintf(loc_min, "%10.5f ",z_b.bulk_rock[i]);
 		}
 		fprintf(loc_min, "\n");	
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[1] == 1){
 				fprintf(loc_min, 	" %5s", cp[i].name);
-				for (int j = 0; j < gv.len_ox; j++){
+				for (int j = 0; j < gv->len_ox; j++){
 					fprintf(loc_min, "%10.5f ", cp[i].ss_comp[j]);
 				}
 				fprintf(loc_min, "\n");
@@ -229,16 +371,16 @@ void dump_results_function(		global_variable 	gv,
 		fprintf(loc_min, "Stable mineral assemblage:\n");	
 		fprintf(loc_min, "%6s%12s %12s %12s %12s %12s %12s %12s %12s\n","phase","mode","f","G" ,"V" ,"Cp","rho","Thermal_Exp","ShearModu");
 					
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[1] == 1){
 				
-				if (gv.Mode == 1){
+				if (gv->Mode == 1){
 					G = cp[i].df;
 				}
 				else{
 					G = 0.0;
-					for (int j = 0; j < gv.len_ox; j++){
-						G += cp[i].ss_comp[j]*gv.gam_tot[j];
+					for (int j = 0; j < gv->len_ox; j++){
+						G += cp[i].ss_comp[j]*gv->gam_tot[j];
 					}
 				}
 
@@ -248,10 +390,10 @@ void dump_results_function(		global_variable 	gv,
 			}
 		}
 		
-		for (int i = 0; i < gv.len_pp; i++){
-			if (gv.pp_flags[i][1] == 1){ 
-				fprintf(loc_min, "%6s", gv.PP_list[i]);
-				fprintf(loc_min, "%+12.5f %+12.5f %+12.5f %+12.5f %+12.5f %+12.5f %+12.8f %+12.2f",gv.pp_n[i],PP_ref_db[i].factor,PP_ref_db[i].gbase,PP_ref_db[i].volume,PP_ref_db[i].phase_cp,PP_ref_db[i].phase_density,PP_ref_db[i].phase_expansivity,PP_ref_db[i].phase_shearModulus);
+		for (int i = 0; i < gv->len_pp; i++){
+			if (gv->pp_flags[i][1] == 1){ 
+				fprintf(loc_min, "%6s", gv->PP_list[i]);
+				fprintf(loc_min, "%+12.5f %+12.5f %+12.5f %+12.5f %+12.5f %+12.5f %+12.8f %+12.2f",gv->pp_n[i],PP_ref_db[i].factor,PP_ref_db[i].gbase,PP_ref_db[i].volume,PP_ref_db[i].phase_cp,PP_ref_db[i].phase_density,PP_ref_db[i].phase_expansivity,PP_ref_db[i].phase_shearModulus);
 				fprintf(loc_min, "\n");
 			}
 		}
@@ -259,22 +401,29 @@ void dump_results_function(		global_variable 	gv,
 		
 			
 		G = 0.0;
-		for (int j = 0; j < gv.len_ox; j++){
-			G += z_b.bulk_rock[j]*gv.gam_tot[j];
+		for (int j = 0; j < gv->len_ox; j++){
+			G += z_b.bulk_rock[j]*gv->gam_tot[j];
 		}
 		fprintf(loc_min, "%6s %24s %+12.5f\n","SYS"," ",G);
 
 		/* output solution phase composition */ 	
 		fprintf(loc_min, "\nGamma (chemical potential of oxides):\n");
-		for (i = 0; i < gv.len_ox; i++){
-			fprintf(loc_min, "%6s %+12.5f\n", gv.ox[i], gv.gam_tot[i]);
+		for (i = 0; i < gv->len_ox; i++){
+			fprintf(loc_min, "%6s %+12.5f\n", gv->ox[i], gv->gam_tot[i]);
 		}
 		fprintf(loc_min, "\ndelta Gibbs energy (G-hyperplane distance):\n");
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[1] == 1){
 				fprintf(loc_min, 	"%5s %+10e\n", cp[i].name,cp[i].df);
 			}
 		}
+		fprintf(loc_min, "\nLocal minimizations (considered phases):\n");
+		fprintf(loc_min, "%6s %4s %6s %12s %8s %6s %8s %6s\n","phase","ON","#LM","time[ms]","#eval","#exit","saved","#hit");
+		for (int i = 0; i < gv->len_cp; i++){
+			if (cp[i].n_LM > 0){
+				fprintf(loc_min, "%6s %4d %6d %12.3f %8d %6d %8d %6d\n", cp[i].name,cp[i].ss_flags[1],cp[i].n_LM,cp[i].LM_time,cp[i].n_eval,cp[i].n_ee,cp[i].n_eval_saved,cp[i].n_hit);
+			}
+		}
 		fprintf(loc_min, "\n\n");
 		fclose(loc_min);	
 	}
@@ -283,35 +432,30 @@ void dump_results_function(		global_variable 	gv,
 	
 	/** ----------------------------------------------------------------------------------------------- **/
 	/** MATLAB GRID OUTPUT **/
-	if (gv.verbose != 2){
-		if (numprocs==1){	sprintf(out_lm,	"%s_pseudosection_output.txt"		,gv.outpath); 		}
-		else 			{	sprintf(out_lm,	"%s_pseudosection_output.%i.txt"	,gv.outpath, rank); }
-
-		int result = 0;							//result, 0 success, 1 under-relaxed, 2 more under-relaxed, 3 failed
-		if (gv.global_ite > gv.ur_1){ result = 1;	}
-		if (gv.global_ite > gv.ur_2){ result = 2;	}
-		if (gv.global_ite > gv.ur_3){ result = 2;	}
-		if (gv.global_ite > gv.ur_f){ result = 3;	}
-		if (gv.div == 1){ 			  result = 4;	}
+	if (gv->verbose != 2){
+		if (numprocs==1){	sprintf(out_lm,	"%s_pseudosection_output.txt"		,gv->outpath); 		}
+		else 			{	sprintf(out_lm,	"%s_pseudosection_output.%i.txt"	,gv->outpath, rank); }
+
+		int result = get_point_status(gv);		//result, 0 success, 1 under-relaxed, 2 more under-relaxed, 3 failed, 4 diverged
 		
 		/* get number of repeated phases for the solvi */
-		int n_solvi[gv.len_ss];
-		for (int i = 0; i < gv.len_ss; i++){
+		int n_solvi[gv->len_ss];
+		for (int i = 0; i < gv->len_ss; i++){
 			n_solvi[i] = 0;
 		}
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 			if (cp[i].ss_flags[1] == 1){
 				n_solvi[cp[i].id] += 1;
 			}
 		}
 	
 		loc_min 	= fopen(out_lm, 	"a"); 
-		fprintf(loc_min, "%i %i %.10f %.10f %.10f %.10f",gv.numPoint+1,result, z_b.P,z_b.T-273.15,gv.G_system,gv.BR_norm);
-		for (i = 0; i < gv.len_ox; i++){
-			fprintf(loc_min, 	" \t %0.10f ", gv.gam_tot[i]);
+		fprintf(loc_min, "%i %i %.10f %.10f %.10f %.10f",gv->numPoint+1,result, z_b.P,z_b.T-273.15,gv->G_system,gv->BR_norm);
+		for (i = 0; i < gv->len_ox; i++){
+			fprintf(loc_min, 	" \t %0.10f ", gv->gam_tot[i]);
 		}
 		fprintf(loc_min, "\n");
-		for (int i = 0; i < gv.len_cp; i++){ 
+		for (int i = 0; i < gv->len_cp; i++){ 
 			if (cp[i].ss_flags[1] == 1){
 				
 				
@@ -335,9 +479,9 @@ void dump_results_function(		global_variable 	gv,
 				fprintf(loc_min, "\n");
 			}
 		}	
-		for (int i = 0; i < gv.len_pp; i++){
-			if (gv.pp_flags[i][1] == 1){
-				fprintf(loc_min, 	"%s \t %.10f \t %.10f \t", gv.PP_list[i], gv.pp_n[i], PP_ref_db[i].phase_density);
+		for (int i = 0; i < gv->len_pp; i++){
+			if (gv->pp_flags[i][1] == 1){
+				fprintf(loc_min, 	"%s \t %.10f \t %.10f \t", gv->PP_list[i], gv->pp_n[i], PP_ref_db[i].phase_density);
 				fprintf(loc_min, "\n");
 			}
 		}	
@@ -349,7 +493,7 @@ void dump_results_function(		global_variable 	gv,
 /**
   Parallel file dump for phase diagrams
 */
-void mergeParallelFiles(global_variable gv){
+void mergeParallelFiles(global_variable *gv){
 
 	int i, rank, numprocs,  MAX_LINE_LENGTH=200;
 	char out_lm[255];
@@ -361,7 +505,7 @@ void mergeParallelFiles(global_variable gv){
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 	if (numprocs == 1){ return; }
 
-	sprintf(out_lm,	"%s_pseudosection_output.txt"		,gv.outpath);
+	sprintf(out_lm,	"%s_pseudosection_output.txt"		,gv->outpath);
    	FILE *fp2 = fopen(out_lm, "w"); 
 
 	fprintf(fp2, "// NUMBER\tSTATUS[S,R1,R2,F]\tP[kbar]\tT[C]\tG_sys[G]\tbr_norm[wt]\tGAMMA[G]; PHASE[name]\tMODE[wt]\tRHO[kg.m-3]\tX-EOS\n");
@@ -369,7 +513,7 @@ void mergeParallelFiles(global_variable gv){
 	// Open file to be merged 
 	for (i = 0; i < numprocs; i++){
 		// open file
-		sprintf(in_lm,	"%s_pseudosection_output.%i.txt"		,gv.outpath, i);
+		sprintf(in_lm,	"%s_pseudosection_output.%i.txt"		,gv->outpath, i);
 		FILE *fp1 = fopen(in_lm, "r"); 
 		
 		fgets(buf, MAX_LINE_LENGTH, fp1);					// skip first line = comment (we don't want to copy that)
@@ -386,7 +530,7 @@ void mergeParallelFiles(global_variable gv){
 /**
   Parallel file dump for local minima search
 */
-void mergeParallel_LocalMinima_Files(global_variable gv){
+void mergeParallel_LocalMinima_Files(global_variable *gv){
 
 	int i, rank, numprocs,  MAX_LINE_LENGTH=200;
 	char out_lm[255];
@@ -398,7 +542,7 @@ void mergeParallel_LocalMinima_Files(global_variable gv){
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 	if (numprocs == 1){ return; }
 
-	sprintf(out_lm,	"%s__LOCAL_MINIMA.txt"		,gv.outpath);
+	sprintf(out_lm,	"%s__LOCAL_MINIMA.txt"		,gv->outpath);
    	FILE *fp2 = fopen(out_lm, "w"); 
 
 	fprintf(fp2, "// PHASE_NAME[char]\tN_x-eos[n]\tN_POINTS\tGAMMA[G]\n");
@@ -408,7 +552,7 @@ void mergeParallel_LocalMinima_Files(global_variable gv){
 	// Open file to be merged 
 	for (i = 0; i < numprocs; i++){
 		// open file
-		sprintf(in_lm,	"%s__LOCAL_MINIMA.%i.txt"		,gv.outpath, i);
+		sprintf(in_lm,	"%s__LOCAL_MINIMA.%i.txt"		,gv->outpath, i);
 		FILE *fp1 = fopen(in_lm, "r"); 
 		
 		fgets(buf, MAX_LINE_LENGTH, fp1);					// skip 1th line = comment (we don't want to copy that)
@@ -429,7 +573,7 @@ void mergeParallel_LocalMinima_Files(global_variable gv){
 /**
   Parallel file dump for first stage of levelling minimization only
 */
-void mergeParallel_LevellingGamma_Files(global_variable gv){
+void mergeParallel_LevellingGamma_Files(global_variable *gv){
 
 	int i, rank, numprocs,  MAX_LINE_LENGTH=200;
 	char out_lm[255];
@@ -441,7 +585,7 @@ void mergeParallel_LevellingGamma_Files(global_variable gv){
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 	if (numprocs == 1){ return; }
 
-	sprintf(out_lm,	"%s__LEVELLING_GAMMA.txt"		,gv.outpath);
+	sprintf(out_lm,	"%s__LEVELLING_GAMMA.txt"		,gv->outpath);
    	FILE *fp2 = fopen(out_lm, "w"); 
 
 	fprintf(fp2, "// BULK-ROCK[len_ox]\tP[kbar]\tT[°C]\tGAMMA[G]\n");
@@ -449,7 +593,7 @@ void mergeParallel_LevellingGamma_Files(global_variable gv){
 	// Open file to be merged 
 	for (i = 0; i < numprocs; i++){
 		// open file
-		sprintf(in_lm,	"%s__LEVELLING_GAMMA.%i.txt"		,gv.outpath, i);
+		sprintf(in_lm,	"%s__LEVELLING_GAMMA.%i.txt"		,gv->outpath, i);
 		FILE *fp1 = fopen(in_lm, "r"); 
 		
 		fgets(buf, MAX_LINE_LENGTH, fp1);					// skip 1th line = comment (we don't want to copy that)
@@ -467,3 +611,82 @@ void mergeParallel_LevellingGamma_Files(global_variable gv){
    fclose(fp2); 
 }
 
+/**
+  Parallel file dump for levelling counters
+*/
+void mergeParallel_LevellingStats_Files(global_variable *gv){
+
+	int i, rank, numprocs,  MAX_LINE_LENGTH=400;
+	char out_lm[255];
+	char in_lm[255];
+	char c; 
+	char buf[MAX_LINE_LENGTH];
+	
+	MPI_Comm_size(MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	if (numprocs == 1 || rank != 0){ return; }
+
+	sprintf(out_lm,	"%s__LEVELLING_STATS.txt"		,gv->outpath);
+   	FILE *fp2 = fopen(out_lm, "w"); 
+
+	fprintf(fp2, "// NUMBER\tP[kbar]\tT[C]\tLVL_time[ms]\tOBJ_time[ms]\tLA_time[ms]\tN_INV\tN_ETA\tN_DEGEN\tN_BLAND\tPRICED[pp,em,pc]\tPIVOTS[pp,em,pc]; PHASE[name]\tPC_GEN\tPC_KEPT\tPC_FILT\tPC_PIVOTS\n");
+
+	// Open file to be merged 
+	for (i = 0; i < numprocs; i++){
+		// open file
+		sprintf(in_lm,	"%s__LEVELLING_STATS.%i.txt"		,gv->outpath, i);
+		FILE *fp1 = fopen(in_lm, "r"); 
+		
+		fgets(buf, MAX_LINE_LENGTH, fp1);					// skip first line = comment (we don't want to copy that)
+	
+		while ((c = fgetc(fp1)) != EOF){ 
+			fputc(c, fp2); 
+		}
+		fclose(fp1); 
+	}
+   fclose(fp2); 
+}
+
+/**
+  Parallel file dump for the PGE convergence trace: the records of the ranks are appended after the header of rank 0
+*/
+void mergeParallel_PGE_trace_Files(global_variable *gv){
+
+	int 	i, rank, numprocs;
+	char 	out_lm[255];
+	char 	in_lm[255];
+	char 	buf[4096];
+	size_t 	n;
+	PGE_trc_header header;
+	
+	MPI_Comm_size(MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	if (numprocs == 1 || rank != 0){ return; }
+
+	sprintf(out_lm,	"%s__PGE_TRACE.bin"		,gv->outpath);
+   	FILE *fp2 = fopen(out_lm, "wb"); 
+
+	for (i = 0; i < numprocs; i++){
+		sprintf(in_lm,	"%s__PGE_TRACE.%i.bin"		,gv->outpath, i);
+		FILE *fp1 = fopen(in_lm, "rb"); 
+		if (fp1 == NULL){ continue; }
+
+		if (fread(&header, sizeof(PGE_trc_header), 1, fp1) != 1){
+			fclose(fp1);
+			continue;
+		}
+		if (i == 0){
+			fwrite(&header, sizeof(PGE_trc_header), 1, fp2);
+			fseek(fp1, sizeof(PGE_trc_header), SEEK_SET);
+		}
+		else{
+			fseek(fp1, header.offset, SEEK_SET);					// skip header and names (only needed once)
+		}
+
+		while ((n = fread(buf, 1, sizeof(buf), fp1)) > 0){
+			fwrite(buf, 1, n, fp2);
+		}
+		fclose(fp1); 
+	}
+   fclose(fp2); 
+}
@@ -1,19 +1,66 @@
 #ifndef __DUMP_FUNCTION_H_
 #define __DUMP_FUNCTION_H_
 
-void dump_init(global_variable gv);
+#define PGE_trc_magic 	"MAGEMin_PGE_trc"
+#define PGE_trc_version 1
+#define PGE_trc_name 	20
 
-void dump_results_function(		global_variable 	gv,
+/**
+	Layout of the PGE convergence trace (__PGE_TRACE.bin, --PGE_trace=1):
+
+	PGE_trc_header
+	char[PGE_trc_name] x (len_ox + len_pp + len_ss)		oxide, pure phase and solution phase names
+	then one variable length record per point:
+
+	int32[6]           point, status (0 success, 1-2 under-relaxed, 3 failed, 4 diverged), n_ite, n_ev, n_cp, n_phase
+	double[4]          P[kbar], T[C], levelling time[ms], final mass residual norm
+	double[n_ite x 4]  per global iteration: duration[ms], mass norm, moving average norm, Gamma norm
+	int32[n_ev x 5]    phase-set changes (PGE_trc_event): iteration, type, phase type, phase index, cp index
+	int32[n_cp x 4]    considered phases: solution phase index, # local minimizations, final state (1 active, 2 hold, 3 removed), split
+	double[n_cp]       local minimization time of the considered phases [ms]
+*/
+typedef struct PGE_trc_headers {
+	char 	magic[16];			/** PGE_trc_magic 														*/
+	int 	version;			/** PGE_trc_version 													*/
+	int 	len_ox;				/** number of oxides 													*/
+	int 	len_pp;				/** number of pure phases 												*/
+	int 	len_ss;				/** number of solution phases 											*/
+	int 	ur_1;				/** under-relaxation thresholds of the run (global iterations) 			*/
+	int 	ur_2;
+	int 	ur_3;
+	int 	ur_f;
+	long 	offset;				/** position of the first record in the file (bytes) 					*/
+} PGE_trc_header;
+
+void dump_init(global_variable *gv);
+
+void dump_results_function(		global_variable 	*gv,
 								struct bulk_info 	z_b,
 								PP_ref 				*PP_ref_db,
 								SS_ref 				*SS_ref_db,
 								csd_phase_set  		*cp
 );
 
-void mergeParallelFiles(global_variable gv);
+void mergeParallelFiles(global_variable *gv);
+
+void mergeParallel_LocalMinima_Files(global_variable *gv);
+
+void mergeParallel_LevellingGamma_Files(global_variable *gv);
+
+void dump_levelling_stats(		global_variable 	*gv,
+								struct bulk_info 	z_b,
+								SS_ref 				*SS_ref_db
+);
+
+void mergeParallel_LevellingStats_Files(global_variable *gv);
+
+int get_point_status(			global_variable 	*gv 				);
 
-void mergeParallel_LocalMinima_Files(global_variable gv);
+void dump_PGE_trace(			global_variable 	*gv,
+								struct bulk_info 	z_b,
+								csd_phase_set  		*cp
+);
 
-void mergeParallel_LevellingGamma_Files(global_variable gv);
+void mergeParallel_PGE_trace_Files(global_variable *gv);
 
 #endif
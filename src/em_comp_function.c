@@ -0,0 +1,70 @@
+/**
+Endmember composition kernels of the PGE inner iterations
+-----------------------------------------------------------
+
+The pure phases and the endmembers of the considered phases are stored in one contiguous column-major composition
+matrix (one column per oxide, one row per endmember). Projecting them on the G-hyperplane is then a sequence of
+len_ox axpy over contiguous columns, vectorized across the endmembers by the compiler, and their Boltzmann factors
+one loop over a contiguous vector (vectorized when a vector math library is available).
+
+Every entry accumulates its terms in the order of the former per-phase loops, the results are unchanged.
+*/
+
+#include <math.h>
+
+#include "em_comp_function.h"
+
+/**
+  g = g - C*gam, C being a column-major m x n matrix of leading dimension ld (rotation of the reference G with
+  respect to the G-hyperplane)
+*/
+void em_project(				double 				*g,
+								double 				*C,
+								int 				 ld,
+								double 				*gam,
+								int 				 m,
+								int 				 n 				){
+	double 	 gj;
+	double 	*Cj;
+	for (int j = 0; j < n; j++){
+		gj = gam[j];
+		Cj = C + j*ld;
+		for (int i = 0; i < m; i++){
+			g[i] -= Cj[i]*gj;
+		}
+	}
+};
+
+/**
+  x = exp(-g/RT) over m contiguous entries
+*/
+void em_exp(					double 				*x,
+								double 				*g,
+								double 				 RT,
+								int 				 m 				){
+	for (int i = 0; i < m; i++){
+		x[i] = exp(-g[i]/RT);
+	}
+};
+
+/**
+  comp = C'*w, C being a column-major m x n matrix of leading dimension ld (composition of a phase from its
+  endmember fractions)
+*/
+void em_mix(					double 				*comp,
+								double 				*C,
+								int 				 ld,
+								double 				*w,
+								int 				 m,
+								int 				 n 				){
+	double 	 cj;
+	double 	*Cj;
+	for (int j = 0; j < n; j++){
+		cj = 0.0;
+		Cj = C + j*ld;
+		for (int i = 0; i < m; i++){
+			cj += Cj[i]*w[i];
+		}
+		comp[j] = cj;
+	}
+};
@@ -0,0 +1,30 @@
+#ifndef __EM_COMP_FUNCTION_H_
+#define __EM_COMP_FUNCTION_H_
+
+/**
+	Kernels working on the flattened endmember composition matrix (gv.em_C, column-major [n_em_rows x len_ox] of leading
+	dimension gv.em_ld):
+	rows 0..len_pp-1 hold the pure phases, the next rows the endmembers of the considered phases (cp[i].em_row).
+	They have no dependency on the MAGEMin structures, such that they can be benchmarked alone (make bench_em).
+*/
+
+void em_project(				double 				*g,
+								double 				*C,
+								int 				 ld,
+								double 				*gam,
+								int 				 m,
+								int 				 n 				);
+
+void em_exp(					double 				*x,
+								double 				*g,
+								double 				 RT,
+								int 				 m 				);
+
+void em_mix(					double 				*comp,
+								double 				*C,
+								int 				 ld,
+								double 				*w,
+								int 				 m,
+								int 				 n 				);
+
+#endif
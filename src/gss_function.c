@@ -2026,23 +2026,23 @@ SS_ref G_SS_spn_function(SS_ref SS_ref_spn_db, int EM_database, double *bulk_roc
 /**
   checks if it can satisfy the mass constraint
 */
-SS_ref G_SS_EM_function(		global_variable 	 gv,
+SS_ref G_SS_EM_function(		global_variable 	*gv,
 								SS_ref 				 SS_ref_db, 
 								int 				 EM_database, 
 								struct 	bulk_info 	 z_b, 
 								char   				*name				){
 									  
-	double eps 		   	= gv.bnd_val;
+	double eps 		   	= gv->bnd_val;
 	double P 			= z_b.P;
 	double T 			= z_b.T;	
 					   
 	SS_ref_db.ss_flags[0]  = 1;
 
 	/* Associate the right solid-solution data */
-	for (int FD = 0; FD < gv.n_Diff; FD++){				/* cycle twice in order to get gb_P_eps to calculate densities later on */
+	for (int FD = 0; FD < gv->n_Diff; FD++){				/* cycle twice in order to get gb_P_eps to calculate densities later on */
 		
-		P = z_b.P + gv.gb_P_eps*gv.numDiff[0][FD];
-		T = z_b.T + gv.gb_T_eps*gv.numDiff[1][FD];
+		P = z_b.P + gv->gb_P_eps*gv->numDiff[0][FD];
+		T = z_b.T + gv->gb_T_eps*gv->numDiff[1][FD];
 
 		if (strcmp( name, "bi") == 0 ){
 			// if no H2O, deactivate
@@ -2119,7 +2119,7 @@ SS_ref G_SS_EM_function(		global_variable 	 gv,
 
 	/* Calculate the number of atoms in the bulk-rock composition */
 	double fbc     = 0.0;
-	for (int i = 0; i < gv.len_ox; i++){
+	for (int i = 0; i < gv->len_ox; i++){
 		fbc += z_b.bulk_rock[i]*z_b.apo[i];
 	}
 
@@ -2133,12 +2133,12 @@ SS_ref G_SS_EM_function(		global_variable 	 gv,
 	
 	SS_ref_db.fbc = z_b.fbc;	
 	
-	if (gv.verbose == 1){
+	if (gv->verbose == 1){
 		printf(" %4s:",name);
 		for (int j = 0; j < SS_ref_db.n_em; j++){
 			printf(" %+12.5f",SS_ref_db.gbase[j]);
 		}
-		for (int j = SS_ref_db.n_em; j < gv.len_ox; j++){
+		for (int j = SS_ref_db.n_em; j < gv->len_ox; j++){
 			printf("%13s","-");
 		}
 		printf("\n");
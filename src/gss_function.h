@@ -1,7 +1,7 @@
 #ifndef __GSS_FUNCTION_H_
 #define __GSS_FUNCTION_H_
 
-SS_ref G_SS_EM_function(	global_variable gv, 
+SS_ref G_SS_EM_function(	global_variable *gv, 
 							SS_ref SS_ref_db,
 							int EM_database,
 							struct bulk_info z_b,
@@ -43,16 +43,19 @@ Declare flags needed for leveling and pge algorithms
 
 #include "MAGEMin.h"
 #include "gss_init_function.h"
+#include "objective_functions.h"
+#include "NLopt_opt_function.h"
+#include "SQP_opt_function.h"
 
 /** 
   allocate memory to store considered phases
 */
-csd_phase_set CP_INIT_function(csd_phase_set cp, global_variable gv){
+csd_phase_set CP_INIT_function(csd_phase_set cp, global_variable *gv){
 	
-	int n 			= gv.len_ox + 1;
+	int n 			= gv->len_ox + 1;
 	
 	/* initialize fractions flags and cycle arrays with zeros */
-	cp.ss_flags 	= malloc (gv.n_flags  * sizeof(int));
+	cp.ss_flags 	= malloc (gv->n_flags  * sizeof(int));
 	
 	cp.name   		= malloc (20 * sizeof (char)		);
 	cp.p_em   		= malloc (n  * sizeof (double) 		);
@@ -67,15 +70,16 @@ csd_phase_set CP_INIT_function(csd_phase_set cp, global_variable gv){
 	cp.gbase    	= malloc (n  * sizeof (double) 		);
 	cp.mu0    		= malloc (n  * sizeof (double) 		);
 	cp.ss_comp		= malloc (n  * sizeof (double) 		);
+	cp.comp_nz		= malloc ((n*gv->len_ox) * sizeof (double) );
 	cp.sf			= malloc ((n*2)  * sizeof (double) 	);
 	
 	cp.phase_density  		= 0.0;
 	cp.phase_cp				= 0.0;
 	cp.phase_expansivity	= 0.0;
 	
-	cp.dpdx 		= malloc ((gv.len_ox+1) * sizeof (double*) 		); 
-	for (int i = 0; i < (gv.len_ox+1); i++){
-		cp.dpdx[i] 	= malloc ((gv.len_ox) * sizeof (double) 		);
+	cp.dpdx 		= malloc ((gv->len_ox+1) * sizeof (double*) 		); 
+	for (int i = 0; i < (gv->len_ox+1); i++){
+		cp.dpdx[i] 	= malloc ((gv->len_ox) * sizeof (double) 		);
 	}
 	
 	return cp;
@@ -84,7 +88,7 @@ csd_phase_set CP_INIT_function(csd_phase_set cp, global_variable gv){
 /** 
   allocate memory for biotite
 */
-SS_ref G_SS_bi_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){		
+SS_ref G_SS_bi_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){		
 	SS_ref SS_ref_bi_db;
 	
 	SS_ref_bi_db.is_liq    = 0;	
@@ -101,7 +105,7 @@ SS_ref G_SS_bi_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for clinopyroxene
 */
-SS_ref G_SS_cpx_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_cpx_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_cpx_db;
 	
 	SS_ref_cpx_db.is_liq    = 0;	
@@ -119,7 +123,7 @@ SS_ref G_SS_cpx_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for cordierite
 */
-SS_ref G_SS_cd_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_cd_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_cd_db;
 	
 	SS_ref_cd_db.is_liq    = 0;		
@@ -136,7 +140,7 @@ SS_ref G_SS_cd_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for epidote
 */
-SS_ref G_SS_ep_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_ep_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_ep_db;
 	
 	SS_ref_ep_db.is_liq     = 0;	
@@ -154,7 +158,7 @@ SS_ref G_SS_ep_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for fluid
 */
-SS_ref G_SS_fl_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_fl_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_fl_db;
 	
 	SS_ref_fl_db.is_liq     = 0;	
@@ -171,7 +175,7 @@ SS_ref G_SS_fl_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for garnet
 */
-SS_ref G_SS_g_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_g_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_g_db;
 	
 	SS_ref_g_db.is_liq      = 0;	
@@ -189,7 +193,7 @@ SS_ref G_SS_g_init_function(SS_ref SS_ref_db, int EM_database, global_variable g
 /** 
   allocate memory for hornblende
 */
-SS_ref G_SS_hb_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_hb_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_hb_db;
 	
 	SS_ref_hb_db.is_liq     = 0;	
@@ -208,7 +212,7 @@ SS_ref G_SS_hb_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for ilmenite
 */
-SS_ref G_SS_ilm_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_ilm_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_ilm_db;
 	
 	SS_ref_ilm_db.is_liq    = 0;	
@@ -226,7 +230,7 @@ SS_ref G_SS_ilm_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for liquid (melt)
 */
-SS_ref G_SS_liq_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_liq_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_liq_db;
 
 	SS_ref_liq_db.is_liq     = 1;	
@@ -244,7 +248,7 @@ SS_ref G_SS_liq_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for muscovite
 */
-SS_ref G_SS_mu_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){		
+SS_ref G_SS_mu_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){		
 	SS_ref SS_ref_mu_db;
 	
 	SS_ref_mu_db.is_liq     = 0;	
@@ -263,7 +267,7 @@ SS_ref G_SS_mu_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for olivine
 */
-SS_ref G_SS_ol_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){		
+SS_ref G_SS_ol_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){		
 	SS_ref SS_ref_ol_db;
 	
 	SS_ref_ol_db.is_liq     = 0;	
@@ -281,7 +285,7 @@ SS_ref G_SS_ol_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for orthopyroxene
 */
-SS_ref G_SS_opx_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){		
+SS_ref G_SS_opx_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){		
 	SS_ref SS_ref_opx_db;
 	
 	SS_ref_opx_db.is_liq    = 0;	
@@ -300,7 +304,7 @@ SS_ref G_SS_opx_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /** 
   allocate memory for plagioclase
 */
-SS_ref G_SS_pl4T_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){
+SS_ref G_SS_pl4T_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){
 	SS_ref SS_ref_pl4T_db;
 	
 	SS_ref_pl4T_db.is_liq     = 0;
@@ -318,7 +322,7 @@ SS_ref G_SS_pl4T_init_function(SS_ref SS_ref_db, int EM_database, global_variabl
 /** 
   allocate memory for spn
 */
-SS_ref G_SS_spn_init_function(SS_ref SS_ref_db, int EM_database, global_variable gv){		
+SS_ref G_SS_spn_init_function(SS_ref SS_ref_db, int EM_database, global_variable *gv){		
 	SS_ref SS_ref_spn_db;
 	
 	SS_ref_spn_db.is_liq    = 0;
@@ -335,7 +339,7 @@ SS_ref G_SS_spn_init_function(SS_ref SS_ref_db, int EM_database, global_variable
 /**
   attributes the right solution phase to the solution phase array
 */
-SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, global_variable gv){
+SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, global_variable *gv){
 								  
 	/** if (EM_database == _tc_ds633_) { **/	
 	//"bi","cd","cpx","ep","fl","g","hb","ilm","liq","mu","ol","opx","pl4T","spn"	
@@ -393,15 +397,13 @@ SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, glob
 	}
 	
 	/* initialize fractions flags and cycle arrays with zeros */
-	SS_ref_db.ss_flags   = malloc (gv.n_flags  * sizeof(int));
-	for (int j = 0; j < gv.n_flags; j++){	
+	SS_ref_db.ss_flags   = malloc (gv->n_flags  * sizeof(int));
+	for (int j = 0; j < gv->n_flags; j++){	
 		SS_ref_db.ss_flags[j]   = 0;
 	}
 	SS_ref_db.ss_n = 0.0;
 
-	for (int i = 0; i < gv.len_ox; i++){
-		SS_ref_db.solvus_id = malloc (gv.len_ox * sizeof (int)  	);
-	}
+	SS_ref_db.solvus_id = malloc (gv->len_ox * sizeof (int)  	);
 
 	/* dynamic memory allocation of data to send to NLopt */
 	SS_ref_db.box_bounds 	= malloc (n_xeos * sizeof (double*)  ); 
@@ -414,7 +416,7 @@ SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, glob
 	SS_ref_db.Comp 			= malloc (n_em 			* sizeof (double*)); 
 	for (int i = 0; i < n_em; i++){
 		SS_ref_db.eye[i] 	= malloc (n_em	 		* sizeof (double) );
-		SS_ref_db.Comp[i] 	= malloc (gv.len_ox 	* sizeof (double) );
+		SS_ref_db.Comp[i] 	= malloc (gv->len_ox 	* sizeof (double) );
 		SS_ref_db.dp_dx[i] 	= malloc (n_xeos 		* sizeof (double) );
 	}
 	
@@ -432,13 +434,13 @@ SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, glob
 	SS_ref_db.dsf      		= malloc ((n_sf*n_xeos) * sizeof (double) ); 
 	SS_ref_db.mu      		= malloc (n_em       	* sizeof (double) ); 
 	SS_ref_db.dfx    		= malloc (n_xeos     	* sizeof (double) ); 
-	SS_ref_db.ss_comp		= malloc (gv.len_ox  	* sizeof (double) ); 
+	SS_ref_db.ss_comp		= malloc (gv->len_ox  	* sizeof (double) ); 
 	SS_ref_db.xi_em   		= malloc (n_em   	 	* sizeof (double) ); 
 	SS_ref_db.xeos    		= malloc (n_xeos     	* sizeof (double) ); 	
 
 	/* memory allocation to store all gbase */
-	SS_ref_db.mu_array = malloc ((gv.n_Diff) * sizeof (double*) ); 
-	for (int i = 0; i < (gv.n_Diff); i++){
+	SS_ref_db.mu_array = malloc ((gv->n_Diff) * sizeof (double*) ); 
+	for (int i = 0; i < (gv->n_Diff); i++){
 		SS_ref_db.mu_array[i] = malloc (n_em * sizeof (double) );
 	}	
 	
@@ -453,9 +455,14 @@ SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, glob
 	SS_ref_db.lb   		= malloc ((n_xeos) * sizeof (double) ); 
 	SS_ref_db.tol_sf   	= malloc ((n_sf) * sizeof (double) ); 
 	for (int j = 0; j < n_sf; j++){
-		SS_ref_db.tol_sf[j] = gv.ineq_res;
+		SS_ref_db.tol_sf[j] = gv->ineq_res;
 	}
 
+	/* workspace of the in-house local minimizer (--LM_solver) */
+	SS_ref_db.sqp_ws 	= malloc ((SQP_ws_size(n_xeos, n_sf))  * sizeof (double) ); 
+	SS_ref_db.sqp_iw 	= malloc ((SQP_iws_size(n_xeos, n_sf)) * sizeof (int) 	  ); 
+	SS_ref_db.hess_ws 	= malloc ((SS_hess_ws_size(n_em, n_xeos)) * sizeof (double) ); 
+
 	for (int j = 0; j < n_xeos; j++){
 		SS_ref_db.dguess[j]  = 0.0;
 		SS_ref_db.iguess[j]  = 0.0;
@@ -466,13 +473,28 @@ SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, glob
 	*/
 	SS_ref_db.tot_pc 	= 0;
 	SS_ref_db.id_pc  	= 0;
-	SS_ref_db.n_pc   	= gv.n_pc;								/** maximum number of pseudocompounds to store */
+	SS_ref_db.n_pc   	= gv->n_pc;								/** maximum number of pseudocompounds to store */
+
+	/* the storage also holds the whole grid of the phase, and the denser grid of the retry ladder when it is mapped */
+	for (int i = 0; i < gv->len_ss; i++){
+		if (strcmp(gv->SS_list[i], name) == 0){
+			if (gv->n_SS_PC[i] > SS_ref_db.n_pc){
+				SS_ref_db.n_pc = gv->n_SS_PC[i];
+			}
+			if (gv->rt_PC_grid_map != NULL && gv->rt_n_SS_PC[i] > SS_ref_db.n_pc){
+				SS_ref_db.n_pc = gv->rt_n_SS_PC[i];
+			}
+		}
+	}
 	
 	SS_ref_db.G_pc   	= malloc ((SS_ref_db.n_pc) * sizeof (double) ); 
 	SS_ref_db.DF_pc 	= malloc ((SS_ref_db.n_pc) * sizeof (double) ); 
 	SS_ref_db.factor_pc = malloc ((SS_ref_db.n_pc) * sizeof (double) ); 
 	SS_ref_db.n_swap 	= malloc ((SS_ref_db.n_pc) * sizeof (int) 	 ); 
 	SS_ref_db.info  	= malloc ((SS_ref_db.n_pc) * sizeof (int) 	 ); 
+	SS_ref_db.kd_idx  	= malloc ((SS_ref_db.n_pc) * sizeof (int) 	 ); 
+	SS_ref_db.kd_nb  	= malloc ((SS_ref_db.n_pc) * sizeof (int) 	 ); 
+	SS_ref_db.kd_n  	= 0;
 	SS_ref_db.p_pc 		= malloc ((SS_ref_db.n_pc) * sizeof (double*)); 
 	SS_ref_db.mu_pc 	= malloc ((SS_ref_db.n_pc) * sizeof (double*)); 
 	
@@ -482,7 +504,7 @@ SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, glob
 	}
 	SS_ref_db.comp_pc = malloc ((SS_ref_db.n_pc) * sizeof (double*) ); 
 	for (int i = 0; i < (SS_ref_db.n_pc); i++){
-		SS_ref_db.comp_pc[i] = malloc (gv.len_ox * sizeof (double) 	);
+		SS_ref_db.comp_pc[i] = malloc (gv->len_ox * sizeof (double) 	);
 	}
 	SS_ref_db.xeos_pc = malloc ((SS_ref_db.n_pc) * sizeof (double*) ); 
 	for (int i = 0; i < (SS_ref_db.n_pc); i++){
@@ -494,7 +516,7 @@ SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, glob
 		SS_ref_db.info[i]   	= 0;
 		SS_ref_db.G_pc[i]   	= 0.0;
 		SS_ref_db.DF_pc[i]  	= 0.0;
-		for (int j = 0; j < gv.len_ox; j++){
+		for (int j = 0; j < gv->len_ox; j++){
 			SS_ref_db.comp_pc[i][j]  = 0.0;	
 		}
 		for (int j = 0; j < n_em; j++){
@@ -527,6 +549,11 @@ SS_ref G_SS_INIT_EM_function(SS_ref SS_ref_db, int EM_database, char *name, glob
 		SS_ref_db.ub_pc[j] = 1.0;
 	}
 	SS_ref_db.forced_stop = 0; 
+	SS_ref_db.LM_ee       = 0;
+	SS_ref_db.LM_ee_exit  = 0;
+	SS_ref_db.cache       = NULL;
+	SS_ref_db.LM_key      = NULL;
+	SS_ref_db.n_eval      = 0;
 	SS_ref_db.min_mode    = 1;
 	SS_ref_db.nlopt_verb  = 0; // no output by default
 
@@ -13,7 +13,7 @@
   read in input data from file 
 */
 void read_in_data(
-	global_variable gv,
+	global_variable *gv,
 	io_data *input_data,												/** input data structure */
 	char    *file_name,
 	int      n_points
@@ -28,8 +28,8 @@ void read_in_data(
 			/* if this is the first line belonging to a PT point to take into account */
 			if (l == 0){
 				/* first allocate memory to fill gamma array */
-				input_data[k].in_gam      = malloc (gv.len_ox * sizeof (double) ); 
-				for (int z = 0; z < gv.len_ox; z++){
+				input_data[k].in_gam      = malloc (gv->len_ox * sizeof (double) ); 
+				for (int z = 0; z < gv->len_ox; z++){
 					input_data[k].in_gam[z] = 0.0; 
 				}
 
@@ -59,12 +59,12 @@ void read_in_data(
 				//input_data[k].sum_phase_xeos = malloc(input_data[k].n_phase * sizeof(double));
 				input_data[k].phase_xeos 	 = malloc(input_data[k].n_phase * sizeof(double*));
 				for (int i = 0; i < input_data[k].n_phase; i++){
-					input_data[k].phase_xeos[i] = malloc((gv.len_ox) * sizeof(double));
+					input_data[k].phase_xeos[i] = malloc((gv->len_ox) * sizeof(double));
 				}
 				/* initialize x-eos to zeros in case there is mistake in the input file */
 				for (int i = 0; i < input_data[k].n_phase; i++){
-					for (int j = 0; j < (gv.len_ox); j++){
-						input_data[k].phase_xeos[i][j] = gv.bnd_val;
+					for (int j = 0; j < (gv->len_ox); j++){
+						input_data[k].phase_xeos[i][j] = gv->bnd_val;
 					}
 				}
 				
@@ -72,11 +72,11 @@ void read_in_data(
 				//input_data[k].sum_phase_emp = malloc(input_data[k].n_phase * sizeof(double));
 				input_data[k].phase_emp 	= malloc(input_data[k].n_phase * sizeof(double*));
 				for (int i = 0; i < input_data[k].n_phase; i++){
-					input_data[k].phase_emp[i] = malloc((gv.len_ox+1) * sizeof(double));
+					input_data[k].phase_emp[i] = malloc((gv->len_ox+1) * sizeof(double));
 				}
 				/* initialize x-eos to zeros in case there is mistake in the input file */
 				for (int i = 0; i < input_data[k].n_phase; i++){
-					for (int j = 0; j < (gv.len_ox+1); j++){
+					for (int j = 0; j < (gv->len_ox+1); j++){
 						input_data[k].phase_emp[i][j] = 0.0;
 					}
 				}
@@ -125,7 +125,7 @@ void read_in_data(
 /* 
 	This initializes the output structure
 */
-out_data InitializeOutput(		global_variable gv,
+out_data InitializeOutput(		global_variable *gv,
 								Databases 		DB)
 {
 	int 		max_num_EM, i, j;
@@ -133,7 +133,7 @@ out_data InitializeOutput(		global_variable gv,
 
 	max_num_EM 			=	15;
 	output.max_num_EM 	= max_num_EM;
-	output.Gamma 		= 	malloc ((gv.len_ox) * sizeof (double) ); 
+	output.Gamma 		= 	malloc ((gv->len_ox) * sizeof (double) ); 
 	
 	// Determine number of stable SS & PP and allocate structures
 	int num_ss, num_pp, num_tot;
@@ -141,13 +141,13 @@ out_data InitializeOutput(		global_variable gv,
 	num_ss	= 0; 
 	num_pp	= 0;
 	
-	for (int i = 0; i < gv.len_cp; i++){ 
+	for (int i = 0; i < gv->len_cp; i++){ 
 		if (DB.cp[i].ss_flags[1] == 1){
 			num_ss += 1;
 		}
 	}
-	for (int i = 0; i < gv.len_pp; i++){
-		if (gv.pp_flags[i][1] == 1){
+	for (int i = 0; i < gv->len_pp; i++){
+		if (gv->pp_flags[i][1] == 1){
 			num_pp += 1;
 		}
 	}		
@@ -218,7 +218,7 @@ void FreeOutput(out_data output)
  * 
  * NOTE: we likely need a cleanup struct for this as well, as we do malloc and julia will likely not release 
 **/
-void AddResults_output_struct(		global_variable 	gv,
+void AddResults_output_struct(		global_variable 	*gv,
 									struct bulk_info 	z_b,
 									Databases 			DB, 
 									out_data 			output		)
@@ -226,31 +226,32 @@ void AddResults_output_struct(		global_variable 	gv,
 	int i,j,num;
 
 	int status = 0;							//status, 0 success, 1 under-relaxed, 2 more under-relaxed, 3 failed
-	if (gv.global_ite > gv.ur_1){ status = 1;	}
-	if (gv.global_ite > gv.ur_2){ status = 2;	}
-	if (gv.global_ite > gv.ur_3){ status = 2;	}
-	if (gv.global_ite > gv.ur_f){ status = 3;	}
-	if (gv.div == 1){ 			  status = 4;	}
+	if (gv->global_ite > gv->ur_1){ status = 1;	}
+	if (gv->global_ite > gv->ur_2){ status = 2;	}
+	if (gv->global_ite > gv->ur_3){ status = 2;	}
+	if (gv->global_ite > gv->ur_f){ status = 3;	}
+	if (gv->div == 1){ 			  status = 4;	}
 
 	printf("\n ********* Outputting data: P=%f \n",z_b.P);
 	output.status 	= 	status;
-	output.number   = 	gv.numPoint+1;
+	output.retry 	= 	gv->rt_rung;
+	output.number   = 	gv->numPoint+1;
 	output.P 		= 	z_b.P;
 	output.T 		= 	z_b.T-273.15;
-	output.G_system =	gv.G_system;
-	output.BR_norm  =	gv.BR_norm;
+	output.G_system =	gv->G_system;
+	output.BR_norm  =	gv->BR_norm;
 
 	// Gamma
-	for (i = 0; i < gv.len_ox; i++){
-		output.Gamma[i] = gv.gam_tot[i];
+	for (i = 0; i < gv->len_ox; i++){
+		output.Gamma[i] = gv->gam_tot[i];
 	}
 
 	// Copy the names & fractions of solid solutions
 	num = 0; 
-	for (int i = 0; i < gv.len_cp; i++){ 
+	for (int i = 0; i < gv->len_cp; i++){ 
 		if (DB.cp[i].ss_flags[1] == 1){
 	
-		//	strcpy(output.StableSolutions[num],gv.SS_list[i]);
+		//	strcpy(output.StableSolutions[num],gv->SS_list[i]);
 			output.StableFractions[num] = 	DB.cp[i].ss_n;
 			output.Phasedensity[num] 	=	DB.cp[i].phase_density;
 			output.n_em[num]			=	DB.cp[i].n_em;
@@ -260,10 +261,10 @@ void AddResults_output_struct(		global_variable 	gv,
 	}
 
 	// Copy the names & fractions of pure phases (if present)
-	for (int i = 0; i < gv.len_pp; i++){
-		if (gv.pp_flags[i][1] == 1){
-			strcpy(output.StableSolutions[num],gv.PP_list[i]);
-			output.StableFractions[num] = 	gv.pp_n[i];
+	for (int i = 0; i < gv->len_pp; i++){
+		if (gv->pp_flags[i][1] == 1){
+			strcpy(output.StableSolutions[num],gv->PP_list[i]);
+			output.StableFractions[num] = 	gv->pp_n[i];
 			output.Phasedensity[num] 	=	DB.PP_ref_db[i].phase_density;
 
 			num += 1;
@@ -274,7 +275,7 @@ void AddResults_output_struct(		global_variable 	gv,
 	
 	// Add xEOS and p_EM info to the output struct
 	num = 0;
-	for (int i = 0; i < gv.len_cp; i++){ 
+	for (int i = 0; i < gv->len_cp; i++){ 
 		if (DB.cp[i].ss_flags[1] == 1){
 			for (int j = 0; j < (output.n_em[num]-1); j++){
 	//			output.xEOS[j][num] = DB.SS_ref_db[i].xeos[j];
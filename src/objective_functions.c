@@ -1975,6 +1975,1070 @@ double obj_spn(unsigned n, const double *x, double *grad, void *SS_ref_db) {
 	return d->df;
 };
 
+/**
+  size of the Hessian workspace (hess_ws) of a solution phase with n_em endmembers and n_xeos x-eos
+*/
+int SS_hess_ws_size(	int 	n_em,
+						int 	n_xeos		){
+	return n_em*n_xeos*n_xeos + 2*n_em*n_xeos + n_em + 3*n_xeos;
+};
+
+/**
+  Hessian of the objective function of a solution phase, the derivative of the gradient of the obj_* functions
+
+	dfx[k] = factor * sum_j (mu_j - ape_j/sum_apep*df_raw) * dp_dx[j][k]
+
+  at the x-eos of the last call of the objective function with gradient (p, sf, mu, mat_phi, dp_dx, df_raw, factor).
+  The hess_* functions of the phases fill
+	- dsf, the jacobian of the site fractions, dsf[s*n_xeos + k]
+	- the first part of hess_ws with the second derivatives of the endmember fractions, d2p[(j*n_xeos + k)*n_xeos + l]
+
+  nu is the n_em x n_sf matrix of the exponents of the site fractions in the ideal activities, such that the ideal part of
+  mu_j is R*T*sum_s nu_js log(sf_s). The excess term follows the symmetric formalism (asym = 0, phi = p) or the
+  asymmetric van Laar formalism (asym = 1, phi = p*v/sum_v and W_jk scaled by 2v_i/(v_j+v_k)).
+  hess is n_xeos x n_xeos (row-major)
+*/
+void SS_hessian(		SS_ref 			*d,
+						const double 	*nu,
+						int 			 asym,
+						double 			*hess 		){
+
+	int 	 n_em 	= d->n_em;
+	int 	 nx 	= d->n_xeos;
+	int 	 n_sf 	= d->n_sf;
+	double 	 RT 	= d->R*d->T;
+	double 	 A 		= d->sum_apep;
+	double 	*phi 	= (asym == 1) ? d->mat_phi : d->p;
+	double **dp_dx 	= d->dp_dx;
+
+	/* workspace layout */
+	double 	*d2p 	= d->hess_ws;
+	double 	*dmu 	= d2p 	+ n_em*nx*nx;			/** derivative of the chemical potentials, dmu[j*nx + l] 	*/
+	double 	*dphi 	= dmu 	+ n_em*nx;				/** derivative of the mixing fractions, dphi[m*nx + l] 		*/
+	double 	*dGdphi = dphi 	+ n_em*nx;				/** derivative of mu_Gex_j as function of phi 				*/
+	double 	*a 		= dGdphi + n_em;				/** sum_j ape_j dp_dx[j][k] 								*/
+	double 	*g 		= a 	+ nx;					/** sum_j mu_j dp_dx[j][k] 									*/
+	double 	*dG 	= g 	+ nx;					/** derivative of df_raw 									*/
+	double 	 vdp, w, h_raw, a2;
+	int 	 it;
+
+	for (int l = 0; l < nx; l++){
+		vdp = 0.0;
+		if (asym == 1){
+			for (int m = 0; m < n_em; m++){
+				vdp += d->v[m]*dp_dx[m][l];
+			}
+		}
+		for (int m = 0; m < n_em; m++){
+			dphi[m*nx + l] = (asym == 1) ? (d->v[m]*dp_dx[m][l] - phi[m]*vdp)/d->sum_v : dp_dx[m][l];
+		}
+	}
+
+	for (int j = 0; j < n_em; j++){
+		/* ideal mixing */
+		for (int l = 0; l < nx; l++){
+			dmu[j*nx + l] = 0.0;
+			for (int s = 0; s < n_sf; s++){
+				if (nu[j*n_sf + s] != 0.0){
+					dmu[j*nx + l] += RT*nu[j*n_sf + s]*d->dsf[s*nx + l]/d->sf[s];
+				}
+			}
+		}
+
+		/* excess */
+		for (int m = 0; m < n_em; m++){
+			dGdphi[m] = 0.0;
+		}
+		it = 0;
+		for (int jj = 0; jj < nx; jj++){
+			for (int kk = jj+1; kk < n_em; kk++){
+				w 			 = (asym == 1) ? d->W[it]*2.0*d->v[j]/(d->v[jj]+d->v[kk]) : d->W[it];
+				dGdphi[jj] 	+= w*(d->eye[j][kk] - phi[kk]);
+				dGdphi[kk] 	+= w*(d->eye[j][jj] - phi[jj]);
+				it 			+= 1;
+			}
+		}
+		for (int l = 0; l < nx; l++){
+			for (int m = 0; m < n_em; m++){
+				dmu[j*nx + l] += dGdphi[m]*dphi[m*nx + l];
+			}
+		}
+	}
+
+	for (int k = 0; k < nx; k++){
+		a[k] 	= 0.0;
+		g[k] 	= 0.0;
+		dG[k] 	= 0.0;
+		for (int j = 0; j < n_em; j++){
+			a[k] 	+= d->ape[j]*dp_dx[j][k];
+			g[k] 	+= d->mu[j]*dp_dx[j][k];
+			dG[k] 	+= d->mu[j]*dp_dx[j][k] + d->p[j]*dmu[j*nx + k];
+		}
+	}
+
+	for (int k = 0; k < nx; k++){
+		for (int l = 0; l < nx; l++){
+			h_raw 	= 0.0;
+			a2 		= 0.0;
+			for (int j = 0; j < n_em; j++){
+				h_raw 	+= dmu[j*nx + l]*dp_dx[j][k] + d->mu[j]*d2p[(j*nx + k)*nx + l];
+				a2 		+= d->ape[j]*d2p[(j*nx + k)*nx + l];
+			}
+			hess[k*nx + l] 	= d->factor*(h_raw - a2*d->df_raw/A - a[k]*dG[l]/A + a[k]*a[l]*d->df_raw/(A*A))
+							- d->factor*a[l]/A*(g[k] - a[k]*d->df_raw/A);
+		}
+	}
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (biotite)
+*/
+static const double nu_bi[6*10] = {
+	1.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0, 1.0, 1.0, 2.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 2.0, 1.0, 1.0, 2.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 2.0, 0.0, 1.0, 1.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 1.0, 2.0, 0.0, 0.0, 2.0, 2.0,
+	0.0, 0.0, 0.0, 3.0, 0.0, 2.0, 0.0, 1.0, 1.0, 0.0,
+	0.0, 0.0, 1.0, 0.0, 0.0, 2.0, 0.0, 0.0, 2.0, 2.0
+};
+
+/** 
+  Hessian of the objective function (biotite), see SS_hessian
+*/
+void hess_bi(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= x[1] + x[2] + x[3] - 1.0;
+	dsf[0*nx + 1] 		= x[0] - 1.0;
+	dsf[0*nx + 2] 		= x[0] - 1.0;
+	dsf[0*nx + 3] 		= x[0] - 1.0;
+	dsf[0*nx + 4] 		= -2.0/3.0;
+	dsf[1*nx + 0] 		= -x[1] - x[2] - x[3] + 1.0;
+	dsf[1*nx + 1] 		= -x[0];
+	dsf[1*nx + 2] 		= -x[0];
+	dsf[1*nx + 3] 		= -x[0];
+	dsf[1*nx + 4] 		= 2.0/3.0;
+	dsf[2*nx + 2] 		= 1.0;
+	dsf[3*nx + 3] 		= 1.0;
+	dsf[4*nx + 1] 		= 1.0;
+	dsf[5*nx + 0] 		= -1.0;
+	dsf[5*nx + 4] 		= 1.0/3.0;
+	dsf[6*nx + 0] 		= 1.0;
+	dsf[6*nx + 4] 		= -1.0/3.0;
+	dsf[7*nx + 1] 		= -0.5;
+	dsf[7*nx + 2] 		= -0.5;
+	dsf[8*nx + 1] 		= 0.5;
+	dsf[8*nx + 2] 		= 0.5;
+	dsf[9*nx + 3] 		= -1.0;
+
+	d2p[(0*nx + 0)*nx + 1] 	= 1.0;
+	d2p[(0*nx + 0)*nx + 2] 	= 1.0;
+	d2p[(0*nx + 0)*nx + 3] 	= 1.0;
+	d2p[(0*nx + 1)*nx + 0] 	= 1.0;
+	d2p[(0*nx + 2)*nx + 0] 	= 1.0;
+	d2p[(0*nx + 3)*nx + 0] 	= 1.0;
+	d2p[(2*nx + 0)*nx + 1] 	= -1.0;
+	d2p[(2*nx + 0)*nx + 2] 	= -1.0;
+	d2p[(2*nx + 0)*nx + 3] 	= -1.0;
+	d2p[(2*nx + 1)*nx + 0] 	= -1.0;
+	d2p[(2*nx + 2)*nx + 0] 	= -1.0;
+	d2p[(2*nx + 3)*nx + 0] 	= -1.0;
+
+	SS_hessian(d, nu_bi, 0, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (cordierite)
+*/
+static const double nu_cd[3*4] = {
+	0.0, 2.0, 0.0, 1.0,
+	2.0, 0.0, 0.0, 1.0,
+	0.0, 2.0, 1.0, 0.0
+};
+
+/** 
+  Hessian of the objective function (cordierite), see SS_hessian
+*/
+void hess_cd(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= 1.0;
+	dsf[1*nx + 0] 		= -1.0;
+	dsf[2*nx + 1] 		= 1.0;
+	dsf[3*nx + 1] 		= -1.0;
+
+
+	SS_hessian(d, nu_cd, 0, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (clinopyroxene)
+*/
+static const double nu_cpx[10*13] = {
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.5, 0.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.5, 0.0,
+	0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.25, 0.25,
+	0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.25, 0.25,
+	0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.25, 0.25,
+	0.5, 0.0, 0.0, 0.0, 0.0, 0.5, 0.0, 0.0, 1.0, 0.0, 0.0, 0.25, 0.25,
+	0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.5, 0.0,
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.5, 0.0,
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.5, 0.0,
+	0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.5, 0.0
+};
+
+/** 
+  Hessian of the objective function (clinopyroxene), see SS_hessian
+*/
+void hess_cpx(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= x[1] + x[3] - x[7] + x[8] - 1.0;
+	dsf[0*nx + 1] 		= x[0] + x[4] - 1.0;
+	dsf[0*nx + 3] 		= x[0] + x[4] - 1.0;
+	dsf[0*nx + 4] 		= x[1] + x[3] - x[7] + x[8] - 1.0;
+	dsf[0*nx + 7] 		= -x[0] - x[4] + 1.0;
+	dsf[0*nx + 8] 		= x[0] + x[4] - 1.0;
+	dsf[1*nx + 0] 		= -x[1] - x[3] + x[7] - x[8] + 1.0;
+	dsf[1*nx + 1] 		= -x[0] - x[4];
+	dsf[1*nx + 3] 		= -x[0] - x[4];
+	dsf[1*nx + 4] 		= -x[1] - x[3] + x[7] - x[8] + 1.0;
+	dsf[1*nx + 7] 		= x[0] + x[4];
+	dsf[1*nx + 8] 		= -x[0] - x[4];
+	dsf[2*nx + 1] 		= 1.0;
+	dsf[2*nx + 3] 		= 1.0;
+	dsf[2*nx + 5] 		= -1.0;
+	dsf[2*nx + 6] 		= -1.0;
+	dsf[2*nx + 7] 		= -2.0;
+	dsf[2*nx + 8] 		= 1.0;
+	dsf[3*nx + 5] 		= 1.0;
+	dsf[4*nx + 6] 		= 1.0;
+	dsf[5*nx + 7] 		= 1.0;
+	dsf[6*nx + 0] 		= -x[2];
+	dsf[6*nx + 1] 		= -x[4];
+	dsf[6*nx + 2] 		= -x[0] + 1.0;
+	dsf[6*nx + 3] 		= -x[4];
+	dsf[6*nx + 4] 		= -x[1] - x[3] + x[7] - x[8] + 1.0;
+	dsf[6*nx + 7] 		= x[4];
+	dsf[6*nx + 8] 		= -x[4];
+	dsf[7*nx + 0] 		= x[2];
+	dsf[7*nx + 1] 		= x[4];
+	dsf[7*nx + 2] 		= x[0];
+	dsf[7*nx + 3] 		= x[4];
+	dsf[7*nx + 4] 		= x[1] + x[3] - x[7] + x[8] - 1.0;
+	dsf[7*nx + 7] 		= -x[4];
+	dsf[7*nx + 8] 		= x[4];
+	dsf[8*nx + 2] 		= -1.0;
+	dsf[8*nx + 3] 		= -1.0;
+	dsf[8*nx + 8] 		= -1.0;
+	dsf[9*nx + 3] 		= 1.0;
+	dsf[10*nx + 8] 		= 1.0;
+	dsf[11*nx + 1] 		= -0.5;
+	dsf[12*nx + 1] 		= 0.5;
+
+	d2p[(1*nx + 0)*nx + 1] 	= -1.0;
+	d2p[(1*nx + 0)*nx + 3] 	= -1.0;
+	d2p[(1*nx + 0)*nx + 7] 	= 1.0;
+	d2p[(1*nx + 0)*nx + 8] 	= -1.0;
+	d2p[(1*nx + 1)*nx + 0] 	= -1.0;
+	d2p[(1*nx + 1)*nx + 4] 	= -1.0;
+	d2p[(1*nx + 3)*nx + 0] 	= -1.0;
+	d2p[(1*nx + 3)*nx + 4] 	= -1.0;
+	d2p[(1*nx + 4)*nx + 1] 	= -1.0;
+	d2p[(1*nx + 4)*nx + 3] 	= -1.0;
+	d2p[(1*nx + 4)*nx + 7] 	= 1.0;
+	d2p[(1*nx + 4)*nx + 8] 	= -1.0;
+	d2p[(1*nx + 7)*nx + 0] 	= 1.0;
+	d2p[(1*nx + 7)*nx + 4] 	= 1.0;
+	d2p[(1*nx + 8)*nx + 0] 	= -1.0;
+	d2p[(1*nx + 8)*nx + 4] 	= -1.0;
+	d2p[(7*nx + 0)*nx + 2] 	= -1.0;
+	d2p[(7*nx + 1)*nx + 4] 	= -1.0;
+	d2p[(7*nx + 2)*nx + 0] 	= -1.0;
+	d2p[(7*nx + 3)*nx + 4] 	= -1.0;
+	d2p[(7*nx + 4)*nx + 1] 	= -1.0;
+	d2p[(7*nx + 4)*nx + 3] 	= -1.0;
+	d2p[(7*nx + 4)*nx + 7] 	= 1.0;
+	d2p[(7*nx + 4)*nx + 8] 	= -1.0;
+	d2p[(7*nx + 7)*nx + 4] 	= 1.0;
+	d2p[(7*nx + 8)*nx + 4] 	= -1.0;
+	d2p[(8*nx + 0)*nx + 1] 	= 1.0;
+	d2p[(8*nx + 0)*nx + 2] 	= 1.0;
+	d2p[(8*nx + 0)*nx + 3] 	= 1.0;
+	d2p[(8*nx + 0)*nx + 7] 	= -1.0;
+	d2p[(8*nx + 0)*nx + 8] 	= 1.0;
+	d2p[(8*nx + 1)*nx + 0] 	= 1.0;
+	d2p[(8*nx + 1)*nx + 4] 	= 2.0;
+	d2p[(8*nx + 2)*nx + 0] 	= 1.0;
+	d2p[(8*nx + 3)*nx + 0] 	= 1.0;
+	d2p[(8*nx + 3)*nx + 4] 	= 2.0;
+	d2p[(8*nx + 4)*nx + 1] 	= 2.0;
+	d2p[(8*nx + 4)*nx + 3] 	= 2.0;
+	d2p[(8*nx + 4)*nx + 7] 	= -2.0;
+	d2p[(8*nx + 4)*nx + 8] 	= 2.0;
+	d2p[(8*nx + 7)*nx + 0] 	= -1.0;
+	d2p[(8*nx + 7)*nx + 4] 	= -2.0;
+	d2p[(8*nx + 8)*nx + 0] 	= 1.0;
+	d2p[(8*nx + 8)*nx + 4] 	= 2.0;
+
+	SS_hessian(d, nu_cpx, 1, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (epidote)
+*/
+static const double nu_ep[3*4] = {
+	0.0, 1.0, 0.0, 1.0,
+	0.0, 1.0, 1.0, 0.0,
+	1.0, 0.0, 1.0, 0.0
+};
+
+/** 
+  Hessian of the objective function (epidote), see SS_hessian
+*/
+void hess_ep(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= 1.0;
+	dsf[0*nx + 1] 		= -1.0;
+	dsf[1*nx + 0] 		= -1.0;
+	dsf[1*nx + 1] 		= 1.0;
+	dsf[2*nx + 0] 		= 1.0;
+	dsf[2*nx + 1] 		= 1.0;
+	dsf[3*nx + 0] 		= -1.0;
+	dsf[3*nx + 1] 		= -1.0;
+
+
+	SS_hessian(d, nu_ep, 0, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (fluid)
+*/
+static const double nu_fl[11*12] = {
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 1.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0
+};
+
+/** 
+  Hessian of the objective function (fluid), see SS_hessian
+*/
+void hess_fl(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= -1.0;
+	dsf[0*nx + 1] 		= -1.0;
+	dsf[0*nx + 2] 		= -1.0;
+	dsf[0*nx + 3] 		= -1.0;
+	dsf[0*nx + 4] 		= -1.0;
+	dsf[0*nx + 5] 		= -1.0;
+	dsf[0*nx + 6] 		= -1.0;
+	dsf[0*nx + 7] 		= -1.0;
+	dsf[0*nx + 8] 		= -1.0;
+	dsf[0*nx + 9] 		= -1.0;
+	dsf[1*nx + 1] 		= 1.0;
+	dsf[2*nx + 0] 		= 1.0;
+	dsf[3*nx + 2] 		= 1.0;
+	dsf[4*nx + 3] 		= 1.0;
+	dsf[5*nx + 4] 		= 1.0;
+	dsf[6*nx + 5] 		= 1.0;
+	dsf[7*nx + 6] 		= 1.0;
+	dsf[8*nx + 7] 		= 1.0;
+	dsf[9*nx + 8] 		= 1.0;
+	dsf[10*nx + 9] 		= 1.0;
+	dsf[11*nx + 9] 		= -1.0;
+
+
+	SS_hessian(d, nu_fl, 0, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (garnet)
+*/
+static const double nu_g[6*7] = {
+	3.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0,
+	0.0, 3.0, 0.0, 2.0, 0.0, 0.0, 0.0,
+	0.0, 0.0, 3.0, 2.0, 0.0, 0.0, 0.0,
+	0.0, 0.0, 3.0, 0.0, 0.0, 2.0, 0.0,
+	3.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0,
+	3.0, 0.0, 0.0, 1.0, 0.0, 0.0, 1.0
+};
+
+/** 
+  Hessian of the objective function (garnet), see SS_hessian
+*/
+void hess_g(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= x[1] - 1.0;
+	dsf[0*nx + 1] 		= x[0] - 1.0;
+	dsf[1*nx + 0] 		= -x[1] + 1.0;
+	dsf[1*nx + 1] 		= -x[0];
+	dsf[2*nx + 1] 		= 1.0;
+	dsf[3*nx + 2] 		= -1.0;
+	dsf[3*nx + 3] 		= -1.0;
+	dsf[3*nx + 4] 		= -2.0;
+	dsf[4*nx + 3] 		= 1.0;
+	dsf[5*nx + 2] 		= 1.0;
+	dsf[6*nx + 4] 		= 1.0;
+
+	d2p[(0*nx + 0)*nx + 1] 	= 1.0;
+	d2p[(0*nx + 1)*nx + 0] 	= 1.0;
+	d2p[(1*nx + 0)*nx + 1] 	= -1.0;
+	d2p[(1*nx + 1)*nx + 0] 	= -1.0;
+
+	SS_hessian(d, nu_g, 1, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (hornblende)
+*/
+static const double nu_hb[11*17] = {
+	1.0, 0.0, 0.0, 3.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 1.0, 0.0, 2.0,
+	1.0, 0.0, 0.0, 3.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.5, 0.5, 2.0,
+	0.0, 1.0, 0.0, 3.0, 0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.5, 0.5, 2.0,
+	1.0, 0.0, 0.0, 3.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0, 1.0, 0.0, 2.0,
+	1.0, 0.0, 0.0, 3.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0, 1.0, 0.0, 2.0,
+	1.0, 0.0, 0.0, 0.0, 3.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0, 1.0, 0.0, 2.0,
+	1.0, 0.0, 0.0, 3.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0, 1.0, 0.0, 2.0,
+	1.0, 0.0, 0.0, 0.0, 3.0, 2.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0, 1.0, 0.0, 2.0,
+	1.0, 0.0, 0.0, 3.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.0, 2.0, 1.0, 0.0, 2.0,
+	0.0, 0.0, 1.0, 3.0, 0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.5, 0.5, 2.0,
+	1.0, 0.0, 0.0, 3.0, 0.0, 0.0, 0.0, 0.0, 0.0, 4.0, 2.0, 0.0, 0.0, 0.0, 0.5, 0.5, 0.0
+};
+
+/** 
+  Hessian of the objective function (hornblende), see SS_hessian
+*/
+void hess_hb(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 3] 		= -1.0;
+	dsf[1*nx + 3] 		= -x[4] + 1.0;
+	dsf[1*nx + 4] 		= -x[3];
+	dsf[2*nx + 3] 		= x[4];
+	dsf[2*nx + 4] 		= x[3];
+	dsf[3*nx + 0] 		= -1.0;
+	dsf[3*nx + 8] 		= 1.0;
+	dsf[4*nx + 0] 		= 1.0;
+	dsf[4*nx + 8] 		= -1.0;
+	dsf[5*nx + 0] 		= x[1] + x[6] + x[7] - 1.0;
+	dsf[5*nx + 1] 		= x[0] - x[9] - 1.0;
+	dsf[5*nx + 6] 		= x[0] - x[9] - 1.0;
+	dsf[5*nx + 7] 		= x[0] - x[9] - 1.0;
+	dsf[5*nx + 9] 		= -x[1] - x[6] - x[7] + 1.0;
+	dsf[6*nx + 0] 		= -x[1] - x[6] - x[7] + 1.0;
+	dsf[6*nx + 1] 		= -x[0] + x[9];
+	dsf[6*nx + 6] 		= -x[0] + x[9];
+	dsf[6*nx + 7] 		= -x[0] + x[9];
+	dsf[6*nx + 9] 		= x[1] + x[6] + x[7] - 1.0;
+	dsf[7*nx + 1] 		= 1.0;
+	dsf[8*nx + 6] 		= 1.0;
+	dsf[9*nx + 7] 		= 1.0;
+	dsf[10*nx + 5] 		= 1.0;
+	dsf[11*nx + 0] 		= x[2] + x[5] - 1.0;
+	dsf[11*nx + 1] 		= x[9];
+	dsf[11*nx + 2] 		= x[0] - 1.0;
+	dsf[11*nx + 5] 		= x[0] - 1.0;
+	dsf[11*nx + 6] 		= x[9];
+	dsf[11*nx + 7] 		= x[9];
+	dsf[11*nx + 8] 		= -1.5;
+	dsf[11*nx + 9] 		= x[1] + x[6] + x[7] - 1.0;
+	dsf[12*nx + 0] 		= -x[2] - x[5] + 1.0;
+	dsf[12*nx + 1] 		= -x[9];
+	dsf[12*nx + 2] 		= -x[0];
+	dsf[12*nx + 5] 		= -x[0];
+	dsf[12*nx + 6] 		= -x[9];
+	dsf[12*nx + 7] 		= -x[9];
+	dsf[12*nx + 8] 		= 1.5;
+	dsf[12*nx + 9] 		= -x[1] - x[6] - x[7] + 1.0;
+	dsf[13*nx + 2] 		= 1.0;
+	dsf[14*nx + 1] 		= -0.5;
+	dsf[14*nx + 2] 		= 0.5;
+	dsf[14*nx + 3] 		= -0.25;
+	dsf[14*nx + 6] 		= -0.5;
+	dsf[14*nx + 7] 		= -0.5;
+	dsf[15*nx + 1] 		= 0.5;
+	dsf[15*nx + 2] 		= -0.5;
+	dsf[15*nx + 3] 		= 0.25;
+	dsf[15*nx + 6] 		= 0.5;
+	dsf[15*nx + 7] 		= 0.5;
+	dsf[16*nx + 7] 		= -1.0;
+
+	d2p[(2*nx + 3)*nx + 4] 	= -1.0;
+	d2p[(2*nx + 4)*nx + 3] 	= -1.0;
+	d2p[(4*nx + 0)*nx + 2] 	= 1.0;
+	d2p[(4*nx + 0)*nx + 5] 	= 1.0;
+	d2p[(4*nx + 1)*nx + 9] 	= 1.0;
+	d2p[(4*nx + 2)*nx + 0] 	= 1.0;
+	d2p[(4*nx + 5)*nx + 0] 	= 1.0;
+	d2p[(4*nx + 6)*nx + 9] 	= 1.0;
+	d2p[(4*nx + 7)*nx + 9] 	= 1.0;
+	d2p[(4*nx + 9)*nx + 1] 	= 1.0;
+	d2p[(4*nx + 9)*nx + 6] 	= 1.0;
+	d2p[(4*nx + 9)*nx + 7] 	= 1.0;
+	d2p[(5*nx + 0)*nx + 1] 	= -1.0;
+	d2p[(5*nx + 0)*nx + 2] 	= 1.0;
+	d2p[(5*nx + 0)*nx + 5] 	= 1.0;
+	d2p[(5*nx + 0)*nx + 6] 	= -1.0;
+	d2p[(5*nx + 0)*nx + 7] 	= -1.0;
+	d2p[(5*nx + 1)*nx + 0] 	= -1.0;
+	d2p[(5*nx + 1)*nx + 9] 	= 2.0;
+	d2p[(5*nx + 2)*nx + 0] 	= 1.0;
+	d2p[(5*nx + 5)*nx + 0] 	= 1.0;
+	d2p[(5*nx + 6)*nx + 0] 	= -1.0;
+	d2p[(5*nx + 6)*nx + 9] 	= 2.0;
+	d2p[(5*nx + 7)*nx + 0] 	= -1.0;
+	d2p[(5*nx + 7)*nx + 9] 	= 2.0;
+	d2p[(5*nx + 9)*nx + 1] 	= 2.0;
+	d2p[(5*nx + 9)*nx + 6] 	= 2.0;
+	d2p[(5*nx + 9)*nx + 7] 	= 2.0;
+	d2p[(6*nx + 0)*nx + 2] 	= -1.0;
+	d2p[(6*nx + 0)*nx + 5] 	= -1.0;
+	d2p[(6*nx + 1)*nx + 9] 	= -1.0;
+	d2p[(6*nx + 2)*nx + 0] 	= -1.0;
+	d2p[(6*nx + 5)*nx + 0] 	= -1.0;
+	d2p[(6*nx + 6)*nx + 9] 	= -1.0;
+	d2p[(6*nx + 7)*nx + 9] 	= -1.0;
+	d2p[(6*nx + 9)*nx + 1] 	= -1.0;
+	d2p[(6*nx + 9)*nx + 6] 	= -1.0;
+	d2p[(6*nx + 9)*nx + 7] 	= -1.0;
+	d2p[(7*nx + 0)*nx + 1] 	= 1.0;
+	d2p[(7*nx + 0)*nx + 2] 	= -1.0;
+	d2p[(7*nx + 0)*nx + 5] 	= -1.0;
+	d2p[(7*nx + 0)*nx + 6] 	= 1.0;
+	d2p[(7*nx + 0)*nx + 7] 	= 1.0;
+	d2p[(7*nx + 1)*nx + 0] 	= 1.0;
+	d2p[(7*nx + 1)*nx + 9] 	= -2.0;
+	d2p[(7*nx + 2)*nx + 0] 	= -1.0;
+	d2p[(7*nx + 5)*nx + 0] 	= -1.0;
+	d2p[(7*nx + 6)*nx + 0] 	= 1.0;
+	d2p[(7*nx + 6)*nx + 9] 	= -2.0;
+	d2p[(7*nx + 7)*nx + 0] 	= 1.0;
+	d2p[(7*nx + 7)*nx + 9] 	= -2.0;
+	d2p[(7*nx + 9)*nx + 1] 	= -2.0;
+	d2p[(7*nx + 9)*nx + 6] 	= -2.0;
+	d2p[(7*nx + 9)*nx + 7] 	= -2.0;
+	d2p[(9*nx + 3)*nx + 4] 	= 1.0;
+	d2p[(9*nx + 4)*nx + 3] 	= 1.0;
+
+	SS_hessian(d, nu_hb, 1, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (ilmenite)
+*/
+static const double nu_ilm[3*6] = {
+	0.5, 0.0, 0.0, 0.0, 0.5, 0.0,
+	0.25, 0.25, 0.0, 0.25, 0.25, 0.0,
+	0.0, 0.0, 0.5, 0.0, 0.0, 0.5
+};
+
+/** 
+  Hessian of the objective function (ilmenite), see SS_hessian
+*/
+void hess_ilm(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= 0.5;
+	dsf[0*nx + 1] 		= 0.5;
+	dsf[1*nx + 0] 		= 0.5;
+	dsf[1*nx + 1] 		= -0.5;
+	dsf[2*nx + 0] 		= -1.0;
+	dsf[3*nx + 0] 		= 0.5;
+	dsf[3*nx + 1] 		= -0.5;
+	dsf[4*nx + 0] 		= 0.5;
+	dsf[4*nx + 1] 		= 0.5;
+	dsf[5*nx + 0] 		= -1.0;
+
+
+	SS_hessian(d, nu_ilm, 0, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (liquid)
+*/
+static const double nu_liq[12*18] = {
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 1.0, -1.0, 0.0, 2.0,
+	0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 1.0, 0.0, -1.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, -1.0, 4.0, 0.0, 0.0, 0.0, -4.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, -1.0, 0.0, 4.0, 0.0, 0.0, -4.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0,
+	0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 2.0, 0.0
+};
+
+/** 
+  Hessian of the objective function (liquid), see SS_hessian
+*/
+void hess_liq(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 1] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 2] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 3] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 4] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 5] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 6] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 7] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 8] 		= -0.75*x[9] - 1.0;
+	dsf[0*nx + 9] 		= -0.75*x[0] - 0.75*x[1] - 0.75*x[2] - 0.75*x[3] - 0.75*x[4] - 0.75*x[5] - 0.75*x[6] - 0.75*x[7] - 0.75*x[8] - 0.75*x[10] + 1.0;
+	dsf[0*nx + 10] 		= -0.75*x[9] - 1.0;
+	dsf[1*nx + 1] 		= 0.75*x[9] + 1.0;
+	dsf[1*nx + 9] 		= 0.75*x[1] - 1.0;
+	dsf[2*nx + 0] 		= 0.75*x[9] + 1.0;
+	dsf[2*nx + 9] 		= 0.75*x[0] - 1.0;
+	dsf[3*nx + 4] 		= 0.75*x[9] + 1.0;
+	dsf[3*nx + 9] 		= 0.75*x[4];
+	dsf[4*nx + 5] 		= 0.75*x[9] + 1.0;
+	dsf[4*nx + 9] 		= 0.75*x[5];
+	dsf[5*nx + 6] 		= 0.75*x[9] + 1.0;
+	dsf[5*nx + 9] 		= 0.75*x[6];
+	dsf[6*nx + 7] 		= 0.75*x[9] + 1.0;
+	dsf[6*nx + 9] 		= 0.75*x[7];
+	dsf[7*nx + 8] 		= 0.75*x[9] + 1.0;
+	dsf[7*nx + 9] 		= 0.75*x[8];
+	dsf[8*nx + 9] 		= 1.0;
+	dsf[9*nx + 2] 		= 0.75*x[9] + 1.0;
+	dsf[9*nx + 3] 		= 0.75*x[9] + 1.0;
+	dsf[9*nx + 9] 		= 0.75*x[2] + 0.75*x[3];
+	dsf[10*nx + 9] 		= -0.75*x[10];
+	dsf[10*nx + 10] 		= -0.75*x[9] - 1.0;
+	dsf[11*nx + 2] 		= 4.0;
+	dsf[12*nx + 3] 		= 4.0;
+	dsf[13*nx + 0] 		= 1.0;
+	dsf[14*nx + 1] 		= 1.0;
+	dsf[15*nx + 0] 		= 1.0;
+	dsf[15*nx + 1] 		= 1.0;
+	dsf[15*nx + 2] 		= 4.0;
+	dsf[15*nx + 3] 		= 4.0;
+	dsf[16*nx + 10] 		= 1.0;
+	dsf[17*nx + 10] 		= -1.0;
+
+	d2p[(0*nx + 0)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 1)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 2)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 3)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 4)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 5)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 6)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 7)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 8)*nx + 9] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 0] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 1] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 2] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 3] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 4] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 5] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 6] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 7] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 8] 	= -0.75;
+	d2p[(0*nx + 9)*nx + 10] 	= -0.75;
+	d2p[(0*nx + 10)*nx + 9] 	= -0.75;
+	d2p[(1*nx + 1)*nx + 9] 	= 0.75;
+	d2p[(1*nx + 9)*nx + 1] 	= 0.75;
+	d2p[(2*nx + 0)*nx + 9] 	= 0.75;
+	d2p[(2*nx + 9)*nx + 0] 	= 0.75;
+	d2p[(3*nx + 2)*nx + 9] 	= 0.75;
+	d2p[(3*nx + 9)*nx + 2] 	= 0.75;
+	d2p[(4*nx + 3)*nx + 9] 	= 0.75;
+	d2p[(4*nx + 9)*nx + 3] 	= 0.75;
+	d2p[(5*nx + 4)*nx + 9] 	= 0.75;
+	d2p[(5*nx + 9)*nx + 4] 	= 0.75;
+	d2p[(6*nx + 5)*nx + 9] 	= 0.75;
+	d2p[(6*nx + 9)*nx + 5] 	= 0.75;
+	d2p[(7*nx + 6)*nx + 9] 	= 0.75;
+	d2p[(7*nx + 9)*nx + 6] 	= 0.75;
+	d2p[(8*nx + 7)*nx + 9] 	= 0.75;
+	d2p[(8*nx + 9)*nx + 7] 	= 0.75;
+	d2p[(9*nx + 8)*nx + 9] 	= 0.75;
+	d2p[(9*nx + 9)*nx + 8] 	= 0.75;
+	d2p[(11*nx + 9)*nx + 10] 	= 0.75;
+	d2p[(11*nx + 10)*nx + 9] 	= 0.75;
+
+	SS_hessian(d, nu_liq, 1, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (muscovite)
+*/
+static const double nu_mu[6*10] = {
+	1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 0.0, 1.0, 1.0,
+	1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 0.0, 2.0, 0.0,
+	1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0, 2.0, 0.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 1.0, 0.0, 1.0, 1.0,
+	0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, 2.0,
+	1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 1.0
+};
+
+/** 
+  Hessian of the objective function (muscovite), see SS_hessian
+*/
+void hess_mu(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 3] 		= -1.0;
+	dsf[0*nx + 4] 		= -1.0;
+	dsf[1*nx + 3] 		= 1.0;
+	dsf[2*nx + 4] 		= 1.0;
+	dsf[3*nx + 0] 		= x[1] - 1.0;
+	dsf[3*nx + 1] 		= x[0] - 1.0;
+	dsf[4*nx + 0] 		= -x[1] + 1.0;
+	dsf[4*nx + 1] 		= -x[0];
+	dsf[5*nx + 1] 		= 1.0;
+	dsf[6*nx + 2] 		= -1.0;
+	dsf[7*nx + 2] 		= 1.0;
+	dsf[8*nx + 1] 		= -0.5;
+	dsf[8*nx + 4] 		= -0.5;
+	dsf[9*nx + 1] 		= 0.5;
+	dsf[9*nx + 4] 		= 0.5;
+
+	d2p[(1*nx + 0)*nx + 1] 	= 1.0;
+	d2p[(1*nx + 1)*nx + 0] 	= 1.0;
+	d2p[(2*nx + 0)*nx + 1] 	= -1.0;
+	d2p[(2*nx + 1)*nx + 0] 	= -1.0;
+
+	SS_hessian(d, nu_mu, 1, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (olivine)
+*/
+static const double nu_ol[4*5] = {
+	1.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 1.0, 0.0, 1.0, 0.0,
+	1.0, 0.0, 1.0, 0.0, 0.0,
+	1.0, 0.0, 0.0, 1.0, 0.0
+};
+
+/** 
+  Hessian of the objective function (olivine), see SS_hessian
+*/
+void hess_ol(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= -1.0;
+	dsf[0*nx + 2] 		= 1.0;
+	dsf[1*nx + 0] 		= 1.0;
+	dsf[1*nx + 2] 		= -1.0;
+	dsf[2*nx + 0] 		= x[1] - 1.0;
+	dsf[2*nx + 1] 		= x[0] - 1.0;
+	dsf[2*nx + 2] 		= -1.0;
+	dsf[3*nx + 0] 		= -x[1] + 1.0;
+	dsf[3*nx + 1] 		= -x[0];
+	dsf[3*nx + 2] 		= 1.0;
+	dsf[4*nx + 1] 		= 1.0;
+
+	d2p[(2*nx + 0)*nx + 1] 	= 1.0;
+	d2p[(2*nx + 1)*nx + 0] 	= 1.0;
+	d2p[(3*nx + 0)*nx + 1] 	= -1.0;
+	d2p[(3*nx + 1)*nx + 0] 	= -1.0;
+
+	SS_hessian(d, nu_ol, 0, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (orthopyroxene)
+*/
+static const double nu_opx[9*12] = {
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.5, 0.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.5, 0.0,
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.5, 0.0,
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.5, 0.0,
+	0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.25, 0.25,
+	0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.25, 0.25,
+	0.5, 0.0, 0.0, 0.0, 0.0, 0.5, 1.0, 0.0, 0.0, 0.0, 0.25, 0.25,
+	0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.25, 0.25,
+	0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.5, 0.0
+};
+
+/** 
+  Hessian of the objective function (orthopyroxene), see SS_hessian
+*/
+void hess_opx(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= x[1] - x[5] + x[7] - 1.0;
+	dsf[0*nx + 1] 		= x[0] + x[3] - 1.0;
+	dsf[0*nx + 3] 		= x[1] - x[5] + x[7] - 1.0;
+	dsf[0*nx + 5] 		= -x[0] - x[3] + 1.0;
+	dsf[0*nx + 7] 		= x[0] + x[3] - 1.0;
+	dsf[1*nx + 0] 		= -x[1] + x[5] - x[7] + 1.0;
+	dsf[1*nx + 1] 		= -x[0] - x[3];
+	dsf[1*nx + 3] 		= -x[1] + x[5] - x[7] + 1.0;
+	dsf[1*nx + 5] 		= x[0] + x[3];
+	dsf[1*nx + 7] 		= -x[0] - x[3];
+	dsf[2*nx + 1] 		= 1.0;
+	dsf[2*nx + 4] 		= -1.0;
+	dsf[2*nx + 5] 		= -2.0;
+	dsf[2*nx + 6] 		= -1.0;
+	dsf[2*nx + 7] 		= 1.0;
+	dsf[3*nx + 4] 		= 1.0;
+	dsf[4*nx + 6] 		= 1.0;
+	dsf[5*nx + 5] 		= 1.0;
+	dsf[6*nx + 0] 		= x[2] + x[7] - 1.0;
+	dsf[6*nx + 1] 		= -x[3];
+	dsf[6*nx + 2] 		= x[0] - 1.0;
+	dsf[6*nx + 3] 		= -x[1] + x[5] - x[7] + 1.0;
+	dsf[6*nx + 5] 		= x[3];
+	dsf[6*nx + 7] 		= x[0] - x[3] - 1.0;
+	dsf[7*nx + 0] 		= -x[2] - x[7] + 1.0;
+	dsf[7*nx + 1] 		= x[3];
+	dsf[7*nx + 2] 		= -x[0];
+	dsf[7*nx + 3] 		= x[1] - x[5] + x[7] - 1.0;
+	dsf[7*nx + 5] 		= -x[3];
+	dsf[7*nx + 7] 		= -x[0] + x[3];
+	dsf[8*nx + 2] 		= 1.0;
+	dsf[9*nx + 7] 		= 1.0;
+	dsf[10*nx + 1] 		= -0.5;
+	dsf[11*nx + 1] 		= 0.5;
+
+	d2p[(0*nx + 0)*nx + 2] 	= 1.0;
+	d2p[(0*nx + 0)*nx + 7] 	= 1.0;
+	d2p[(0*nx + 1)*nx + 3] 	= -1.0;
+	d2p[(0*nx + 2)*nx + 0] 	= 1.0;
+	d2p[(0*nx + 3)*nx + 1] 	= -1.0;
+	d2p[(0*nx + 3)*nx + 5] 	= 1.0;
+	d2p[(0*nx + 3)*nx + 7] 	= -1.0;
+	d2p[(0*nx + 5)*nx + 3] 	= 1.0;
+	d2p[(0*nx + 7)*nx + 0] 	= 1.0;
+	d2p[(0*nx + 7)*nx + 3] 	= -1.0;
+	d2p[(1*nx + 0)*nx + 1] 	= -1.0;
+	d2p[(1*nx + 0)*nx + 5] 	= 1.0;
+	d2p[(1*nx + 0)*nx + 7] 	= -1.0;
+	d2p[(1*nx + 1)*nx + 0] 	= -1.0;
+	d2p[(1*nx + 1)*nx + 3] 	= -1.0;
+	d2p[(1*nx + 3)*nx + 1] 	= -1.0;
+	d2p[(1*nx + 3)*nx + 5] 	= 1.0;
+	d2p[(1*nx + 3)*nx + 7] 	= -1.0;
+	d2p[(1*nx + 5)*nx + 0] 	= 1.0;
+	d2p[(1*nx + 5)*nx + 3] 	= 1.0;
+	d2p[(1*nx + 7)*nx + 0] 	= -1.0;
+	d2p[(1*nx + 7)*nx + 3] 	= -1.0;
+	d2p[(2*nx + 0)*nx + 1] 	= 1.0;
+	d2p[(2*nx + 0)*nx + 2] 	= -1.0;
+	d2p[(2*nx + 0)*nx + 5] 	= -1.0;
+	d2p[(2*nx + 1)*nx + 0] 	= 1.0;
+	d2p[(2*nx + 1)*nx + 3] 	= 2.0;
+	d2p[(2*nx + 2)*nx + 0] 	= -1.0;
+	d2p[(2*nx + 3)*nx + 1] 	= 2.0;
+	d2p[(2*nx + 3)*nx + 5] 	= -2.0;
+	d2p[(2*nx + 3)*nx + 7] 	= 2.0;
+	d2p[(2*nx + 5)*nx + 0] 	= -1.0;
+	d2p[(2*nx + 5)*nx + 3] 	= -2.0;
+	d2p[(2*nx + 7)*nx + 3] 	= 2.0;
+
+	SS_hessian(d, nu_opx, 1, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (plagioclase)
+*/
+static const double nu_pl4T[3*5] = {
+	1.0, 0.0, 0.0, 0.25, 0.75,
+	0.0, 1.0, 0.0, 0.5, 0.5,
+	0.0, 0.0, 1.0, 0.25, 0.75
+};
+
+/** 
+  Hessian of the objective function (plagioclase), see SS_hessian
+*/
+void hess_pl4T(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= -1.0;
+	dsf[0*nx + 1] 		= -1.0;
+	dsf[1*nx + 0] 		= 1.0;
+	dsf[2*nx + 1] 		= 1.0;
+	dsf[3*nx + 0] 		= 0.25;
+	dsf[4*nx + 0] 		= -0.25;
+
+
+	SS_hessian(d, nu_pl4T, 1, hess);
+};
+
+/** 
+  exponents of the site fractions in the ideal activities of the endmembers (spinel)
+*/
+static const double nu_spn[8*10] = {
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0, 0.5, 0.0, 0.5, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0, 0.0, 0.5, 0.5, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0,
+	0.0, 0.0, 0.0, 1.0, 0.0, 0.5, 0.0, 0.5, 0.0, 0.0,
+	1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0,
+	1.0, 0.0, 0.0, 0.0, 0.5, 0.0, 0.0, 0.0, 0.0, 0.5
+};
+
+/** 
+  Hessian of the objective function (spinel), see SS_hessian
+*/
+void hess_spn(unsigned n, const double *x, double *hess, void *SS_ref_db){
+	SS_ref *d    = (SS_ref *) SS_ref_db;
+	int     nx   = d->n_xeos;
+	double *dsf  = d->dsf;
+	double *d2p  = d->hess_ws;
+
+	for (int i = 0; i < d->n_sf*nx; i++){ 		dsf[i] = 0.0; }
+	for (int i = 0; i < d->n_em*nx*nx; i++){ 	d2p[i] = 0.0; }
+
+	dsf[0*nx + 0] 		= -1.0/3.0*x[3] - 1.0/3.0;
+	dsf[0*nx + 3] 		= -1.0/3.0*x[0] + 1.0/3.0;
+	dsf[0*nx + 4] 		= 2.0/3.0;
+	dsf[1*nx + 0] 		= 1.0/3.0*x[3] + 1.0/3.0;
+	dsf[1*nx + 3] 		= 1.0/3.0*x[0];
+	dsf[1*nx + 5] 		= 2.0/3.0;
+	dsf[2*nx + 1] 		= 2.0/3.0*x[2] + 2.0/3.0*x[3] - 2.0/3.0;
+	dsf[2*nx + 2] 		= 2.0/3.0*x[1];
+	dsf[2*nx + 3] 		= 2.0/3.0*x[1] - 1.0/3.0;
+	dsf[2*nx + 4] 		= -2.0/3.0;
+	dsf[2*nx + 5] 		= -2.0/3.0;
+	dsf[2*nx + 6] 		= -2.0/3.0;
+	dsf[3*nx + 1] 		= -2.0/3.0*x[2] - 2.0/3.0*x[3] + 2.0/3.0;
+	dsf[3*nx + 2] 		= -2.0/3.0*x[1];
+	dsf[3*nx + 3] 		= -2.0/3.0*x[1];
+	dsf[3*nx + 6] 		= 2.0/3.0;
+	dsf[4*nx + 0] 		= -1.0/3.0*x[3] - 1.0/3.0;
+	dsf[4*nx + 3] 		= -1.0/3.0*x[0] + 1.0/3.0;
+	dsf[4*nx + 4] 		= -1.0/3.0;
+	dsf[5*nx + 0] 		= 1.0/3.0*x[3] + 1.0/3.0;
+	dsf[5*nx + 3] 		= 1.0/3.0*x[0];
+	dsf[5*nx + 5] 		= -1.0/3.0;
+	dsf[6*nx + 1] 		= 2.0/3.0*x[2] + 2.0/3.0*x[3] - 2.0/3.0;
+	dsf[6*nx + 2] 		= 2.0/3.0*x[1] - 1.0;
+	dsf[6*nx + 3] 		= 2.0/3.0*x[1] - 5.0/6.0;
+	dsf[6*nx + 4] 		= 1.0/3.0;
+	dsf[6*nx + 5] 		= 1.0/3.0;
+	dsf[6*nx + 6] 		= 1.0/3.0;
+	dsf[7*nx + 1] 		= -2.0/3.0*x[2] - 2.0/3.0*x[3] + 2.0/3.0;
+	dsf[7*nx + 2] 		= -2.0/3.0*x[1];
+	dsf[7*nx + 3] 		= -2.0/3.0*x[1];
+	dsf[7*nx + 6] 		= -1.0/3.0;
+	dsf[8*nx + 2] 		= 1.0;
+	dsf[9*nx + 3] 		= 0.5;
+
+	d2p[(0*nx + 0)*nx + 3] 	= -1.0/3.0;
+	d2p[(0*nx + 3)*nx + 0] 	= -1.0/3.0;
+	d2p[(1*nx + 0)*nx + 3] 	= -2.0/3.0;
+	d2p[(1*nx + 3)*nx + 0] 	= -2.0/3.0;
+	d2p[(2*nx + 0)*nx + 3] 	= 1.0/3.0;
+	d2p[(2*nx + 1)*nx + 2] 	= 1.0/3.0;
+	d2p[(2*nx + 1)*nx + 3] 	= 1.0/3.0;
+	d2p[(2*nx + 2)*nx + 1] 	= 1.0/3.0;
+	d2p[(2*nx + 3)*nx + 0] 	= 1.0/3.0;
+	d2p[(2*nx + 3)*nx + 1] 	= 1.0/3.0;
+	d2p[(3*nx + 0)*nx + 3] 	= 2.0/3.0;
+	d2p[(3*nx + 1)*nx + 2] 	= 2.0/3.0;
+	d2p[(3*nx + 1)*nx + 3] 	= 2.0/3.0;
+	d2p[(3*nx + 2)*nx + 1] 	= 2.0/3.0;
+	d2p[(3*nx + 3)*nx + 0] 	= 2.0/3.0;
+	d2p[(3*nx + 3)*nx + 1] 	= 2.0/3.0;
+	d2p[(4*nx + 1)*nx + 2] 	= -1.0/3.0;
+	d2p[(4*nx + 1)*nx + 3] 	= -1.0/3.0;
+	d2p[(4*nx + 2)*nx + 1] 	= -1.0/3.0;
+	d2p[(4*nx + 3)*nx + 1] 	= -1.0/3.0;
+	d2p[(5*nx + 1)*nx + 2] 	= -2.0/3.0;
+	d2p[(5*nx + 1)*nx + 3] 	= -2.0/3.0;
+	d2p[(5*nx + 2)*nx + 1] 	= -2.0/3.0;
+	d2p[(5*nx + 3)*nx + 1] 	= -2.0/3.0;
+
+	SS_hessian(d, nu_spn, 0, hess);
+};
+
 SS_ref PC_PX_function(		SS_ref SS_ref_db, 
 							double  *x,
 							char    *name){
@@ -2084,12 +3148,12 @@ SS_ref PC_DPDX_function(	SS_ref SS_ref_db,
 };
 
 
-SS_ref P2X(		global_variable gv,
+SS_ref P2X(		global_variable *gv,
 				SS_ref SS_ref_db, 
 				struct bulk_info z_b,
 				char    *name				){
 
-	double eps = gv.bnd_val;
+	double eps = gv->bnd_val;
 
 	/* Associate the right solid-solution data */
 	if 	(strcmp( name, "bi") == 0 ){
@@ -2141,8 +3205,8 @@ SS_ref P2X(		global_variable gv,
 	return SS_ref_db;
 };
 
-SS_ref PC_function(		global_variable 	 gv,
-						SS_ref 				 SS_ref_db, 
+void PC_function(		global_variable 	*gv,
+						SS_ref 				*SS_ref_db, 
 						struct bulk_info 	 z_b,
 						char    			*name				){
 
@@ -2150,88 +3214,86 @@ SS_ref PC_function(		global_variable 	 gv,
 
 	/* Associate the right solid-solution data */
 	if 	(strcmp( name, "bi") == 0 ){
-		G0 = obj_bi(SS_ref_db.n_xeos, SS_ref_db.iguess, 	SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_bi(SS_ref_db->n_xeos, SS_ref_db->iguess, 	SS_ref_db->dfx, SS_ref_db);
 	}
 	else if (strcmp( name, "cd")  == 0){
-		G0 = obj_cd(SS_ref_db.n_xeos, SS_ref_db.iguess, 	SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_cd(SS_ref_db->n_xeos, SS_ref_db->iguess, 	SS_ref_db->dfx, SS_ref_db);
 	}
 	else if (strcmp( name, "cpx") == 0){	
-		G0 = obj_cpx(SS_ref_db.n_xeos, SS_ref_db.iguess, 	SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_cpx(SS_ref_db->n_xeos, SS_ref_db->iguess, 	SS_ref_db->dfx, SS_ref_db);
 			}	
 	else if (strcmp( name, "ep")  == 0){
-		G0 = obj_ep(SS_ref_db.n_xeos, SS_ref_db.iguess, 	SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_ep(SS_ref_db->n_xeos, SS_ref_db->iguess, 	SS_ref_db->dfx, SS_ref_db);
 	}
 	else if (strcmp( name, "fl")  == 0){
-		G0 = obj_fl(SS_ref_db.n_xeos, SS_ref_db.iguess, 	SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_fl(SS_ref_db->n_xeos, SS_ref_db->iguess, 	SS_ref_db->dfx, SS_ref_db);
 	}		
 	else if (strcmp( name, "g")   == 0){
-		G0 = obj_g(SS_ref_db.n_xeos, SS_ref_db.iguess, 		SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_g(SS_ref_db->n_xeos, SS_ref_db->iguess, 		SS_ref_db->dfx, SS_ref_db);
 	}
 	else if (strcmp( name, "hb")  == 0){
-		G0 = obj_hb(SS_ref_db.n_xeos, SS_ref_db.iguess, 	SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_hb(SS_ref_db->n_xeos, SS_ref_db->iguess, 	SS_ref_db->dfx, SS_ref_db);
 	}	
 	else if (strcmp( name, "ilm") == 0){
-		G0 = obj_ilm(SS_ref_db.n_xeos, SS_ref_db.iguess, 	SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_ilm(SS_ref_db->n_xeos, SS_ref_db->iguess, 	SS_ref_db->dfx, SS_ref_db);
 	}	
 	else if (strcmp( name, "liq") == 0){
-		G0 = obj_liq(SS_ref_db.n_xeos, SS_ref_db.iguess, 	SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_liq(SS_ref_db->n_xeos, SS_ref_db->iguess, 	SS_ref_db->dfx, SS_ref_db);
 	}
 	else if (strcmp( name, "mu")  == 0){
-		G0 = obj_mu(SS_ref_db.n_xeos, SS_ref_db.iguess, SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_mu(SS_ref_db->n_xeos, SS_ref_db->iguess, SS_ref_db->dfx, SS_ref_db);
 	}	
 	else if (strcmp( name, "ol")  == 0){
-		G0 = obj_ol(SS_ref_db.n_xeos, SS_ref_db.iguess, SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_ol(SS_ref_db->n_xeos, SS_ref_db->iguess, SS_ref_db->dfx, SS_ref_db);
 	}
 	else if (strcmp( name, "opx") == 0){
-		G0 = obj_opx(SS_ref_db.n_xeos, SS_ref_db.iguess, SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_opx(SS_ref_db->n_xeos, SS_ref_db->iguess, SS_ref_db->dfx, SS_ref_db);
 	}
 	else if (strcmp( name, "pl4T")  == 0){
-		G0 = obj_pl4T(SS_ref_db.n_xeos, SS_ref_db.iguess, SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_pl4T(SS_ref_db->n_xeos, SS_ref_db->iguess, SS_ref_db->dfx, SS_ref_db);
 	}	
 	else if (strcmp( name, "spn") == 0){	
-		G0 = obj_spn(SS_ref_db.n_xeos, SS_ref_db.iguess, SS_ref_db.dfx, &SS_ref_db);
+		G0 = obj_spn(SS_ref_db->n_xeos, SS_ref_db->iguess, SS_ref_db->dfx, SS_ref_db);
 	}
 	else{
 		printf("\nsolid solution '%s' is not in the database\n",name);		
 	}	
 	
 	/** get driving force for simplex pseudocompounds */
-	SS_ref_db.df = G0;
+	SS_ref_db->df = G0;
 	
 	/** initialize composition */
 	for (int j = 0; j < nEl; j++){
-	   SS_ref_db.ss_comp[j] = 0.0;
+	   SS_ref_db->ss_comp[j] = 0.0;
 	}
 	
 	/* set mu = 0 for absent oxides */
-	for (int j = 0; j < SS_ref_db.n_em; j++){
-	   SS_ref_db.mu[j] *= SS_ref_db.z_em[j];
+	for (int j = 0; j < SS_ref_db->n_em; j++){
+	   SS_ref_db->mu[j] *= SS_ref_db->z_em[j];
 	} 
 	
 	/* find solution phase composition*/
-	for (int i = 0; i < SS_ref_db.n_em; i++){
+	for (int i = 0; i < SS_ref_db->n_em; i++){
 	   for (int j = 0; j < nEl; j++){
-		   SS_ref_db.ss_comp[j] += SS_ref_db.Comp[i][j]*SS_ref_db.p[i]*SS_ref_db.z_em[i];
+		   SS_ref_db->ss_comp[j] += SS_ref_db->Comp[i][j]*SS_ref_db->p[i]*SS_ref_db->z_em[i];
 	   } 
 	}
 	
 	/* check if site fractions are satisfied */
-	SS_ref_db.sf_ok = 1;
-	for (int i = 0; i < SS_ref_db.n_sf; i++){
-		if (SS_ref_db.sf[i] < gv.eps_sf_pc || isnan(SS_ref_db.sf[i]) == 1|| isinf(SS_ref_db.sf[i]) == 1){
-			SS_ref_db.sf_ok = 0;	
+	SS_ref_db->sf_ok = 1;
+	for (int i = 0; i < SS_ref_db->n_sf; i++){
+		if (SS_ref_db->sf[i] < gv->eps_sf_pc || isnan(SS_ref_db->sf[i]) == 1|| isinf(SS_ref_db->sf[i]) == 1){
+			SS_ref_db->sf_ok = 0;	
 			break;
 		}
 	}
-
-	return SS_ref_db;
 };
 
-int get_phase_id(		global_variable 	 gv,
+int get_phase_id(		global_variable 	*gv,
 						char    			*name				){
 	int id = 0;
-	for (int i = 0; i < gv.len_ss; i++){
-		if 	(strcmp( name, gv.SS_list[i]) == 0 ){
+	for (int i = 0; i < gv->len_ss; i++){
+		if 	(strcmp( name, gv->SS_list[i]) == 0 ){
 			id = i;
 			break;
 		}
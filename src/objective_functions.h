@@ -9,8 +9,21 @@ typedef double (*obj_type) (	unsigned  		 n,
 								double 			*grad,
 								void 			*SS_ref_db		);
  
+/** 
+	analytic Hessian of the objective function (n_xeos x n_xeos, row-major), at the x-eos of the last call of the
+	objective function with gradient
+*/
+typedef void (*hess_type) (		unsigned  		 n,
+								const double 	*x,
+								double 			*hess,
+								void 			*SS_ref_db		);
+
+obj_type SS_objective_function(		char 				*name 			);
+
+hess_type SS_hessian_function(		char 				*name 			);
+
 void SS_objective_init_function(	obj_type 			*SS_objective,
-									global_variable 	 gv				);
+									global_variable 	*gv				);
 
 void p2x_bi(  SS_ref SS_ref_db, double eps);
 void p2x_cd(  SS_ref SS_ref_db, double eps);
@@ -42,20 +55,43 @@ double obj_opx(unsigned  n, const double *x, double *grad, void *SS_ref_db);
 double obj_pl4T(unsigned n, const double *x, double *grad, void *SS_ref_db);
 double obj_spn(unsigned  n, const double *x, double *grad, void *SS_ref_db);
 
+int SS_hess_ws_size(	int 	n_em,
+						int 	n_xeos		);
+
+void SS_hessian(		SS_ref 			*d,
+						const double 	*nu,
+						int 			 asym,
+						double 			*hess 		);
+
+void hess_bi(unsigned   n, const double *x, double *hess, void *SS_ref_db);
+void hess_cd(unsigned   n, const double *x, double *hess, void *SS_ref_db);
+void hess_cpx(unsigned  n, const double *x, double *hess, void *SS_ref_db);
+void hess_ep(unsigned   n, const double *x, double *hess, void *SS_ref_db);
+void hess_fl(unsigned   n, const double *x, double *hess, void *SS_ref_db);
+void hess_g(unsigned    n, const double *x, double *hess, void *SS_ref_db);
+void hess_hb(unsigned   n, const double *x, double *hess, void *SS_ref_db);
+void hess_ilm(unsigned  n, const double *x, double *hess, void *SS_ref_db);
+void hess_liq(unsigned  n, const double *x, double *hess, void *SS_ref_db);
+void hess_mu(unsigned   n, const double *x, double *hess, void *SS_ref_db);
+void hess_ol(unsigned   n, const double *x, double *hess, void *SS_ref_db);
+void hess_opx(unsigned  n, const double *x, double *hess, void *SS_ref_db);
+void hess_pl4T(unsigned n, const double *x, double *hess, void *SS_ref_db);
+void hess_spn(unsigned  n, const double *x, double *hess, void *SS_ref_db);
+
 SS_ref PC_PX_function(		SS_ref SS_ref_db, 
 							double  *x,
 							char    *name				);	
 													
-SS_ref PC_function(			global_variable gv,
-							SS_ref SS_ref_db, 
+void PC_function(			global_variable *gv,
+							SS_ref *SS_ref_db, 
 							struct bulk_info z_b,
 							char    *name				);
 													
-SS_ref P2X(					global_variable gv,
+SS_ref P2X(					global_variable *gv,
 							SS_ref SS_ref_db, 
 							struct bulk_info z_b,
 							char    *name				);	
 							
-int get_phase_id(		global_variable 	 gv,
+int get_phase_id(		global_variable 	*gv,
 						char    			*name		);
 #endif
@@ -15,49 +15,66 @@ This function simply update the driving forces of pure phase each time the G-hyp
 
 #include "MAGEMin.h"
 #include "gem_function.h"
+#include "em_comp_function.h"
 
 /**
-  main pure phase minimization routine
+  main pure phase minimization routine, the pure phases are levelled at once using the first len_pp rows of gv.em_C
 */
-void pp_min_function(		global_variable 	 gv,
+void pp_min_function(		global_variable 	*gv,
 							struct bulk_info 	 z_b,
 							PP_ref 				*PP_ref_db
 ){
+	for (int i = 0; i < gv->len_pp; i++){
+		gv->em_g[i] = PP_ref_db[i].gbase;
+	}
+
+	/* level the phases using chemical potential of oxides (gamma) */
+	em_project(				gv->em_g,
+							gv->em_C,
+							gv->em_ld,
+							gv->gam_tot,
+							gv->len_pp,
+							gv->len_ox			);
+
+	em_exp(					gv->em_x,
+							gv->em_g,
+							z_b.R*z_b.T,
+							gv->len_pp			);
+
 	// update delta_G of pure phases using Gamma
-	for (int i = 0; i < gv.len_pp; i++){
+	for (int i = 0; i < gv->len_pp; i++){
 		/* if pure phase is active or on hold (PP cannot be removed from consideration */
-		if (gv.pp_flags[i][0] == 1){
-			PP_ref_db[i].gb_lvl = PP_ref_db[i].gbase;
-			
-			/* level the phase using chemical potential of oxides (gamma) */
-			for (int j = 0; j < gv.len_ox; j++) {
-				PP_ref_db[i].gb_lvl -= PP_ref_db[i].Comp[j]*gv.gam_tot[j];
-			}
-			
-			gv.pp_xi[i] = exp(-PP_ref_db[i].gb_lvl/(z_b.R*z_b.T));
+		if (gv->pp_flags[i][0] == 1){
+			PP_ref_db[i].gb_lvl = gv->em_g[i];
+			gv->pp_xi[i] 		= gv->em_x[i];
 		}
 	}
 };
 
 /** 
   initialize pure phase database */
-global_variable init_em_db(		int 				EM_database,
-								struct bulk_info 	z_b,
-								global_variable 	gv,
-								PP_ref 			   *PP_ref_db
+void init_em_db(		int 				EM_database,
+						struct bulk_info 	z_b,
+						global_variable 	*gv,
+						PP_ref 			   *PP_ref_db
 ){
 		/* initialize endmember database */
 		char state[] = "equilibrium";	
 		int sum_zel;
-		for (int i = 0; i < gv.len_pp; i++){
+		for (int i = 0; i < gv->len_pp; i++){
 
 			PP_ref_db[i] = G_EM_function(	EM_database, 
 											z_b.bulk_rock, 
 											z_b.P, 
 											z_b.T, 
-											gv.PP_list[i], 
+											gv->PP_list[i], 
 											state				);
 
+			/* composition row of the pure phase in the flattened endmember matrix */
+			for (int j = 0; j < gv->len_ox; j++){
+				gv->em_C[j*gv->em_ld + i] = PP_ref_db[i].Comp[j];
+			}
+
 			sum_zel = 0;
 			for (int j = 0; j < z_b.zEl_val; j++){
 				
@@ -68,19 +85,17 @@ global_variable init_em_db(		int 				EM_database,
 				
 				/* If pure-phase contains an oxide absent in the bulk-rock then do not take it into account */
 				if (sum_zel != 0){
-					gv.pp_flags[i][0] = 0;
-					gv.pp_flags[i][1] = 0;
-					gv.pp_flags[i][2] = 0;
-					gv.pp_flags[i][3] = 1;
+					gv->pp_flags[i][0] = 0;
+					gv->pp_flags[i][1] = 0;
+					gv->pp_flags[i][2] = 0;
+					gv->pp_flags[i][3] = 1;
 				}
 				else{
-					gv.pp_flags[i][0] = 1;
-					gv.pp_flags[i][1] = 0;
-					gv.pp_flags[i][2] = 1;
-					gv.pp_flags[i][3] = 0;
+					gv->pp_flags[i][0] = 1;
+					gv->pp_flags[i][1] = 0;
+					gv->pp_flags[i][2] = 1;
+					gv->pp_flags[i][3] = 0;
 				}
 			}
 		}
-		
-		return gv;
 };
@@ -0,0 +1,270 @@
+/**
+Retry ladder of the failed points
+-----------------------------------
+
+A point whose PGE iterations fail (more than ur_f global iterations) or diverge is computed again by cheaper and
+cheaper alternatives, until one converges (--PGE_retry=n selects the number of rungs):
+
+1. neighbour : the levelled assemblage and Gamma are replaced by the last solution converged by the rank
+2. dense grid: the levelling uses the denser pseudocompound grid (--PGE_retry_grid, fine by default)
+3. perturbed : the point is computed at slightly perturbed P/T, the solution is then used to restart the point at
+               the requested P/T as for the first rung
+
+Every rung is stopped when its (wall) time budget is exceeded (--PGE_retry_time=ms), the rung that succeeded is stored in
+gv.rt_rung and reported with the results. The output is always the one of the requested P/T.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MAGEMin.h"
+#include "ss_min_function.h"
+#include "dump_function.h"
+#include "PC_grid_function.h"
+#include "recovery_function.h"
+#include "batch_levelling_function.h"
+
+/**
+  store the converged assemblage of the current point, restart point of the next failed point of the rank
+*/
+void save_retry_solution(	struct bulk_info 	 z_b,
+							global_variable 	*gv,
+							csd_phase_set 		*cp 				){
+	int 	n = 0;
+
+	if (gv->rt_max == 0 || get_point_status(gv) >= 3){
+		return;
+	}
+
+	for (int i = 0; i < gv->len_ox; i++){
+		gv->rt_sol.gam_tot[i] = gv->gam_tot[i];
+	}
+	for (int i = 0; i < gv->len_pp; i++){
+		gv->rt_sol.pp_act[i] = gv->pp_flags[i][1];
+		gv->rt_sol.pp_n[i] 	= gv->pp_n[i];
+	}
+	for (int i = 0; i < gv->len_cp && n < gv->len_ox; i++){
+		if (cp[i].ss_flags[1] == 1){
+			gv->rt_sol.cp_ss[n] 		= cp[i].id;
+			gv->rt_sol.cp_n[n] 		= cp[i].ss_n;
+			gv->rt_sol.cp_factor[n] 	= cp[i].factor;
+			for (int j = 0; j < cp[i].n_xeos; j++){
+				gv->rt_sol.cp_xeos[n*gv->len_ox + j] 		= cp[i].xeos[j];
+			}
+			for (int j = 0; j < cp[i].n_em; j++){
+				gv->rt_sol.cp_p[n*(gv->len_ox+1) + j] 	= cp[i].p_em[j];
+			}
+			n += 1;
+		}
+	}
+	gv->rt_sol.n_cp 	= n;
+	gv->rt_sol.P 	= z_b.P;
+	gv->rt_sol.T 	= z_b.T;
+	gv->rt_sol.ok 	= 1;
+};
+
+/**
+  replace the assemblage given by the levelling with the stored solution (gv.rt_sol). The levelled phases that are not
+  part of the stored solution are kept on hold, such that PGE can still bring them back.
+*/
+void seed_retry_solution(	struct bulk_info 	 z_b,
+							global_variable 	*gv,
+
+							PP_ref 				*PP_ref_db,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set 		*cp 				){
+	int 	ss, id_cp;
+
+	for (int i = 0; i < gv->len_ox; i++){
+		gv->gam_tot[i] = gv->rt_sol.gam_tot[i];
+	}
+
+	/* pure phases */
+	for (int i = 0; i < gv->len_pp; i++){
+		if (gv->pp_flags[i][0] == 1){
+			if (gv->rt_sol.pp_act[i] == 1){
+				gv->pp_flags[i][1] 	= 1;
+				gv->pp_flags[i][2] 	= 0;
+				gv->pp_n[i] 			= gv->rt_sol.pp_n[i];
+			}
+			else if (gv->pp_flags[i][1] == 1){
+				gv->pp_flags[i][1] 	= 0;
+				gv->pp_flags[i][2] 	= 1;
+				gv->pp_n[i] 			= 0.0;
+			}
+		}
+	}
+
+	/* levelled solution phases are put on hold */
+	for (int i = 0; i < gv->len_cp; i++){
+		if (cp[i].ss_flags[1] == 1){
+			cp[i].ss_flags[1] 	= 0;
+			cp[i].ss_flags[2] 	= 1;
+			cp[i].ss_n 			= 0.0;
+		}
+	}
+
+	/* solution phases of the stored solution, using an instance on hold of the phase when there is one */
+	for (int k = 0; k < gv->rt_sol.n_cp; k++){
+		ss 		= gv->rt_sol.cp_ss[k];
+		id_cp 	= -1;
+
+		if (SS_ref_db[ss].ss_flags[0] != 1){ continue; }
+
+		for (int i = 0; i < gv->len_cp; i++){
+			if (cp[i].id == ss && cp[i].ss_flags[0] == 1 && cp[i].ss_flags[1] == 0){
+				id_cp = i;
+				break;
+			}
+		}
+		if (id_cp == -1){
+			if (gv->len_cp == gv->max_n_cp){ continue; }
+
+			id_cp 					= gv->len_cp;
+			strcpy(cp[id_cp].name,gv->SS_list[ss]);
+			cp[id_cp].split 		= 0;
+			cp[id_cp].id 			= ss;
+			cp[id_cp].n_xeos		= SS_ref_db[ss].n_xeos;
+			cp[id_cp].n_em			= SS_ref_db[ss].n_em;
+			cp[id_cp].n_sf			= SS_ref_db[ss].n_sf;
+			for (int j = 0; j < SS_ref_db[ss].n_em; j++){
+				cp[id_cp].z_em[j] 	= SS_ref_db[ss].z_em[j];
+			}
+
+			gv->id_solvi[ss][gv->n_solvi[ss]] = id_cp;
+			gv->n_solvi[ss] 		   += 1;
+			gv->len_cp 			   += 1;
+		}
+
+		cp[id_cp].ss_flags[0] 	= 1;
+		cp[id_cp].ss_flags[1] 	= 1;
+		cp[id_cp].ss_flags[2] 	= 0;
+		cp[id_cp].ss_n 			= gv->rt_sol.cp_n[k];
+		cp[id_cp].df 			= 0.0;
+		cp[id_cp].factor 		= gv->rt_sol.cp_factor[k];
+
+		for (int j = 0; j < cp[id_cp].n_em; j++){
+			cp[id_cp].p_em[j] 		= gv->rt_sol.cp_p[k*(gv->len_ox+1) + j];
+		}
+		for (int j = 0; j < cp[id_cp].n_xeos; j++){
+			cp[id_cp].dguess[j] 	= gv->rt_sol.cp_xeos[k*gv->len_ox + j];
+			cp[id_cp].xeos[j] 		= gv->rt_sol.cp_xeos[k*gv->len_ox + j];
+			cp[id_cp].lvlxeos[j] 	= gv->rt_sol.cp_xeos[k*gv->len_ox + j];
+		}
+	}
+
+	/* count the phases of the new assemblage */
+	gv->n_pp_phase = 0;
+	gv->n_cp_phase = 0;
+	for (int i = 0; i < gv->len_pp; i++){
+		if (gv->pp_flags[i][1] == 1){ gv->n_pp_phase += 1; }
+	}
+	for (int i = 0; i < gv->len_cp; i++){
+		if (cp[i].ss_flags[1] == 1){ gv->n_cp_phase += 1; }
+	}
+	gv->n_phase = gv->n_pp_phase + gv->n_cp_phase;
+
+	if (gv->verbose == 1){
+		printf("\n Restart from the solution at P = %.4f kbar, T = %.4f C (%d phases)\n", gv->rt_sol.P, gv->rt_sol.T - 273.15, gv->n_phase);
+	}
+};
+
+/**
+  compute the current point again from scratch, optionally restarted from the stored solution
+*/
+void retry_point(			int 				 EM_database,
+							io_data 			 input_data,
+							struct bulk_info 	 z_b,
+							global_variable 	*gv,
+							Databases 			 DB,
+							int 				 seed 				){
+
+	gv->BR_norm     = 1.0;
+	gv->global_ite  = 0;
+
+	reset_global_variables(		gv,
+								DB.PP_ref_db,
+								DB.SS_ref_db,
+								DB.cp						);
+
+	reset_phases(					gv,
+									z_b,
+									DB.PP_ref_db,
+									DB.SS_ref_db,
+									DB.cp						);
+
+	gv->rt_seed = seed;
+	ComputeEquilibrium_Point(		EM_database,
+									input_data,
+									0,
+									z_b,
+									gv,
+									DB.PP_ref_db,
+									DB.SS_ref_db,
+									DB.cp						);
+	gv->rt_seed = 0;
+};
+
+/**
+  run the rungs of the retry ladder on a failed point (Mode 0), until one converges
+*/
+void run_retry_ladder(		int 				 EM_database,
+							io_data 			 input_data,
+							struct bulk_info 	 z_b,
+							global_variable 	*gv,
+							Databases 			 DB 				){
+	struct bulk_info 	z_p;
+	double 				t;
+
+	gv->rt_rung = 0;
+	if (gv->rt_max == 0 || get_point_status(gv) < 3){
+		return;
+	}
+	gv->rt_rung = -1;
+
+	for (int rung = 1; rung <= gv->rt_max && rung <= 3; rung++){
+
+		if (rung == 1 && gv->rt_sol.ok == 0){ 			continue; }
+		if (rung == 2 && gv->rt_PC_grid_map == NULL){ 	continue; }
+
+		t 				= batch_wtime()*1000.0;
+		gv->rt_deadline 	= (gv->rt_time > 0.0) ? (t + gv->rt_time) : 0.0;
+
+		if (gv->verbose == 1){
+			printf("\n Point %d failed (status %d), retry ladder rung %d\n", gv->numPoint, get_point_status(gv), rung);
+		}
+
+		if (rung == 1){
+			retry_point(	EM_database, input_data, z_b, gv, DB, 1		);
+		}
+		else if (rung == 2){
+			swap_PC_grid(	gv 											);
+			retry_point(	EM_database, input_data, z_b, gv, DB, 0		);
+			swap_PC_grid(	gv 											);
+		}
+		else{
+			z_p 	= z_b;
+			z_p.P  += gv->rt_dP;
+			z_p.T  += gv->rt_dT;
+			retry_point(	EM_database, input_data, z_p, gv, DB, 0		);
+
+			if (get_point_status(gv) < 3){
+				save_retry_solution(	z_p, gv, DB.cp 					);
+				retry_point(			EM_database, input_data, z_b, gv, DB, 1		);
+			}
+		}
+
+		if (gv->verbose == 1){
+			printf(" retry ladder rung %d: status %d, %.3f ms\n", rung, get_point_status(gv), batch_wtime()*1000.0 - t);
+		}
+
+		if (get_point_status(gv) < 3){
+			gv->rt_rung = rung;
+			break;
+		}
+	}
+	gv->rt_deadline = 0.0;
+};
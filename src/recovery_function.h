@@ -0,0 +1,21 @@
+#ifndef __RECOVERY_FUNCTION_H_
+#define __RECOVERY_FUNCTION_H_
+
+void save_retry_solution(	struct bulk_info 	 z_b,
+							global_variable 	*gv,
+							csd_phase_set 		*cp 				);
+
+void seed_retry_solution(	struct bulk_info 	 z_b,
+							global_variable 	*gv,
+
+							PP_ref 				*PP_ref_db,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set 		*cp 				);
+
+void run_retry_ladder(		int 				 EM_database,
+							io_data 			 input_data,
+							struct bulk_info 	 z_b,
+							global_variable 	*gv,
+							Databases 			 DB 				);
+
+#endif
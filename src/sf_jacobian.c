@@ -0,0 +1,486 @@
+/**
+  sparse jacobians of the site-fraction constraints (<phase>_c functions of NLopt_opt_function.c)
+
+  generated by python/sf_jacobian_generator.py, do not edit: the constant non-zero entries of the m x n
+  gradient are listed once per phase, <phase>_c_jac only writes the entries that depend on x
+*/
+
+#include <stdio.h>
+
+#include "nlopt.h"
+#include "MAGEMin.h"
+#include "NLopt_opt_function.h"
+#include "sf_jacobian.h"
+
+
+/**
+  cpx: 13 x 9, 16 constant and 26 x-dependent non-zero entries
+*/
+static const int cpx_jc_i[] = {
+	19, 21, 23, 24, 25, 26, 32, 42, 52, 74, 75, 80, 84, 98, 100, 109
+};
+static const double cpx_jc_v[] = {
+	-1.0, -1.0, 1.0, 1.0, 2.0, -1.0, -1.0, -1.0,
+	-1.0, 1.0, 1.0, 1.0, -1.0, -1.0, 0.50, -0.50
+};
+static const int cpx_jv_i[] = {
+	0, 1, 3, 4, 7, 8, 9, 10, 12, 13, 16, 17, 54, 55, 56, 57,
+	58, 61, 62, 63, 64, 65, 66, 67, 70, 71
+};
+
+void cpx_c_jac(const double *x, double *grad){
+    grad[0] = -x[8] - x[3] + x[7] - x[1] + 1.0;
+    grad[1] = -x[4] - x[0] + 1.0;
+    grad[3] = -x[4] - x[0] + 1.0;
+    grad[4] = -x[8] - x[3] + x[7] - x[1] + 1.0;
+    grad[7] = x[4] + x[0] - 1.0;
+    grad[8] = -x[4] - x[0] + 1.0;
+    grad[9] = x[8] + x[3] - x[7] + x[1] - 1.0;
+    grad[10] = x[4] + x[0];
+    grad[12] = x[4] + x[0];
+    grad[13] = x[8] + x[3] - x[7] + x[1] - 1.0;
+    grad[16] = -x[4] - x[0];
+    grad[17] = x[4] + x[0];
+    grad[54] = x[2];
+    grad[55] = x[4];
+    grad[56] = x[0] - 1.0;
+    grad[57] = x[4];
+    grad[58] = x[8] + x[3] - x[7] + x[1] - 1.0;
+    grad[61] = -x[4];
+    grad[62] = x[4];
+    grad[63] = -x[2];
+    grad[64] = -x[4];
+    grad[65] = -x[0];
+    grad[66] = -x[4];
+    grad[67] = -x[8] - x[3] + x[7] - x[1] + 1.0;
+    grad[70] = x[4];
+    grad[71] = -x[4];
+}
+
+const sf_jac_data cpx_sf_jac = {
+	cpx_c, cpx_c_jac, 13, 9,
+	16, cpx_jc_i, cpx_jc_v,
+	26, cpx_jv_i
+};
+
+/**
+  ep: 4 x 2, 8 constant and 0 x-dependent non-zero entries
+*/
+static const int ep_jc_i[] = {
+	0, 1, 2, 3, 4, 5, 6, 7
+};
+static const double ep_jc_v[] = {
+	-1.0, 1.0, 1.0, -1.0, -1.0, -1.0, 1.0, 1.0
+};
+static const int ep_jv_i[] = {
+	0
+};
+
+void ep_c_jac(const double *x, double *grad){
+}
+
+const sf_jac_data ep_sf_jac = {
+	ep_c, ep_c_jac, 4, 2,
+	8, ep_jc_i, ep_jc_v,
+	0, ep_jv_i
+};
+
+/**
+  fl: 12 x 10, 21 constant and 0 x-dependent non-zero entries
+*/
+static const int fl_jc_i[] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 20, 32, 43, 54, 65,
+	76, 87, 98, 109, 119
+};
+static const double fl_jc_v[] = {
+	1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0,
+	1.0, 1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0,
+	-1.0, -1.0, -1.0, -1.0, 1.0
+};
+static const int fl_jv_i[] = {
+	0
+};
+
+void fl_c_jac(const double *x, double *grad){
+}
+
+const sf_jac_data fl_sf_jac = {
+	fl_c, fl_c_jac, 12, 10,
+	21, fl_jc_i, fl_jc_v,
+	0, fl_jv_i
+};
+
+/**
+  g: 7 x 5, 7 constant and 4 x-dependent non-zero entries
+*/
+static const int g_jc_i[] = {
+	11, 17, 18, 19, 23, 27, 34
+};
+static const double g_jc_v[] = {
+	-1.0, 1.0, 1.0, 2.0, -1.0, -1.0, -1.0
+};
+static const int g_jv_i[] = {
+	0, 1, 5, 6
+};
+
+void g_c_jac(const double *x, double *grad){
+    grad[0] = 1.0 - x[1];
+    grad[1] = 1.0 - x[0];
+    grad[5] = x[1] - 1.0;
+    grad[6] = x[0];
+}
+
+const sf_jac_data g_sf_jac = {
+	g_c, g_c_jac, 7, 5,
+	7, g_jc_i, g_jc_v,
+	4, g_jv_i
+};
+
+/**
+  hb: 17 x 10, 23 constant and 28 x-dependent non-zero entries
+*/
+static const int hb_jc_i[] = {
+	3, 30, 38, 40, 48, 71, 86, 97, 105, 118, 128, 132, 141, 142, 143, 146,
+	147, 151, 152, 153, 156, 157, 167
+};
+static const double hb_jc_v[] = {
+	1.0, 1.0, -1.0, -1.0, 1.0, -1.0, -1.0, -1.0,
+	-1.0, 1.50, -1.50, -1.0, 0.50, -0.50, 0.250, 0.50,
+	0.50, -0.50, 0.50, -0.250, -0.50, -0.50, 1.0
+};
+static const int hb_jv_i[] = {
+	13, 14, 23, 24, 50, 51, 56, 57, 59, 60, 61, 66, 67, 69, 110, 111,
+	112, 115, 116, 117, 119, 120, 121, 122, 125, 126, 127, 129
+};
+
+void hb_c_jac(const double *x, double *grad){
+    grad[13] = x[4] - 1.0;
+    grad[14] = x[3];
+    grad[23] = -x[4];
+    grad[24] = -x[3];
+    grad[50] = -x[6] - x[7] - x[1] + 1.0;
+    grad[51] = x[9] - x[0] + 1.0;
+    grad[56] = x[9] - x[0] + 1.0;
+    grad[57] = x[9] - x[0] + 1.0;
+    grad[59] = x[6] + x[7] + x[1] - 1.0;
+    grad[60] = x[6] + x[7] + x[1] - 1.0;
+    grad[61] = -x[9] + x[0];
+    grad[66] = -x[9] + x[0];
+    grad[67] = -x[9] + x[0];
+    grad[69] = -x[6] - x[7] - x[1] + 1.0;
+    grad[110] = -x[5] - x[2] + 1.0;
+    grad[111] = -x[9];
+    grad[112] = 1.0 - x[0];
+    grad[115] = 1.0 - x[0];
+    grad[116] = -x[9];
+    grad[117] = -x[9];
+    grad[119] = -x[6] - x[7] - x[1] + 1.0;
+    grad[120] = x[5] + x[2] - 1.0;
+    grad[121] = x[9];
+    grad[122] = x[0];
+    grad[125] = x[0];
+    grad[126] = x[9];
+    grad[127] = x[9];
+    grad[129] = x[6] + x[7] + x[1] - 1.0;
+}
+
+const sf_jac_data hb_sf_jac = {
+	hb_c, hb_c_jac, 17, 10,
+	23, hb_jc_i, hb_jc_v,
+	28, hb_jv_i
+};
+
+/**
+  ilm: 6 x 2, 10 constant and 0 x-dependent non-zero entries
+*/
+static const int ilm_jc_i[] = {
+	0, 1, 2, 3, 4, 6, 7, 8, 9, 10
+};
+static const double ilm_jc_v[] = {
+	-0.50, -0.50, -0.50, 0.50, 1.0, -0.50, 0.50, -0.50,
+	-0.50, 1.0
+};
+static const int ilm_jv_i[] = {
+	0
+};
+
+void ilm_c_jac(const double *x, double *grad){
+}
+
+const sf_jac_data ilm_sf_jac = {
+	ilm_c, ilm_c_jac, 6, 2,
+	10, ilm_jc_i, ilm_jc_v,
+	0, ilm_jv_i
+};
+
+/**
+  liq: 18 x 11, 11 constant and 30 x-dependent non-zero entries
+*/
+static const int liq_jc_i[] = {
+	97, 123, 135, 143, 155, 165, 166, 167, 168, 186, 197
+};
+static const double liq_jc_v[] = {
+	-1.0, -4.0, -4.0, -1.0, -1.0, -1.0, -1.0, -4.0,
+	-4.0, -1.0, 1.0
+};
+static const int liq_jv_i[] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 20, 22, 31, 37,
+	42, 49, 53, 61, 64, 73, 75, 85, 86, 101, 102, 108, 119, 120
+};
+
+void liq_c_jac(const double *x, double *grad){
+    grad[0] = 0.75*x[9] + 1.0;
+    grad[1] = 0.75*x[9] + 1.0;
+    grad[2] = 0.75*x[9] + 1.0;
+    grad[3] = 0.75*x[9] + 1.0;
+    grad[4] = 0.75*x[9] + 1.0;
+    grad[5] = 0.75*x[9] + 1.0;
+    grad[6] = 0.75*x[9] + 1.0;
+    grad[7] = 0.75*x[9] + 1.0;
+    grad[8] = 0.75*x[9] + 1.0;
+    grad[9] = 0.75*x[6] + 0.75*x[3] + 0.75*x[2] + 0.75*x[10] + 0.75*x[5] + 0.75*x[4] + 0.75*x[8] + 0.75*x[1] + 0.75*x[7] + 0.75*x[0] - 1.0;
+    grad[10] = 0.75*x[9] + 1.0;
+    grad[12] = -0.75*x[9] - 1.0;
+    grad[20] = 1.0 - 0.75*x[1];
+    grad[22] = -0.75*x[9] - 1.0;
+    grad[31] = 1.0 - 0.75*x[0];
+    grad[37] = -0.75*x[9] - 1.0;
+    grad[42] = -0.75*x[4];
+    grad[49] = -0.75*x[9] - 1.0;
+    grad[53] = -0.75*x[5];
+    grad[61] = -0.75*x[9] - 1.0;
+    grad[64] = -0.75*x[6];
+    grad[73] = -0.75*x[9] - 1.0;
+    grad[75] = -0.75*x[7];
+    grad[85] = -0.75*x[9] - 1.0;
+    grad[86] = -0.75*x[8];
+    grad[101] = -0.75*x[9] - 1.0;
+    grad[102] = -0.75*x[9] - 1.0;
+    grad[108] = -0.75*x[3] - 0.75*x[2];
+    grad[119] = 0.75*x[10];
+    grad[120] = 0.75*x[9] + 1.0;
+}
+
+const sf_jac_data liq_sf_jac = {
+	liq_c, liq_c_jac, 18, 11,
+	11, liq_jc_i, liq_jc_v,
+	30, liq_jv_i
+};
+
+/**
+  mu: 10 x 5, 11 constant and 4 x-dependent non-zero entries
+*/
+static const int mu_jc_i[] = {
+	3, 4, 8, 14, 26, 32, 37, 41, 44, 46, 49
+};
+static const double mu_jc_v[] = {
+	1.0, 1.0, -1.0, -1.0, -1.0, 1.0, -1.0, 0.50,
+	0.50, -0.50, -0.50
+};
+static const int mu_jv_i[] = {
+	15, 16, 20, 21
+};
+
+void mu_c_jac(const double *x, double *grad){
+    grad[15] = 1.0 - x[1];
+    grad[16] = 1.0 - x[0];
+    grad[20] = x[1] - 1.0;
+    grad[21] = x[0];
+}
+
+const sf_jac_data mu_sf_jac = {
+	mu_c, mu_c_jac, 10, 5,
+	11, mu_jc_i, mu_jc_v,
+	4, mu_jv_i
+};
+
+/**
+  ol: 5 x 3, 7 constant and 4 x-dependent non-zero entries
+*/
+static const int ol_jc_i[] = {
+	0, 2, 3, 5, 8, 11, 13
+};
+static const double ol_jc_v[] = {
+	1.0, -1.0, -1.0, 1.0, 1.0, -1.0, -1.0
+};
+static const int ol_jv_i[] = {
+	6, 7, 9, 10
+};
+
+void ol_c_jac(const double *x, double *grad){
+    grad[6] = 1.0 - x[1];
+    grad[7] = 1.0 - x[0];
+    grad[9] = x[1] - 1.0;
+    grad[10] = x[0];
+}
+
+const sf_jac_data ol_sf_jac = {
+	ol_c, ol_c_jac, 5, 3,
+	7, ol_jc_i, ol_jc_v,
+	4, ol_jv_i
+};
+
+/**
+  opx: 12 x 8, 12 constant and 22 x-dependent non-zero entries
+*/
+static const int opx_jc_i[] = {
+	17, 20, 21, 22, 23, 28, 38, 45, 66, 79, 81, 89
+};
+static const double opx_jc_v[] = {
+	-1.0, 1.0, 2.0, 1.0, -1.0, -1.0, -1.0, -1.0,
+	-1.0, -1.0, 0.50, -0.50
+};
+static const int opx_jv_i[] = {
+	0, 1, 3, 5, 7, 8, 9, 11, 13, 15, 48, 49, 50, 51, 53, 55,
+	56, 57, 58, 59, 61, 63
+};
+
+void opx_c_jac(const double *x, double *grad){
+    grad[0] = -x[7] + x[5] - x[1] + 1.0;
+    grad[1] = -x[3] - x[0] + 1.0;
+    grad[3] = -x[7] + x[5] - x[1] + 1.0;
+    grad[5] = x[3] + x[0] - 1.0;
+    grad[7] = -x[3] - x[0] + 1.0;
+    grad[8] = x[7] - x[5] + x[1] - 1.0;
+    grad[9] = x[3] + x[0];
+    grad[11] = x[7] - x[5] + x[1] - 1.0;
+    grad[13] = -x[3] - x[0];
+    grad[15] = x[3] + x[0];
+    grad[48] = -x[2] - x[7] + 1.0;
+    grad[49] = x[3];
+    grad[50] = 1.0 - x[0];
+    grad[51] = x[7] - x[5] + x[1] - 1.0;
+    grad[53] = -x[3];
+    grad[55] = x[3] - x[0] + 1.0;
+    grad[56] = x[2] + x[7] - 1.0;
+    grad[57] = -x[3];
+    grad[58] = x[0];
+    grad[59] = -x[7] + x[5] - x[1] + 1.0;
+    grad[61] = x[3];
+    grad[63] = -x[3] + x[0];
+}
+
+const sf_jac_data opx_sf_jac = {
+	opx_c, opx_c_jac, 12, 8,
+	12, opx_jc_i, opx_jc_v,
+	22, opx_jv_i
+};
+
+/**
+  pl4T: 5 x 2, 6 constant and 0 x-dependent non-zero entries
+*/
+static const int pl4T_jc_i[] = {
+	0, 1, 2, 5, 6, 8
+};
+static const double pl4T_jc_v[] = {
+	1.0, 1.0, -1.0, -1.0, -0.250, 0.250
+};
+static const int pl4T_jv_i[] = {
+	0
+};
+
+void pl4T_c_jac(const double *x, double *grad){
+}
+
+const sf_jac_data pl4T_sf_jac = {
+	pl4T_c, pl4T_c_jac, 5, 2,
+	6, pl4T_jc_i, pl4T_jc_v,
+	0, pl4T_jv_i
+};
+
+/**
+  spn: 10 x 7, 14 constant and 20 x-dependent non-zero entries
+*/
+static const int spn_jc_i[] = {
+	4, 12, 18, 19, 20, 27, 32, 40, 46, 47, 48, 55, 58, 66
+};
+static const double spn_jc_v[] = {
+	-2.0/3.0, -2.0/3.0, 2.0/3.0, 2.0/3.0, 2.0/3.0, -2.0/3.0, 1.0/3.0, 1.0/3.0,
+	-1.0/3.0, -1.0/3.0, -1.0/3.0, 1.0/3.0, -1.0, -0.50
+};
+static const int spn_jv_i[] = {
+	0, 3, 7, 10, 15, 16, 17, 22, 23, 24, 28, 31, 35, 38, 43, 44,
+	45, 50, 51, 52
+};
+
+void spn_c_jac(const double *x, double *grad){
+    grad[0] = 1.0/3.0*x[3] + 1.0/3.0;
+    grad[3] = 1.0/3.0*x[0] - 1.0/3.0;
+    grad[7] = -1.0/3.0*x[3] - 1.0/3.0;
+    grad[10] = -1.0/3.0*x[0];
+    grad[15] = -2.0/3.0*x[2] - 2.0/3.0*x[3] + 2.0/3.0;
+    grad[16] = -2.0/3.0*x[1];
+    grad[17] = 1.0/3.0 - 2.0/3.0*x[1];
+    grad[22] = 2.0/3.0*x[2] + 2.0/3.0*x[3] - 2.0/3.0;
+    grad[23] = 2.0/3.0*x[1];
+    grad[24] = 2.0/3.0*x[1];
+    grad[28] = 1.0/3.0*x[3] + 1.0/3.0;
+    grad[31] = 1.0/3.0*x[0] - 1.0/3.0;
+    grad[35] = -1.0/3.0*x[3] - 1.0/3.0;
+    grad[38] = -1.0/3.0*x[0];
+    grad[43] = -2.0/3.0*x[2] - 2.0/3.0*x[3] + 2.0/3.0;
+    grad[44] = 1.0 - 2.0/3.0*x[1];
+    grad[45] = 5.0/6.0 - 2.0/3.0*x[1];
+    grad[50] = 2.0/3.0*x[2] + 2.0/3.0*x[3] - 2.0/3.0;
+    grad[51] = 2.0/3.0*x[1];
+    grad[52] = 2.0/3.0*x[1];
+}
+
+const sf_jac_data spn_sf_jac = {
+	spn_c, spn_c_jac, 10, 7,
+	14, spn_jc_i, spn_jc_v,
+	20, spn_jv_i
+};
+
+/**
+  bi: 10 x 5, 14 constant and 8 x-dependent non-zero entries
+*/
+static const int bi_jc_i[] = {
+	4, 9, 12, 18, 21, 25, 29, 30, 34, 36, 37, 41, 42, 48
+};
+static const double bi_jc_v[] = {
+	2.0/3.0, -2.0/3.0, -1.0, -1.0, -1.0, 1.0, -1.0/3.0, -1.0,
+	1.0/3.0, 0.50, 0.50, -0.50, -0.50, 1.0
+};
+static const int bi_jv_i[] = {
+	0, 1, 2, 3, 5, 6, 7, 8
+};
+
+void bi_c_jac(const double *x, double *grad){
+    grad[0] = -x[2] - x[3] - x[1] + 1.0;
+    grad[1] = 1.0 - x[0];
+    grad[2] = 1.0 - x[0];
+    grad[3] = 1.0 - x[0];
+    grad[5] = x[2] + x[3] + x[1] - 1.0;
+    grad[6] = x[0];
+    grad[7] = x[0];
+    grad[8] = x[0];
+}
+
+const sf_jac_data bi_sf_jac = {
+	bi_c, bi_c_jac, 10, 5,
+	14, bi_jc_i, bi_jc_v,
+	8, bi_jv_i
+};
+
+/**
+  cd: 4 x 2, 4 constant and 0 x-dependent non-zero entries
+*/
+static const int cd_jc_i[] = {
+	0, 2, 5, 7
+};
+static const double cd_jc_v[] = {
+	-1.0, 1.0, -1.0, 1.0
+};
+static const int cd_jv_i[] = {
+	0
+};
+
+void cd_c_jac(const double *x, double *grad){
+}
+
+const sf_jac_data cd_sf_jac = {
+	cd_c, cd_c_jac, 4, 2,
+	4, cd_jc_i, cd_jc_v,
+	0, cd_jv_i
+};
@@ -0,0 +1,60 @@
+#ifndef __SF_JACOBIAN_H_
+#define __SF_JACOBIAN_H_
+
+void cpx_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void cpx_c_jac(const double *x, double *grad);
+extern const sf_jac_data cpx_sf_jac;
+
+void ep_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void ep_c_jac(const double *x, double *grad);
+extern const sf_jac_data ep_sf_jac;
+
+void fl_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void fl_c_jac(const double *x, double *grad);
+extern const sf_jac_data fl_sf_jac;
+
+void g_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void g_c_jac(const double *x, double *grad);
+extern const sf_jac_data g_sf_jac;
+
+void hb_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void hb_c_jac(const double *x, double *grad);
+extern const sf_jac_data hb_sf_jac;
+
+void ilm_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void ilm_c_jac(const double *x, double *grad);
+extern const sf_jac_data ilm_sf_jac;
+
+void liq_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void liq_c_jac(const double *x, double *grad);
+extern const sf_jac_data liq_sf_jac;
+
+void mu_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void mu_c_jac(const double *x, double *grad);
+extern const sf_jac_data mu_sf_jac;
+
+void ol_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void ol_c_jac(const double *x, double *grad);
+extern const sf_jac_data ol_sf_jac;
+
+void opx_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void opx_c_jac(const double *x, double *grad);
+extern const sf_jac_data opx_sf_jac;
+
+void pl4T_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void pl4T_c_jac(const double *x, double *grad);
+extern const sf_jac_data pl4T_sf_jac;
+
+void spn_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void spn_c_jac(const double *x, double *grad);
+extern const sf_jac_data spn_sf_jac;
+
+void bi_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void bi_c_jac(const double *x, double *grad);
+extern const sf_jac_data bi_sf_jac;
+
+void cd_c(unsigned m, double *result, unsigned n, const double *x, double *grad, void *data);
+void cd_c_jac(const double *x, double *grad);
+extern const sf_jac_data cd_sf_jac;
+
+#endif
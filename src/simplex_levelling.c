@@ -32,7 +32,7 @@ Levelling occurs in two stages:
 #include "nlopt.h"
 #include "toolkit.h"
 #include "PGE_function.h"
-#include "SS_xeos_PC.h"
+#include "batch_levelling_function.h"
 
 /**
   Get the number of max_pc
@@ -58,44 +58,91 @@ void update_local_gamma(	double *A1,
 	}
 };
 
+/**
+	objective function of a solution phase, NULL if the phase is not in the database
+*/
+obj_type SS_objective_function(		char 				*name 			){
+
+	if      (strcmp( name, "bi")  == 0 ){
+		return obj_bi; 		}
+	else if (strcmp( name, "cd")  == 0){
+		return obj_cd; 		}
+	else if (strcmp( name, "cpx") == 0){
+		return obj_cpx; 	}
+	else if (strcmp( name, "ep")  == 0){
+		return obj_ep; 		}
+	else if (strcmp( name, "fl")  == 0){
+		return obj_fl; 		}
+	else if (strcmp( name, "g")   == 0){
+		return obj_g; 		}
+	else if (strcmp( name, "hb")  == 0){
+		return obj_hb; 		}
+	else if (strcmp( name, "ilm") == 0){
+		return obj_ilm; 	}
+	else if (strcmp( name, "liq") == 0){
+		return obj_liq; 	}
+	else if (strcmp( name, "mu")  == 0){
+		return obj_mu; 		}
+	else if (strcmp( name, "ol")  == 0){
+		return obj_ol; 		}
+	else if (strcmp( name, "opx") == 0){
+		return obj_opx; 	}
+	else if (strcmp( name, "pl4T") == 0){
+		return obj_pl4T; 	}
+	else if (strcmp( name, "spn") == 0){
+		return obj_spn; 	}
+
+	return NULL;
+}
+
+/**
+	analytic Hessian of the objective function of a solution phase, NULL if the phase is not in the database
+*/
+hess_type SS_hessian_function(		char 				*name 			){
+
+	if      (strcmp( name, "bi")  == 0 ){
+		return hess_bi; 	}
+	else if (strcmp( name, "cd")  == 0){
+		return hess_cd; 	}
+	else if (strcmp( name, "cpx") == 0){
+		return hess_cpx; 	}
+	else if (strcmp( name, "ep")  == 0){
+		return hess_ep; 	}
+	else if (strcmp( name, "fl")  == 0){
+		return hess_fl; 	}
+	else if (strcmp( name, "g")   == 0){
+		return hess_g; 		}
+	else if (strcmp( name, "hb")  == 0){
+		return hess_hb; 	}
+	else if (strcmp( name, "ilm") == 0){
+		return hess_ilm; 	}
+	else if (strcmp( name, "liq") == 0){
+		return hess_liq; 	}
+	else if (strcmp( name, "mu")  == 0){
+		return hess_mu; 	}
+	else if (strcmp( name, "ol")  == 0){
+		return hess_ol; 	}
+	else if (strcmp( name, "opx") == 0){
+		return hess_opx; 	}
+	else if (strcmp( name, "pl4T") == 0){
+		return hess_pl4T; 	}
+	else if (strcmp( name, "spn") == 0){
+		return hess_spn; 	}
+
+	return NULL;
+}
+
 /**
 	associate the array of pointer with the right solution phase
 */
 void SS_objective_init_function(	obj_type 			*SS_objective,
-									global_variable 	 gv				){	
+									global_variable 	*gv				){	
 						 
-	for (int iss = 0; iss < gv.len_ss; iss++){
-
-		if      (strcmp( gv.SS_list[iss], "bi")  == 0 ){
-			SS_objective[iss]  = obj_bi; 		}
-		else if (strcmp( gv.SS_list[iss], "cd")  == 0){
-			SS_objective[iss]  = obj_cd; 		}
-		else if (strcmp( gv.SS_list[iss], "cpx") == 0){
-			SS_objective[iss]  = obj_cpx; 		}
-		else if (strcmp( gv.SS_list[iss], "ep")  == 0){
-			SS_objective[iss]  = obj_ep; 		}
-		else if (strcmp( gv.SS_list[iss], "fl")  == 0){
-			SS_objective[iss]  = obj_fl; 		}
-		else if (strcmp( gv.SS_list[iss], "g")   == 0){
-			SS_objective[iss]  = obj_g; 		}
-		else if (strcmp( gv.SS_list[iss], "hb")  == 0){
-			SS_objective[iss]  = obj_hb; 		}
-		else if (strcmp( gv.SS_list[iss], "ilm") == 0){
-			SS_objective[iss]  = obj_ilm; 		}
-		else if (strcmp( gv.SS_list[iss], "liq") == 0){
-			SS_objective[iss]  = obj_liq; 		}
-		else if (strcmp( gv.SS_list[iss], "mu")  == 0){
-			SS_objective[iss]  = obj_mu; 		}
-		else if (strcmp( gv.SS_list[iss], "ol")  == 0){
-			SS_objective[iss]  = obj_ol; 		}
-		else if (strcmp( gv.SS_list[iss], "opx") == 0){
-			SS_objective[iss]  = obj_opx; 		}
-		else if (strcmp( gv.SS_list[iss], "pl4T") == 0){
-			SS_objective[iss]  = obj_pl4T; 		}
-		else if (strcmp( gv.SS_list[iss], "spn") == 0){
-			SS_objective[iss]  = obj_spn; 		}
-		else{
-			printf("\nsolid solution '%s' is not in the database, cannot be initiated\n", gv.SS_list[iss]);	
+	for (int iss = 0; iss < gv->len_ss; iss++){
+		SS_objective[iss] = SS_objective_function(gv->SS_list[iss]);
+
+		if (SS_objective[iss] == NULL){
+			printf("\nsolid solution '%s' is not in the database, cannot be initiated\n", gv->SS_list[iss]);	
 		}	
 	};			
 }
@@ -115,45 +162,12 @@ simplex_data update_global_gamma( 		struct bulk_info 	z_b,
 	return splx_data;
 };
 
-/**
-  function to calculate delta G (position of potential phases with current G hyperplane*)
-*/
-simplex_data update_dG(	simplex_data splx_data
-){
-	double F;
-	double minF = 0.0;
-
-	VecMatMul(	splx_data.B1,
-				splx_data.A1,
-				splx_data.B,
-				splx_data.n_Ox	);
-	
-	splx_data.dG_B = splx_data.g0_B;
-	for (int j = 0; j < splx_data.n_Ox; j++){
-		splx_data.dG_B -= splx_data.B1[j]*splx_data.g0_A[j];
-	}
-	
-	splx_data.ph2swp = -1;	
-	if (splx_data.dG_B < -1e-6){	
-		splx_data.min_F  =  1e6;												/** max value for F, tentative here because F can tend to +inf */
-		for (int i = 0; i < splx_data.n_Ox; i++){
-			F = (splx_data.n_vec[i])/splx_data.B1[i];
-			if (F < splx_data.min_F && F > minF){
-				splx_data.min_F  = F;
-				splx_data.ph2swp = i;
-			}
-		}
-	}
-
-	return splx_data;
-}
-
 /**
   function to allocate memory for simplex linear programming (A)
 */	
 simplex_data init_simplex_A(
 	simplex_data splx_data,
-	global_variable gv,
+	global_variable *gv,
 	struct bulk_info z_b
 ){
 	/* allocate reference assemblage memory */
@@ -162,8 +176,12 @@ simplex_data init_simplex_A(
 	splx_data.ph2swp      = -1;
 	splx_data.n_swp       =  0;
 	splx_data.swp         =  0;
+	splx_data.n_upd       =  0;
+	splx_data.n_degen     =  0;
+	splx_data.blk         =  0;
+	memset(&splx_data.stat, 0, sizeof(lvl_stat));
 	splx_data.n_Ox        =  z_b.nzEl_val;
-	splx_data.len_ox      =  gv.len_ox;
+	splx_data.len_ox      =  gv->len_ox;
 	
 	splx_data.A           = malloc ((splx_data.n_Ox*splx_data.n_Ox)  * sizeof(double));
 	splx_data.A1  		  = malloc ((splx_data.n_Ox*splx_data.n_Ox)  * sizeof(double));
@@ -214,18 +232,18 @@ simplex_data init_simplex_A(
   function to allocate memory for simplex linear programming (B)
 */	
 simplex_data init_simplex_B_em(		simplex_data 		 splx_data,
-									global_variable 	 gv,
+									global_variable 	*gv,
 									struct bulk_info 	 z_b,
 
 									PP_ref 				*PP_ref_db,
 									SS_ref 				*SS_ref_db
 ){
-	splx_data.ph_id_B    = malloc (3  * sizeof(int));
+	splx_data.ph_id_B    = malloc (4  * sizeof(int));
 	splx_data.B   	 	 = malloc ((splx_data.n_Ox) * sizeof(double));
 	splx_data.B1   	 	 = malloc ((splx_data.n_Ox) * sizeof(double));
 
 	/** initialize arrays */
-	for (int j = 0; j < 3; j++){
+	for (int j = 0; j < 4; j++){
 		splx_data.ph_id_B[j] = 0;
 	}
 
@@ -242,7 +260,7 @@ simplex_data init_simplex_B_em(		simplex_data 		 splx_data,
 */	
 simplex_data fill_simplex_arrays_A(		struct bulk_info 	 z_b,
 										simplex_data 		 splx_data,
-										global_variable 	 gv,
+										global_variable 	*gv,
 										
 										PP_ref 				*PP_ref_db,
 										SS_ref 				*SS_ref_db
@@ -262,7 +280,7 @@ simplex_data fill_simplex_arrays_A(		struct bulk_info 	 z_b,
 	print levelling informations 
 */
 void print_levelling(		struct bulk_info 	 z_b,
-							global_variable 	 gv,
+							global_variable 	*gv,
 							
 							PP_ref 				*PP_ref_db,
 							SS_ref 				*SS_ref_db
@@ -272,19 +290,19 @@ void print_levelling(		struct bulk_info 	 z_b,
 	printf("\n");
 	printf("DISPLAY SWAP NUMBER FOR EACH PC\n");
 	printf("-------------------------------\n");
-	for (int i = 0; i < gv.len_ss; i++){
+	for (int i = 0; i < gv->len_ss; i++){
 
 		int n_em = SS_ref_db[i].n_em;
 		max_n_pc = get_max_n_pc(SS_ref_db[i].tot_pc, SS_ref_db[i].n_pc);	
 
 		for (int l = 0; l < max_n_pc; l++){
 			SS_ref_db[i].DF_pc[l] = SS_ref_db[i].G_pc[l];
-			for (int j = 0; j < gv.len_ox; j++) {
-				SS_ref_db[i].DF_pc[l] -= SS_ref_db[i].comp_pc[l][j]*gv.gam_tot[j];
+			for (int j = 0; j < gv->len_ox; j++) {
+				SS_ref_db[i].DF_pc[l] -= SS_ref_db[i].comp_pc[l][j]*gv->gam_tot[j];
 			}
 			
 			if (SS_ref_db[i].DF_pc[l] < 1.0){
-				printf(" %4s %04d  #swap: %04d #stage %04d | ",gv.SS_list[i],l,SS_ref_db[i].n_swap[l],SS_ref_db[i].info[l]);
+				printf(" %4s %04d  #swap: %04d #stage %04d | ",gv->SS_list[i],l,SS_ref_db[i].n_swap[l],SS_ref_db[i].info[l]);
 				printf("DF: %+4f | ", SS_ref_db[i].DF_pc[l]);
 				//for (int j = 0; j < SS_ref_db[i].n_xeos; j++){
 					//printf(" %+4f",SS_ref_db[i].xeos_pc[l][j]);
@@ -295,8 +313,8 @@ void print_levelling(		struct bulk_info 	 z_b,
 				//printf(" | ");
 
 				for (int j = 0; j < SS_ref_db[i].n_em; j++){
-					//for (int k = 0; k < gv.len_ox; k++) {
-						//SS_ref_db[i].mu_pc[l][j] -= SS_ref_db[i].comp_pc[l][k]*gv.gam_tot[k];
+					//for (int k = 0; k < gv->len_ox; k++) {
+						//SS_ref_db[i].mu_pc[l][j] -= SS_ref_db[i].comp_pc[l][k]*gv->gam_tot[k];
 					//}
 					printf(" %+4f",SS_ref_db[i].mu_pc[l][j]);
 				}
@@ -323,7 +341,7 @@ void print_levelling(		struct bulk_info 	 z_b,
 void generate_pseudocompounds(	int 		 		 ss,
 								simplex_data 		 splx_data,
 								struct bulk_info 	 z_b,
-								global_variable 	 gv,
+								global_variable 	*gv,
 								SS_ref 				*SS_ref_db,
 								PC_ref 				*SS_PC_xeos,
 								obj_type 			*SS_objective				){
@@ -338,7 +356,7 @@ void generate_pseudocompounds(	int 		 		 ss,
 		SS_ref_db[ss].gb_lvl[k] = SS_ref_db[ss].gbase[k];
 	}
 						
-	for (int k = 0; k < gv.n_SS_PC[ss]; k++){
+	for (int k = 0; k < gv->n_SS_PC[ss]; k++){
 		get_ss_pv = SS_PC_xeos[ss].ss_pc_xeos[k]; 
 		
 		/* TMP, not so elegant way to deal with cases were an oxide of the bulk rock composition = 0.0 */	
@@ -348,9 +366,10 @@ void generate_pseudocompounds(	int 		 		 ss,
 			}
 		}
 		G 	= (*SS_objective[ss])(SS_ref_db[ss].n_xeos, get_ss_pv.xeos_pc, 	NULL, &SS_ref_db[ss]);
+		SS_ref_db[ss].n_pc_gen += 1;
 
 		/** store pseudocompound */
-		if ( G < gv.max_G_pc ){
+		if ( G < gv->max_G_pc ){
 
 			/* get composition of solution phase */
 			for (j = 0; j < nEl; j++){
@@ -370,7 +389,7 @@ void generate_pseudocompounds(	int 		 		 ss,
 				SS_ref_db[ss].DF_pc[m_pc]     = G;
 				
 				/* get pseudocompound composition */
-				for ( j = 0; j < gv.len_ox; j++){				
+				for ( j = 0; j < gv->len_ox; j++){				
 					SS_ref_db[ss].comp_pc[m_pc][j] = SS_ref_db[ss].ss_comp[j]*SS_ref_db[ss].factor;	/** composition */
 				}
 				for ( j = 0; j < SS_ref_db[ss].n_em; j++){												/** save coordinates */
@@ -387,10 +406,39 @@ void generate_pseudocompounds(	int 		 		 ss,
 				/* add increment to the number of considered phases */
 				SS_ref_db[ss].tot_pc += 1;
 				SS_ref_db[ss].id_pc  += 1;
+				SS_ref_db[ss].n_pc_kept += 1;
 				swp = 1;	
 			}	
 		}
 	}
+	SS_ref_db[ss].fbc_pc = z_b.fbc;
+}
+
+/**
+	Rescale the pseudocompounds kept from the previous point (same P-T conditions and zero oxides).
+	Gibbs energy and composition of the pseudocompounds only depend on the bulk-rock through the
+	normalization factor fbc/sum_apep, the x-eos, p and the k-d tree remain valid.
+*/
+void rescale_pseudocompounds(	int 		 		 ss,
+								struct bulk_info 	 z_b,
+								SS_ref 				*SS_ref_db					){
+	
+	double ratio 	= z_b.fbc/SS_ref_db[ss].fbc_pc;
+	int max_n_pc 	= get_max_n_pc(	SS_ref_db[ss].tot_pc,
+									SS_ref_db[ss].n_pc		);
+
+	for (int l = 0; l < max_n_pc; l++){
+		SS_ref_db[ss].info[l]       = 0;
+		SS_ref_db[ss].n_swap[l]     = 0;
+		SS_ref_db[ss].factor_pc[l] *= ratio;
+		SS_ref_db[ss].G_pc[l] 	   *= ratio;
+		SS_ref_db[ss].DF_pc[l]      = SS_ref_db[ss].G_pc[l];
+		for (int j = 0; j < nEl; j++){
+			SS_ref_db[ss].comp_pc[l][j] *= ratio;
+		}
+	}
+	SS_ref_db[ss].fbc_pc 	 = z_b.fbc;
+	SS_ref_db[ss].n_pc_kept  = max_n_pc;
 }
 
 
@@ -398,11 +446,11 @@ void generate_pseudocompounds(	int 		 		 ss,
   Get bounds for pseudocompounds compositional bounds after levelling
 */
 void reduce_ss_list( SS_ref 			*SS_ref_db,
-					 global_variable 	 gv				){
+					 global_variable 	*gv				){
 						 
 	int max_n_pc;			 
 	int phase_on;
-	for (int iss = 0; iss < gv.len_ss; iss++){										/**loop to pass informations from active endmembers */
+	for (int iss = 0; iss < gv->len_ss; iss++){										/**loop to pass informations from active endmembers */
 		if (SS_ref_db[iss].ss_flags[0] == 1){
 			phase_on = 0;
 			
@@ -410,14 +458,14 @@ void reduce_ss_list( SS_ref 			*SS_ref_db,
 			
 			for (int l = 0; l < max_n_pc; l++){
 				/* if the driving force of the pseudocompound is lower to the filter then consider it */
-				if (SS_ref_db[iss].DF_pc[l]*SS_ref_db[iss].factor_pc[l] < gv.bnd_filter_pc){
+				if (SS_ref_db[iss].DF_pc[l]*SS_ref_db[iss].factor_pc[l] < gv->bnd_filter_pc){
 					phase_on = 1;
 				}	
 			}
 			/* if no generated pseudocompound are close to the hyperplane then turn off the solution phase */
 			if (phase_on == 0){
-				if (gv.verbose != 2){
-					printf("  -> deleted = %s\n",gv.SS_list[iss]);
+				if (gv->verbose != 2){
+					printf("  -> deleted = %s\n",gv->SS_list[iss]);
 				}
 				SS_ref_db[iss].ss_flags[0] = 0;
 				SS_ref_db[iss].ss_flags[1] = 0;
@@ -435,28 +483,45 @@ void reduce_ss_list( SS_ref 			*SS_ref_db,
 simplex_data filter_hld_PC(			int 				refine_lvl,
 									struct bulk_info 	z_b,
 									simplex_data 		splx_data,
-									global_variable 	gv,
+									global_variable 	*gv,
 									SS_ref 			   *SS_ref_db					
 ){
-	if (gv.verbose == 1){
+	if (gv->verbose == 1){
 		printf("   [Filter nearly idendical PC]\n");
 	}
-	int i,j,k,l;
-	int max_n_pc;
-	double distance;
+	int i,k,l,m;
+	int max_n_pc, n_nb;
 
-	for (i = 0; i < gv.len_ss; i++){
+	for (i = 0; i < gv->len_ss; i++){
 		if (SS_ref_db[i].ss_flags[0] == 1){
 			max_n_pc = get_max_n_pc(	SS_ref_db[i].tot_pc,
 										SS_ref_db[i].n_pc		);
-										
+			
+			if (SS_ref_db[i].kd_n != max_n_pc){
+				kdtree_build(			SS_ref_db[i].kd_idx,
+										SS_ref_db[i].xeos_pc,
+										max_n_pc,
+										SS_ref_db[i].n_xeos		);
+				SS_ref_db[i].kd_n = max_n_pc;
+			}
+			
+			/* a PC is filtered out when a following (not filtered) PC lies within the distance criterion */
 			for (k = 0; k < max_n_pc; k++){
-				for (l = k+1; l < max_n_pc; l++){
-					if (SS_ref_db[i].info[k] != -1 && SS_ref_db[i].info[l] != -1){
-						distance 	= partial_euclidean_distance( SS_ref_db[i].xeos_pc[k], SS_ref_db[i].xeos_pc[l], SS_ref_db[i].n_xeos);
-						if (distance < 1e-2){
+				if (SS_ref_db[i].info[k] != -1){
+					n_nb = kdtree_radius_search(	SS_ref_db[i].kd_idx,
+													SS_ref_db[i].xeos_pc,
+													max_n_pc,
+													SS_ref_db[i].n_xeos,
+													SS_ref_db[i].xeos_pc[k],
+													1e-2,
+													SS_ref_db[i].kd_nb		);
+					for (m = 0; m < n_nb; m++){
+						l = SS_ref_db[i].kd_nb[m];
+						if (l > k && SS_ref_db[i].info[l] != -1){
 							SS_ref_db[i].info[k] = -1;
-							splx_data.n_filter += 1;
+							SS_ref_db[i].n_pc_filt += 1;
+							splx_data.n_filter  += 1;
+							break;
 						}
 					}
 				}
@@ -469,19 +534,19 @@ simplex_data filter_hld_PC(			int 				refine_lvl,
 
 
 
-global_variable update_global_info(		struct bulk_info 	 z_b,
-										simplex_data 		 splx_data,
-										global_variable 	 gv,
+void update_global_info(		struct bulk_info 	 z_b,
+								simplex_data 		 splx_data,
+								global_variable 	*gv,
 										
-										PP_ref 				*PP_ref_db,
-										SS_ref 				*SS_ref_db,
-										csd_phase_set  		*cp,
-										obj_type 			*SS_objective
+								PP_ref 				*PP_ref_db,
+								SS_ref 				*SS_ref_db,
+								csd_phase_set  		*cp,
+								obj_type 			*SS_objective
 ){
 	
 	/* copy gamma total to the global variables */
-	for (int i = 0; i < gv.len_ox; i++){
-		gv.gam_tot[i] = splx_data.gamma_tot[i];
+	for (int i = 0; i < gv->len_ox; i++){
+		gv->gam_tot[i] = splx_data.gamma_tot[i];
 	}
 
 	double distance;
@@ -493,10 +558,10 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 	int pc_id;
 	int em_id;
 	int add_phase;
-	int phase_on[gv.len_ss];
+	int *phase_on = gv->ws.phase_on;
 	
 	/* initialiaze phase active in the considered assemblage */
-	for (int i = 0; i < gv.len_ss; i++){
+	for (int i = 0; i < gv->len_ss; i++){
 		phase_on[i] = 0;
 	}
 
@@ -509,11 +574,11 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 			
 		/* if phase is a pure species */
 		if (splx_data.ph_id_A[i][0] == 1 ){
-			gv.pp_flags[ph_id][1] 	= 1;
-			gv.pp_flags[ph_id][2] 	= 0;
-			gv.pp_n[ph_id]          = splx_data.n_vec[i];
-			gv.n_pp_phase		   += 1;
-			gv.n_phase 			   += 1;
+			gv->pp_flags[ph_id][1] 	= 1;
+			gv->pp_flags[ph_id][2] 	= 0;
+			gv->pp_n[ph_id]          = splx_data.n_vec[i];
+			gv->n_pp_phase		   += 1;
+			gv->n_phase 			   += 1;
 		}
 		/* pure endmembers as solution phase */
 		if (splx_data.ph_id_A[i][0] == 2){
@@ -521,21 +586,21 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 			em_id 					= splx_data.ph_id_A[i][3];
 
 			for (int j = 0; j < SS_ref_db[ph_id].n_em; j++) {	
-				SS_ref_db[ph_id].p[j] = gv.em2ss_shift;
+				SS_ref_db[ph_id].p[j] = gv->em2ss_shift;
 			}
-			SS_ref_db[ph_id].p[em_id] = 1.0 - gv.em2ss_shift*SS_ref_db[ph_id].n_em;
+			SS_ref_db[ph_id].p[em_id] = 1.0 - gv->em2ss_shift*SS_ref_db[ph_id].n_em;
 			
 			SS_ref_db[ph_id] = P2X(			gv,
 											SS_ref_db[ph_id],
 											z_b,
-											gv.SS_list[ph_id]		);
+											gv->SS_list[ph_id]		);
 
-			SS_ref_db[ph_id] = PC_function(	gv,
-											SS_ref_db[ph_id], 
-											z_b,
-											gv.SS_list[ph_id] 		);
+			PC_function(	gv,
+							&SS_ref_db[ph_id], 
+							z_b,
+							gv->SS_list[ph_id] 		);
 											
-			strcpy(cp[id_cp].name,gv.SS_list[ph_id]);				/* get phase name */	
+			strcpy(cp[id_cp].name,gv->SS_list[ph_id]);				/* get phase name */	
 			
 			cp[id_cp].split 		= 0;							
 			cp[id_cp].id 			= ph_id;						/* get phase id */
@@ -562,12 +627,12 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 				cp[id_cp].xeos[ii]    = SS_ref_db[ph_id].iguess[ii];
 			}
 	
-			gv.id_solvi[ph_id][gv.n_solvi[ph_id]] = id_cp;
-			gv.n_solvi[ph_id] 	   += 1;
+			gv->id_solvi[ph_id][gv->n_solvi[ph_id]] = id_cp;
+			gv->n_solvi[ph_id] 	   += 1;
 			id_cp 				   += 1;
-			gv.len_cp 			   += 1;
-			gv.n_cp_phase 		   += 1;
-			gv.n_phase             += 1;
+			gv->len_cp 			   += 1;
+			gv->n_cp_phase 		   += 1;
+			gv->n_phase             += 1;
 		}
 		
 		/* solution phase */
@@ -575,7 +640,7 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 			pc_id 					= splx_data.ph_id_A[i][3];
 			phase_on[ph_id] 		= 1;
 			
-			strcpy(cp[id_cp].name,gv.SS_list[ph_id]);				/* get phase name */	
+			strcpy(cp[id_cp].name,gv->SS_list[ph_id]);				/* get phase name */	
 			
 			cp[id_cp].split 		= 0;							
 			cp[id_cp].id 			= ph_id;						/* get phase id */
@@ -602,12 +667,12 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 				cp[id_cp].lvlxeos[ii] = SS_ref_db[ph_id].xeos_pc[pc_id][ii];
 			}
 
-			gv.id_solvi[ph_id][gv.n_solvi[ph_id]] = id_cp;
-			gv.n_solvi[ph_id] 	   += 1;
+			gv->id_solvi[ph_id][gv->n_solvi[ph_id]] = id_cp;
+			gv->n_solvi[ph_id] 	   += 1;
 			id_cp 				   += 1;
-			gv.len_cp 			   += 1;
-			gv.n_cp_phase 		   += 1;
-			gv.n_phase             += 1;
+			gv->len_cp 			   += 1;
+			gv->n_cp_phase 		   += 1;
+			gv->n_phase             += 1;
 		}
 	}
 
@@ -616,7 +681,7 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 	*/
 	int max_n_pc;
 	double pc_df;
-	for (int i = 0; i < gv.len_ss; i++){
+	for (int i = 0; i < gv->len_ss; i++){
 		ph_id = i;
 		if (phase_on[i] == 0 && SS_ref_db[i].ss_flags[0] == 1){
 			pc_id	 = -1;
@@ -631,7 +696,7 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 			}
 			
 			if (pc_id != -1){
-				strcpy(cp[id_cp].name,gv.SS_list[ph_id]);				/* get phase name */	
+				strcpy(cp[id_cp].name,gv->SS_list[ph_id]);				/* get phase name */	
 				
 				cp[id_cp].id 			= ph_id;						/* get phaseid */
 				cp[id_cp].n_xeos		= SS_ref_db[ph_id].n_xeos;		/* get number of compositional variables */
@@ -657,13 +722,13 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 					cp[id_cp].lvlxeos[ii]   = SS_ref_db[ph_id].xeos_pc[pc_id][ii];
 				}
 				
-				gv.id_solvi[ph_id][gv.n_solvi[ph_id]] = id_cp;
-				gv.n_solvi[ph_id] 	+= 1;
-				gv.len_cp 			+= 1;
+				gv->id_solvi[ph_id][gv->n_solvi[ph_id]] = id_cp;
+				gv->n_solvi[ph_id] 	+= 1;
+				gv->len_cp 			+= 1;
 				id_cp 				+= 1;
 				
-				if (gv.len_cp == gv.max_n_cp){
-					printf(" !! Maxmimum number of allowed phases under consideration reached !!\n    -> check your problem and potentially increase gv.max_n_cp\n");
+				if (gv->len_cp == gv->max_n_cp){
+					printf(" !! Maxmimum number of allowed phases under consideration reached !!\n    -> check your problem and potentially increase gv->max_n_cp\n");
 					break;
 				}
 			}
@@ -671,7 +736,7 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 	}
 
 	if(0 == 1){
-		for (int i = 0; i < gv.len_cp; i++){
+		for (int i = 0; i < gv->len_cp; i++){
 				int ss = cp[i].id;
 
 				for (int j = 0; j < SS_ref_db[ss].n_xeos; j++) {	
@@ -681,19 +746,19 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 				/**
 					Rotate G-base hyperplane
 				*/
-				SS_ref_db[ss] = rotate_hyperplane(			gv, 
-															SS_ref_db[ss]		);
+				rotate_hyperplane(			gv, 
+											&SS_ref_db[ss]		);
 
 								
-				SS_ref_db[ss] = PC_function(				gv,
-															SS_ref_db[ss], 
-															z_b,
-															gv.SS_list[ss] 			);
+				PC_function(				gv,
+											&SS_ref_db[ss], 
+											z_b,
+											gv->SS_list[ss] 			);
 																			
-				SS_ref_db[ss] = SS_UPDATE_function(			gv, 
-															SS_ref_db[ss], 
-															z_b, 
-															gv.SS_list[ss]			);	
+				SS_UPDATE_function(			gv, 
+											&SS_ref_db[ss], 
+											z_b, 
+											gv->SS_list[ss]			);	
 												
 				for (int v = 0; v < cp[i].n_em; v++){
 					cp[i].xi_em[v]		= SS_ref_db[ss].xi_em[v];
@@ -707,33 +772,33 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 		Routine to deactivate the liquid endmembers after levelling 
 	*/
 	char liq_tail[] = "L";
-	for (int i = 0; i < gv.len_pp; i++){
-		if ( EndsWithTail(gv.PP_list[i], liq_tail) == 1 ) {
-			if (gv.pp_flags[i][0] == 1){
-				if (gv.pp_flags[i][1] == 1){
-					gv.pp_flags[i][0] = 0;
-					gv.pp_flags[i][1] = 0;
-					gv.pp_flags[i][2] = 0;
-					gv.pp_flags[i][3] = 1;
-					gv.n_phase       -= 1;
-					gv.n_pp_phase    -= 1;
-					gv.pp_n[i]        = 0.0;
+	for (int i = 0; i < gv->len_pp; i++){
+		if ( EndsWithTail(gv->PP_list[i], liq_tail) == 1 ) {
+			if (gv->pp_flags[i][0] == 1){
+				if (gv->pp_flags[i][1] == 1){
+					gv->pp_flags[i][0] = 0;
+					gv->pp_flags[i][1] = 0;
+					gv->pp_flags[i][2] = 0;
+					gv->pp_flags[i][3] = 1;
+					gv->n_phase       -= 1;
+					gv->n_pp_phase    -= 1;
+					gv->pp_n[i]        = 0.0;
 				}
 				else{
-					gv.pp_flags[i][0] = 0;
-					gv.pp_flags[i][1] = 0;
-					gv.pp_flags[i][2] = 0;
-					gv.pp_flags[i][3] = 1;
+					gv->pp_flags[i][0] = 0;
+					gv->pp_flags[i][1] = 0;
+					gv->pp_flags[i][2] = 0;
+					gv->pp_flags[i][3] = 1;
 				}
 			}
 		}
 	}
 	
-	if (gv.verbose == 1){
+	if (gv->verbose == 1){
 		printf("\n Initial guesses for compositional variables:\n");
 		printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
 		
-		for (int id_cp = 0; id_cp < gv.len_cp; id_cp++){
+		for (int id_cp = 0; id_cp < gv->len_cp; id_cp++){
 			if (cp[id_cp].ss_flags[0] == 1){
 				printf(" %5s [%+10f]->  ",cp[id_cp].name,cp[id_cp].df*cp[id_cp].factor);
 				for (int i = 0; i < cp[id_cp].n_xeos; i++){
@@ -747,276 +812,372 @@ global_variable update_global_info(		struct bulk_info 	 z_b,
 		}
 		printf("\n");	
 	}
-	
-	return gv;
 }
 
 /**
-  function to swp pure phases
-*/	
-simplex_data swap_pure_phases(		struct bulk_info 	 z_b,
-									simplex_data 		 splx_data,
-									global_variable 	 gv,
-									
-									PP_ref 				*PP_ref_db,
-									SS_ref 				*SS_ref_db
-){
-	int     k;
-	double  br[splx_data.n_Ox];
-	
-	/** get a local copy of the bulk rock composition, without zero values */
-	for (int i = 0; i < splx_data.n_Ox; i++){
-		br[i] = z_b.bulk_rock[z_b.nzEl_array[i]];
+  get the number of candidates of a pricing block
+  blocks are ordered as: pure phases (0), endmembers of solution phase i (1+i), pseudocompounds of solution phase i (1+len_ss+i)
+*/
+int get_block_size(				int 				 blk,
+								global_variable 	*gv,
+								SS_ref 				*SS_ref_db		){
+	int ss;
+
+	if (blk == 0){
+		return gv->len_pp;
 	}
-	
-	for (int i = 0; i < gv.len_pp; i++){
-		if (gv.pp_flags[i][0] == 1){
-			
-			splx_data.g0_B 			= PP_ref_db[i].gbase*PP_ref_db[i].factor;
-			splx_data.ph_id_B[0]  	= 1;															/** added phase is a pure species */
-			splx_data.ph_id_B[1]	= i;															/** save pure species index */
-		
-			/* retrieve the composition in the right (reduced) chemical space */
-			for (int j = 0; j < z_b.nzEl_val; j++){
-				splx_data.B[j] = PP_ref_db[i].Comp[z_b.nzEl_array[j]]*PP_ref_db[i].factor; 
-			}
-			
-			/** update deltaG with respect to G hyperplane */
-			splx_data = update_dG(splx_data);
-			
-			/** swap phase */
-			if (splx_data.ph2swp != -1){															/** if the phase can be added */
-				splx_data.swp 						   = 1;
-				splx_data.n_swp 					  += 1;
-				splx_data.ph_id_A[splx_data.ph2swp][0] = splx_data.ph_id_B[0];
-				splx_data.ph_id_A[splx_data.ph2swp][1] = splx_data.ph_id_B[1];
-				splx_data.ph_id_A[splx_data.ph2swp][2] = splx_data.ph_id_B[2];
-				splx_data.g0_A[splx_data.ph2swp] 	   = splx_data.g0_B;
-				
-				for (int j = 0; j < splx_data.n_Ox; j++){				
-					k = splx_data.ph2swp + j*splx_data.n_Ox;
-					splx_data.A[k] = splx_data.B[j];
-				}
-				
-				for (int k = 0; k < splx_data.n_Ox*splx_data.n_Ox; k++){ splx_data.A1[k] = splx_data.A[k];}
+	else if (blk <= gv->len_ss){
+		ss = blk - 1;
+		return ((SS_ref_db[ss].ss_flags[0] == 1) ? (SS_ref_db[ss].n_em) : (0));
+	}
+	else{
+		ss = blk - 1 - gv->len_ss;
+		return ((SS_ref_db[ss].ss_flags[0] == 1) ? (get_max_n_pc(SS_ref_db[ss].tot_pc, SS_ref_db[ss].n_pc)) : (0));
+	}
+};
 
-				/** inverse guessed assemblage stoechiometry matrix */
-				inverseMatrix(	splx_data.A1,
-								splx_data.n_Ox		);
-				
-				/** update phase fractions */
-				MatVecMul(		splx_data.A1,
-								br,
-								splx_data.n_vec,
-								splx_data.n_Ox		);	
-			}
+/**
+  retrieve the Gibbs energy and the composition (reduced chemical space) of candidate l of a pricing block
+*/
+simplex_data get_candidate(		struct bulk_info 	 z_b,
+								simplex_data 		 splx_data,
+								global_variable 	*gv,
+
+								PP_ref 				*PP_ref_db,
+								SS_ref 				*SS_ref_db,
+								int 				 blk,
+								int 				 l				){
+	int 	ss;
+	double 	factor;
+
+	if (blk == 0){
+		splx_data.g0_B 			= PP_ref_db[l].gbase*PP_ref_db[l].factor;
+		splx_data.ph_id_B[0] 	= 1;															/** added phase is a pure species */
+		splx_data.ph_id_B[1] 	= l;															/** save pure species index */
+		for (int j = 0; j < splx_data.n_Ox; j++){
+			splx_data.B[j] 		= PP_ref_db[l].Comp[z_b.nzEl_array[j]]*PP_ref_db[l].factor;
 		}
 	}
-	
+	else if (blk <= gv->len_ss){
+		ss 						= blk - 1;
+		factor 					= z_b.fbc/SS_ref_db[ss].ape[l];									/** update normalizing factor for solution models than need it */
+		splx_data.g0_B 			= SS_ref_db[ss].gbase[l]*factor;
+		splx_data.ph_id_B[0] 	= 2;															/** added phase is a pure endmember */
+		splx_data.ph_id_B[1] 	= ss;															/** save solution phase index */
+		for (int j = 0; j < splx_data.n_Ox; j++){
+			splx_data.B[j] 		= SS_ref_db[ss].Comp[l][z_b.nzEl_array[j]]*factor;
+		}
+	}
+	else{
+		ss 						= blk - 1 - gv->len_ss;
+		splx_data.g0_B 			= SS_ref_db[ss].G_pc[l];
+		splx_data.ph_id_B[0] 	= 3;															/** added phase is a pseudocompound */
+		splx_data.ph_id_B[1] 	= ss;															/** save solution phase index */
+		for (int j = 0; j < splx_data.n_Ox; j++){
+			splx_data.B[j] 		= SS_ref_db[ss].comp_pc[l][z_b.nzEl_array[j]];
+		}
+	}
+	splx_data.ph_id_B[2] 		= 0;
+	splx_data.ph_id_B[3] 		= l;															/** save endmember/pseudocompound index */
+
 	return splx_data;
-}
+};
 
 /**
-  function to swp pure endmembers
-*/	
-simplex_data swap_pure_endmembers(		struct bulk_info 	 z_b,
-										simplex_data 		 splx_data,
-										global_variable 	 gv,
-										
-										PP_ref 				*PP_ref_db,
-										SS_ref 				*SS_ref_db
-){
-	int     k;
-	double  br[splx_data.n_Ox];
-	double factor;
-	
-	/** get a local copy of the bulk rock composition, without zero values */
+  price the candidates of a block against the simplex multipliers (gam) of the current basis
+  Dantzig rule (most negative reduced cost) or, when bland == 1, first improving candidate.
+  The driving force of the pseudocompounds is saved, it is used to select the phases after levelling.
+*/
+simplex_data price_block(		struct bulk_info 	 z_b,
+								simplex_data 		 splx_data,
+								global_variable 	*gv,
+
+								PP_ref 				*PP_ref_db,
+								SS_ref 				*SS_ref_db,
+								int 				 blk,
+								double 				*gam,
+								int 				 bland			){
+	int 	ss, n_cand, type, is_basic;
+	int 	n_bas = 0;
+	int 	*bas = gv->ws.bas;
+	double 	dG, factor;
+
+	n_cand 				= get_block_size(blk, gv, SS_ref_db);
+	splx_data.dG_B 		= 0.0;
+	splx_data.ph2swp 	= -1;
+
+	/* candidates of the block already in the basis (their reduced cost is only zero up to round-off) */
+	type 	= (blk == 0) ? (1) : ((blk <= gv->len_ss) ? (2) : (3));
+	ss 		= (blk == 0) ? (-1) : ((blk <= gv->len_ss) ? (blk - 1) : (blk - 1 - gv->len_ss));
 	for (int i = 0; i < splx_data.n_Ox; i++){
-		br[i] = z_b.bulk_rock[z_b.nzEl_array[i]];
+		if (splx_data.ph_id_A[i][0] == type && (type == 1 || splx_data.ph_id_A[i][1] == ss)){
+			bas[n_bas] 	= (type == 1) ? (splx_data.ph_id_A[i][1]) : (splx_data.ph_id_A[i][3]);
+			n_bas 	   += 1;
+		}
 	}
-	
-	for (int i = 0; i < gv.len_ss; i++){												/**loop to pass informations from active endmembers */
-		if (SS_ref_db[i].ss_flags[0] == 1){														/** if SS is not filtered out then continue */
 
-			for (int l = 0; l < SS_ref_db[i].n_em; l++){	
-				/** if bulk-rock satisfy the compositions of endmembers, retrieve their informations */
-				if (SS_ref_db[i].z_em[l] == 1){ 
-					
-					/* update normalizing factor for solution models than need it */
-					factor 	= z_b.fbc/SS_ref_db[i].ape[l];	
+	for (int l = 0; l < n_cand; l++){
+		is_basic = 0;
+		for (int i = 0; i < n_bas; i++){
+			if (bas[i] == l){ is_basic = 1; }
+		}
+		if (type == 1){
+			if (gv->pp_flags[l][0] != 1 || is_basic == 1){ continue; }
+			dG = PP_ref_db[l].gbase*PP_ref_db[l].factor;
+			for (int j = 0; j < splx_data.n_Ox; j++){
+				dG -= PP_ref_db[l].Comp[z_b.nzEl_array[j]]*PP_ref_db[l].factor*gam[j];
+			}
+		}
+		else if (type == 2){
+			if (SS_ref_db[ss].z_em[l] != 1 || is_basic == 1){ continue; }
+			factor 	= z_b.fbc/SS_ref_db[ss].ape[l];
+			dG 		= SS_ref_db[ss].gbase[l]*factor;
+			for (int j = 0; j < splx_data.n_Ox; j++){
+				dG -= SS_ref_db[ss].Comp[l][z_b.nzEl_array[j]]*factor*gam[j];
+			}
+		}
+		else{
+			dG = SS_ref_db[ss].G_pc[l];
+			for (int j = 0; j < splx_data.n_Ox; j++){
+				dG -= SS_ref_db[ss].comp_pc[l][z_b.nzEl_array[j]]*gam[j];
+			}
+			SS_ref_db[ss].DF_pc[l] = dG;
+			if (is_basic == 1){ continue; }
+		}
+		splx_data.stat.n_price[type - 1] += 1;
 
+		if (dG < splx_data.dG_B){
+			splx_data.dG_B 		= dG;
+			splx_data.ph2swp 	= l;																/** index of the entering candidate within the block */
+			if (bland == 1 && dG < -gv->lvl_dG_tol){ break; }
+		}
+	}
 
-					splx_data.g0_B		 = SS_ref_db[i].gbase[l]*factor;
-					splx_data.ph_id_B[0] = 2;														/** added phase is a pure species */
-					splx_data.ph_id_B[1] = i;														/** save pure species index */
-					splx_data.ph_id_B[2] = 0;														/** save used initial guess */	
-					
-					/** retrieve the composition in the right (reduced) chemical space */
-					for (int j = 0; j < z_b.nzEl_val; j++){
-						splx_data.B[j] 	 = SS_ref_db[i].Comp[l][z_b.nzEl_array[j]]*factor; 
-					}
+	return splx_data;
+};
 
-					/** update deltaG with respect to G hyperplane */
-					splx_data = update_dG(splx_data);
-									
-					/** swap phase */
-					if (splx_data.ph2swp != -1){													/** if the phase can be added */
-						splx_data.swp 						   = 1;
-						splx_data.n_swp 					  += 1;
-						splx_data.ph_id_A[splx_data.ph2swp][0] = splx_data.ph_id_B[0];
-						splx_data.ph_id_A[splx_data.ph2swp][1] = splx_data.ph_id_B[1];
-						splx_data.ph_id_A[splx_data.ph2swp][2] = splx_data.ph_id_B[2];
-						splx_data.ph_id_A[splx_data.ph2swp][3] = l;	
-						splx_data.g0_A[splx_data.ph2swp] 	   = splx_data.g0_B;
-						
-						for (int j = 0; j < splx_data.n_Ox; j++){				
-							int k = splx_data.ph2swp + j*splx_data.n_Ox;
-							splx_data.A[k] = splx_data.B[j];
-						}
-						for (int k = 0; k < splx_data.n_Ox*splx_data.n_Ox; k++){ splx_data.A1[k] = splx_data.A[k];}
+/**
+  order of the phases of the basis used by Bland's rule, same as the pricing order (penalty phases first)
+*/
+int is_lower_phase(				int 				*ph_id_1,
+								int 				 pos_1,
+								int 				*ph_id_2,
+								int 				 pos_2			){
+	int key_1[3] = {ph_id_1[0], ph_id_1[1], (ph_id_1[0] == 0) ? (pos_1) : (ph_id_1[3])};
+	int key_2[3] = {ph_id_2[0], ph_id_2[1], (ph_id_2[0] == 0) ? (pos_2) : (ph_id_2[3])};
 
-						/** inverse guessed assemblage stoechiometry matrix */
-						inverseMatrix(	splx_data.A1,
-										splx_data.n_Ox		);
-						
-						/** update phase fractions */
-						MatVecMul(		splx_data.A1,
-										br,
-										splx_data.n_vec,
-										splx_data.n_Ox		);	
-					}
+	for (int j = 0; j < 3; j++){
+		if (key_1[j] != key_2[j]){ return (key_1[j] < key_2[j]) ? (1) : (0); }
+	}
+	return 0;
+};
+
+/**
+  ratio test: get the column of the basis leaving when candidate B enters.
+  Ties (degenerate vertex) are broken by the largest pivot, or by the lowest phase under Bland's rule.
+*/
+simplex_data ratio_test(		simplex_data 		 splx_data,
+								global_variable 	*gv,
+								int 				 bland			){
+	int    r;
+	double F;
+
+	/* column of the entering candidate expressed in the current basis */
+	VecMatMul(			splx_data.B1,
+						splx_data.A1,
+						splx_data.B,
+						splx_data.n_Ox		);
+
+	splx_data.ph2swp = -1;
+	splx_data.min_F  =  1e6;																	/** max value for F, tentative here because F can tend to +inf */
+	for (int i = 0; i < splx_data.n_Ox; i++){
+		if (splx_data.B1[i] > gv->lvl_piv_tol){
+			F = splx_data.n_vec[i]/splx_data.B1[i];
+			r = splx_data.ph2swp;
+			if (F < splx_data.min_F - 1e-12){
+				splx_data.min_F  = F;
+				splx_data.ph2swp = i;
+			}
+			else if (F < splx_data.min_F + 1e-12 && r != -1){
+				if ( (bland == 0 && splx_data.B1[i] > splx_data.B1[r])
+				  || (bland == 1 && is_lower_phase(splx_data.ph_id_A[i], i, splx_data.ph_id_A[r], r) == 1) ){
+					splx_data.ph2swp = i;
 				}
 			}
 		}
 	}
-	
+
 	return splx_data;
-}
+};
 
 /**
-  function to swp pure phases
-*/	
-simplex_data swap_pseudocompounds(		struct bulk_info 	 z_b,
-										simplex_data 		 splx_data,
-										global_variable 	gv,
-										
-										PP_ref 				*PP_ref_db,
-										SS_ref 				*SS_ref_db
-){
-	int     k, max_n_pc;
-	double  br[splx_data.n_Ox];
-	
-	/** get a local copy of the bulk rock composition, without zero values */
-	for (int i = 0; i < splx_data.n_Ox; i++){
-		br[i] = z_b.bulk_rock[z_b.nzEl_array[i]];
+  replace basis column ph2swp by the entering candidate B and update the inverse of the basis (product form update),
+  the inverse is recomputed from scratch every gv.lvl_refac updates to avoid the accumulation of round-off errors
+*/
+simplex_data update_basis(		struct bulk_info 	 z_b,
+								simplex_data 		 splx_data,
+								global_variable 	*gv				){
+	int 	r = splx_data.ph2swp;
+	int 	n = splx_data.n_Ox;
+	double 	piv, theta;
+	double *br = gv->ws.br;
+
+	splx_data.n_swp 		+= 1;
+	splx_data.g0_A[r] 		 = splx_data.g0_B;
+	for (int j = 0; j < 4; j++){
+		splx_data.ph_id_A[r][j] = splx_data.ph_id_B[j];
+	}
+	for (int j = 0; j < n; j++){
+		splx_data.A[r + j*n] = splx_data.B[j];
 	}
-	
-	for (int i = 0; i < gv.len_ss; i++){										/**loop to pass informations from active endmembers */
-		if (SS_ref_db[i].ss_flags[0] == 1){
 
-			max_n_pc = get_max_n_pc(SS_ref_db[i].tot_pc, SS_ref_db[i].n_pc);
+	/* keep track of degenerate pivots (no change of the phase fractions) */
+	theta = splx_data.min_F;
+	if (theta < 1e-12){ splx_data.n_degen += 1; splx_data.stat.n_degen += 1; }
+	else 			  { splx_data.n_degen  = 0; }
 
-			for (int l = 0; l < max_n_pc; l++){
+	splx_data.n_upd += 1;
+	if (splx_data.n_upd >= gv->lvl_refac){
+		for (int k = 0; k < n*n; k++){ splx_data.A1[k] = splx_data.A[k];}
+		splx_data.stat.n_inv += 1;
 
-				splx_data.g0_B		 = SS_ref_db[i].G_pc[l];
-				splx_data.ph_id_B[0] = 3;														/** added phase is a pure species */
-				splx_data.ph_id_B[1] = i;														/** save solution phase index */
-				splx_data.ph_id_B[2] = 0;														/** save pseudocompound index */
-			
-				/* retrieve the composition in the right (reduced) chemical space */
-				for (int j = 0; j < z_b.nzEl_val; j++){
-					splx_data.B[j] = SS_ref_db[i].comp_pc[l][z_b.nzEl_array[j]]; 
-				}
+		/** inverse guessed assemblage stoechiometry matrix */
+		inverseMatrix(	splx_data.A1,
+						gv->ws.lvl_ipiv,
+						n					);
 
-				/** update deltaG with respect to G hyperplane */
-				splx_data = update_dG(splx_data);
-				
-				/** save updated driving force */
-				SS_ref_db[i].DF_pc[l] = splx_data.dG_B;
-				
-				/** swap phase */
-				if (splx_data.ph2swp != -1){													/** if the phase can be added */
-					SS_ref_db[i].n_swap[l]       		   = splx_data.n_swp;
-					splx_data.swp 				 		   = 1;
-					splx_data.n_swp 					  += 1;
-					splx_data.ph_id_A[splx_data.ph2swp][0] = splx_data.ph_id_B[0];
-					splx_data.ph_id_A[splx_data.ph2swp][1] = splx_data.ph_id_B[1];
-					splx_data.ph_id_A[splx_data.ph2swp][2] = splx_data.ph_id_B[2];
-					splx_data.ph_id_A[splx_data.ph2swp][3] = l;									/** save pseudocompound number */
-					splx_data.g0_A[splx_data.ph2swp] 	   = splx_data.g0_B;
-					
-					for (int j = 0; j < splx_data.n_Ox; j++){				
-						int k = splx_data.ph2swp + j*splx_data.n_Ox;
-						splx_data.A[k] = splx_data.B[j];
-					}
-					
-					for (int k = 0; k < splx_data.n_Ox*splx_data.n_Ox; k++){ splx_data.A1[k] = splx_data.A[k];}
+		/** update phase fractions */
+		for (int i = 0; i < n; i++){
+			br[i] = z_b.bulk_rock[z_b.nzEl_array[i]];
+		}
+		MatVecMul(		splx_data.A1,
+						br,
+						splx_data.n_vec,
+						n					);
+		splx_data.n_upd = 0;
+	}
+	else{
+		splx_data.stat.n_eta += 1;
+
+		/* update phase fractions */
+		for (int i = 0; i < n; i++){
+			if (i != r){
+				splx_data.n_vec[i] -= theta*splx_data.B1[i];
+				if (splx_data.n_vec[i] < 0.0){ splx_data.n_vec[i] = 0.0; }
+			}
+		}
+		splx_data.n_vec[r] = theta;
 
-					/** inverse guessed assemblage stoechiometry matrix */
-					inverseMatrix(	splx_data.A1,
-									splx_data.n_Ox		);
-					
-					/** update phase fractions */
-					MatVecMul(		splx_data.A1,
-									br,
-									splx_data.n_vec,
-									splx_data.n_Ox		);
+		/* eta update of the inverse */
+		piv = splx_data.B1[r];
+		for (int k = 0; k < n; k++){
+			splx_data.A1[r*n + k] /= piv;
+		}
+		for (int i = 0; i < n; i++){
+			if (i != r && splx_data.B1[i] != 0.0){
+				for (int k = 0; k < n; k++){
+					splx_data.A1[i*n + k] -= splx_data.B1[i]*splx_data.A1[r*n + k];
 				}
 			}
 		}
 	}
-	
+
 	return splx_data;
-}
+};
 
 /**
-  function to run simplex linear programming with pseudocompounds only
-*/	
-simplex_data run_simplex_vPC_only(		struct bulk_info 	 z_b,
-										simplex_data 		 splx_data,
-										global_variable 	 gv,
-										
-										PP_ref 				*PP_ref_db,
-										SS_ref 				*SS_ref_db
-){
+  revised simplex over the first n_blk pricing blocks, starting from the basis stored in splx_data (warm start).
 
-	int     k = 0;
-	double  br[splx_data.n_Ox];
-	
-	/** get a local copy of the bulk rock composition, without zero values */
-	for (int i = 0; i < splx_data.n_Ox; i++){
-		br[i] = z_b.bulk_rock[z_b.nzEl_array[i]];
-	}
-	
-	splx_data.swp = 1;
-	while (splx_data.swp == 1){																			/** as long as a phase can be added to the guessed assemblage, go on */
-		k 				 += 1;
-		splx_data.swp     = 0;
-		
-		splx_data = swap_pure_phases(		z_b,
+  Each iteration computes the simplex multipliers once, then uses partial pricing: the blocks are scanned starting
+  from the block of the last pivot and the scan stops at the first block holding an improving candidate. After
+  gv.lvl_max_degen consecutive degenerate pivots, Bland's rule is used until a non-degenerate pivot occurs. The
+  simplex stops when a full scan finds no candidate with a negative reduced cost (all pseudocompound driving forces
+  are then up to date with respect to the final basis).
+*/
+simplex_data run_revised_simplex(	struct bulk_info 	 z_b,
+									simplex_data 		 splx_data,
+									global_variable 	*gv,
+
+									PP_ref 				*PP_ref_db,
+									SS_ref 				*SS_ref_db,
+									int 				 n_blk			){
+	int 	blk, bland, found, ss;
+	int 	n_pivot = 0;
+	double  *gam = gv->ws.gam;
+
+	splx_data.blk 		= 0;
+	splx_data.n_degen 	= 0;
+
+	while (n_pivot < gv->lvl_max_pivot){
+
+		/* simplex multipliers of the current basis */
+		update_local_gamma(					splx_data.A1,
+											splx_data.g0_A,
+											gam,
+											splx_data.n_Ox			);
+
+		bland = (splx_data.n_degen >= gv->lvl_max_degen) ? 1 : 0;
+		found = 0;
+		splx_data.stat.n_bland += bland;
+		for (int i = 0; i < n_blk; i++){
+			blk 		= (bland == 1) ? (i) : ((splx_data.blk + i) % n_blk);
+			splx_data 	= price_block(		z_b,
 											splx_data,
 											gv,
 											PP_ref_db,
-											SS_ref_db	);	
-											
-		splx_data = swap_pure_endmembers(	z_b,
+											SS_ref_db,
+											blk,
+											gam,
+											bland					);
+			if (splx_data.dG_B < -gv->lvl_dG_tol){
+				found = 1;
+				break;
+			}
+		}
+		if (found == 0){ break; }
+
+		splx_data.blk 	= blk;
+		splx_data 		= get_candidate(	z_b,
 											splx_data,
 											gv,
 											PP_ref_db,
-											SS_ref_db	);	
-		
-		splx_data = swap_pseudocompounds(	z_b,
-											splx_data,
+											SS_ref_db,
+											blk,
+											splx_data.ph2swp		);
+
+		splx_data 		= ratio_test(		splx_data,
 											gv,
-											PP_ref_db,
-											SS_ref_db	);				
+											bland					);
+
+		if (splx_data.ph2swp == -1){
+			if (gv->verbose == 1){
+				printf("    unbounded direction found during levelling, levelling stopped\n");
+			}
+			break;
+		}
+
+		if (splx_data.ph_id_B[0] == 3){
+			ss = splx_data.ph_id_B[1];
+			SS_ref_db[ss].n_swap[splx_data.ph_id_B[3]] = splx_data.n_swp;
+			SS_ref_db[ss].n_pc_pivot += 1;
+		}
+		splx_data.stat.n_pivot[splx_data.ph_id_B[0] - 1] += 1;
+
+		splx_data 		= update_basis(		z_b,
+											splx_data,
+											gv						);
+		n_pivot 	   += 1;
+	}
+
+	if (n_pivot == gv->lvl_max_pivot && gv->verbose == 1){
+		printf("    maximum number of pivots reached during levelling (%d)\n",n_pivot);
 	}
-	if (gv.verbose == 1){
-		printf("    (# iterations %d)",k);	
+	if (gv->verbose == 1){
+		printf("    (# pivots %d)",n_pivot);
 	}
-	
+
 	return splx_data;
-}
+};
 
 
 /**
@@ -1025,38 +1186,33 @@ simplex_data run_simplex_vPC_only(		struct bulk_info 	 z_b,
 simplex_data run_simplex_vPC_stage1(	struct bulk_info 	 z_b,
 										simplex_data 		 splx_data,
 										
-										global_variable 	 gv,
+										global_variable 	*gv,
 										
 										PP_ref 				*PP_ref_db,
 										SS_ref 				*SS_ref_db,
 										obj_type			*SS_objective
 ){
-	int i, k, iss;
-	
-	/** get a local copy of the bulk rock composition, without zero values */
-	double  br[splx_data.n_Ox];
-	for (int i = 0; i < splx_data.n_Ox; i++){
-		br[i] = z_b.bulk_rock[z_b.nzEl_array[i]];
-	}
+	int i, k, iss, max_n_pc;
+	double t; 
+	double time_taken;
+	t = batch_wtime();
 
 	/** copy A onto A1 in order to inverse it using LAPACKE */
 	for (k = 0; k < splx_data.n_Ox*splx_data.n_Ox; k++){ splx_data.A1[k] = splx_data.A[k];}
 
 	/** inverse guessed assemblage stoechiometry matrix */
 	inverseMatrix(						splx_data.A1, 
+										gv->ws.lvl_ipiv,
 										splx_data.n_Ox			);
+	splx_data.stat.n_inv += 1;
 	
-	splx_data = swap_pure_phases(		z_b,
+	/** levelling using pure species only (pure phases and endmembers) */
+	splx_data = run_revised_simplex(	z_b,
 										splx_data,
 										gv,
 										PP_ref_db,
-										SS_ref_db				);	
-										
-	splx_data = swap_pure_endmembers(	z_b,
-										splx_data,
-										gv,
-										PP_ref_db,
-										SS_ref_db				);	
+										SS_ref_db,
+										1 + gv->len_ss			);
 	
 	update_local_gamma(					splx_data.A1,
 										splx_data.g0_A,
@@ -1069,53 +1225,66 @@ simplex_data run_simplex_vPC_stage1(	struct bulk_info 	 z_b,
 		splx_data.gamma_tot[z_b.nzEl_array[i]] = splx_data.gamma_ps[i];
 	}
 
+	t = batch_wtime() - t; 
+	splx_data.stat.la_time += t*1000;
+
 	/** 
 		Pseudocompound levelling with refinement 
 	*/
-	clock_t t; 
-	double time_taken;
-	t = clock();
+	t = batch_wtime();
 
 	/** generate the pseudocompounds -> stored in the SS_ref_db structure */
-	if (gv.verbose == 1){ printf(" Generate pseudocompounds:\n"); }
-	
-	PC_ref 			SS_PC_xeos[gv.len_ss];
+	if (gv->verbose == 1){ printf(" Generate pseudocompounds:\n"); }
 	
-	for (iss = 0; iss < gv.len_ss; iss++){
-		SS_PC_init_function(			SS_PC_xeos, 
-										iss,
-										gv.SS_list[iss]				);
-	}
-	
-	for (iss = 0; iss < gv.len_ss; iss++){
+	for (iss = 0; iss < gv->len_ss; iss++){
 		if (SS_ref_db[iss].ss_flags[0] == 1){
 
-			generate_pseudocompounds(	iss,
-										splx_data,
-										z_b,
-										gv,
-										SS_ref_db,
-										SS_PC_xeos,
-										SS_objective				);
+			/* pseudocompounds of the previous point are reused by the batch levelling mode */
+			if (gv->PC_reuse == 1 && SS_ref_db[iss].tot_pc > 0){
+				rescale_pseudocompounds(	iss,
+											z_b,
+											SS_ref_db					);
+			}
+			else{
+				generate_pseudocompounds(	iss,
+											splx_data,
+											z_b,
+											gv,
+											SS_ref_db,
+											gv->PC_xeos,
+											SS_objective				);
+
+				/* index the pseudocompounds once, used for the proximity queries (PC filtering and solvus check) */
+				max_n_pc = get_max_n_pc(	SS_ref_db[iss].tot_pc,
+											SS_ref_db[iss].n_pc		);
+
+				kdtree_build(				SS_ref_db[iss].kd_idx,
+											SS_ref_db[iss].xeos_pc,
+											max_n_pc,
+											SS_ref_db[iss].n_xeos		);
+				SS_ref_db[iss].kd_n = max_n_pc;
+			}
 
-			if (gv.verbose == 1){
-				printf(" %4s -> %05d active PCs\n",gv.SS_list[iss],SS_ref_db[iss].tot_pc);
+			if (gv->verbose == 1){
+				printf(" %4s -> %05d active PCs\n",gv->SS_list[iss],SS_ref_db[iss].tot_pc);
 			}
 		}
 
 	}
 
-	t = clock() - t; 
-	time_taken  = ((double)t)/CLOCKS_PER_SEC; 
-	if (gv.verbose == 1){ printf("\n [time to generate PC time (ms) %.8f]\n",time_taken*1000);	}
-	t = clock();
+	t = batch_wtime() - t; 
+	time_taken  = t; 
+	splx_data.stat.obj_time += time_taken*1000;
+	if (gv->verbose == 1){ printf("\n [time to generate PC time (ms) %.8f]\n",time_taken*1000);	}
+	t = batch_wtime();
 	
-	/** run linear programming with simplex approach */
-	splx_data = run_simplex_vPC_only(	z_b,
+	/** run linear programming with pseudocompounds, warm started from the pure species basis */
+	splx_data = run_revised_simplex(	z_b,
 										splx_data,
 										gv,
 										PP_ref_db,
-										SS_ref_db				);
+										SS_ref_db,
+										1 + 2*gv->len_ss			);
 				
 	/* update gamma of SS */
 	update_local_gamma(					splx_data.A1,
@@ -1123,9 +1292,10 @@ simplex_data run_simplex_vPC_stage1(	struct bulk_info 	 z_b,
 										splx_data.gamma_ss,
 										splx_data.n_Ox			);
 										
-	t = clock() - t; 
-	time_taken  = ((double)t)/CLOCKS_PER_SEC;
-	if (gv.verbose == 1){ printf("\n [time to swap SS time (ms) %.8f]\n",time_taken*1000);	}
+	t = batch_wtime() - t; 
+	time_taken  = t;
+	splx_data.stat.la_time += time_taken*1000;
+	if (gv->verbose == 1){ printf("\n [time to swap SS time (ms) %.8f]\n",time_taken*1000);	}
 	
 	return splx_data;
 };
@@ -1169,21 +1339,21 @@ void destroy_simplex_B(
   Part A: Reference assemblage against which candidates are tested
   Part B: Candidate phases
 */	
-global_variable run_levelling_function(		struct bulk_info 	 z_b,
-											global_variable 	 gv,
+void run_levelling_function(		struct bulk_info 	 z_b,
+									global_variable 	*gv,
 
-											PP_ref 				*PP_ref_db,
-											SS_ref 				*SS_ref_db,
-											csd_phase_set  		*cp
+									PP_ref 				*PP_ref_db,
+									SS_ref 				*SS_ref_db,
+									csd_phase_set  		*cp
 ){
 	
-	clock_t t; 
+	double t; 
 	double time_taken;
-	t = clock();
+	t = batch_wtime();
 	
 	/** declare structure to storesimplex arrays */
 	simplex_data 	splx_data;
-	obj_type 		SS_objective[gv.len_ss];	
+	obj_type 		SS_objective[gv->len_ss];	
 	
 	SS_objective_init_function(				SS_objective,
 											gv				);
@@ -1227,28 +1397,28 @@ global_variable run_levelling_function(		struct bulk_info 	 z_b,
 											splx_data		);	
 	
 										
-	/* remove solution from consideration when min driving force is > gv.bnd_filter_pc */
+	/* remove solution from consideration when min driving force is > gv->bnd_filter_pc */
 	reduce_ss_list( 						SS_ref_db, 
 											gv 				);
 	
 	
 	/* function to send back the updated initial guess, and phases flags */
-	gv = update_global_info(				z_b,
-											splx_data,
-											gv,
-											PP_ref_db,
-											SS_ref_db,
-											cp,
-											SS_objective	);
-
-	//if (gv.verbose == 1){
+	update_global_info(				z_b,
+									splx_data,
+									gv,
+									PP_ref_db,
+									SS_ref_db,
+									cp,
+									SS_objective	);
+
+	//if (gv->verbose == 1){
 		//print_levelling(				z_b,
 										//gv,
 										//PP_ref_db,
 										//SS_ref_db			);											
 	//}
 
-	if (gv.verbose == 1){
+	if (gv->verbose == 1){
 		printf("\nGet initial guess (Gamma and phase fractions) \n");
 		printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
 		printf("   STEP 1: Pure species guess\n");
@@ -1263,14 +1433,14 @@ global_variable run_levelling_function(		struct bulk_info 	 z_b,
 			sum_prop += splx_data.n_vec[i];
 			
 			if (splx_data.ph_id_A[i][0] == 1){
-				printf("\t['%5s' %+10f  %+10f  %5d ]", gv.PP_list[splx_data.ph_id_A[i][1]], splx_data.n_vec[i], splx_data.g0_A[i], splx_data.ph_id_A[i][0]);
+				printf("\t['%5s' %+10f  %+10f  %5d ]", gv->PP_list[splx_data.ph_id_A[i][1]], splx_data.n_vec[i], splx_data.g0_A[i], splx_data.ph_id_A[i][0]);
 				printf("\n");
 			}
 			if (splx_data.ph_id_A[i][0] == 2){
-				printf("\t['%5s' %+10f  %+10f  %5d ]\n", gv.SS_list[splx_data.ph_id_A[i][1]], splx_data.n_vec[i], splx_data.g0_A[i], splx_data.ph_id_A[i][0]);
+				printf("\t['%5s' %+10f  %+10f  %5d ]\n", gv->SS_list[splx_data.ph_id_A[i][1]], splx_data.n_vec[i], splx_data.g0_A[i], splx_data.ph_id_A[i][0]);
 			}
 			if (splx_data.ph_id_A[i][0] == 3){
-				printf("\t['%5s' %+10f  %+10f  %5d ]", gv.SS_list[splx_data.ph_id_A[i][1]], splx_data.n_vec[i], splx_data.g0_A[i], splx_data.ph_id_A[i][0]);
+				printf("\t['%5s' %+10f  %+10f  %5d ]", gv->SS_list[splx_data.ph_id_A[i][1]], splx_data.n_vec[i], splx_data.g0_A[i], splx_data.ph_id_A[i][0]);
 				for (int ii = 0; ii < SS_ref_db[splx_data.ph_id_A[i][1]].n_xeos; ii++){
 					printf(" %+10f", SS_ref_db[splx_data.ph_id_A[i][1]].xeos_pc[splx_data.ph_id_A[i][3]][ii] );
 				}
@@ -1281,7 +1451,7 @@ global_variable run_levelling_function(		struct bulk_info 	 z_b,
 		printf("\t[  OXIDE      GAMMA_EM        GAMMA_PC  ]\n");
 		printf("\t[---------------------------------------]\n");
 		for (int i = 0; i < splx_data.n_Ox; i++){
-			printf("\t[ %5s %+15f %+15f ]\n", gv.ox[z_b.nzEl_array[i]], splx_data.gamma_ps[i], splx_data.gamma_tot[z_b.nzEl_array[i]]);
+			printf("\t[ %5s %+15f %+15f ]\n", gv->ox[z_b.nzEl_array[i]], splx_data.gamma_ps[i], splx_data.gamma_tot[z_b.nzEl_array[i]]);
 		}
 		printf("\t[---------------------------------------]\n");
 		printf("\t[            %4d swaps                 ]\n", splx_data.n_swp);
@@ -1290,17 +1460,17 @@ global_variable run_levelling_function(		struct bulk_info 	 z_b,
 		printf("\n\t[---------------------------------------]\n");
 		printf("\t[           ACTIVE PHASES               ]\n");
 		printf("\t[---------------------------------------]\n");
-		for (int i = 0; i < gv.len_ss; i++){
+		for (int i = 0; i < gv->len_ss; i++){
 			if (SS_ref_db[i].ss_flags[0] == 1){
-				printf("\t[                %5s                  ]\n",gv.SS_list[i]);
+				printf("\t[                %5s                  ]\n",gv->SS_list[i]);
 			}
 		}
 		printf("\t[---------------------------------------]\n");
 		printf("\t[           UNACTIVE PHASES             ]\n");
 		printf("\t[---------------------------------------]\n");
-		for (int i = 0; i < gv.len_ss; i++){
+		for (int i = 0; i < gv->len_ss; i++){
 			if (SS_ref_db[i].ss_flags[0] == 0){
-				printf("\t[                %5s                  ]\n",gv.SS_list[i]);
+				printf("\t[                %5s                  ]\n",gv->SS_list[i]);
 			}
 		}
 		printf("\t[---------------------------------------]\n");
@@ -1310,42 +1480,39 @@ global_variable run_levelling_function(		struct bulk_info 	 z_b,
 	destroy_simplex_A(splx_data);
 	destroy_simplex_B(splx_data);
 
-	t 			= clock() - t; 
-	time_taken  = ((double)t)/CLOCKS_PER_SEC; // in seconds 
-	gv.LVL_time = time_taken*1000;	
-	
-	return gv;
+	t 			= batch_wtime() - t; 
+	time_taken  = t; // in seconds 
+	gv->LVL_time = time_taken*1000;	
+	gv->lvl 		= splx_data.stat;
 };		
 
 /**
   main levelling routine
 */ 
-global_variable Levelling(
+void Levelling(
 	struct bulk_info z_b,
-	global_variable gv,
+	global_variable *gv,
 
 	PP_ref *PP_ref_db,
 	SS_ref *SS_ref_db,
 	csd_phase_set  *cp
 	){
 
-	if (gv.verbose == 1){
+	if (gv->verbose == 1){
 		printf("\nLevelling (endmembers & solution phase)\n");
 		printf("‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾\n");
 	}
 			
 	/* pseudosection function to get starting guess */
-	gv = run_levelling_function(	z_b,												/** bulk rock informations    */
-									gv,													/** global variables (e.g. Gamma) */
+	run_levelling_function(	z_b,												/** bulk rock informations    */
+							gv,													/** global variables (e.g. Gamma) */
 										
-									PP_ref_db,											/** pure phase database */
-									SS_ref_db,											/** solution phase database */
-									cp				);
-	if (gv.verbose == 1){
-		printf("    [    Levelling time  %+12f ms    ]\n",gv.LVL_time);
+							PP_ref_db,											/** pure phase database */
+							SS_ref_db,											/** solution phase database */
+							cp				);
+	if (gv->verbose == 1){
+		printf("    [    Levelling time  %+12f ms    ]\n",gv->LVL_time);
 		printf("    [---------------------------------------]\n\n\n");
 	}
 
-
-	return gv;
 };		
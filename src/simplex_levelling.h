@@ -1,13 +1,13 @@
 #ifndef __run_levelling_function_H_
 #define __run_levelling_function_H_
 
-void inverseMatrix(double *A1, int n);
+void inverseMatrix(double *A1, int *ipiv, int n);
 void VecMatMul(double *B1, double *A1, double *B, int n);
 void MatVecMul(double *A1, double *br, double *n_vec, int n);
 
-global_variable Levelling(
+void Levelling(
 	struct bulk_info z_b,
-	global_variable gv,
+	global_variable *gv,
 	
 	PP_ref *PP_ref_db,
 	SS_ref *SS_ref_db,
@@ -26,6 +26,10 @@ typedef struct simplex_datas
 	int      ph2swp;	/** index of phase to swap */
 	int      n_swp;     /** number of phase added to the reference assemblage */
 	int      swp;       /** swap occured? */
+	int      n_upd;     /** number of basis updates since the last computation of the inverse */
+	int      n_degen;   /** number of consecutive degenerate pivots */
+	int      blk;       /** pricing block of the last pivot (partial pricing) */
+	lvl_stat stat;		/** levelling counters */
 	int     *pivot;		/** pivot point when doing RREF toget the rational basis of the null space */
 	
 	/* Reference assemblage */
@@ -59,7 +63,7 @@ typedef struct simplex_datas
 void print_levelling(
 	struct bulk_info z_b,
 	
-	global_variable gv,
+	global_variable *gv,
 	
 	PP_ref *PP_ref_db,
 	SS_ref *SS_ref_db
@@ -0,0 +1,324 @@
+/**
+Multi-start solvus search
+-------------------------
+
+check_PC adds at most one instance per solution phase, started from the pseudocompound of lowest driving force away
+from the existing instances. For the phases selected with --solvus_ms=ph1,ph2 (or all), the solvus search is run right
+after check_PC, once per point:
+
+1. seeds   : up to gv.ms_n pseudocompounds with a driving force lower than PC_df_add, taken by increasing driving force
+             and lying at least ms_sep grid steps away from each other and PC_min_dist from the existing instances
+2. minima  : a local minimization is started from every seed, the starts are shared between the gv.LM_threads OpenMP
+             threads (scratch copies gv.SS_th) and the remaining ones are skipped once the wall time budget of the
+             search is exceeded (--solvus_ms_time=ms)
+3. cluster : the minima are visited by increasing driving force, a minimum with respected site fractions and a negative
+             driving force is added as a new considered phase when its endmember fractions are further than
+             merge_value from all the instances of the phase, including the ones just added
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MAGEMin.h"
+#include "toolkit.h"
+#include "objective_functions.h"
+#include "NLopt_opt_function.h"
+#include "ss_min_function.h"
+#include "solvus_function.h"
+#include "batch_levelling_function.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+  pick the starting pseudocompounds of solution phase i and store them from the start n on, returns the number of seeds
+*/
+int solvus_seeds(			int 				 i,
+							int 				 n,
+							global_variable 	*gv,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set 		*cp 				){
+	int 	*dist 	= gv->ws.dist;
+	int 	 n_xeos = SS_ref_db[i].n_xeos;
+	int 	 n_seed = 0;
+	int 	 max_n_pc, min_df_id, n_nb;
+	double 	 min_df, r2;
+
+	max_n_pc  = ((SS_ref_db[i].tot_pc >= SS_ref_db[i].n_pc) ? (SS_ref_db[i].n_pc) : (SS_ref_db[i].tot_pc));
+
+	if (SS_ref_db[i].kd_n != max_n_pc){
+		kdtree_build(			SS_ref_db[i].kd_idx,
+								SS_ref_db[i].xeos_pc,
+								max_n_pc,
+								n_xeos					);
+		SS_ref_db[i].kd_n = max_n_pc;
+	}
+
+	/* flag the PCs lying too close to an existing instance of the solution phase */
+	for (int l = 0; l < max_n_pc; l++){
+		dist[l] = 1;
+	}
+	r2 = pow(gv->PC_min_dist*gv->SS_PC_stp[i],2.0)*(double)n_xeos;
+	for (int k = 0; k < gv->len_cp; k++){
+		if (cp[k].ss_flags[0] == 1 && cp[k].id == i){
+			n_nb = kdtree_radius_search(	SS_ref_db[i].kd_idx,
+											SS_ref_db[i].xeos_pc,
+											max_n_pc,
+											n_xeos,
+											cp[k].xeos,
+											r2,
+											SS_ref_db[i].kd_nb		);
+			for (int m = 0; m < n_nb; m++){
+				dist[SS_ref_db[i].kd_nb[m]] = 0;
+			}
+		}
+	}
+
+	for (int l = 0; l < max_n_pc; l++){
+		if (dist[l] == 1){
+			SS_ref_db[i].DF_pc[l] = SS_ref_db[i].G_pc[l];
+			for (int j = 0; j < gv->len_ox; j++) {
+				SS_ref_db[i].DF_pc[l] -= SS_ref_db[i].comp_pc[l][j]*gv->gam_tot[j];
+			}
+		}
+	}
+
+	/* seeds by increasing driving force, every seed excludes its neighbourhood */
+	r2 = pow(gv->ms_sep*gv->SS_PC_stp[i],2.0)*(double)n_xeos;
+	while (n_seed < gv->ms_n){
+		min_df_id = -1;
+		min_df    = gv->PC_df_add;
+		for (int l = 0; l < max_n_pc; l++){
+			if (dist[l] == 1 && SS_ref_db[i].DF_pc[l] < min_df){
+				min_df 		= SS_ref_db[i].DF_pc[l];
+				min_df_id 	= l;
+			}
+		}
+		if (min_df_id == -1){
+			break;
+		}
+
+		gv->ws.ms_ph[n + n_seed] = i;
+		for (int j = 0; j < n_xeos; j++){
+			gv->ws.ms_x[(n + n_seed)*gv->ws.n_xeos_max + j] = SS_ref_db[i].xeos_pc[min_df_id][j];
+		}
+		n_seed += 1;
+
+		dist[min_df_id] = 0;
+		n_nb = kdtree_radius_search(	SS_ref_db[i].kd_idx,
+										SS_ref_db[i].xeos_pc,
+										max_n_pc,
+										n_xeos,
+										SS_ref_db[i].xeos_pc[min_df_id],
+										r2,
+										SS_ref_db[i].kd_nb		);
+		for (int m = 0; m < n_nb; m++){
+			dist[SS_ref_db[i].kd_nb[m]] = 0;
+		}
+	}
+
+	return n_seed;
+};
+
+/**
+  local minimization of the start k, in the solution phase (or scratch copy) SS_ref_db, as done by ss_min_PGE
+*/
+void solvus_LM(				int 				 k,
+							global_variable 	*gv,
+							struct bulk_info 	 z_b,
+							SS_ref 				*SS_ref_db 			){
+	int 	ph_id 	= gv->ws.ms_ph[k];
+	double *x 		= gv->ws.ms_x + k*gv->ws.n_xeos_max;
+	double *p 		= gv->ws.ms_p + k*gv->ws.n_em_max;
+
+	SS_ref_db->min_mode = 1;
+	for (int j = 0; j < SS_ref_db->n_xeos; j++){
+		SS_ref_db->iguess[j] = x[j];
+	}
+
+	rotate_hyperplane(			gv,
+								SS_ref_db					);
+
+	restrict_SS_HyperVolume(	gv,
+								SS_ref_db,
+								gv->box_size_mode_1			);
+
+	NLopt_opt_function(			gv,
+								SS_ref_db,
+								ph_id						);
+
+	for (int j = 0; j < SS_ref_db->n_xeos; j++){
+		SS_ref_db->iguess[j] = SS_ref_db->xeos[j];
+	}
+
+	PC_function(				gv,
+								SS_ref_db,
+								z_b,
+								gv->SS_list[ph_id] 			);
+
+	SS_UPDATE_function(			gv,
+								SS_ref_db,
+								z_b,
+								gv->SS_list[ph_id]			);
+
+	gv->ws.ms_ok[k] = SS_ref_db->sf_ok;
+	gv->ws.ms_df[k] = SS_ref_db->df_raw;
+	for (int j = 0; j < SS_ref_db->n_xeos; j++){
+		x[j] = SS_ref_db->iguess[j];
+	}
+	for (int j = 0; j < SS_ref_db->n_em; j++){
+		p[j] = SS_ref_db->p[j];
+	}
+};
+
+/**
+  add the minimum of the start k as a new instance of its solution phase
+*/
+void solvus_add_cp(			int 				 k,
+							global_variable 	*gv,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set 		*cp 				){
+	int 	ph_id 	= gv->ws.ms_ph[k];
+	int 	id_cp 	= gv->len_cp;
+	double *x 		= gv->ws.ms_x + k*gv->ws.n_xeos_max;
+	double *p 		= gv->ws.ms_p + k*gv->ws.n_em_max;
+
+	strcpy(cp[id_cp].name,gv->SS_list[ph_id]);					/* get phase name */
+	cp[id_cp].in_iter			= gv->global_ite;
+	cp[id_cp].split 			= 0;
+	cp[id_cp].id 				= ph_id;						/* get phase id */
+	cp[id_cp].n_xeos			= SS_ref_db[ph_id].n_xeos;		/* get number of compositional variables */
+	cp[id_cp].n_em				= SS_ref_db[ph_id].n_em;		/* get number of endmembers */
+	cp[id_cp].n_sf				= SS_ref_db[ph_id].n_sf;		/* get number of site fractions */
+
+	cp[id_cp].df				= gv->ws.ms_df[k];
+	cp[id_cp].factor			= 0.0;
+
+	cp[id_cp].ss_flags[0] 		= 1;							/* set flags */
+	cp[id_cp].ss_flags[1] 		= 0;
+	cp[id_cp].ss_flags[2] 		= 1;
+
+	cp[id_cp].ss_n          	= 0.0;							/* get initial phase fraction */
+
+	for (int ii = 0; ii < SS_ref_db[ph_id].n_em; ii++){
+		cp[id_cp].z_em[ii]      = SS_ref_db[ph_id].z_em[ii];
+		cp[id_cp].p_em[ii]      = p[ii];
+		cp[id_cp].mu[ii]    	= 0.0;
+	}
+	for (int ii = 0; ii < SS_ref_db[ph_id].n_xeos; ii++){
+		cp[id_cp].dguess[ii]    = x[ii];
+		cp[id_cp].lvlxeos[ii]   = x[ii];
+		cp[id_cp].xeos[ii]      = x[ii];
+	}
+
+	gv->id_solvi[ph_id][gv->n_solvi[ph_id]] = id_cp;
+	gv->n_solvi[ph_id] 	+= 1;
+	gv->len_cp 			+= 1;
+
+	if (gv->verbose == 1){
+		printf(" %4s  | %+10f | cp#%d added by the solvus search\n",gv->SS_list[ph_id],cp[id_cp].df,id_cp);
+	}
+};
+
+/**
+	multi-start solvus search of the selected solution phases (gv.ms_ss), adds the distinct minima below the
+	G-hyperplane as new considered phases
+*/
+void solvus_search(			struct bulk_info 	 z_b,
+							global_variable 	*gv,
+
+							SS_ref 				*SS_ref_db,
+							csd_phase_set 		*cp 				){
+	int 	n_ms 	 = 0;
+	int 	n_add 	 = 0;
+	int 	threaded = (gv->LM_threads > 1 && gv->SS_th != NULL && gv->verbose != 1) ? 1 : 0;
+	int 	best, ph_id, distinct;
+	double 	min_df;
+	double 	t0 		 = batch_wtime();
+
+	for (int i = 0; i < gv->len_ss; i++){
+		if (gv->ms_ss[i] == 1 && SS_ref_db[i].ss_flags[0] == 1 && gv->verifyPC[i] == 1){
+			n_ms += solvus_seeds(	i, n_ms,
+									gv,
+									SS_ref_db,
+									cp 				);
+		}
+	}
+	if (n_ms == 0){
+		return;
+	}
+
+	/**
+		local minimizations of the starts, the starts left when the time budget is exceeded are skipped
+	*/
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(gv->LM_threads) if(threaded)
+	for (int k = 0; k < n_ms; k++){
+		int 	ph 		= gv->ws.ms_ph[k];
+		int 	thread 	= 0;
+		SS_ref *SS 		= &SS_ref_db[ph];
+
+		gv->ws.ms_ok[k] = 0;
+		if (gv->ms_time > 0.0 && (batch_wtime() - t0)*1000.0 > gv->ms_time){
+			continue;
+		}
+		if (threaded == 1){
+#ifdef _OPENMP
+			thread 		= omp_get_thread_num();
+#endif
+			gv->SS_th[thread][ph] = SS_scratch_swap(	SS_ref_db[ph],
+														gv->SS_th[thread][ph]	);
+			SS 			= &gv->SS_th[thread][ph];
+		}
+		solvus_LM(			k,
+							gv,
+							z_b,
+							SS 					);
+	}
+
+	/**
+		cluster the minima, by increasing driving force
+	*/
+	while (gv->len_cp < gv->max_n_cp){
+		best 	= -1;
+		min_df 	= 0.0;
+		for (int k = 0; k < n_ms; k++){
+			if (gv->ws.ms_ok[k] == 1 && gv->ws.ms_df[k] < min_df){
+				min_df 	= gv->ws.ms_df[k];
+				best 	= k;
+			}
+		}
+		if (best == -1){
+			break;
+		}
+		gv->ws.ms_ok[best] = 0;
+
+		ph_id 	 = gv->ws.ms_ph[best];
+		distinct = 1;
+		for (int l = 0; l < gv->len_cp; l++){
+			if (cp[l].ss_flags[0] == 1 && cp[l].id == ph_id
+				&& euclidean_distance(cp[l].p_em, gv->ws.ms_p + best*gv->ws.n_em_max, SS_ref_db[ph_id].n_em) < gv->merge_value){
+				distinct = 0;
+				break;
+			}
+		}
+		if (distinct == 1){
+			solvus_add_cp(	best,
+							gv,
+							SS_ref_db,
+							cp 				);
+			n_add += 1;
+
+			if (gv->len_cp == gv->max_n_cp){
+				printf(" !! Maxmimum number of allowed phases under consideration reached !!\n    -> check your problem and potentially increase gv->max_n_cp\n");
+			}
+		}
+	}
+
+	if (gv->verbose == 1){
+		printf(" solvus search: %d starts, %d instances added (%.3f ms)\n\n",n_ms,n_add,(batch_wtime() - t0)*1000.0);
+	}
+};
@@ -0,0 +1,26 @@
+#ifndef __SOLVUS_FUNCTION_H_
+#define __SOLVUS_FUNCTION_H_
+
+int solvus_seeds(			int 				 i,
+							int 				 n,
+							global_variable 	*gv,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set 		*cp 				);
+
+void solvus_LM(				int 				 k,
+							global_variable 	*gv,
+							struct bulk_info 	 z_b,
+							SS_ref 				*SS_ref_db 			);
+
+void solvus_add_cp(			int 				 k,
+							global_variable 	*gv,
+							SS_ref 				*SS_ref_db,
+							csd_phase_set 		*cp 				);
+
+void solvus_search(			struct bulk_info 	 z_b,
+							global_variable 	*gv,
+
+							SS_ref 				*SS_ref_db,
+							csd_phase_set 		*cp 				);
+
+#endif
@@ -16,6 +16,7 @@ Function to call solution phase Minimization
 #include "gem_function.h"
 #include "gss_function.h"
 #include "NLopt_opt_function.h"
+#include "SQP_opt_function.h"
 #include "dump_function.h"
 #include "toolkit.h"
 #include "phase_update_function.h"
@@ -24,36 +25,34 @@ Function to call solution phase Minimization
 /** 
 Function to update xi and sum_xi during local minimization.
 */
-SS_ref SS_UPDATE_function(		global_variable gv,
-								SS_ref SS_ref_db, 
+void SS_UPDATE_function(		global_variable *gv,
+								SS_ref *SS_ref_db, 
 								struct bulk_info z_b,
 								char    *name){
 
 	/* sf_ok?*/
-	SS_ref_db.sf_ok = 1;
-	for (int i = 0; i < SS_ref_db.n_sf; i++){
-		if (SS_ref_db.sf[i] <= 0.0 || isnan(SS_ref_db.sf[i]) == 1|| isinf(SS_ref_db.sf[i]) == 1){
-			SS_ref_db.sf_ok = 0;	
+	SS_ref_db->sf_ok = 1;
+	for (int i = 0; i < SS_ref_db->n_sf; i++){
+		if (SS_ref_db->sf[i] <= 0.0 || isnan(SS_ref_db->sf[i]) == 1|| isinf(SS_ref_db->sf[i]) == 1){
+			SS_ref_db->sf_ok = 0;	
 			break;
 		}
 	}
 
 	/* xi calculation (phase fraction expression for PGE) */
-	SS_ref_db.sum_xi 	= 0.0;	
-	for (int i = 0; i < SS_ref_db.n_em; i++){ 
-		SS_ref_db.xi_em[i] = exp(-SS_ref_db.mu[i]/(SS_ref_db.R*SS_ref_db.T));
-		SS_ref_db.sum_xi  += SS_ref_db.xi_em[i]*SS_ref_db.p[i]*SS_ref_db.z_em[i];
+	SS_ref_db->sum_xi 	= 0.0;	
+	for (int i = 0; i < SS_ref_db->n_em; i++){ 
+		SS_ref_db->xi_em[i] = exp(-SS_ref_db->mu[i]/(SS_ref_db->R*SS_ref_db->T));
+		SS_ref_db->sum_xi  += SS_ref_db->xi_em[i]*SS_ref_db->p[i]*SS_ref_db->z_em[i];
 	}
 
 	/* get composition of solution phase */
 	for (int j = 0; j < nEl; j++){
-		SS_ref_db.ss_comp[j] = 0.0;
-		for (int i = 0; i < SS_ref_db.n_em; i++){
-		   SS_ref_db.ss_comp[j] += SS_ref_db.Comp[i][j]*SS_ref_db.p[i]*SS_ref_db.z_em[i];
+		SS_ref_db->ss_comp[j] = 0.0;
+		for (int i = 0; i < SS_ref_db->n_em; i++){
+		   SS_ref_db->ss_comp[j] += SS_ref_db->Comp[i][j]*SS_ref_db->p[i]*SS_ref_db->z_em[i];
 	   } 
 	}
-
-	return SS_ref_db;
 };
 
 
@@ -61,7 +60,7 @@ SS_ref SS_UPDATE_function(		global_variable gv,
 Function to update xi and sum_xi for the considered phases list (during the inner loop of the PGE stage).
 NOTE: When the phase is "liq", the normalization factor is also updated as it depends on the endmember fractions
 */
-csd_phase_set CP_UPDATE_function(		global_variable 	gv,
+csd_phase_set CP_UPDATE_function(		global_variable 	*gv,
 										SS_ref 				SS_ref_db,
 										csd_phase_set  		cp, 
 										struct bulk_info 	z_b			){
@@ -98,10 +97,10 @@ csd_phase_set CP_UPDATE_function(		global_variable 	gv,
 	- Drifting occurs when tilting of the hyperplane moves the x-eos far away from their initial guess
 	- Note that each instance of the phase, initialized during levelling can only be split once
 */
-global_variable split_cp(	int 				i, 
-							global_variable 	gv,
-							SS_ref 			    *SS_ref_db,
-							csd_phase_set  		*cp
+void split_cp(	int 				i, 
+				global_variable 	*gv,
+				SS_ref 			    *SS_ref_db,
+				csd_phase_set  		*cp
 ){
 	int id_cp;
 	int ph_id = cp[i].id;
@@ -109,13 +108,13 @@ global_variable split_cp(	int 				i,
 
 	distance 	= euclidean_distance( cp[i].xeos, cp[i].dguess, SS_ref_db[ph_id].n_xeos);
 
-	if (distance > 2.0*gv.SS_PC_stp[ph_id]*pow((double)SS_ref_db[ph_id].n_xeos,0.5) && cp[i].split == 0){
-		id_cp 					= gv.len_cp;
+	if (distance > 2.0*gv->SS_PC_stp[ph_id]*pow((double)SS_ref_db[ph_id].n_xeos,0.5) && cp[i].split == 0){
+		id_cp 					= gv->len_cp;
 				
 		cp[id_cp].split 		= 1;							/* set split number to one */
 		cp[i].split 			= 1;							/* set split number to one */
 
-		strcpy(cp[id_cp].name,gv.SS_list[ph_id]);				/* get phase name */	
+		strcpy(cp[id_cp].name,gv->SS_list[ph_id]);				/* get phase name */	
 		
 		cp[id_cp].id 			= ph_id;						/* get phaseid */
 		cp[id_cp].n_xeos		= SS_ref_db[ph_id].n_xeos;		/* get number of compositional variables */
@@ -141,30 +140,152 @@ global_variable split_cp(	int 				i,
 			cp[i].dguess[ii]    	= cp[i].xeos[ii];
 		}
 		
-		gv.id_solvi[ph_id][gv.n_solvi[ph_id]] = id_cp;
-		gv.n_solvi[ph_id] 	+= 1;
-		gv.len_cp 			+= 1;
+		gv->id_solvi[ph_id][gv->n_solvi[ph_id]] = id_cp;
+		gv->n_solvi[ph_id] 	+= 1;
+		gv->len_cp 			+= 1;
 		
-		if (gv.verbose == 1){
-			printf("\n  {FYI} %4s cp#%d is grazing away from its field, a copy has been added (xeos = dguess)\n",gv.SS_list[ph_id],i);
+		if (gv->verbose == 1){
+			printf("\n  {FYI} %4s cp#%d is grazing away from its field, a copy has been added (xeos = dguess)\n",gv->SS_list[ph_id],i);
 		}
 		
-		if (gv.len_cp == gv.max_n_cp){
-			printf(" !! Maxmimum number of allowed phases under consideration reached !!\n    -> check your problem and potentially increase gv.max_n_cp\n");
+		if (gv->len_cp == gv->max_n_cp){
+			printf(" !! Maxmimum number of allowed phases under consideration reached !!\n    -> check your problem and potentially increase gv->max_n_cp\n");
 		}
 		
 	}
-	
-	return gv;
 };
 
 
+/**
+	copy the state of solution phase SS_ref_db (x-eos in iguess, evaluated by PC_function and SS_UPDATE_function) to
+	the considered phase cp_i
+*/
+void SS_to_cp(			global_variable 	*gv,
+						SS_ref 				*SS_ref_db,
+						csd_phase_set 		*cp_i 			){
+
+	cp_i->df				= SS_ref_db->df_raw;
+	cp_i->factor			= SS_ref_db->factor;
+	cp_i->sum_xi			= SS_ref_db->sum_xi;
+
+	for (int ii = 0; ii < cp_i->n_xeos; ii++){
+		cp_i->xeos[ii]		= SS_ref_db->iguess[ii]; 
+		cp_i->dfx[ii]		= SS_ref_db->dfx[ii]; 
+	}
+	for (int ii = 0; ii < cp_i->n_em; ii++){
+		cp_i->p_em[ii]		= SS_ref_db->p[ii];
+		cp_i->xi_em[ii]		= SS_ref_db->xi_em[ii];
+		cp_i->mu[ii]		= SS_ref_db->mu[ii];
+	}
+	for (int ii = 0; ii < SS_ref_db->n_em; ii++){
+		for (int jj = 0; jj < SS_ref_db->n_xeos; jj++){
+			cp_i->dpdx[ii][jj] = SS_ref_db->dp_dx[ii][jj];
+		}
+	}
+	for (int ii = 0; ii < gv->len_ox; ii++){
+		cp_i->ss_comp[ii]	= SS_ref_db->ss_comp[ii];
+	}
+	for (int ii = 0; ii < cp_i->n_sf; ii++){
+		cp_i->sf[ii]		= SS_ref_db->sf[ii];
+	}
+};
+
+/**
+	key of the local minimization about to be run in SS_ref_db: every input the minimizer depends on. The rotated
+	reference G (gb_lvl) carries Gamma and, with P and T, the pressure-temperature dependent data of the phase, such
+	that an entry is not returned anymore as soon as gb_lvl changes
+*/
+void LM_cache_key(		global_variable 	*gv,
+						SS_ref 				*SS_ref_db,
+						double 				*key 			){
+
+	int n_em 	= SS_ref_db->n_em;
+	int n_xeos 	= SS_ref_db->n_xeos;
+	int k 		= 0;
+
+	key[k++] = SS_ref_db->P;
+	key[k++] = SS_ref_db->T;
+	key[k++] = SS_ref_db->min_mode;
+	key[k++] = SS_ref_db->LM_ee;
+	key[k++] = gv->maxeval;
+	for (int j = 0; j < n_em; j++){
+		key[k++] = SS_ref_db->gb_lvl[j];
+	}
+	for (int j = 0; j < n_xeos; j++){
+		key[k++] = SS_ref_db->iguess[j];
+		key[k++] = SS_ref_db->box_bounds[j][0];
+		key[k++] = SS_ref_db->box_bounds[j][1];
+	}
+};
+
+/**
+	look up key in the memo table of SS_ref_db, newest entry first. On a hit the output of the local minimizer (xeos,
+	df, status) is restored and 1 is returned
+*/
+int LM_cache_lookup(	global_variable 	*gv,
+						SS_ref 				*SS_ref_db,
+						double 				*key 			){
+
+	LM_cache *c 	= SS_ref_db->cache;
+	int 	  n_x 	= SS_ref_db->n_xeos;
+	int 	  e, ok;
+	double 	 *ke;
+
+	c->n_lookup += 1;
+	for (int l = 1; l <= c->n_used; l++){
+		e 	= (c->next - l + c->n) % c->n;
+		ke 	= c->key + e*c->len_key;
+		ok 	= 1;
+		for (int k = 0; k < c->len_key; k++){
+			if (fabs(key[k] - ke[k]) > gv->LM_cache_tol*(1.0 + fabs(key[k]))){ ok = 0; break; }
+		}
+		if (ok == 1){
+			for (int j = 0; j < n_x; j++){
+				SS_ref_db->xeos[j] = c->xeos[e*n_x + j];
+			}
+			SS_ref_db->df 			= c->df[e];
+			SS_ref_db->status 		= c->status[e];
+			SS_ref_db->LM_ee_exit 	= c->ee_exit[e];
+			SS_ref_db->LM_ee 		= 0;
+			SS_ref_db->n_eval 		= 0;
+			SS_ref_db->LM_time 		= 0.0;
+			c->n_hit 			   += 1;
+			return 1;
+		}
+	}
+	return 0;
+};
+
+/**
+	store the output of the local minimization of SS_ref_db under key, replacing the oldest entry when the table is full
+*/
+void LM_cache_store(	SS_ref 				*SS_ref_db,
+						double 				*key 			){
+
+	LM_cache *c 	= SS_ref_db->cache;
+	int 	  n_x 	= SS_ref_db->n_xeos;
+	int 	  e 	= c->next;
+
+	for (int k = 0; k < c->len_key; k++){
+		c->key[e*c->len_key + k] = key[k];
+	}
+	for (int j = 0; j < n_x; j++){
+		c->xeos[e*n_x + j] = SS_ref_db->xeos[j];
+	}
+	c->df[e] 		= SS_ref_db->df;
+	c->status[e] 	= SS_ref_db->status;
+	c->ee_exit[e] 	= SS_ref_db->LM_ee_exit;
+
+	c->next 		= (e + 1) % c->n;
+	c->n_used 		= (c->n_used < c->n) ? c->n_used + 1 : c->n;
+};
+
 /** 
 	Minimization function for PGE 
 */
 void ss_min_PGE(		int 				mode, 
 						int 				i, 
-						global_variable 	gv,
+						global_variable 	*gv,
 						struct 	bulk_info 	z_b,
 						SS_ref 			    *SS_ref_db,
 						csd_phase_set  		*cp
@@ -173,7 +294,6 @@ void ss_min_PGE(		int 				mode,
 	
 	cp[i].min_time		  		= 0.0;								/** reset local minimization time to 0.0 */
 	SS_ref_db[ph_id].min_mode 	= mode;								/** send the right mode to the local minimizer */
-	gv.maxeval   		  		= gv.maxeval_mode_1;
 
 	/**
 		set the iguess of the solution phase to the one of the considered phase 
@@ -185,12 +305,12 @@ void ss_min_PGE(		int 				mode,
 	/**
 		Rotate G-base hyperplane
 	*/
-	SS_ref_db[ph_id] = rotate_hyperplane(	gv, 
-											SS_ref_db[ph_id]			);
+	rotate_hyperplane(	gv, 
+						&SS_ref_db[ph_id]			);
 
 
 	double relax, norm;
-	if (cp[i].in_iter > 0 && abs(cp[i].in_iter - gv.global_ite) <= 8){
+	if (cp[i].in_iter > 0 && abs(cp[i].in_iter - gv->global_ite) <= 8){
 		relax = 1.0;
 	}
 	else{
@@ -198,7 +318,7 @@ void ss_min_PGE(		int 				mode,
 	}
 
 	norm = 1.0;
-	if (gv.BR_norm < gv.relax_PGE){
+	if (gv->BR_norm < gv->relax_PGE){
 		norm = norm_vector(cp[i].mu,cp[i].n_em)/relax;
 		if (norm > 1.0){ 
 			norm = 1.0;
@@ -208,16 +328,46 @@ void ss_min_PGE(		int 				mode,
 	/**
 		Define a sub-hypervolume for the solution phases bounds
 	*/
-	SS_ref_db[ph_id] = restrict_SS_HyperVolume(	gv, 
-												SS_ref_db[ph_id],
-												gv.box_size_mode_1*norm	);
+	restrict_SS_HyperVolume(	gv, 
+								&SS_ref_db[ph_id],
+								gv->box_size_mode_1*norm	);
 	
+	/**
+		on-hold phases may stop as soon as LM_early_exit decides the sign of their driving force (--LM_early=1, heuristic)
+	*/
+	SS_ref_db[ph_id].LM_ee 		= (gv->LM_early == 1 && cp[i].ss_flags[1] == 0 && cp[i].n_LM > 0) ? 1 : 0;
+
+	/**
+		return the memorized minimization when the same inputs were already minimized (--LM_cache=n)
+	*/
+	LM_cache *cache = SS_ref_db[ph_id].cache;
+	double 	 *key 	= SS_ref_db[ph_id].LM_key;
+	int 	  hit 	= 0;
+
+	if (cache != NULL){
+		LM_cache_key(		gv,
+							&SS_ref_db[ph_id],
+							key 						);
+		#pragma omp critical(LM_cache)
+		hit = LM_cache_lookup(	gv,
+								&SS_ref_db[ph_id],
+								key 					);
+	}
+
 	/**
 		call to NLopt for non-linear + inequality constraints optimization
 	*/
-	SS_ref_db[ph_id] = NLopt_opt_function(	gv, 
-											SS_ref_db[ph_id], 
-											ph_id						);
+	if (hit == 0){
+		NLopt_opt_function(	gv, 
+							&SS_ref_db[ph_id], 
+							ph_id						);
+
+		if (cache != NULL){
+			#pragma omp critical(LM_cache)
+			LM_cache_store(		&SS_ref_db[ph_id],
+								key 					);
+		}
+	}
 	
 	/**
 		establish a set of conditions to update initial guess for next round of local minimization 
@@ -226,57 +376,61 @@ void ss_min_PGE(		int 				mode,
 		SS_ref_db[ph_id].iguess[k]  = SS_ref_db[ph_id].xeos[k];
 	}	
 
-	SS_ref_db[ph_id] = PC_function(			gv,
-											SS_ref_db[ph_id], 
-											z_b,
-											gv.SS_list[ph_id] 			);
+	PC_function(			gv,
+							&SS_ref_db[ph_id], 
+							z_b,
+							gv->SS_list[ph_id] 			);
 											
-	SS_ref_db[ph_id] = SS_UPDATE_function(	gv, 
-											SS_ref_db[ph_id], 
-											z_b, 
-											gv.SS_list[ph_id]			);
+	SS_UPDATE_function(	gv, 
+						&SS_ref_db[ph_id], 
+						z_b, 
+						gv->SS_list[ph_id]			);
 	
 	/**
 		copy the minimized phase informations to cp structure, if the site fractions are respected
 	*/
-	if (SS_ref_db[ph_id].sf_ok == 1){
-		cp[i].min_time			= SS_ref_db[ph_id].LM_time;
-		cp[i].df				= SS_ref_db[ph_id].df_raw;
-		cp[i].factor			= SS_ref_db[ph_id].factor;
-		cp[i].sum_xi			= SS_ref_db[ph_id].sum_xi;
+	cp[i].min_skip 				= 0;
+	cp[i].n_LM 				   += 1;
+	cp[i].LM_time 			   += SS_ref_db[ph_id].LM_time;
+	cp[i].n_eval 			   += SS_ref_db[ph_id].n_eval;
+	if (hit == 1){
+		cp[i].n_hit 		   += 1;
+	}
+	else if (SS_ref_db[ph_id].LM_ee_exit != 0){
+		cp[i].n_ee 			   += 1;
+		cp[i].n_eval_saved 	   += (cp[i].n_eval_ref > SS_ref_db[ph_id].n_eval) ? cp[i].n_eval_ref - SS_ref_db[ph_id].n_eval : 0;
+	}
+	else{
+		cp[i].n_eval_ref 		= SS_ref_db[ph_id].n_eval;
+	}
 
-		for (int ii = 0; ii < cp[i].n_xeos; ii++){
-			cp[i].xeos[ii]		= SS_ref_db[ph_id].iguess[ii]; 
-			cp[i].dfx[ii]		= SS_ref_db[ph_id].dfx[ii]; 
-		}
-		
-		for (int ii = 0; ii < cp[i].n_em; ii++){
-			cp[i].p_em[ii]		= SS_ref_db[ph_id].p[ii];
-			cp[i].xi_em[ii]		= SS_ref_db[ph_id].xi_em[ii];
-			cp[i].mu[ii]		= SS_ref_db[ph_id].mu[ii];
-		}
-		for (int ii = 0; ii < SS_ref_db[ph_id].n_em; ii++){
-			for (int jj = 0; jj < SS_ref_db[ph_id].n_xeos; jj++){
-				cp[i].dpdx[ii][jj] = SS_ref_db[ph_id].dp_dx[ii][jj];
-			}
+	if (SS_ref_db[ph_id].sf_ok == 1){
+		/* the minimization is steady when it leaves x-eos and the (rotated) driving force unchanged */
+		if (		euclidean_distance(cp[i].xeos, SS_ref_db[ph_id].iguess, cp[i].n_xeos) 	< gv->adapt_xeos_tol
+				&& 	fabs(cp[i].df - SS_ref_db[ph_id].df_raw) 								< gv->adapt_df_tol		){
+			cp[i].min_stable   += 1;
 		}
-		for (int ii = 0; ii < gv.len_ox; ii++){
-			cp[i].ss_comp[ii]	= SS_ref_db[ph_id].ss_comp[ii];
+		else{
+			cp[i].min_stable 	= 0;
 		}
-		
-		for (int ii = 0; ii < cp[i].n_sf; ii++){
-			cp[i].sf[ii]		= SS_ref_db[ph_id].sf[ii];
-		}	
+
+		cp[i].min_time			= SS_ref_db[ph_id].LM_time;
+		cp[i].df_LM				= SS_ref_db[ph_id].df_raw;
+
+		SS_to_cp(				gv,
+								&SS_ref_db[ph_id],
+								&cp[i] 						);
 	}
 	else{
-		if (gv.verbose == 1){
-			printf(" !> SF not respected for %4s (SS not updated)\n",gv.SS_list[ph_id]);
+		cp[i].min_stable 		= 0;
+		if (gv->verbose == 1){
+			printf(" !> SF not respected for %4s (SS not updated)\n",gv->SS_list[ph_id]);
 		}	
 	}
 	/** 
 		print solution phase informations 
 	*/
-	if (gv.verbose == 1){
+	if (gv->verbose == 1){
 		print_SS_informations(  gv,
 								SS_ref_db[ph_id],
 								ph_id									);
@@ -284,110 +438,367 @@ void ss_min_PGE(		int 				mode,
 };
 
 
+/**
+	Scratch copy of a solution phase for the threaded local minimizations: the arrays modified by the local minimizer
+	are duplicated, the P-T dependent data (gbase, Comp, W, bounds, ...) are shared with SS_ref_db. Each thread gets its
+	own copy of the NLopt optimizer of the phase
+*/
+SS_ref SS_scratch_init(			global_variable 	*gv,
+								SS_ref 				SS_ref_db		){
+
+	SS_ref 	SS_th  = SS_ref_db;
+	int 	n_em   = SS_ref_db.n_em;
+	int 	n_xeos = SS_ref_db.n_xeos;
+	int 	n_sf   = SS_ref_db.n_sf;
+
+	SS_th.box_bounds 	= malloc (n_xeos 		* sizeof (double*)	);
+	for (int i = 0; i < n_xeos; i++){
+		SS_th.box_bounds[i] = malloc (2 		* sizeof (double) 	);
+	}
+	SS_th.dp_dx 		= malloc (n_em 			* sizeof (double*)	);
+	for (int i = 0; i < n_em; i++){
+		SS_th.dp_dx[i] 	= malloc (n_xeos 		* sizeof (double) 	);
+	}
+	SS_th.gb_lvl  		= malloc (n_em   	 	* sizeof (double) 	);
+	SS_th.iguess  		= malloc (n_xeos   	  	* sizeof (double) 	);
+	SS_th.p       		= malloc (n_em       	* sizeof (double) 	);
+	SS_th.mat_phi 		= malloc (n_em       	* sizeof (double) 	);
+	SS_th.mu_Gex  		= malloc (n_em       	* sizeof (double) 	);
+	SS_th.sf      		= malloc (n_sf       	* sizeof (double) 	);
+	SS_th.dsf      		= malloc ((n_sf*n_xeos) * sizeof (double) 	);
+	SS_th.mu      		= malloc (n_em       	* sizeof (double) 	);
+	SS_th.dfx    		= malloc (n_xeos     	* sizeof (double) 	);
+	SS_th.ss_comp		= malloc (gv->len_ox  	* sizeof (double) 	);
+	SS_th.xi_em   		= malloc (n_em   	 	* sizeof (double) 	);
+	SS_th.xeos    		= malloc (n_xeos     	* sizeof (double) 	);
+	SS_th.xeos_sf_ok 	= malloc (n_xeos 		* sizeof (double) 	);
+	SS_th.ub   			= malloc (n_xeos 		* sizeof (double) 	);
+	SS_th.lb   			= malloc (n_xeos 		* sizeof (double) 	);
+	SS_th.opt 			= nlopt_copy(SS_ref_db.opt);
+	SS_th.sqp_ws 		= malloc (SQP_ws_size(n_xeos, n_sf)  * sizeof (double) 	);
+	SS_th.sqp_iw 		= malloc (SQP_iws_size(n_xeos, n_sf) * sizeof (int) 		);
+	SS_th.hess_ws 		= malloc (SS_hess_ws_size(n_em, n_xeos) * sizeof (double) );
+	SS_th.LM_key 		= (SS_ref_db.cache != NULL) ? malloc (SS_ref_db.cache->len_key * sizeof (double) ) : NULL;
+
+	return SS_th;
+};
+
+/**
+	Solution phase SS_ref_db working in the arrays of the scratch copy SS_th (scalars and shared data are the ones of SS_ref_db)
+*/
+SS_ref SS_scratch_swap(			SS_ref 				SS_ref_db,
+								SS_ref 				SS_th			){
+
+	SS_ref_db.box_bounds 	= SS_th.box_bounds;
+	SS_ref_db.dp_dx 		= SS_th.dp_dx;
+	SS_ref_db.gb_lvl  		= SS_th.gb_lvl;
+	SS_ref_db.iguess  		= SS_th.iguess;
+	SS_ref_db.p       		= SS_th.p;
+	SS_ref_db.mat_phi 		= SS_th.mat_phi;
+	SS_ref_db.mu_Gex  		= SS_th.mu_Gex;
+	SS_ref_db.sf      		= SS_th.sf;
+	SS_ref_db.dsf      		= SS_th.dsf;
+	SS_ref_db.mu      		= SS_th.mu;
+	SS_ref_db.dfx    		= SS_th.dfx;
+	SS_ref_db.ss_comp		= SS_th.ss_comp;
+	SS_ref_db.xi_em   		= SS_th.xi_em;
+	SS_ref_db.xeos    		= SS_th.xeos;
+	SS_ref_db.xeos_sf_ok 	= SS_th.xeos_sf_ok;
+	SS_ref_db.ub   			= SS_th.ub;
+	SS_ref_db.lb   			= SS_th.lb;
+	SS_ref_db.opt 			= SS_th.opt;
+	SS_ref_db.sqp_ws 		= SS_th.sqp_ws;
+	SS_ref_db.sqp_iw 		= SS_th.sqp_iw;
+	SS_ref_db.hess_ws 		= SS_th.hess_ws;
+	SS_ref_db.LM_key 		= SS_th.LM_key;
+
+	return SS_ref_db;
+};
+
+/**
+	Copy the state of the scratch copy SS_th, left by a local minimization, back to the solution phase SS_ref_db
+*/
+SS_ref SS_scratch_copy(			global_variable 	*gv,
+								SS_ref 				SS_ref_db,
+								SS_ref 				SS_th			){
+
+	int 	n_em   = SS_th.n_em;
+	int 	n_xeos = SS_th.n_xeos;
+	int 	n_sf   = SS_th.n_sf;
+
+	for (int i = 0; i < n_xeos; i++){
+		SS_ref_db.box_bounds[i][0] 	= SS_th.box_bounds[i][0];
+		SS_ref_db.box_bounds[i][1] 	= SS_th.box_bounds[i][1];
+		SS_ref_db.iguess[i] 		= SS_th.iguess[i];
+		SS_ref_db.dfx[i] 			= SS_th.dfx[i];
+		SS_ref_db.xeos[i] 			= SS_th.xeos[i];
+		SS_ref_db.xeos_sf_ok[i] 	= SS_th.xeos_sf_ok[i];
+		SS_ref_db.ub[i] 			= SS_th.ub[i];
+		SS_ref_db.lb[i] 			= SS_th.lb[i];
+	}
+	for (int i = 0; i < n_em; i++){
+		for (int j = 0; j < n_xeos; j++){
+			SS_ref_db.dp_dx[i][j] 	= SS_th.dp_dx[i][j];
+		}
+		SS_ref_db.gb_lvl[i] 		= SS_th.gb_lvl[i];
+		SS_ref_db.p[i] 				= SS_th.p[i];
+		SS_ref_db.mat_phi[i] 		= SS_th.mat_phi[i];
+		SS_ref_db.mu_Gex[i] 		= SS_th.mu_Gex[i];
+		SS_ref_db.mu[i] 			= SS_th.mu[i];
+		SS_ref_db.xi_em[i] 			= SS_th.xi_em[i];
+	}
+	for (int i = 0; i < n_sf; i++){
+		SS_ref_db.sf[i] 			= SS_th.sf[i];
+	}
+	for (int i = 0; i < n_sf*n_xeos; i++){
+		SS_ref_db.dsf[i] 			= SS_th.dsf[i];
+	}
+	for (int i = 0; i < gv->len_ox; i++){
+		SS_ref_db.ss_comp[i] 		= SS_th.ss_comp[i];
+	}
+
+	/* scalars (df, factor, sum_xi, status, ...) are the ones of SS_th, arrays the ones of SS_ref_db */
+	return SS_scratch_swap(SS_th, SS_ref_db);
+};
+
+/**
+	Allocate the scratch copies of the solution phases used by the threaded local minimizations (gv.LM_threads > 1)
+*/
+void init_LM_threads(		global_variable 	*gv,
+							SS_ref 				*SS_ref_db		){
+
+#ifndef _OPENMP
+	if (gv->LM_threads > 1 && gv->verbose == 1){
+		printf(" MAGEMin was compiled without OpenMP, --LM_threads is ignored\n");
+	}
+	gv->LM_threads = 1;
+#endif
+	if (gv->LM_threads < 2){
+		gv->SS_th = NULL;
+		return;
+	}
+
+	gv->SS_th = malloc (gv->LM_threads * sizeof(SS_ref*));
+	for (int t = 0; t < gv->LM_threads; t++){
+		gv->SS_th[t] = malloc (gv->len_ss * sizeof(SS_ref));
+		for (int i = 0; i < gv->len_ss; i++){
+			gv->SS_th[t][i] = SS_scratch_init(	gv,
+												SS_ref_db[i]	);
+		}
+	}
+};
+
+/**
+	Allocate the memo tables of the local minimizations (gv.LM_cache > 0). They are kept for the whole run, as the
+	keys hold P, T and the rotated reference G. Called before init_LM_threads, which gives each scratch copy its own
+	key buffer
+*/
+void init_LM_cache(			global_variable 	*gv,
+							SS_ref 				*SS_ref_db		){
+
+	if (gv->LM_cache < 1){
+		return;
+	}
+	for (int i = 0; i < gv->len_ss; i++){
+		LM_cache *c 	= malloc (sizeof(LM_cache));
+		int 	  n 	= gv->LM_cache;
+
+		c->n 			= n;
+		c->n_used 		= 0;
+		c->next 		= 0;
+		c->len_key 		= 5 + SS_ref_db[i].n_em + 3*SS_ref_db[i].n_xeos;
+		c->key 			= malloc (n*c->len_key 			* sizeof (double) 	);
+		c->xeos 		= malloc (n*SS_ref_db[i].n_xeos * sizeof (double) 	);
+		c->df 			= malloc (n 					* sizeof (double) 	);
+		c->status 		= malloc (n 					* sizeof (int) 		);
+		c->ee_exit 		= malloc (n 					* sizeof (int) 		);
+		c->n_lookup 	= 0;
+		c->n_hit 		= 0;
+
+		SS_ref_db[i].cache 	= c;
+		SS_ref_db[i].LM_key = malloc (c->len_key 		* sizeof (double) 	);
+	}
+};
+
+/**
+	Free the memo tables of the local minimizations
+*/
+void destroy_LM_cache(		global_variable 	*gv,
+							SS_ref 				*SS_ref_db		){
+
+	for (int i = 0; i < gv->len_ss; i++){
+		LM_cache *c = SS_ref_db[i].cache;
+		if (c == NULL){ continue; }
+
+		free(c->key);
+		free(c->xeos);
+		free(c->df);
+		free(c->status);
+		free(c->ee_exit);
+		free(c);
+		free(SS_ref_db[i].LM_key);
+		SS_ref_db[i].cache 	= NULL;
+		SS_ref_db[i].LM_key = NULL;
+	}
+};
+
+/**
+	Free the scratch copies of the solution phases
+*/
+void destroy_LM_threads(				global_variable 	*gv 			){
+
+	if (gv->SS_th == NULL){ return; }
+
+	for (int t = 0; t < gv->LM_threads; t++){
+		for (int i = 0; i < gv->len_ss; i++){
+			for (int j = 0; j < gv->SS_th[t][i].n_xeos; j++){
+				free(gv->SS_th[t][i].box_bounds[j]);
+			}
+			for (int j = 0; j < gv->SS_th[t][i].n_em; j++){
+				free(gv->SS_th[t][i].dp_dx[j]);
+			}
+			free(gv->SS_th[t][i].box_bounds);
+			free(gv->SS_th[t][i].dp_dx);
+			free(gv->SS_th[t][i].gb_lvl);
+			free(gv->SS_th[t][i].iguess);
+			free(gv->SS_th[t][i].p);
+			free(gv->SS_th[t][i].mat_phi);
+			free(gv->SS_th[t][i].mu_Gex);
+			free(gv->SS_th[t][i].sf);
+			free(gv->SS_th[t][i].dsf);
+			free(gv->SS_th[t][i].mu);
+			free(gv->SS_th[t][i].dfx);
+			free(gv->SS_th[t][i].ss_comp);
+			free(gv->SS_th[t][i].xi_em);
+			free(gv->SS_th[t][i].xeos);
+			free(gv->SS_th[t][i].xeos_sf_ok);
+			free(gv->SS_th[t][i].ub);
+			free(gv->SS_th[t][i].lb);
+			nlopt_destroy(gv->SS_th[t][i].opt);
+			free(gv->SS_th[t][i].sqp_ws);
+			free(gv->SS_th[t][i].sqp_iw);
+			free(gv->SS_th[t][i].hess_ws);
+			free(gv->SS_th[t][i].LM_key);
+		}
+		free(gv->SS_th[t]);
+	}
+	free(gv->SS_th);
+};
+
 /**
   reset global variable for parallel calculations 
 */
-global_variable reset_global_variables(		global_variable 	gv,
-											PP_ref 				*PP_ref_db,
-											SS_ref 				*SS_ref_db,
-											csd_phase_set  		*cp
+void reset_global_variables(		global_variable 	*gv,
+									PP_ref 				*PP_ref_db,
+									SS_ref 				*SS_ref_db,
+									csd_phase_set  		*cp
 ){
 	int i,k;
-	for (k = 0; k < gv.n_flags; k++){
-		for (i = 0; i < gv.len_pp; i++){
-			gv.pp_flags[i][k]   = 0;
+	for (k = 0; k < gv->n_flags; k++){
+		for (i = 0; i < gv->len_pp; i++){
+			gv->pp_flags[i][k]   = 0;
 		}
-		for (int i = 0; i < gv.len_ss; i++){ 
+		for (int i = 0; i < gv->len_ss; i++){ 
 			SS_ref_db[i].ss_flags[k]   = 0;
 		}
 	}
 	
 	/* reset pure phases fractions and xi */
-	for (int i = 0; i < gv.len_pp; i++){		
-		gv.pp_n[i] 		  = 0.0;
-		gv.delta_pp_n[i]  = 0.0;
-		gv.pp_xi[i] 	  = 0.0;
-		gv.delta_pp_xi[i] = 0.0;
+	for (int i = 0; i < gv->len_pp; i++){		
+		gv->pp_n[i] 		  = 0.0;
+		gv->delta_pp_n[i]  = 0.0;
+		gv->pp_xi[i] 	  = 0.0;
+		gv->delta_pp_xi[i] = 0.0;
 	}
 	
 	/* reset solution phases frations */
-	for (int i = 0; i < gv.len_ss; i++){ 	
+	for (int i = 0; i < gv->len_ss; i++){ 	
 		SS_ref_db[i].ss_n = 0.0;
 	}
 	
-	gv.check_PC_ite		  = 0;
-	gv.check_PC			  = 0;
-	gv.maxeval		      = gv.maxeval_mode_1;
-	gv.len_cp 		  	  = 0;
-	gv.div				  = 0;
-	gv.n_phase            = 0;                  /** reset the number of phases to start with */
-	gv.global_ite		  = 0;					/** reset the number of global iteration to zero */
-	gv.G_system           = 0.0;
-	gv.n_cp_phase         = 0;					/** reset the number of ss phases to start with */
-	gv.n_pp_phase         = 0;					/** reset the number of pp phases to start with */
-	gv.alpha          	  = gv.max_fac;
-
-    for (i = 0; i < gv.ur_f; i++){	
-        gv.PGE_mass_norm[i] = 0.0;
+	gv->check_PC_ite		  = 0;
+	gv->check_PC			  = 0;
+	gv->GM_done			  = 0;
+	gv->maxeval		      = gv->maxeval_mode_1;
+	gv->len_cp 		  	  = 0;
+	gv->div				  = 0;
+	gv->n_phase            = 0;                  /** reset the number of phases to start with */
+	gv->global_ite		  = 0;					/** reset the number of global iteration to zero */
+	gv->G_system           = 0.0;
+	gv->n_cp_phase         = 0;					/** reset the number of ss phases to start with */
+	gv->n_pp_phase         = 0;					/** reset the number of pp phases to start with */
+	gv->alpha          	  = gv->max_fac;
+	gv->inner_PGE_n		  = gv->inner_PGE_ite;
+	gv->adapt_n_stable	  = 0;
+	gv->n_trc_ev			  = 0;
+
+    for (i = 0; i < gv->ur_f; i++){	
+        gv->PGE_mass_norm[i] = 0.0;
     }
 
-    for (i = 0; i < gv.len_ox; i++){	
-        gv.mass_residual[i] = 0.0;
-        gv.gam_tot[i]     	= 0.0;
-        gv.del_gam_tot[i]   = 0.0;
-        gv.delta_gam_tot[i] = 0.0;
+    for (i = 0; i < gv->len_ox; i++){	
+        gv->mass_residual[i] = 0.0;
+        gv->gam_tot[i]     	= 0.0;
+        gv->del_gam_tot[i]   = 0.0;
+        gv->delta_gam_tot[i] = 0.0;
     }
 
-    for (i = 0; i < gv.len_ss; i++){	
-        gv.n_solvi[i] = 0;
-		for (k = 0; k < gv.max_n_cp; k++){	
-			gv.id_solvi[i][k] = 0;
+    for (i = 0; i < gv->len_ss; i++){	
+        gv->n_solvi[i] = 0;
+		for (k = 0; k < gv->max_n_cp; k++){	
+			gv->id_solvi[i][k] = 0;
 		} 
     }
-
-	return gv;
 }
 
 /**
   initilize solution phase database
 **/
-global_variable init_ss_db(		int 				 EM_database,
-								struct bulk_info 	 z_b,
-								global_variable 	 gv,
-								SS_ref 				*SS_ref_db
+void init_ss_db(		int 				 EM_database,
+						struct bulk_info 	 z_b,
+						global_variable 	*gv,
+						SS_ref 				*SS_ref_db
 ){
 	double R  = 0.0083144; 
-	for (int i = 0; i < gv.len_ss; i++){
+	for (int i = 0; i < gv->len_ss; i++){
 	
 		SS_ref_db[i]    = G_SS_EM_function(			gv, 
 													SS_ref_db[i], 
 													EM_database, 
 													z_b, 
-													gv.SS_list[i]		);
+													gv->SS_list[i]		);
 										 
 		SS_ref_db[i].P  = z_b.P;									/** needed to pass to local minimizer, allows for P variation for liq/sol */
 		SS_ref_db[i].T  = z_b.T;		
 		SS_ref_db[i].R  = R;										/** can become a global variable instead */
 
 	}
-
-	return gv;
 };
 
 /**
   reset compositional variables (xeos) when something goes wrong during minimization 
 */
-global_variable reset_phases(		global_variable 	 gv,
-									struct bulk_info 	 z_b,
-									PP_ref 				*PP_ref_db,
-									SS_ref 				*SS_ref_db,
-									csd_phase_set  		*cp
+void reset_phases(		global_variable 	*gv,
+						struct bulk_info 	 z_b,
+						PP_ref 				*PP_ref_db,
+						SS_ref 				*SS_ref_db,
+						csd_phase_set  		*cp
 ){
 	
-	for (int i = 0; i < gv.max_n_cp; i++){		
+	for (int i = 0; i < gv->max_n_cp; i++){		
 		strcpy(cp[i].name,"");					/* get phase name */	
 		cp[i].in_iter		= 0;
 		cp[i].split			= 0;
+		cp[i].min_stable	= 0;
+		cp[i].min_skip		= 0;
+		cp[i].n_LM			= 0;
+		cp[i].LM_time		= 0.0;
+		cp[i].n_eval		= 0;
+		cp[i].n_ee			= 0;
+		cp[i].n_eval_ref	= 0;
+		cp[i].n_eval_saved	= 0;
+		cp[i].n_hit			= 0;
+		cp[i].df_LM			= 0.0;
 		cp[i].id 			= -1;				/* get phaseid */
 		cp[i].n_xeos		= 0;				/* get number of compositional variables */
 		cp[i].n_em			= 0;				/* get number of endmembers */
@@ -396,14 +807,14 @@ global_variable reset_phases(		global_variable 	 gv,
 		cp[i].df 			= 0.0;
 		cp[i].factor 		= 0.0;
 		
-		for (int ii = 0; ii < gv.n_flags; ii++){
+		for (int ii = 0; ii < gv->n_flags; ii++){
 			cp[i].ss_flags[ii] = 0;
 		}
 
 		cp[i].ss_n        	= 0.0;				/* get initial phase fraction */
 		cp[i].delta_ss_n    = 0.0;				/* get initial phase fraction */
 		
-		for (int ii = 0; ii < gv.len_ox + 1; ii++){
+		for (int ii = 0; ii < gv->len_ox + 1; ii++){
 			cp[i].p_em[ii]      = 0.0;
 			cp[i].z_em[ii]      = 1.0;
 			cp[i].xi_em[ii]     = 0.0;
@@ -415,7 +826,7 @@ global_variable reset_phases(		global_variable 	 gv,
 			cp[i].ss_comp[ii]   = 0.0;
 		}
 		 
-		for (int ii = 0; ii < (gv.len_ox + 1)*2; ii++){
+		for (int ii = 0; ii < (gv->len_ox + 1)*2; ii++){
 			cp[i].sf[ii]    = 0.0;
 		}
 		
@@ -427,51 +838,60 @@ global_variable reset_phases(		global_variable 	 gv,
 	
 	/* reset pure phases */
 	char liq_tail[] = "L";
-	for (int i = 0; i < gv.len_pp; i++){
-		if ( EndsWithTail(gv.PP_list[i], liq_tail) == 1 ){
+	for (int i = 0; i < gv->len_pp; i++){
+		if ( EndsWithTail(gv->PP_list[i], liq_tail) == 1 ){
 			if (z_b.T < 773.0){
-				gv.pp_flags[i][0] = 0;
-				gv.pp_flags[i][1] = 0;
-				gv.pp_flags[i][2] = 0;
-				gv.pp_flags[i][3] = 1;
+				gv->pp_flags[i][0] = 0;
+				gv->pp_flags[i][1] = 0;
+				gv->pp_flags[i][2] = 0;
+				gv->pp_flags[i][3] = 1;
 			}
 			else{
-				gv.pp_flags[i][0] = 1;
-				gv.pp_flags[i][1] = 0;
-				gv.pp_flags[i][2] = 0;
-				gv.pp_flags[i][3] = 0;
+				gv->pp_flags[i][0] = 1;
+				gv->pp_flags[i][1] = 0;
+				gv->pp_flags[i][2] = 0;
+				gv->pp_flags[i][3] = 0;
 			}
 		}
 		else{
-			gv.pp_flags[i][0] = 1;
-			gv.pp_flags[i][1] = 0;
-			gv.pp_flags[i][2] = 1;
-			gv.pp_flags[i][3] = 0;
+			gv->pp_flags[i][0] = 1;
+			gv->pp_flags[i][1] = 0;
+			gv->pp_flags[i][2] = 1;
+			gv->pp_flags[i][3] = 0;
 		}
 	}
 	
 	/* reset solution phases */
-	for (int iss = 0; iss < gv.len_ss; iss++){
+	for (int iss = 0; iss < gv->len_ss; iss++){
 		SS_ref_db[iss].min_mode	= 1;
-		SS_ref_db[iss].tot_pc 	= 0;
-		SS_ref_db[iss].id_pc  	= 0;
-		for (int j = 0; j < gv.len_ox; j++){
+		SS_ref_db[iss].n_pc_gen   = 0;
+		SS_ref_db[iss].n_pc_kept  = 0;
+		SS_ref_db[iss].n_pc_filt  = 0;
+		SS_ref_db[iss].n_pc_pivot = 0;
+		for (int j = 0; j < gv->len_ox; j++){
 			SS_ref_db[iss].solvus_id[j] = -1;	
 		}
-		for (int i = 0; i < (SS_ref_db[iss].n_pc); i++){
-			SS_ref_db[iss].factor_pc[i] = 0.0;
-			SS_ref_db[iss].n_swap[i] = 0;
-			SS_ref_db[iss].G_pc[i]   = 0.0;
-			SS_ref_db[iss].DF_pc[i]  = 0.0;
-			for (int j = 0; j < gv.len_ox; j++){
-				SS_ref_db[iss].comp_pc[i][j]  = 0.0;
-			}
-			for (int j = 0; j < SS_ref_db[iss].n_em; j++){
-				SS_ref_db[iss].p_pc[i][j]  = 0;	
-				SS_ref_db[iss].mu_pc[i][j] = 0;	
-			}
-			for (int j = 0; j < (SS_ref_db[iss].n_xeos); j++){
-				SS_ref_db[iss].xeos_pc[i][j]  = 0.0;
+
+		/* the pseudocompounds are kept when the batch levelling mode reuses them for the next point */
+		if (gv->PC_reuse == 0){
+			SS_ref_db[iss].tot_pc 	= 0;
+			SS_ref_db[iss].id_pc  	= 0;
+			SS_ref_db[iss].kd_n  	= 0;
+			for (int i = 0; i < (SS_ref_db[iss].n_pc); i++){
+				SS_ref_db[iss].factor_pc[i] = 0.0;
+				SS_ref_db[iss].n_swap[i] = 0;
+				SS_ref_db[iss].G_pc[i]   = 0.0;
+				SS_ref_db[iss].DF_pc[i]  = 0.0;
+				for (int j = 0; j < gv->len_ox; j++){
+					SS_ref_db[iss].comp_pc[i][j]  = 0.0;
+				}
+				for (int j = 0; j < SS_ref_db[iss].n_em; j++){
+					SS_ref_db[iss].p_pc[i][j]  = 0;	
+					SS_ref_db[iss].mu_pc[i][j] = 0;	
+				}
+				for (int j = 0; j < (SS_ref_db[iss].n_xeos); j++){
+					SS_ref_db[iss].xeos_pc[i][j]  = 0.0;
+				}
 			}
 		}
 		for (int j = 0; j < SS_ref_db[iss].n_em; j++){
@@ -490,26 +910,37 @@ global_variable reset_phases(		global_variable 	 gv,
 			SS_ref_db[iss].box_bounds[k][1] = SS_ref_db[iss].box_bounds_default[k][1];
 		}		
 	}	
-	
-	return gv;
 };
 
 
 /**
 Function to destroy allocated memory of solution phase structure
 */
-void SS_ref_destroy(	global_variable gv, 
+void SS_ref_destroy(	global_variable *gv, 
 						SS_ref *SS_ref_db		){	
 											  
-	for (int i = 0; i < gv.len_ss; i++){
+	for (int i = 0; i < gv->len_ss; i++){
 		
 		free(SS_ref_db[i].ss_flags);
+		free(SS_ref_db[i].solvus_id);
+		free(SS_ref_db[i].W);
+		if (SS_ref_db[i].symmetry == 0){
+			free(SS_ref_db[i].v);
+		}
 		for (int j = 0; j < SS_ref_db[i].n_em; j++) {
+			free(SS_ref_db[i].EM_list[j]);
+			free(SS_ref_db[i].eye[j]);
 			free(SS_ref_db[i].dp_dx[j]);
 			free(SS_ref_db[i].Comp[j]);
 		}
+		free(SS_ref_db[i].EM_list);
+		free(SS_ref_db[i].eye);
 		free(SS_ref_db[i].dp_dx);
 		free(SS_ref_db[i].Comp);
+		for (int j = 0; j < gv->n_Diff; j++) {
+			free(SS_ref_db[i].mu_array[j]);
+		}
+		free(SS_ref_db[i].mu_array);
 		
 		free(SS_ref_db[i].gbase);
 		free(SS_ref_db[i].gb_lvl);
@@ -518,6 +949,7 @@ void SS_ref_destroy(	global_variable gv,
 		free(SS_ref_db[i].dguess);
 		free(SS_ref_db[i].iguess);
 		free(SS_ref_db[i].p);
+		free(SS_ref_db[i].ape);
 		free(SS_ref_db[i].mat_phi);
 		free(SS_ref_db[i].mu_Gex);
 		free(SS_ref_db[i].sf);
@@ -527,6 +959,12 @@ void SS_ref_destroy(	global_variable gv,
 		free(SS_ref_db[i].xi_em);	
 		free(SS_ref_db[i].xeos);
 		free(SS_ref_db[i].dsf);
+		free(SS_ref_db[i].sqp_ws);
+		free(SS_ref_db[i].sqp_iw);
+		free(SS_ref_db[i].hess_ws);
+		free(SS_ref_db[i].ub);
+		free(SS_ref_db[i].lb);
+		free(SS_ref_db[i].tol_sf);
 
 		/** destroy box bounds */
 		for (int j = 0; j< SS_ref_db[i].n_xeos; j++) {
@@ -540,13 +978,17 @@ void SS_ref_destroy(	global_variable gv,
 		for (int j = 0; j< SS_ref_db[i].n_pc; j++) {
 			free(SS_ref_db[i].comp_pc[j]);
 			free(SS_ref_db[i].p_pc[j]);
+			free(SS_ref_db[i].mu_pc[j]);
 			free(SS_ref_db[i].xeos_pc[j]);
 		}
 		free(SS_ref_db[i].comp_pc);
 		free(SS_ref_db[i].n_swap);
 		free(SS_ref_db[i].info);
+		free(SS_ref_db[i].kd_idx);
+		free(SS_ref_db[i].kd_nb);
 		free(SS_ref_db[i].xeos_pc);
 		free(SS_ref_db[i].p_pc);
+		free(SS_ref_db[i].mu_pc);
 		free(SS_ref_db[i].G_pc);
 		free(SS_ref_db[i].factor_pc);
 		free(SS_ref_db[i].DF_pc);
@@ -559,10 +1001,10 @@ void SS_ref_destroy(	global_variable gv,
 /**
 	Function to destroy allocated memory of considered phase structure
 */
-void CP_destroy(		global_variable gv, 
+void CP_destroy(		global_variable *gv, 
 						csd_phase_set  *cp		){	
 											  
-	for (int i = 0; i < gv.max_n_cp; i++){
+	for (int i = 0; i < gv->max_n_cp; i++){
 		free(cp[i].name);
 		free(cp[i].z_em);
 		free(cp[i].p_em);
@@ -571,6 +1013,7 @@ void CP_destroy(		global_variable gv,
 		free(cp[i].xeos);
 		free(cp[i].ss_flags);
 		free(cp[i].ss_comp);
+		free(cp[i].comp_nz);
 		free(cp[i].dfx);
 		free(cp[i].sf);
 		free(cp[i].mu);
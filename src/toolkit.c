@@ -397,11 +397,89 @@ double partial_euclidean_distance(double *array1 ,double *array2 ,int n){
 
 	return norm;
 }
+
 /**
-  inverse a matrix using LAPACKE dgetrf and dgetri
-*/	
-void inverseMatrix(double *A1, int n){
-	int    ipiv[n];					
+  partial sort of an index array (quickselect) so that idx[k] holds the median point along axis
+*/
+void kdtree_select(int *idx, double **pts, int lo, int hi, int k, int axis){
+	int    i, j, tmp;
+	double pivot;
+
+	while (hi > lo){
+		pivot = pts[idx[(lo+hi)/2]][axis];
+		i 	  = lo;
+		j 	  = hi;
+		while (i <= j){
+			while (pts[idx[i]][axis] < pivot){ i++; }
+			while (pts[idx[j]][axis] > pivot){ j--; }
+			if (i <= j){
+				tmp = idx[i]; idx[i] = idx[j]; idx[j] = tmp;
+				i++; j--;
+			}
+		}
+		if 		(k <= j){ hi = j; }
+		else if (k >= i){ lo = i; }
+		else 			{ return; }
+	}
+};
+
+/**
+  recursive construction of an implicit k-d tree: the median of [lo,hi) is stored at (lo+hi)/2
+*/
+void kdtree_build_rec(int *idx, double **pts, int lo, int hi, int depth, int dim){
+	if (hi - lo <= 1){ return; }
+
+	int mid = (lo+hi)/2;
+	kdtree_select(idx, pts, lo, hi-1, mid, depth%dim);
+	kdtree_build_rec(idx, pts, lo,    mid, depth+1, dim);
+	kdtree_build_rec(idx, pts, mid+1, hi,  depth+1, dim);
+};
+
+/**
+  build a balanced k-d tree over n points of dimension dim, the tree is stored as a permutation of the point indexes
+*/
+void kdtree_build(int *idx, double **pts, int n, int dim){
+	for (int i = 0; i < n; i++){
+		idx[i] = i;
+	}
+	kdtree_build_rec(idx, pts, 0, n, 0, dim);
+};
+
+/**
+  recursive radius search in the implicit k-d tree
+*/
+int kdtree_radius_rec(int *idx, double **pts, int lo, int hi, int depth, int dim, double *q, double r2, int *out, int n_out){
+	if (hi <= lo){ return n_out; }
+
+	int    mid  = (lo+hi)/2;
+	int    axis = depth%dim;
+	double diff = q[axis] - pts[idx[mid]][axis];
+
+	if (partial_euclidean_distance(pts[idx[mid]], q, dim) < r2){
+		out[n_out] = idx[mid];
+		n_out 	  += 1;
+	}
+	if (diff <= 0.0 || diff*diff < r2){
+		n_out = kdtree_radius_rec(idx, pts, lo, mid, depth+1, dim, q, r2, out, n_out);
+	}
+	if (diff >= 0.0 || diff*diff < r2){
+		n_out = kdtree_radius_rec(idx, pts, mid+1, hi, depth+1, dim, q, r2, out, n_out);
+	}
+	return n_out;
+};
+
+/**
+  get the indexes of all the points lying strictly within sqrt(r2) of q, returns the number of points found
+  - out must be able to hold n entries
+*/
+int kdtree_radius_search(int *idx, double **pts, int n, int dim, double *q, double r2, int *out){
+	return kdtree_radius_rec(idx, pts, 0, n, 0, dim, q, r2, out, 0);
+};
+
+/**
+  inverse a matrix using LAPACKE dgetrf and dgetri, ipiv holds n pivot indices
+*/
+void inverseMatrix(double *A1, int *ipiv, int n){
 	int    info;
 	
 	/* call lapacke to inverse Matrix */
@@ -409,6 +487,51 @@ void inverseMatrix(double *A1, int n){
 	info = LAPACKE_dgetri(LAPACK_ROW_MAJOR, n, A1, n, ipiv);
 };
 
+/**
+  Cholesky factorization A = L*L' of a symmetric positive definite matrix (row major, n*n),
+  L is stored in the lower triangle of A. Returns 1 if the matrix is not positive definite
+*/
+int cholesky_factor(double *A, int n){
+	double sum;
+
+	for (int j = 0; j < n; j++){
+		sum = A[j*n + j];
+		for (int k = 0; k < j; k++){
+			sum -= A[j*n + k]*A[j*n + k];
+		}
+		if (sum <= 1e-12*fabs(A[j*n + j])){ return 1; }				/** also rejects numerically singular matrices */
+		A[j*n + j] = sqrt(sum);
+
+		for (int i = j + 1; i < n; i++){
+			sum = A[i*n + j];
+			for (int k = 0; k < j; k++){
+				sum -= A[i*n + k]*A[j*n + k];
+			}
+			A[i*n + j] = sum/A[j*n + j];
+		}
+	}
+	return 0;
+};
+
+/**
+  solve L*L'*x = b using the factor of cholesky_factor, the solution overwrites b
+*/
+void cholesky_solve(double *L, double *b, int n){
+
+	for (int i = 0; i < n; i++){
+		for (int k = 0; k < i; k++){
+			b[i] -= L[i*n + k]*b[k];
+		}
+		b[i] /= L[i*n + i];
+	}
+	for (int i = n - 1; i >= 0; i--){
+		for (int k = i + 1; k < n; k++){
+			b[i] -= L[k*n + i]*b[k];
+		}
+		b[i] /= L[i*n + i];
+	}
+};
+
 /**
   vector vectorT multiplication
 */	
@@ -526,23 +649,23 @@ void print_vector_norm( char* desc, int m, int n, double* a, int lda ) {
 	function to print out considered phases structure 
 */
 void print_cp(
-	global_variable gv,
+	global_variable *gv,
 	csd_phase_set  *cp
 ){
 	printf("PRINT CONSIDERED PHASES\n");
 	printf("------------------------\n\n");
 	
-	printf(" N_solvi %d: \n",gv.len_cp);
-	for (int i = 0; i < gv.len_ss; i++){	
-		printf(" %4s %d | ",gv.SS_list[i],gv.n_solvi[i]);
-		for (int j = 0; j < gv.n_solvi[i]; j++){	
-			printf(" %4s %d",cp[gv.id_solvi[i][j]].name,gv.id_solvi[i][j]);
+	printf(" N_solvi %d: \n",gv->len_cp);
+	for (int i = 0; i < gv->len_ss; i++){	
+		printf(" %4s %d | ",gv->SS_list[i],gv->n_solvi[i]);
+		for (int j = 0; j < gv->n_solvi[i]; j++){	
+			printf(" %4s %d",cp[gv->id_solvi[i][j]].name,gv->id_solvi[i][j]);
 		}
 		printf("\n");
 	}
 	printf("\n");
 	
-	for (int i = 0; i < gv.len_cp; i++){		
+	for (int i = 0; i < gv->len_cp; i++){		
 		printf("[ #%d ]\n",i);
 		printf(" SS name:  %4s\n",   cp[i].name);
 		printf(" SS id:     %d\n",   cp[i].id);
@@ -552,7 +675,7 @@ void print_cp(
 		printf(" SS_factor:%+10f\n", cp[i].factor);
 		printf(" SS_min_time:%+10f\n", cp[i].min_time);
 	 	printf(" SS_flags: ");
-		for (int ii = 0; ii < gv.n_flags; ii++){
+		for (int ii = 0; ii < gv->n_flags; ii++){
 			printf(" %d",cp[i].ss_flags[ii]);
 		}
 		printf("\n");
@@ -595,10 +718,10 @@ void print_cp(
 /**
    rotate G-hyperplane using Gamma
 */
-void print_SS_informations(		global_variable gv,
+void print_SS_informations(		global_variable *gv,
 								SS_ref SS_ref_db,
 								int		iss					){
-	printf(" %4s  | %+10f | %2d | %+10f | %+10f | ",gv.SS_list[iss],SS_ref_db.df,SS_ref_db.sf_ok,SS_ref_db.sum_xi,SS_ref_db.LM_time);
+	printf(" %4s  | %+10f | %2d | %+10f | %+10f | ",gv->SS_list[iss],SS_ref_db.df,SS_ref_db.sf_ok,SS_ref_db.sum_xi,SS_ref_db.LM_time);
 	for (int k = 0; k < SS_ref_db.n_xeos; k++) {
 		printf(" %+10f",SS_ref_db.xeos[k]);
 	}
@@ -613,7 +736,7 @@ void print_SS_informations(		global_variable gv,
 		//printf(" %10s","-");
 	//}
 	//printf(" | ");
-	//for (int k = 0; k < gv.len_ox; k++){
+	//for (int k = 0; k < gv->len_ox; k++){
 		//printf(" %+10f",SS_ref_db.ss_comp[k]*SS_ref_db.factor);
 	//}
 	printf(" | ");
@@ -629,75 +752,67 @@ void print_SS_informations(		global_variable gv,
 /**
    rotate G-hyperplane using Gamma
 */
-SS_ref rotate_hyperplane(	global_variable gv,
-							SS_ref SS_ref_db		){
+void rotate_hyperplane(	global_variable *gv,
+							SS_ref *SS_ref_db		){
 	
 	/** rotate gbase with respect to the G-hyperplane (change of base) */
-	for (int k = 0; k < SS_ref_db.n_em; k++) {
-		SS_ref_db.gb_lvl[k] = SS_ref_db.gbase[k];
-		for (int j = 0; j < gv.len_ox; j++) {
-			SS_ref_db.gb_lvl[k] -= SS_ref_db.Comp[k][j]*gv.gam_tot[j];
+	for (int k = 0; k < SS_ref_db->n_em; k++) {
+		SS_ref_db->gb_lvl[k] = SS_ref_db->gbase[k];
+		for (int j = 0; j < gv->len_ox; j++) {
+			SS_ref_db->gb_lvl[k] -= SS_ref_db->Comp[k][j]*gv->gam_tot[j];
 		}
 	}	
-	
-	return SS_ref_db;
 }
 
 /**
    raw G-hyperplane using Gamma
 */
-SS_ref raw_hyperplane(		global_variable  gv,
-							SS_ref 			 SS_ref_db,
+void raw_hyperplane(		global_variable *gv,
+							SS_ref 			*SS_ref_db,
 							double 			*gb				){
 	
 	/** rotate gbase with respect to the G-hyperplane (change of base) */
-	for (int k = 0; k < SS_ref_db.n_em; k++) {
-		SS_ref_db.gb_lvl[k] = gb[k];
+	for (int k = 0; k < SS_ref_db->n_em; k++) {
+		SS_ref_db->gb_lvl[k] = gb[k];
 	}	
-	
-	return SS_ref_db;
 }
 
 
 /**
    restrict solution phase hyper volume for local minimization
 */
-SS_ref restrict_SS_HyperVolume(		global_variable gv, 
-									SS_ref SS_ref_db,
+void restrict_SS_HyperVolume(		global_variable *gv, 
+									SS_ref *SS_ref_db,
 									double box_size		){
 									
-	for (int j = 0; j < SS_ref_db.n_xeos; j++){
-		SS_ref_db.box_bounds[j][0] = SS_ref_db.iguess[j] - box_size;
-		SS_ref_db.box_bounds[j][1] = SS_ref_db.iguess[j] + box_size;
+	for (int j = 0; j < SS_ref_db->n_xeos; j++){
+		SS_ref_db->box_bounds[j][0] = SS_ref_db->iguess[j] - box_size;
+		SS_ref_db->box_bounds[j][1] = SS_ref_db->iguess[j] + box_size;
 		
-		if (SS_ref_db.box_bounds[j][0] < SS_ref_db.box_bounds_default[j][0]){
-			SS_ref_db.box_bounds[j][0] = SS_ref_db.box_bounds_default[j][0];
+		if (SS_ref_db->box_bounds[j][0] < SS_ref_db->box_bounds_default[j][0]){
+			SS_ref_db->box_bounds[j][0] = SS_ref_db->box_bounds_default[j][0];
 		}
-		if (SS_ref_db.box_bounds[j][1] > SS_ref_db.box_bounds_default[j][1]){
-			SS_ref_db.box_bounds[j][1] = SS_ref_db.box_bounds_default[j][1];
+		if (SS_ref_db->box_bounds[j][1] > SS_ref_db->box_bounds_default[j][1]){
+			SS_ref_db->box_bounds[j][1] = SS_ref_db->box_bounds_default[j][1];
 		}
 	}
-						
-	return SS_ref_db;										
 }
 
 
 /**
    check bounds
 */
-SS_ref check_SS_bounds(		global_variable gv, 
-							SS_ref SS_ref_db					){
+void check_SS_bounds(		global_variable *gv, 
+							SS_ref *SS_ref_db					){
 									
-	for (int j = 0; j < SS_ref_db.n_xeos; j++){
-		if (SS_ref_db.iguess[j] < SS_ref_db.box_bounds_default[j][0]){
-			SS_ref_db.iguess[j] = SS_ref_db.box_bounds_default[j][0];
+	for (int j = 0; j < SS_ref_db->n_xeos; j++){
+		if (SS_ref_db->iguess[j] < SS_ref_db->box_bounds_default[j][0]){
+			SS_ref_db->iguess[j] = SS_ref_db->box_bounds_default[j][0];
 		}
-		if (SS_ref_db.iguess[j] > SS_ref_db.box_bounds_default[j][1]){
-			SS_ref_db.iguess[j] = SS_ref_db.box_bounds_default[j][1];
+		if (SS_ref_db->iguess[j] > SS_ref_db->box_bounds_default[j][1]){
+			SS_ref_db->iguess[j] = SS_ref_db->box_bounds_default[j][1];
 		}
 	}
-						
-	return SS_ref_db;										
 }
 
 
@@ -705,12 +820,12 @@ SS_ref check_SS_bounds(		global_variable gv,
 /**
    retrieve the number of solution phase that are active 
 */
-int getActiveSPhaseN(	global_variable gv,
+int getActiveSPhaseN(	global_variable *gv,
 						PP_ref *PP_ref_db,
 						SS_ref *SS_ref_db		){
 	
 	int n = 0;
-	for (int i = 0; i < gv.len_ss; i++){
+	for (int i = 0; i < gv->len_ss; i++){
 		if (SS_ref_db[i].ss_flags[1] == 1){	n += 1;	}
 	}
 	
@@ -720,16 +835,16 @@ int getActiveSPhaseN(	global_variable gv,
 /**
    retrieve the number of phases that are active 
 */
-int getActivePhaseN(	global_variable gv,
+int getActivePhaseN(	global_variable *gv,
 						PP_ref *PP_ref_db,
 						SS_ref *SS_ref_db		){
 	
 	int n = 0;
-	for (int i = 0; i < gv.len_ss; i++){
+	for (int i = 0; i < gv->len_ss; i++){
 		if (SS_ref_db[i].ss_flags[1] == 1){	n += 1;	}
 	}
-	for (int i = 0; i < gv.len_pp; i++){
-		if (gv.pp_flags[i][1] == 1){	n += 1;	}
+	for (int i = 0; i < gv->len_pp; i++){
+		if (gv->pp_flags[i][1] == 1){	n += 1;	}
 	}	
 	return n;
 }
@@ -757,46 +872,42 @@ void get_act_sf_id(int *result, double *A, int n){
 /**
 	get id of active pure phases
 */
-global_variable get_pp_id(	global_variable  	 gv		
+void get_pp_id(	global_variable  	*gv		
 ){
 	/* extact pure phases to take into account */
 	int k = 0;
-	for (int i = 0; i < gv.len_pp; i++){
-		if (gv.pp_flags[i][1] == 1){
-			//gv.nEntry_sys += 1;
-			gv.pp_id[k] = i;
+	for (int i = 0; i < gv->len_pp; i++){
+		if (gv->pp_flags[i][1] == 1){
+			//gv->nEntry_sys += 1;
+			gv->pp_id[k] = i;
 			k       += 1;
 		}
 	}
 	
-	if (gv.n_pp_phase != k){
+	if (gv->n_pp_phase != k){
 		printf("\n   !WARNING! inconsistent number of active phases (n_pp_phase vs sum(pp_flag[1])\n");
-		printf("   !WARNING! n_pp_phase %i; sum(pp_flag[1]) %i;\n\n",gv.n_pp_phase,k);
+		printf("   !WARNING! n_pp_phase %i; sum(pp_flag[1]) %i;\n\n",gv->n_pp_phase,k);
 	}
-	
-	return gv;
 }
 
 /**
 	get id of active solution phases
 */
-global_variable get_ss_id(	global_variable  	 gv,
-							csd_phase_set  		*cp		
+void get_ss_id(	global_variable  	*gv,
+				csd_phase_set  		*cp		
 ){
 	/* extact solution phases to take into account */
 	int k = 0;
-	for (int i = 0; i < gv.len_cp; i++){
+	for (int i = 0; i < gv->len_cp; i++){
 		if (cp[i].ss_flags[1] == 1){
-			//gv.nEntry_sys += cp[i].n_xeos;
-			gv.cp_id[k] = i;
+			//gv->nEntry_sys += cp[i].n_xeos;
+			gv->cp_id[k] = i;
 			k += 1;
 		}
 	}
 	
-	if (gv.n_cp_phase != k){
+	if (gv->n_cp_phase != k){
 		printf("\n   !WARNING! inconsistent number of active phases (n_ss_phase vs sum(ss_flag[1])\n");
-		printf("   !WARNING! n_ss_phase %i; sum(ss_flag[1]) %i;\n\n",gv.n_cp_phase,k);
+		printf("   !WARNING! n_ss_phase %i; sum(ss_flag[1]) %i;\n\n",gv->n_cp_phase,k);
 	}
-	
-	return gv;
 }
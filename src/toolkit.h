@@ -9,7 +9,9 @@ void 	_Epsilon_J_fct(double *result, double *A, double *b, int n_xeos);
 void 	_I_DC_Null_fct(int *id, double *result, double *A, double **B, double *eye, int n_act_sf, int n_xeos);
 void 	_FillEyeMatrix(double *A, int n);
 void 	get_act_sf_id(int *result, double *A, int n);
-void 	inverseMatrix(double *A1, int n);
+void 	inverseMatrix(double *A1, int *ipiv, int n);
+int 	cholesky_factor(double *A, int n);
+void 	cholesky_solve(double *L, double *b, int n);
 void 	MatMatMul( double **A, int nrowA, double **B, int ncolB, int common, double **C);
 void 	VecMatMul(double *B1, double *A1, double *B, int n);
 void 	MatVecMul(double *A1, double *br, double *n_vec, int n);
@@ -32,6 +34,11 @@ double 	norm_vector(double *array ,int n);
 double 	euclidean_distance(double *array1 ,double *array2 ,int n);
 double 	partial_euclidean_distance(double *array1 ,double *array2 ,int n);
 double 	VecVecMul(double *B0, double *B1, int n);
+
+/* k-d tree used for proximity queries on pseudocompounds */
+void 	kdtree_build(int *idx, double **pts, int n, int dim);
+int 	kdtree_radius_search(int *idx, double **pts, int n, int dim, double *q, double r2, int *out);
+
 double 	BrentRoots(  double 	x1, 
 					double 	x2,
 					double *data, 
@@ -45,27 +52,27 @@ double 	BrentRoots(  double 	x1,
 					int    *error 			);
 
 /* printing function (verbose) */
-void print_cp(					global_variable gv,
+void print_cp(					global_variable *gv,
 								csd_phase_set  *cp
 															);
 
-void print_SS_informations(		global_variable gv,
+void print_SS_informations(		global_variable *gv,
 								SS_ref SS_ref_db,
 								int		iss					);
 								
 /* functon related to hyperplane manipulation */
-SS_ref rotate_hyperplane(		global_variable gv,
-								SS_ref SS_ref_db			);
+void rotate_hyperplane(		global_variable *gv,
+								SS_ref *SS_ref_db			);
 							
-SS_ref raw_hyperplane(		global_variable  gv,
-							SS_ref 			 SS_ref_db,
+void raw_hyperplane(		global_variable *gv,
+							SS_ref 			*SS_ref_db,
 							double 			*gb				);
-SS_ref restrict_SS_HyperVolume(	global_variable gv, 
-								SS_ref SS_ref_db,
+void restrict_SS_HyperVolume(	global_variable *gv, 
+								SS_ref *SS_ref_db,
 								double box_size				);		
 									
-SS_ref check_SS_bounds(			global_variable gv, 
-								SS_ref SS_ref_db			);																	
+void check_SS_bounds(			global_variable *gv, 
+								SS_ref *SS_ref_db			);																	
 
 
 /*	Reduce row echelon form function (should be deleted eventually) */
@@ -82,9 +89,9 @@ void 	cleanUpMatrix(TMATRIX stoeMat,  double tolerance);
 
 
 /* function related to update on global variables structure */
-global_variable get_pp_id(			global_variable  	 gv		);
+void get_pp_id(			global_variable  	*gv		);
 
-global_variable get_ss_id(			global_variable  	 gv,
-									csd_phase_set  		*cp		);
+void get_ss_id(			global_variable  	*gv,
+						csd_phase_set  		*cp		);
 			
 #endif